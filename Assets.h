@@ -0,0 +1,102 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include "DrawList.h"
+
+/**
+ * @file Assets.h
+ * @brief Header file for the shared asset cache and its background loader.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Assets are looked up by file name. A file in the directory named by the WW_ASSET_DIR environment
+ * variable wins; otherwise builds made with WW_EMBED_ASSETS read the copy compiled into the executable,
+ * and other builds read the file from the working directory.
+ *
+ * Tools that draw into a raster::Canvas instead of a window switch the cache to memory mode before loading
+ * anything. Images then stay decoded in memory and are never uploaded, and text is rendered by the glyph cache,
+ * so nothing needs an OpenGL context or a display.
+ */
+
+namespace assets {
+
+    /**
+     * @brief Keeps images and glyphs in memory instead of on the graphics card. Must be called before any asset
+     * is requested.
+     */
+    void keepInMemory();
+
+    /**
+     * @brief Checks if the cache keeps images and glyphs in memory.
+     * @return True after keepInMemory().
+     */
+    bool inMemory();
+
+    /**
+     * @brief Starts decoding images and fonts on worker threads.
+     * Images are decoded into sf::Image and uploaded to textures later by pump() on the render thread.
+     * @param images File names of the images to decode.
+     * @param fonts File names of the fonts to parse.
+     */
+    void preload(const std::vector<std::string>& images, const std::vector<std::string>& fonts);
+
+    /**
+     * @brief Uploads every decoded image to a texture. Must be called on the render thread.
+     * @return Fraction of preloaded assets that are resident, from 0 to 1.
+     */
+    float pump();
+
+    /**
+     * @brief Draws a progress bar until every preloaded asset is resident.
+     * @param window SFML RenderWindow to draw the loading screen on.
+     */
+    void loadingScreen(sf::RenderWindow& window);
+
+    /**
+     * @brief Gets a texture from the cache, loading it first if it is not resident yet.
+     * Must be called on the render thread. In memory mode the texture is made on first use, which needs OpenGL.
+     * @param file File name of the image.
+     * @return Reference to the cached texture, valid for the lifetime of the program.
+     */
+    const sf::Texture& texture(const std::string& file);
+
+    /**
+     * @brief Creates a sprite that draws an image at the size it appears on screen.
+     * Images packed by atlasTool come from the shared atlas texture; others fall back to their own texture.
+     * Must be called on the render thread.
+     * @param file File name of the source image.
+     * @return Sprite ready to be positioned and drawn.
+     */
+    sf::Sprite sprite(const std::string& file);
+
+    /**
+     * @brief Records an image into a draw list at the size it appears on screen, as sprite() would draw it. In
+     * memory mode the quad samples the decoded image, and no texture is made.
+     * Must be called on the render thread.
+     * @param list Draw list to record into.
+     * @param file File name of the source image.
+     * @param position Where the image's top left corner goes.
+     * @param layer Layer to draw on.
+     */
+    void record(DrawList& list, const std::string& file, const sf::Vector2f& position = sf::Vector2f(0, 0),
+                int layer = 0);
+
+    /**
+     * @brief Gets a font from the cache, loading it first if it is not resident yet.
+     * @param file File name of the font.
+     * @return Reference to the cached font, valid for the lifetime of the program.
+     */
+    const sf::Font& font(const std::string& file);
+
+    /**
+     * @brief Reads a text asset such as the event deck. Safe to call from any thread.
+     * @param file File name of the asset.
+     * @return Contents of the file, or an empty string if it could not be found.
+     */
+    std::string text(const std::string& file);
+
+} // namespace assets
+
+#endif // ASSETS_H
@@ -0,0 +1,71 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * @file Atlas.h
+ * @brief Header file for packing the game's images into a single pre-scaled texture atlas.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace atlas {
+
+    const char* const imageFile = "atlas.png"; ///< Packed atlas image written by atlasTool.
+    const char* const indexFile = "atlas.txt"; ///< Region table written by atlasTool.
+
+    /**
+     * @brief One image stored in the atlas.
+     */
+    struct Region {
+        std::string file;     ///< Source image file name.
+        float scale;          ///< Scale the image is drawn at on screen.
+        sf::Vector2u maxSize; ///< Largest on-screen size ever visible; anything beyond is cropped. Zero means no limit.
+        sf::IntRect rect;     ///< Location of the pre-scaled image inside the atlas.
+    };
+
+    /**
+     * @brief Lists every image that goes into the atlas, with the scale it is drawn at.
+     * @return Regions with their rects left empty.
+     */
+    std::vector<Region> layout();
+
+    /**
+     * @brief Resamples an image with an area-averaging filter and crops it.
+     * @param source Image to resample.
+     * @param scale Scale factor; values below 1 shrink the image.
+     * @param maxSize Crop size after scaling. Zero means no limit.
+     * @return The scaled image.
+     */
+    sf::Image resample(const sf::Image& source, float scale, sf::Vector2u maxSize);
+
+    /**
+     * @brief Scales each source image to its on-screen size and packs them all into one image.
+     * @param sources Decoded images, in the same order as regions.
+     * @param regions Regions from layout(); their rects are filled in.
+     * @return The atlas image, with power-of-two dimensions.
+     */
+    sf::Image pack(const std::vector<sf::Image>& sources, std::vector<Region>& regions);
+
+    /**
+     * @brief Writes the region table to a text file.
+     * @param file Output file name.
+     * @param regions Packed regions.
+     * @return True if the file was written.
+     */
+    bool writeIndex(const std::string& file, const std::vector<Region>& regions);
+
+    /**
+     * @brief Reads a region table written by writeIndex().
+     * @param in Stream holding the table.
+     * @param regions Receives the packed regions.
+     * @return True if at least one region was read.
+     */
+    bool readIndex(std::istream& in, std::vector<Region>& regions);
+
+} // namespace atlas
+
+#endif // ATLAS_H
@@ -0,0 +1,94 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Rules.h"
+
+/**
+ * @file Batch.h
+ * @brief Header file for the batch simulator, which plays many games at once in lockstep, one game per vector
+ * lane, for balance sweeps.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Every lane spins, moves, draws and applies its event with the same vector instructions, and a lane whose game
+ * ends takes the next one straight away. Built with -mavx512f the kernel runs 16 games at a time and with -mavx2
+ * 8; otherwise, and for shuffled decks, whose bags do not fit in a lane, games go through the scalar rules one
+ * by one. Events with scripted effects are run through the interpreter for just the lanes that drew them. Either
+ * way the results match rules::playTurn exactly, game for game and bit for bit.
+ */
+
+namespace batch {
+
+    /**
+     * @class Simulator
+     * @brief Plays games to graduation on the vector kernel, using tables built once from a board and deck.
+     */
+    class Simulator {
+    private:
+        const rules::Board& board;             ///< Board being played.
+        const rules::EventDeck& deck;          ///< Event deck.
+        std::int32_t stride;                   ///< Entries per path in the space tables.
+        std::int32_t last[rules::pathCount];   ///< Last index of each path.
+        std::vector<std::int32_t> spaceSize;   ///< Columns in the alias table drawn from on each space, or 0, by path.
+        std::vector<std::int32_t> spaceOffset; ///< Where that alias table starts in sides and threshold.
+        std::vector<std::int32_t> sides;       ///< Each column's own event, plus its alias event times 65536.
+        std::vector<std::int32_t> threshold;   ///< Each column's chance out of 65536 of keeping its own event.
+        std::vector<std::int32_t> happiness;   ///< Constant happiness change of each event.
+        std::vector<std::int32_t> debt;        ///< Constant debt change of each event.
+        std::vector<std::int32_t> gpa;         ///< Constant GPA change of each event.
+        std::vector<std::int32_t> scripted;    ///< 1 for events whose effect runs in the interpreter.
+        bool anyScripted;                      ///< True if any event's effect runs in the interpreter.
+
+        /**
+         * @brief Plays games on the vector kernel.
+         * @tparam V Vector operations of one instruction set.
+         * @param states Games, played to graduation in place.
+         * @param rngs Each game's random stream, advanced in place.
+         * @param count Number of games.
+         */
+        template <typename V>
+        void playLanes(rules::GameState* states, rules::Rng* rngs, std::size_t count) const;
+
+    public:
+        /**
+         * @brief Constructor for the Simulator class. The board and deck must outlive the simulator.
+         * @param board Board being played.
+         * @param deck Event deck.
+         */
+        Simulator(const rules::Board& board, const rules::EventDeck& deck);
+
+        /**
+         * @brief Gets the number of games the kernel plays at once in this build.
+         * @return 16 for AVX-512, 8 for AVX2 or 1 for the scalar rules.
+         */
+        static int lanes();
+
+        /**
+         * @brief Gets the instruction set the kernel was built for.
+         * @return "AVX-512", "AVX2" or "scalar".
+         */
+        static const char* instructionSet();
+
+        /**
+         * @brief Plays games to graduation with the fastest kernel this build and deck allow. Each game is played
+         * exactly as repeated rules::playTurn calls would play it.
+         * @param states Games, played to graduation in place; both players should have chosen.
+         * @param rngs Each game's random stream, advanced in place.
+         * @param count Number of games.
+         */
+        void play(rules::GameState* states, rules::Rng* rngs, std::size_t count) const;
+
+        /**
+         * @brief Plays games to graduation one at a time with rules::playTurn.
+         * @param states Games, played to graduation in place.
+         * @param rngs Each game's random stream, advanced in place.
+         * @param count Number of games.
+         */
+        void playScalar(rules::GameState* states, rules::Rng* rngs, std::size_t count) const;
+    };
+
+} // namespace batch
+
+#endif // BATCH_H
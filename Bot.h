@@ -0,0 +1,117 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Rules.h"
+
+/**
+ * @file Bot.h
+ * @brief Header file for the computer player, which decides by playing out the rest of the game many times.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @class Bot
+ * @brief Computer player. Each decision is a list of candidate states, one per option; worker threads play
+ * random games from the candidates until the time budget runs out, and the option that won most often is chosen.
+ *
+ * Decisions run in the background: start() returns at once and poll() reports the choice when it is ready,
+ * so the frame loop never waits on the bot.
+ */
+class Bot {
+private:
+    typedef std::chrono::steady_clock Clock; ///< Clock used for the time budget.
+
+    const rules::Board& board;               ///< Board being played.
+    const rules::EventDeck& deck;            ///< Event deck.
+    std::chrono::microseconds budget;        ///< Time each decision may take.
+
+    std::vector<std::thread> workers;        ///< Threads running rollouts.
+    std::mutex lock;                         ///< Guards everything below.
+    std::condition_variable wakeWorkers;     ///< Signalled when a decision starts or the bot is destroyed.
+    std::condition_variable finished;        ///< Signalled when a decision is ready.
+    std::vector<rules::GameState> options;   ///< Candidate state for each option of the current decision.
+    int player;                              ///< Player the bot decides for.
+    Clock::time_point deadline;              ///< When workers stop starting new rollouts.
+    std::uint32_t seed;                      ///< Seed of the current decision's rollouts.
+    unsigned int generation;                 ///< Incremented for every decision, so workers notice new ones.
+    std::vector<long> points;                ///< Points per option: 2 per win and 1 per tie.
+    std::vector<long> plays;                 ///< Rollouts played per option.
+    int busy;                                ///< Workers still running rollouts for the current decision.
+    int choice;                              ///< Chosen option once ready, otherwise -1.
+    long rollouts;                           ///< Rollouts behind the last choice.
+    bool stopping;                           ///< True when the destructor wants the workers to exit.
+
+    /**
+     * @brief Body of each worker thread.
+     * @param id Worker number, mixed into the rollout seeds.
+     */
+    void work(int id);
+
+public:
+    /**
+     * @brief Constructor for the Bot class.
+     * @param board Board being played; must outlive the bot.
+     * @param deck Event deck; must outlive the bot.
+     * @param budget Time each decision may take.
+     * @param threads Number of worker threads, or 0 for one per hardware thread.
+     */
+    Bot(const rules::Board& board, const rules::EventDeck& deck,
+        std::chrono::microseconds budget = std::chrono::milliseconds(5), unsigned int threads = 0);
+
+    /**
+     * @brief Stops the worker threads.
+     */
+    ~Bot();
+
+    Bot(const Bot&) = delete;
+    Bot& operator=(const Bot&) = delete;
+
+    /**
+     * @brief Starts deciding between options in the background, abandoning any decision in progress.
+     * @param candidates State after each option is taken.
+     * @param player Player the bot decides for.
+     */
+    void start(const std::vector<rules::GameState>& candidates, int player);
+
+    /**
+     * @brief Starts choosing a path for a player in the background. The choice is the path index.
+     * @param state Current state; the player must not have chosen yet.
+     * @param player Player the bot chooses for.
+     */
+    void startPathChoice(const rules::GameState& state, int player);
+
+    /**
+     * @brief Checks if the decision is ready without waiting.
+     * @param result Receives the chosen option when ready.
+     * @return True if the decision is ready.
+     */
+    bool poll(int& result);
+
+    /**
+     * @brief Waits for the decision.
+     * @return The chosen option.
+     */
+    int wait();
+
+    /**
+     * @brief Chooses a path, waiting up to the time budget.
+     * @param state Current state; the player must not have chosen yet.
+     * @param player Player the bot chooses for.
+     * @return Path index.
+     */
+    int choosePath(const rules::GameState& state, int player);
+
+    /**
+     * @brief Gets the number of rollouts behind the last decision.
+     * @return Rollouts played.
+     */
+    long lastRollouts();
+};
+
+#endif // BOT_H
@@ -0,0 +1,147 @@
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file Channels.h
+ * @brief Header file for the lock-free channels between the simulation thread and the render thread: a queue for
+ * input going one way and a triple buffer for state snapshots going the other.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Neither side ever waits for the other, so a slow frame cannot hold up the simulation and a busy simulation tick
+ * cannot hold up a frame. The telemetry log uses the same queue to hand records from game threads to its writer.
+ */
+
+/**
+ * @class SpscQueue
+ * @brief Bounded single-producer, single-consumer queue with no locks.
+ * @tparam T Trivially copyable item type.
+ */
+template <typename T>
+class SpscQueue {
+private:
+    std::vector<T> slots;            ///< Storage; the size is a power of two.
+    std::size_t mask;                ///< slots.size() - 1.
+    std::atomic<std::size_t> head;   ///< Next slot to read; written by the consumer only.
+    char padding[64];                ///< Keeps head and tail on separate cache lines.
+    std::atomic<std::size_t> tail;   ///< Next slot to write; written by the producer only.
+
+public:
+    /**
+     * @brief Constructor for the SpscQueue class.
+     * @param capacity Minimum number of items held, rounded up to a power of two.
+     */
+    explicit SpscQueue(std::size_t capacity) : head(0), tail(0) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    /**
+     * @brief Adds an item. Called by the producer only; the release store publishes the slot to the consumer.
+     * @param item Item to add.
+     * @return False if the queue is full.
+     */
+    bool push(const T& item) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest item. Called by the consumer only; the release store hands the slot back.
+     * @param item Receives the item.
+     * @return False if the queue is empty.
+     */
+    bool pop(T& item) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+/**
+ * @class TripleBuffer
+ * @brief Hands the latest value from one writer thread to one reader thread without locks or waiting.
+ * @tparam T Value type, copied into a slot by the writer.
+ *
+ * The writer fills its back slot and swaps it with the middle one; the reader swaps the middle slot with its front
+ * one whenever the middle holds something newer. Each side always owns one slot outright, so the writer never
+ * overwrites what the reader is drawing, and the reader always sees a whole snapshot, skipping any it was too
+ * slow to pick up.
+ */
+template <typename T>
+class TripleBuffer {
+private:
+    static const unsigned fresh = 4; ///< Set in middle when it holds a value the reader has not taken.
+
+    T slots[3];                  ///< Back, middle and front slots, in no fixed order.
+    std::atomic<unsigned> middle; ///< Index of the middle slot, plus the fresh flag.
+    unsigned back;               ///< Slot the writer fills; touched by the writer only.
+    unsigned front;              ///< Slot the reader sees; touched by the reader only.
+
+public:
+    /**
+     * @brief Constructor for the TripleBuffer class.
+     * @param initial Value the reader sees before anything is published.
+     */
+    explicit TripleBuffer(const T& initial = T()) : middle(1), back(0), front(2) {
+        for (auto& slot : slots) {
+            slot = initial;
+        }
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Gets the slot to fill. Called by the writer only.
+     * @return The back slot.
+     */
+    T& writeSlot() {
+        return slots[back];
+    }
+
+    /**
+     * @brief Publishes the back slot as the newest value and takes the old middle slot to fill next.
+     */
+    void publish() {
+        back = middle.exchange(back | fresh, std::memory_order_acq_rel) & ~fresh;
+    }
+
+    /**
+     * @brief Takes the newest published value if there is one. Called by the reader only.
+     * @return True if latest() changed.
+     */
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & fresh)) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & ~fresh;
+        return true;
+    }
+
+    /**
+     * @brief Gets the value the reader holds. It stays unchanged until the next update().
+     * @return The front slot.
+     */
+    const T& latest() const {
+        return slots[front];
+    }
+};
+
+#endif // CHANNELS_H
@@ -0,0 +1,170 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file DrawList.h
+ * @brief Header file for the draw list, a command buffer that game code records shapes, sprites and text into and
+ * that is drawn in a few merged batches instead of one draw call per shape.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Every command is turned into triangles when it is recorded. Building the list sorts the commands by layer, then
+ * by texture, keeping recording order within each, and merges each run that shares a texture into one batch, so
+ * untextured shapes, atlas sprites and each font's glyphs cost one draw call per layer. Layers keep the painter's
+ * order where it matters: anything that must appear above something else goes on a higher layer. A list can be
+ * drawn any number of times once recorded, and its batches can be read back for other backends or replays.
+ *
+ * Quads can also sample an sf::Image in memory instead of a texture. Those batches are for raster::Canvas, which
+ * draws without a graphics card; render targets skip them. The asset cache and the glyph cache record images
+ * instead of textures when they keep everything in memory.
+ */
+
+/**
+ * @class DrawList
+ * @brief Records draw commands for a frame and draws them as merged batches.
+ */
+class DrawList {
+public:
+    /**
+     * @brief A run of triangles drawn with one texture in one call.
+     */
+    struct Batch {
+        const sf::Texture* texture; ///< Texture, or nullptr for plain colour or an image.
+        const sf::Image* image;     ///< Image in memory, or nullptr for plain colour or a texture.
+        bool smooth;                ///< True to filter between the image's texels.
+        std::size_t first;          ///< First vertex in vertices().
+        std::size_t count;          ///< Number of vertices, three per triangle.
+    };
+
+private:
+    /**
+     * @brief One recorded command.
+     */
+    struct Command {
+        int layer;                  ///< Layer; higher layers are drawn later.
+        const sf::Texture* texture; ///< Texture, or nullptr for plain colour or an image.
+        const sf::Image* image;     ///< Image in memory, or nullptr for plain colour or a texture.
+        bool smooth;                ///< True to filter between the image's texels.
+        std::size_t first;          ///< First vertex in recorded.
+        std::size_t count;          ///< Number of vertices.
+    };
+
+    std::vector<Command> commands;    ///< Commands in recording order.
+    std::vector<sf::Vertex> recorded; ///< Triangles of every command, in recording order.
+    std::vector<sf::Vertex> merged;   ///< Triangles sorted into batches.
+    std::vector<Batch> batches;       ///< Batches in drawing order.
+    bool built;                       ///< True if the batches match the commands.
+
+    /**
+     * @brief Records a fan of triangles over a convex outline.
+     * @param corners Outline in drawing order.
+     * @param count Number of corners.
+     * @param texture Texture, or nullptr for plain colour or an image.
+     * @param image Image in memory, or nullptr for plain colour or a texture.
+     * @param smooth True to filter between the image's texels.
+     * @param layer Layer to draw on.
+     */
+    void addFan(const sf::Vertex* corners, std::size_t count, const sf::Texture* texture, const sf::Image* image,
+                bool smooth, int layer);
+
+    /**
+     * @brief Records a quad as big as a texture rectangle, as sf::Sprite draws it.
+     * @param rect Part of the texture or image to draw, in texels.
+     * @param transform Places the quad.
+     * @param color Colour the texels are multiplied by.
+     * @param texture Texture, or nullptr for an image.
+     * @param image Image in memory, or nullptr for a texture.
+     * @param smooth True to filter between the image's texels.
+     * @param layer Layer to draw on.
+     */
+    void addQuad(const sf::IntRect& rect, const sf::Transform& transform, const sf::Color& color,
+                 const sf::Texture* texture, const sf::Image* image, bool smooth, int layer);
+
+public:
+    /**
+     * @brief Constructor for the DrawList class. The list starts empty.
+     */
+    DrawList();
+
+    /**
+     * @brief Removes every command.
+     */
+    void clear();
+
+    /**
+     * @brief Checks if nothing has been recorded.
+     * @return True if the list is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Records a filled rectangle. Fully transparent rectangles are skipped.
+     * @param area Rectangle to fill.
+     * @param color Fill colour.
+     * @param layer Layer to draw on.
+     */
+    void rect(const sf::FloatRect& area, const sf::Color& color, int layer = 0);
+
+    /**
+     * @brief Records the fill of a convex shape, such as an sf::RectangleShape or sf::ConvexShape, with its
+     * transform. Outlines and shape textures are not drawn.
+     * @param shape Shape to fill.
+     * @param layer Layer to draw on.
+     */
+    void shape(const sf::Shape& shape, int layer = 0);
+
+    /**
+     * @brief Records a sprite with its transform, texture rectangle and colour.
+     * @param sprite Sprite to draw; its texture must outlive the list.
+     * @param layer Layer to draw on.
+     */
+    void sprite(const sf::Sprite& sprite, int layer = 0);
+
+    /**
+     * @brief Records part of an image in memory as a quad, one pixel per texel before the transform.
+     * @param image Image to sample; it must outlive the list.
+     * @param rect Part of the image to draw, in texels.
+     * @param transform Places the quad.
+     * @param smooth True to filter between texels, as a smooth texture is.
+     * @param layer Layer to draw on.
+     */
+    void image(const sf::Image& image, const sf::IntRect& rect, const sf::Transform& transform, bool smooth,
+               int layer = 0);
+
+    /**
+     * @brief Records a text's glyphs as quads cut from its font's texture, or from the glyph cache's page in
+     * memory mode, laid out as sf::Text lays them out. Outlines, underlines and strike-throughs are not drawn.
+     * @param text Text to draw; its font must outlive the list.
+     * @param layer Layer to draw on.
+     */
+    void text(const sf::Text& text, int layer = 0);
+
+    /**
+     * @brief Sorts the commands and merges them into batches, if anything was recorded since the last build.
+     * @return Batches in drawing order, indexing into vertices().
+     */
+    const std::vector<Batch>& build();
+
+    /**
+     * @brief Gets the triangles of every batch.
+     * @return Vertices, valid after build().
+     */
+    const std::vector<sf::Vertex>& vertices() const;
+
+    /**
+     * @brief Builds the list if needed and draws every batch except those that sample images in memory.
+     * @param target Render target to draw on.
+     */
+    void draw(sf::RenderTarget& target);
+
+    /**
+     * @brief Gets the number of commands recorded.
+     * @return Commands since the last clear().
+     */
+    std::size_t commandCount() const;
+};
+
+#endif // DRAWLIST_H
@@ -0,0 +1,94 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file Effects.h
+ * @brief Header file for the event effect language: expressions in events.txt compiled to bytecode at load.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Each of an event's happiness, debt and GPA lines may be an expression instead of a number, and an optional
+ * line starting with "when" gives a condition; the event has no effect unless it holds. Expressions are integer
+ * arithmetic over the player's state before the event:
+ *
+ *     happiness, debt, gpa   the player's resources
+ *     path                   the player's path: western (0) or ivey (1)
+ *     space                  index of the space the player landed on
+ *
+ * with + - * / % (division by zero gives 0), comparisons < <= > >= == != (1 or 0), && || !, c ? a : b,
+ * parentheses and the functions min(a, b), max(a, b), abs(a) and clamp(x, lo, hi). For example:
+ *
+ *     -max(happiness - 20, 0) / 10
+ *     when path == ivey
+ */
+
+namespace effects {
+
+    /**
+     * @brief Instructions of the effect bytecode. Operands follow their instruction in the code.
+     */
+    enum Op : std::int32_t {
+        Halt,       ///< Stops the program.
+        Push,       ///< Pushes the operand.
+        Load,       ///< Pushes the input with the operand's index.
+        Add,        ///< Pops b and a, pushes a + b.
+        Sub,        ///< Pops b and a, pushes a - b.
+        Mul,        ///< Pops b and a, pushes a * b.
+        Div,        ///< Pops b and a, pushes a / b, or 0 if b is 0.
+        Mod,        ///< Pops b and a, pushes a % b, or 0 if b is 0.
+        Neg,        ///< Negates the top of the stack.
+        Not,        ///< Replaces the top of the stack with 1 if it is 0, otherwise 0.
+        Less,       ///< Pops b and a, pushes a < b.
+        LessEqual,  ///< Pops b and a, pushes a <= b.
+        Equal,      ///< Pops b and a, pushes a == b.
+        NotEqual,   ///< Pops b and a, pushes a != b.
+        And,        ///< Pops b and a, pushes a && b.
+        Or,         ///< Pops b and a, pushes a || b.
+        Min,        ///< Pops b and a, pushes the smaller.
+        Max,        ///< Pops b and a, pushes the larger.
+        Abs,        ///< Replaces the top of the stack with its absolute value.
+        Select,     ///< Pops b, a and c, pushes c ? a : b.
+        Store,      ///< Pops a value into the output with the operand's index.
+        ExitIfZero  ///< Pops a value and stops the program if it is 0.
+    };
+
+    /**
+     * @brief Inputs a program can read, in Load operand order.
+     */
+    enum Input : std::int32_t {
+        Happiness, ///< Player's happiness.
+        Debt,      ///< Player's debt.
+        Gpa,       ///< Player's GPA.
+        Path,      ///< Player's path index.
+        Space,     ///< Index of the space landed on.
+        inputCount ///< Number of inputs.
+    };
+
+    const int outputCount = 3; ///< Outputs: happiness, debt and GPA deltas.
+
+    /**
+     * @brief Compiles an event's effect into bytecode.
+     * @param expressions Happiness, debt and GPA expressions.
+     * @param condition Condition expression, or empty for none.
+     * @param code Receives the program; left empty if the effect is three constants and has no condition.
+     * @param constants Receives the three values if the effect is constant, otherwise zeros.
+     * @param error Receives a description of the first syntax error.
+     * @return False on a syntax error.
+     */
+    bool compile(const std::string expressions[outputCount], const std::string& condition,
+                 std::vector<std::int32_t>& code, std::int32_t constants[outputCount], std::string& error);
+
+    /**
+     * @brief Runs a compiled effect.
+     * @param code Program from compile().
+     * @param inputs inputCount input values.
+     * @param outputs Receives the three deltas; all 0 if the condition fails.
+     */
+    void run(const std::int32_t* code, const std::int32_t inputs[inputCount], std::int32_t outputs[outputCount]);
+
+} // namespace effects
+
+#endif // EFFECTS_H
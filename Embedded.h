@@ -0,0 +1,54 @@
+#ifndef EMBEDDED_H
+#define EMBEDDED_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @file Embedded.h
+ * @brief Header file for game assets compiled into the executable.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace embedded {
+
+    /**
+     * @brief One asset file stored as a constant byte array.
+     */
+    struct File {
+        const char* name;          ///< File name the asset would otherwise be loaded from.
+        const unsigned char* data; ///< Stored bytes, compressed if compressed is true.
+        std::size_t size;          ///< Number of stored bytes.
+        std::size_t rawSize;       ///< Size of the original file.
+        bool compressed;           ///< True if data must be passed through decompress() first.
+    };
+
+    /**
+     * @brief Looks up an embedded file.
+     * Only finds anything in builds made with WW_EMBED_ASSETS and the generated embeddedAssets.cpp.
+     * @param name File name of the asset.
+     * @return The embedded file, or nullptr if it is not embedded.
+     */
+    const File* find(const std::string& name);
+
+    /**
+     * @brief Compresses bytes with a small LZ77 coder that decodes quickly.
+     * @param input Bytes to compress.
+     * @return Compressed bytes.
+     */
+    std::vector<unsigned char> compress(const std::vector<unsigned char>& input);
+
+    /**
+     * @brief Reverses compress().
+     * @param data Compressed bytes.
+     * @param size Number of compressed bytes.
+     * @param rawSize Size of the original data.
+     * @param output Receives the original bytes.
+     * @return True if the data decoded to exactly rawSize bytes.
+     */
+    bool decompress(const unsigned char* data, std::size_t size, std::size_t rawSize, std::vector<unsigned char>& output);
+
+} // namespace embedded
+
+#endif // EMBEDDED_H
@@ -3,7 +3,9 @@
 
 #include <SFML/Graphics.hpp>
 #include <iostream>
+#include "DrawList.h"
 #include "Player.h"
+#include "Rules.h"
 
 /**
  * @file Events.h
@@ -18,8 +20,49 @@ namespace events {
      * @param window SFML RenderWindow to display the event popup.
      * @param message Message to be displayed in the popup window.
      * @param player Player object representing the game state.
+     * @return Index of the event drawn, or -1 if none could be drawn.
      */
-    void playerEvent(sf::RenderWindow& window, const std::string& message, Player& player);
+    int playerEvent(sf::RenderWindow& window, const std::string& message, Player& player);
+
+    /**
+     * @brief Builds the rules view of a player, for working out event effects and recording turns.
+     * @param player Player on the board.
+     * @return The player's path, space and resources.
+     */
+    rules::PlayerState playerState(const Player& player);
+
+    /**
+     * @brief Displays the popup for one event until the player closes it, without changing any resources.
+     * @param window SFML RenderWindow to display the event popup.
+     * @param selectedEvent Event to describe.
+     * @param effect Changes the event made, from rules::eventEffect.
+     */
+    void eventPopup(sf::RenderWindow& window, const rules::Event& selectedEvent, const rules::Effect& effect);
+
+    /**
+     * @brief Records the popup for one event into a draw list, laid out for a target of the given size, so it can
+     * be drawn without blocking, such as over one table of several.
+     * @param popup Draw list to record into.
+     * @param size Size of the target the popup is drawn on, in pixels.
+     * @param selectedEvent Event to describe.
+     * @param effect Changes the event made, from rules::eventEffect.
+     * @return Bounds of the close button on the target.
+     */
+    sf::FloatRect recordPopup(DrawList& popup, const sf::Vector2u& size, const rules::Event& selectedEvent,
+                              const rules::Effect& effect);
+
+    /**
+     * @brief Sets the board events are drawn on, which decides the region of each space. The standard board is
+     * used until this is called.
+     * @param board Board being played; must outlive every later event.
+     */
+    void useBoard(const rules::Board& board);
+
+    /**
+     * @brief Gets the event deck, parsed from events.txt the first time it is needed.
+     * @return The shared event deck.
+     */
+    const rules::EventDeck& deck();
 
 } // namespace events
 
@@ -2,7 +2,12 @@
 #define GAMEBOARD_H
 
 #include <SFML/Graphics.hpp>
+#include <cstddef>
 #include <vector>
+#include "SceneGraph.h"
+#include "DrawList.h"
+#include "Raster.h"
+#include "Rules.h"
 
 /**
  * @file GameBoard.h
@@ -12,10 +17,25 @@
 
 /**
  * @class GameBoard
- * @brief Represents the game board and its properties.
+ * @brief Represents the game board and its properties. Drawn as a static scene node.
+ *
+ * The standard board is drawn over the campus picture. Boards loaded from a layout file can be up to
+ * rules::maxBoardTiles tiles each way, so their tiles are baked into vertex buffers for square chunks of the board
+ * and only the chunks inside the current view are drawn.
  */
-class GameBoard {
+class GameBoard : public SceneNode {
 private:
+    /**
+     * @brief The coloured tiles in one square of chunkTiles by chunkTiles tiles.
+     */
+    struct Chunk {
+        sf::VertexBuffer buffer;   ///< Tile quads on the graphics card.
+        sf::VertexArray vertices;  ///< Tile quads, kept only when vertex buffers are unavailable.
+        std::size_t count;         ///< Number of vertices.
+    };
+
+    static const int chunkTiles = 32; ///< Width and height of a chunk in tiles.
+
     std::vector<sf::Vector2f> spaces; ///< Coordinates for each space on the board
     // Additional properties, like textures, tiles, etc., can be added here
 
@@ -29,11 +49,41 @@ private:
     std::vector<sf::Vector2f> westernPath;  ///< Coordinates for spaces on the Western path.
     std::vector<sf::Vector2f> eventSpaces;  ///< Coordinates for spaces where events can occur.
 
+    const rules::Board& layout;  ///< Board being drawn.
+    bool pictured;               ///< True for the standard board, drawn over the campus picture.
+    std::vector<Chunk> chunks;   ///< Chunks row by row, empty for the standard board.
+    int chunkColumns;            ///< Chunks across the board.
+    int chunkRows;               ///< Chunks down the board.
+    DrawList picture;            ///< Campus picture and coloured squares of the standard board, recorded once.
+
+    /**
+     * @brief Bakes the tiles of a loaded layout into chunks.
+     */
+    void buildChunks();
+
+    /**
+     * @brief Draws the chunks that overlap the target's view.
+     * @param target Render target to draw on.
+     */
+    void drawChunks(sf::RenderTarget& target);
+
+    /**
+     * @brief Records the campus picture and the coloured squares of the standard board.
+     */
+    void recordPicture();
+
 public:
     /**
      * @brief Constructor for the GameBoard class.
+     * @param board Board to draw; must outlive the GameBoard. Defaults to the standard board.
+     */
+    explicit GameBoard(const rules::Board& board = rules::Board::standard());
+
+    /**
+     * @brief Gets the board being drawn.
+     * @return The rules view of the board.
      */
-    GameBoard();
+    const rules::Board& getLayout() const;
 
     /**
      * @brief Get the coordinates of spaces on the Ivey path.
@@ -54,10 +104,32 @@ public:
     const std::vector<sf::Vector2f>& getEventSpaces() const;
 
     /**
-     * @brief Draw the game board on the specified SFML RenderWindow.
-     * @param window SFML RenderWindow on which to draw the game board.
+     * @brief Draw the game board on the specified render target. A loaded layout only draws what lies inside the
+     * target's current view.
+     * @param window SFML RenderWindow or RenderTexture on which to draw the game board.
+     */
+    void draw(sf::RenderTarget& window);
+
+    /**
+     * @brief Draw the game board into a software canvas. Only the standard board can be drawn this way, as the
+     * tiles of a loaded layout live in vertex buffers on the graphics card.
+     * @param canvas Canvas on which to draw the game board.
+     * @param transform Maps board pixels onto the canvas.
+     * @return False if the board is a loaded layout, which is not drawn.
+     */
+    bool draw(raster::Canvas& canvas, const sf::Transform& transform = sf::Transform::Identity);
+
+    /**
+     * @brief Get the area covered by the board.
+     * @return Bounding rectangle of all tiles, in board pixels.
+     */
+    sf::FloatRect getBounds() const override;
+
+    /**
+     * @brief Draw the board as part of the scene.
+     * @param target Render target to draw on.
      */
-    void draw(sf::RenderWindow& window);
+    void render(sf::RenderTarget& target) override;
 
     // bool isSpecialSpace(int index) const;
 };
@@ -0,0 +1,280 @@
+#ifndef GAMESTORE_H
+#define GAMESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file GameStore.h
+ * @brief Header file for the columnar store of simulated game results, built to hold hundreds of millions of games
+ * and answer group-by questions over them in seconds.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * A store file is a short header followed by blocks of up to blockRows games. Each block keeps every column in its
+ * own run of bytes, encoded to suit it: small values as single bytes, counts as varints, resources as zigzag
+ * varints, and game ids and event ids as zigzag varints of the difference from the previous value. A query only
+ * decodes the columns it needs. Blocks are only ever appended, each in one write, and each block header ends with a
+ * checksum of the block, so a block a crash cut short or left as zeros is dropped the next time the file is opened.
+ */
+
+namespace store {
+
+    const std::uint32_t blockRows = 65536; ///< Most games in a block.
+
+    /**
+     * @brief The columns of a store, in the order they are kept in each block.
+     */
+    enum Column {
+        Game,        ///< Game id, which seeds the game.
+        Path1,       ///< Player 1's path.
+        Path2,       ///< Player 2's path.
+        Winner,      ///< 0 or 1 for the winning player, or -1 for a tie.
+        Spins,       ///< Turns taken by both players together.
+        Happiness1,  ///< Player 1's final happiness.
+        Happiness2,  ///< Player 2's final happiness.
+        Debt1,       ///< Player 1's final debt.
+        Debt2,       ///< Player 2's final debt.
+        Gpa1,        ///< Player 1's final GPA.
+        Gpa2,        ///< Player 2's final GPA.
+        EventCount1, ///< Number of events player 1 landed on.
+        EventCount2, ///< Number of events player 2 landed on.
+        Events1,     ///< Event ids player 1 landed on, EventCount1 per game, in increasing order within a game.
+        Events2,     ///< Event ids player 2 landed on, EventCount2 per game, in increasing order within a game.
+        columnCount  ///< Number of columns.
+    };
+
+    /**
+     * @brief Gets a column's name as the tools print it.
+     * @param column Column.
+     * @return The name.
+     */
+    const char* columnName(Column column);
+
+    /**
+     * @brief The result of one game.
+     */
+    struct Row {
+        std::uint64_t game;                 ///< Game id.
+        int paths[2];                       ///< Each player's path.
+        int winner;                         ///< 0 or 1 for the winning player, or -1 for a tie.
+        int spins;                          ///< Turns taken by both players together.
+        int happiness[2];                   ///< Each player's final happiness.
+        int debt[2];                        ///< Each player's final debt.
+        int gpa[2];                         ///< Each player's final GPA.
+        std::vector<std::uint16_t> events[2]; ///< Event ids each player landed on, in any order.
+    };
+
+    /**
+     * @class BlockBuilder
+     * @brief Encodes games into a block, one column at a time.
+     */
+    class BlockBuilder {
+    private:
+        std::string columns[columnCount]; ///< Encoded bytes of each column so far.
+        std::int64_t last[columnCount];   ///< Previous value of each delta-encoded column.
+        std::uint32_t rows;               ///< Games added so far.
+        std::vector<std::uint16_t> sorted; ///< Scratch space for sorting a game's event ids.
+
+    public:
+        /**
+         * @brief Constructor for the BlockBuilder class. The block starts empty.
+         */
+        BlockBuilder();
+
+        /**
+         * @brief Adds a game to the block.
+         * @param row The game; there must be fewer than blockRows games in the block.
+         */
+        void add(const Row& row);
+
+        /**
+         * @brief Gets the number of games in the block.
+         * @return Games added since the last finish().
+         */
+        std::uint32_t size() const;
+
+        /**
+         * @brief Appends the finished block, header first, and starts a new empty one.
+         * @param out Buffer to append to.
+         */
+        void finish(std::string& out);
+    };
+
+    /**
+     * @class Writer
+     * @brief Appends blocks to a store file. Safe to share between threads; each block goes out in one write.
+     */
+    class Writer {
+    private:
+        int fd;             ///< Store file, or -1 when closed.
+        std::mutex writing; ///< Held while a block is written.
+
+    public:
+        /**
+         * @brief Constructor for the Writer class. The writer starts closed.
+         */
+        Writer();
+
+        /**
+         * @brief Destructor for the Writer class. Closes the file.
+         */
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * @brief Opens a store file for appending, creating it if needed and dropping any block a crash cut short
+         * or damaged.
+         * @param path File name.
+         * @return False, after reporting why on the console, if the file could not be opened or is not a store.
+         */
+        bool open(const std::string& path);
+
+        /**
+         * @brief Appends a block made by BlockBuilder::finish.
+         * @param block Encoded block.
+         * @return False if the write failed.
+         */
+        bool append(const std::string& block);
+
+        /**
+         * @brief Syncs the file to disk and closes it.
+         * @return False if the sync failed.
+         */
+        bool close();
+    };
+
+    /**
+     * @class Reader
+     * @brief Reads a store file through a memory map, so blocks are paged in as queries touch them.
+     */
+    class Reader {
+    private:
+        /**
+         * @brief Where a block's columns are in the file.
+         */
+        struct Block {
+            std::uint32_t rows;                  ///< Games in the block.
+            std::size_t offset[columnCount];     ///< Start of each column.
+            std::uint32_t bytes[columnCount];    ///< Length of each column.
+        };
+
+        int fd;                      ///< Store file, or -1 when closed.
+        const unsigned char* data;   ///< Mapped file.
+        std::size_t size;            ///< Length of the mapped file.
+        std::vector<Block> blocks;   ///< Every complete block.
+        std::uint64_t rows;          ///< Games in every complete block.
+
+    public:
+        /**
+         * @brief Constructor for the Reader class. The reader starts closed.
+         */
+        Reader();
+
+        /**
+         * @brief Destructor for the Reader class. Closes the file.
+         */
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @brief Maps a store file and finds its blocks, checking each one's checksum. A block cut short, left as
+         * zeros or damaged at the end of the file is ignored, with everything after it.
+         * @param path File name.
+         * @return False, after reporting why on the console, if the file could not be read or is not a store.
+         */
+        bool open(const std::string& path);
+
+        /**
+         * @brief Unmaps and closes the file.
+         */
+        void close();
+
+        /**
+         * @brief Gets the number of games in the store.
+         * @return Games in every complete block.
+         */
+        std::uint64_t rowCount() const;
+
+        /**
+         * @brief Gets the number of blocks in the store.
+         * @return Complete blocks.
+         */
+        std::size_t blockCount() const;
+
+        /**
+         * @brief Gets the number of games in a block.
+         * @param block Block index.
+         * @return Games in the block.
+         */
+        std::uint32_t blockRows(std::size_t block) const;
+
+        /**
+         * @brief Gets the space a column takes across the whole store.
+         * @param column Column.
+         * @return Encoded bytes.
+         */
+        std::uint64_t columnBytes(Column column) const;
+
+        /**
+         * @brief Decodes one column of a block. Safe to call from many threads at once.
+         * @param block Block index.
+         * @param column Column.
+         * @param values Receives one value per game, or for Events1 and Events2 every event id of the block in
+         * game order.
+         * @return False, after reporting it on the console, if the column is corrupt.
+         */
+        bool decode(std::size_t block, Column column, std::vector<std::int64_t>& values) const;
+    };
+
+    /**
+     * @brief What a query groups games by.
+     */
+    enum Key {
+        ByPair,   ///< Both players' paths; a group describes player 1's side of its games.
+        ByPath,   ///< A player's path; each game adds both of its players.
+        ByEvent,  ///< An event id; each game adds each player who landed on the event, once however often.
+        ByWinner  ///< The winner; a group describes player 1's side of its games.
+    };
+
+    /**
+     * @brief Totals for one group of players.
+     */
+    struct Aggregate {
+        std::uint64_t rows; ///< Players in the group.
+        std::uint64_t won;  ///< Players who won.
+        std::uint64_t lost; ///< Players who lost.
+        std::uint64_t tied; ///< Players who tied.
+        std::int64_t happiness; ///< Sum of final happiness.
+        std::int64_t debt;      ///< Sum of final debt.
+        std::int64_t gpa;       ///< Sum of final GPA.
+        std::int64_t spins;     ///< Sum of the turns taken in the players' games.
+    };
+
+    /**
+     * @brief Gets the number of groups a key can have.
+     * @param key Key.
+     * @return Size of the vector aggregate() fills.
+     */
+    std::size_t groupCount(Key key);
+
+    /**
+     * @brief Scans a store on several threads, each taking the next unscanned block, and totals every group.
+     * @param reader Open store.
+     * @param key What to group by.
+     * @param threads Number of threads to scan with.
+     * @param groups Receives groupCount(key) totals: by player 1's path times 2 plus player 2's for ByPair, by
+     * path for ByPath, by event id for ByEvent and by winner plus 1 for ByWinner. Groups nobody fell in are zero.
+     * @return False if a block is corrupt.
+     */
+    bool aggregate(const Reader& reader, Key key, int threads, std::vector<Aggregate>& groups);
+
+} // namespace store
+
+#endif // GAMESTORE_H
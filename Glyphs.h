@@ -0,0 +1,71 @@
+#ifndef GLYPHS_H
+#define GLYPHS_H
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+/**
+ * @file Glyphs.h
+ * @brief Header file for the glyph cache text is laid out and drawn with, which renders characters with FreeType
+ * into images in memory when the asset cache keeps everything in memory, so text needs no OpenGL context.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * sf::Font renders each glyph into a texture the first time it is asked for, and even its kerning asks for the
+ * glyphs, so laying out text with it needs a graphics card and a display. In memory mode the glyphs are rendered
+ * the way sf::Font renders them, with the same hinting, sizes and padding, but onto pages held as sf::Image and
+ * packed into rows as sf::Font packs its texture. Otherwise every call goes straight to the font. A page only ever
+ * grows, keeping every glyph where it was, and is drawn from directly, so a draw always sees every glyph on it.
+ * Everything but add() is for the render thread only, as sf::Font is.
+ */
+
+namespace glyphs {
+
+    /**
+     * @brief Hands a font's file to the cache so it can render the font's glyphs in memory. Called by the asset
+     * cache for every font it parses in memory mode. Safe to call from any thread.
+     * @param font The parsed font.
+     * @param data Contents of the font file; they are copied.
+     * @param size Number of bytes.
+     */
+    void add(const sf::Font& font, const unsigned char* data, std::size_t size);
+
+    /**
+     * @brief Gets a glyph, rendering it first if needed.
+     * @param font Font of the glyph.
+     * @param character Unicode code point.
+     * @param size Character size in pixels.
+     * @param bold True for the bold glyph.
+     * @return The glyph, with its place on the page for its size.
+     */
+    const sf::Glyph& glyph(const sf::Font& font, sf::Uint32 character, unsigned size, bool bold);
+
+    /**
+     * @brief Gets the kerning between two characters, as sf::Font::getKerning() does.
+     * @param font Font of the characters.
+     * @param first Character on the left.
+     * @param second Character on the right.
+     * @param size Character size in pixels.
+     * @param bold True for bold glyphs.
+     * @return Offset to add to the pen position, in pixels.
+     */
+    float kerning(const sf::Font& font, sf::Uint32 first, sf::Uint32 second, unsigned size, bool bold);
+
+    /**
+     * @brief Gets the page in memory that a size's glyphs are rendered on. Only meaningful in memory mode.
+     * @param font The font.
+     * @param size Character size in pixels.
+     * @return The page, valid for the lifetime of the program; it grows as glyphs are added.
+     */
+    const sf::Image& page(const sf::Font& font, unsigned size);
+
+    /**
+     * @brief Gets the local bounds of a text, as sf::Text::getLocalBounds() does, without asking the font's
+     * texture for glyphs in memory mode.
+     * @param text The text.
+     * @return Bounds of the glyphs before the text's transform.
+     */
+    sf::FloatRect bounds(const sf::Text& text);
+
+} // namespace glyphs
+
+#endif // GLYPHS_H
@@ -0,0 +1,133 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Rules.h"
+
+/**
+ * @file History.h
+ * @brief Header file for the game timeline, which keeps every turn of a game so it can be undone or rewound.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * The timeline is persistent: a turn only ever changes the player who spun, so each turn stores that player's
+ * new state, where the random stream got to and a link to the turn that last changed the other player, and
+ * shares everything else with the turns before it. Shuffled decks also share their bags between turns, copying
+ * them only on turns that dealt an event. Any turn can be brought back in constant time from at most two
+ * records, whatever the length of the game.
+ */
+
+namespace history {
+
+    /**
+     * @class Timeline
+     * @brief Every turn of one game, from the state before the first spin.
+     */
+    class Timeline {
+    private:
+        /**
+         * @brief One turn: the state of the player who spun, as it was after the turn.
+         */
+        struct Version {
+            std::int32_t happiness; ///< Mover's happiness.
+            std::int32_t debt;      ///< Mover's debt.
+            std::int32_t gpa;       ///< Mover's GPA.
+            std::uint32_t counter;  ///< Random stream position after the turn.
+            std::uint32_t other;    ///< Version that last changed the other player.
+            std::uint32_t bags;     ///< Bag set in force after the turn.
+            std::uint32_t place;    ///< Mover's space in the low 28 bits; the mover, their path and chosen flag, and
+                                    ///< whose turn is next in the top 4.
+        };
+
+        /**
+         * @brief The bags of every region, copied only when one changes.
+         */
+        struct BagSet {
+            rules::Bag bags[rules::regionCount]; ///< Each region's bag.
+        };
+
+        std::vector<Version> versions; ///< Two roots, one per player, then one version per turn.
+        std::vector<BagSet> bagSets;   ///< Bag sets referred to by the versions.
+        std::uint32_t seed;            ///< Seed of the game's random stream.
+        std::size_t current;           ///< Turn the game is on.
+
+        /**
+         * @brief Packs one player's state into a version.
+         * @param state Game state.
+         * @param player Player whose state is kept.
+         * @param counter Random stream position.
+         * @param other Version holding the other player.
+         * @param bags Bag set in force.
+         * @return The version.
+         */
+        static Version pack(const rules::GameState& state, int player, std::uint32_t counter, std::uint32_t other,
+                            std::uint32_t bags);
+
+        /**
+         * @brief Unpacks a version's player into a game state.
+         * @param version The version.
+         * @param state Game state whose player is overwritten.
+         */
+        static void unpack(const Version& version, rules::GameState& state);
+
+    public:
+        /**
+         * @brief Constructor for the Timeline class. The timeline starts empty.
+         */
+        Timeline();
+
+        /**
+         * @brief Starts the timeline from the state before the first spin, forgetting any earlier game.
+         * @param state Game state, with both paths chosen.
+         * @param rng Random stream the game is played with.
+         */
+        void start(const rules::GameState& state, const rules::Rng& rng);
+
+        /**
+         * @brief Checks if the timeline was started.
+         * @return True once start() was called.
+         */
+        bool started() const;
+
+        /**
+         * @brief Records a turn just played from the current turn. Turns after the current one, left by a
+         * rewind, are dropped, so the game goes on from where it was rewound to.
+         * @param state Game state after the turn.
+         * @param rng Random stream after the turn.
+         * @param mover Player who spun.
+         */
+        void record(const rules::GameState& state, const rules::Rng& rng, int mover);
+
+        /**
+         * @brief Gets the number of turns recorded.
+         * @return Turns since start(), including any ahead of the current turn.
+         */
+        std::size_t turns() const;
+
+        /**
+         * @brief Gets the turn the game is on.
+         * @return Turns played before the current state, 0 before the first spin.
+         */
+        std::size_t position() const;
+
+        /**
+         * @brief Brings back the game as it was after a turn, in constant time. Later turns are kept until the
+         * next record(), so a rewind can be undone.
+         * @param turn Turn to go to, from 0 (before the first spin) to turns().
+         * @param state Receives the game state.
+         * @param rng Receives the random stream.
+         * @return False if the turn is out of range or the timeline was not started.
+         */
+        bool restore(std::size_t turn, rules::GameState& state, rules::Rng& rng);
+
+        /**
+         * @brief Gets the memory the timeline holds.
+         * @return Bytes used by its records.
+         */
+        std::size_t bytes() const;
+    };
+
+} // namespace history
+
+#endif // HISTORY_H
@@ -0,0 +1,96 @@
+#ifndef IMPACT_H
+#define IMPACT_H
+
+#include <cstdint>
+#include <vector>
+#include "Rules.h"
+
+/**
+ * @file Impact.h
+ * @brief Header file for the event impact analyser, which measures how much each event in the deck changes the
+ * chance of winning on each path by replaying seeded games with the event taken out.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Every variant plays the same seeded games as the unchanged deck (common random numbers), so the difference in
+ * wins is measured game by game and most of the noise of two separate samples cancels out. Spins and event draws
+ * never depend on a player's resources, so a game lands on the same spaces and draws the same events whatever
+ * the events do; only the resources differ. Each game is therefore played once with the rules, and then for each
+ * event it drew, only the resources of the players who drew that event are replayed. Games that never drew an
+ * event are unchanged by taking it out and cost nothing, so the work grows with the number of draws, not with the
+ * number of events times the number of games.
+ */
+
+namespace impact {
+
+    /**
+     * @brief How an event is taken out.
+     */
+    enum Variant {
+        Neutralise, ///< The event is still drawn but does nothing.
+        Remove      ///< The event is not in the deck; a draw of it is replaced by a draw from the rest of its region.
+    };
+
+    /**
+     * @brief Paired win differences for one event, summed over every game. For a game, the difference on a path
+     * is the wins of the players on that path with the event taken out minus their wins with the full deck.
+     */
+    struct EventImpact {
+        std::uint64_t games;                    ///< Games in which the event was drawn.
+        std::int64_t change[rules::pathCount];  ///< Sum of the game differences on each path.
+        std::int64_t squares[rules::pathCount]; ///< Sum of the squared game differences on each path.
+    };
+
+    /**
+     * @brief Result of an analysis. All counts are whole numbers, so the result does not depend on the number of
+     * threads.
+     */
+    struct Report {
+        std::uint64_t games;                  ///< Games played.
+        std::uint64_t seats[rules::pathCount]; ///< Players who played each path, over all games.
+        std::uint64_t wins[rules::pathCount];  ///< Of those, the ones who won with the full deck.
+        std::uint64_t mismatched;             ///< Games whose replay with the full deck did not match the rules.
+        std::vector<EventImpact> events;      ///< Impact of each event, in deck order.
+
+        /**
+         * @brief Gets the chance of winning on a path with the full deck.
+         * @param path Path index.
+         * @return Wins per player on the path.
+         */
+        double baseline(int path) const;
+
+        /**
+         * @brief Gets how much taking an event out changes the chance of winning on a path.
+         * @param event Deck index.
+         * @param path Path index.
+         * @return Change in wins per player on the path.
+         */
+        double change(int event, int path) const;
+
+        /**
+         * @brief Gets the half-width of the confidence interval of change(), from the spread of the paired game
+         * differences.
+         * @param event Deck index.
+         * @param path Path index.
+         * @param z Standard normal quantile of the confidence level, 1.96 for 95%.
+         * @return Half-width of the interval.
+         */
+        double margin(int event, int path, double z = 1.96) const;
+    };
+
+    /**
+     * @brief Plays games for every pair of paths and measures the impact of each event, splitting the games
+     * between threads.
+     * @param board Board to play on.
+     * @param deck Event deck; Remove needs a deck that is not shuffled.
+     * @param variant How each event is taken out.
+     * @param games Games per pair of paths.
+     * @param seed Seed the games' streams are derived from; the same seed plays the same games.
+     * @param threads Threads to play on, or 0 for one per core.
+     * @return The impact of every event.
+     */
+    Report analyse(const rules::Board& board, const rules::EventDeck& deck, Variant variant, std::uint64_t games,
+                   std::uint32_t seed, unsigned threads = 0);
+
+} // namespace impact
+
+#endif // IMPACT_H
@@ -0,0 +1,145 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "Channels.h"
+#include "Rules.h"
+
+/**
+ * @file Journal.h
+ * @brief Header file for the autosave journal, a write-ahead log of every change to a local game that lets the
+ * game carry on after a crash or power cut.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Each path choice, spin (with its move and the event it applied), rewind and graduation is appended as a
+ * fixed-size entry holding the whole game state after it, so replaying the journal never runs the rules again.
+ * The simulation thread only pushes entries into a lock-free queue; a writer thread appends them in batches and
+ * syncs the file once per batch, so every entry is on disk within a few milliseconds without an fsync per entry.
+ * Every so often the writer folds the journal into a snapshot file, replaced atomically, and starts the journal
+ * afresh, so recovery reads one snapshot and a short journal.
+ */
+
+namespace journal {
+
+    /**
+     * @brief What an entry records.
+     */
+    enum Kind : std::uint8_t {
+        Started, ///< A new game began; the journal and snapshot of any earlier game are dropped.
+        Chose,   ///< A player chose a path.
+        Spun,    ///< A player spun, moved and had any event applied.
+        Rewound, ///< The game was taken back or forward to another turn.
+        Ended    ///< Both players graduated; there is nothing left to resume.
+    };
+
+    /**
+     * @brief One change to the game and the state it left. Trivially copyable, so a push is a plain copy.
+     */
+    struct Entry {
+        std::uint32_t sequence; ///< Entries since the game started; 0 for Started.
+        std::uint8_t kind;      ///< A Kind.
+        std::int8_t player;     ///< Player who chose or spun, or -1.
+        std::int8_t value;      ///< Path chosen, wheel result or turns rewound.
+        std::int32_t event;     ///< Event applied by a spin, or -1; decks hold up to rules::maxEvents.
+        std::uint32_t seed;     ///< Seed of the spin and event stream.
+        std::uint32_t counter;  ///< Random stream position after the change.
+        std::uint32_t layout;   ///< fingerprint() of the journal format, board and deck the game is played with.
+        rules::GameState state; ///< Game state after the change.
+        std::uint32_t check;    ///< Checksum of the bytes above, filled in by the writer.
+    };
+
+    /**
+     * @brief Hashes the journal's format version and everything about a board and deck that the saved states
+     * depend on: the paths, the event spaces and every event's text, effect, weight and regions. Every entry
+     * carries it, so a game is never resumed from an older journal or on a board or deck that has changed since
+     * it was saved.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @return The fingerprint.
+     */
+    std::uint32_t fingerprint(const rules::Board& board, const rules::EventDeck& deck);
+
+    /**
+     * @brief Finds the latest state of an unfinished game from the snapshot and the journal after it. A torn or
+     * corrupt entry at the end, left by a crash mid-write, ends the replay at the entry before it.
+     * @param path Journal file; the snapshot sits beside it with ".snap" added.
+     * @param board Board the game would be resumed on.
+     * @param deck Event deck it would be resumed with.
+     * @param entry Receives the latest intact entry.
+     * @return True if there is a game to resume, false if there is no journal, its game ended, or it was saved
+     * with another board or deck or holds spaces the board does not have, which is reported on the console.
+     */
+    bool recover(const std::string& path, const rules::Board& board, const rules::EventDeck& deck, Entry& entry);
+
+    /**
+     * @class Writer
+     * @brief Journal file fed through a lock-free queue and written by a background thread.
+     */
+    class Writer {
+    private:
+        SpscQueue<Entry> queue;             ///< Entries waiting for the writer.
+        std::string path;                   ///< Journal file name.
+        int fd;                             ///< Journal file, or -1 when closed.
+        std::thread writer;                 ///< Thread appending entries.
+        std::atomic<bool> stopping;         ///< Set to make the writer drain and stop.
+        std::atomic<std::uint64_t> dropped; ///< Entries lost because the queue was full.
+
+        /**
+         * @brief Runs the writer thread until the journal is closed.
+         */
+        void run();
+
+        /**
+         * @brief Replaces the snapshot with an entry and empties the journal.
+         * @param latest The newest entry written.
+         * @return False if the snapshot could not be written, in which case the journal is kept.
+         */
+        bool compact(const Entry& latest);
+
+    public:
+        /**
+         * @brief Constructor for the Writer class. The journal starts closed, and entries are ignored until it is
+         * opened.
+         */
+        Writer();
+
+        /**
+         * @brief Destructor for the Writer class. Closes the journal.
+         */
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * @brief Opens the journal for appending, keeping what is in it, and starts the writer.
+         * @param file Journal file name.
+         * @return False if the file could not be opened.
+         */
+        bool open(const std::string& file);
+
+        /**
+         * @brief Queues an entry without blocking. Does nothing while the journal is closed. Called by one thread
+         * only.
+         * @param entry Entry to queue.
+         */
+        void append(const Entry& entry);
+
+        /**
+         * @brief Writes out everything queued, syncs the file and stops the writer.
+         */
+        void close();
+
+        /**
+         * @brief Checks if the journal is open.
+         * @return True if entries are being written.
+         */
+        bool isOpen() const;
+    };
+
+} // namespace journal
+
+#endif // JOURNAL_H
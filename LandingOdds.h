@@ -0,0 +1,100 @@
+#ifndef LANDINGODDS_H
+#define LANDINGODDS_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "SceneGraph.h"
+
+/**
+ * @file LandingOdds.h
+ * @brief Header file for the board overlay that shades upcoming spaces by the chance of landing on them.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @class LandingOdds
+ * @brief Shades each space ahead of a player by the chance of landing on it within the next few spins, with
+ * event spaces in a different colour. Drawn as one vertex array above the board.
+ *
+ * The odds are recomputed only when the tracked player's path or space changes; otherwise the node stays clean
+ * and the scene does not redraw it.
+ */
+class LandingOdds : public SceneNode {
+private:
+    std::vector<double> spin;                 ///< Chance of spinning each number, indexed by number.
+    std::vector<sf::Vector2f> eventSpaces;    ///< Spaces that trigger events.
+    std::vector<sf::Vector2f> path;           ///< Path of the tracked player.
+    int index;                                ///< Space the tracked player is on or moving to, or -1.
+    int spins;                                ///< Number of spins ahead to look.
+    std::vector<std::vector<double>> position; ///< position[s][i]: chance of being on space i after s spins.
+    std::vector<double> landing;              ///< Chance of landing on each space within the next spins.
+    sf::VertexArray shading;                  ///< One quad per shaded space.
+    sf::FloatRect bounds;                     ///< Area covered by the shading.
+    bool visible;                             ///< True if the overlay is shown.
+
+    /**
+     * @brief Extends the position distributions by convolving the last one with the spin distribution.
+     * @param upTo Number of spins to extend to.
+     */
+    void convolve(int upTo);
+
+    /**
+     * @brief Rebuilds the landing chances and the vertex array from the position distributions.
+     */
+    void rebuild();
+
+public:
+    /**
+     * @brief Constructor for the LandingOdds class.
+     * @param wheelNumbers Numbers on the wheel, as returned by Wheel::GetNumbers.
+     * @param eventSpaces Positions of the event spaces.
+     * @param spins Number of spins ahead to look.
+     */
+    LandingOdds(const std::vector<int>& wheelNumbers, const std::vector<sf::Vector2f>& eventSpaces, int spins = 3);
+
+    /**
+     * @brief Follows a player. Does nothing unless the path or space differs from last time.
+     * @param playerPath Path the player follows.
+     * @param spaceIndex Space the player is on or moving to.
+     */
+    void track(const std::vector<sf::Vector2f>& playerPath, int spaceIndex);
+
+    /**
+     * @brief Changes how many spins ahead to look.
+     * @param count Number of spins, at least 1.
+     */
+    void setSpins(int count);
+
+    /**
+     * @brief Shows or hides the overlay.
+     * @param show True to show the overlay.
+     */
+    void setVisible(bool show);
+
+    /**
+     * @brief Checks if the overlay is shown.
+     * @return True if the overlay is shown.
+     */
+    bool isVisible() const;
+
+    /**
+     * @brief Gets the chance of landing on a space of the tracked path within the next spins.
+     * @param space Index of the space.
+     * @return Probability from 0 to 1.
+     */
+    double chance(int space) const;
+
+    /**
+     * @brief Gets the area covered by the shading.
+     * @return Bounding rectangle, empty while hidden.
+     */
+    sf::FloatRect getBounds() const override;
+
+    /**
+     * @brief Draws the shading as part of the scene.
+     * @param target Render target to draw on.
+     */
+    void render(sf::RenderTarget& target) override;
+};
+
+#endif // LANDINGODDS_H
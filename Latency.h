@@ -0,0 +1,82 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <SFML/Graphics.hpp>
+#include <ostream>
+#include <string>
+
+/**
+ * @file Latency.h
+ * @brief Header file for the input-to-photon latency mode, which times each input from the moment it is polled to
+ * the return of the display() call for the first frame that shows its result.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Every window loop polls through latency::pollEvent and presents through latency::display. Code that handles an
+ * input calls pressed(); code that is about to draw its result calls reflect(), which tags the next displayed
+ * frame. Everything is a no-op until enable() is called, and all of it runs on the window thread.
+ */
+
+namespace latency {
+
+    /**
+     * @brief Kinds of input that are timed separately.
+     */
+    enum Input {
+        Spin,         ///< Space released until the wheel starts turning.
+        MajorPick,    ///< I or W pressed on the path choice until the popup is gone.
+        ResourceView, ///< A or B pressed until the resources are on screen.
+        PopupClose,   ///< A popup's close button or key until the popup is gone.
+        inputCount    ///< Number of kinds.
+    };
+
+    /**
+     * @brief Turns the latency mode on.
+     * @param script File of scripted input to play back, or empty for a person at the keyboard. Each line holds
+     * the milliseconds since enable() and an event: "press <key>", "release <key>", "click <x> <y>" or "quit",
+     * where keys are letters or Space; # starts a comment.
+     * @return False if the script could not be read.
+     */
+    bool enable(const std::string& script = std::string());
+
+    /**
+     * @brief Checks if the latency mode is on.
+     * @return True once enable() has succeeded.
+     */
+    bool enabled();
+
+    /**
+     * @brief Polls the window, handing out any scripted event that is due before the real ones.
+     * @param window Window to poll.
+     * @param event Receives the event.
+     * @return True if an event was returned.
+     */
+    bool pollEvent(sf::RenderWindow& window, sf::Event& event);
+
+    /**
+     * @brief Notes that an input was just polled, replacing any earlier one of its kind still waiting to be shown.
+     * @param input Kind of input.
+     */
+    void pressed(Input input);
+
+    /**
+     * @brief Tags the next displayed frame as the first to show the result of the waiting input of this kind.
+     * Does nothing if none is waiting, as when the bot spins.
+     * @param input Kind of input.
+     */
+    void reflect(Input input);
+
+    /**
+     * @brief Shows the frame and records the latency of every input it was tagged with.
+     * @param window Window to display.
+     */
+    void display(sf::RenderWindow& window);
+
+    /**
+     * @brief Writes a histogram and percentiles for each kind of input.
+     * @param out Stream to write to.
+     */
+    void report(std::ostream& out);
+
+} // namespace latency
+
+#endif // LATENCY_H
@@ -0,0 +1,123 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @file Metrics.h
+ * @brief Header file for the live metrics endpoint, which serves the game's counters and histograms in the
+ * Prometheus text format on a local socket.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Game code counts what it does by calling the functions below, each of which is a check of one flag and a few
+ * relaxed atomic adds, with no locks or allocation. An exporter thread started by serve() answers each scrape
+ * by reading the atomics and writing them out, so a scraper polling the endpoint never touches the window or
+ * simulation threads. Until serve() is called, every function returns at once.
+ */
+
+namespace metrics {
+
+    const char* const defaultAddress = "127.0.0.1:9464"; ///< Address served when none is given.
+
+    /**
+     * @brief Kinds of popup whose time on screen is measured.
+     */
+    enum Popup {
+        EventPopup,      ///< An event's card.
+        ResourcePopup,   ///< A player's resources.
+        MajorPopup,      ///< The path choice.
+        GraduationPopup, ///< The graduation results.
+        StartPopup,      ///< The start screen.
+        popupCount       ///< Number of kinds.
+    };
+
+    /**
+     * @brief Starts counting and starts the exporter thread.
+     * @param eventCount Events in the loaded deck, each of which gets a counter of its own.
+     * @param address Address to listen on, "host:port" or "unix:/path/to/socket".
+     * @return False if the address could not be listened on.
+     */
+    bool serve(std::size_t eventCount, const std::string& address = defaultAddress);
+
+    /**
+     * @brief Stops the exporter thread and closes its socket. Counting goes on until the program ends.
+     */
+    void stop();
+
+    /**
+     * @brief Checks if metrics are being counted.
+     * @return True once serve() has succeeded.
+     */
+    bool enabled();
+
+    /**
+     * @brief Counts a frame put on screen, timing it from the frame before. Called from the window thread only.
+     */
+    void frameShown();
+
+    /**
+     * @brief Counts a spin of the wheel.
+     */
+    void spun();
+
+    /**
+     * @brief Counts an event shown to a player. An index outside the deck given to serve() is counted as
+     * uncounted, so a mismatched deck shows up rather than vanishing.
+     * @param id Index of the event in the deck.
+     */
+    void eventShown(int id);
+
+    /**
+     * @brief Counts a lookup in the asset cache.
+     * @param hit True if the asset was already resident.
+     */
+    void assetLookup(bool hit);
+
+    /**
+     * @brief Counts a game played to graduation.
+     */
+    void gameCompleted();
+
+    /**
+     * @brief Records how long a popup was on screen.
+     * @param kind Kind of popup.
+     * @param seconds Time from opening to closing.
+     */
+    void popupClosed(Popup kind, double seconds);
+
+    /**
+     * @brief Writes every metric in the Prometheus text format, as the exporter serves it.
+     * @return The metrics.
+     */
+    std::string scrape();
+
+    /**
+     * @class PopupTimer
+     * @brief Times a popup from its construction to its destruction, so a popup function only needs one at its top.
+     */
+    class PopupTimer {
+    private:
+        Popup kind;                                   ///< Kind of popup.
+        std::chrono::steady_clock::time_point opened; ///< Time the popup opened.
+
+    public:
+        /**
+         * @brief Constructor for the PopupTimer class. Starts the timer.
+         * @param kind Kind of popup.
+         */
+        explicit PopupTimer(Popup kind);
+
+        /**
+         * @brief Records the popup's time on screen.
+         */
+        ~PopupTimer();
+
+        PopupTimer(const PopupTimer&) = delete;
+        PopupTimer& operator=(const PopupTimer&) = delete;
+    };
+
+} // namespace metrics
+
+#endif // METRICS_H
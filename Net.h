@@ -0,0 +1,122 @@
+#ifndef NET_H
+#define NET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Protocol.h"
+
+/**
+ * @file Net.h
+ * @brief Header file for the socket helpers used by the game server and its clients.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Addresses are written as "unix:/path/to/socket" for a Unix-domain socket or "host:port" for TCP,
+ * for example "127.0.0.1:5555".
+ */
+
+namespace net {
+
+    const char* const defaultAddress = "unix:/tmp/westernwonderland.sock"; ///< Address used when none is given.
+
+    /**
+     * @brief Opens a non-blocking listening socket.
+     * @param address Address to listen on.
+     * @return Socket descriptor, or -1 on error.
+     */
+    int listenOn(const std::string& address);
+
+    /**
+     * @brief Connects to a server and makes the socket non-blocking.
+     * @param address Address of the server.
+     * @return Socket descriptor, or -1 on error.
+     */
+    int connectTo(const std::string& address);
+
+    /**
+     * @brief Accepts a pending connection and makes it non-blocking.
+     * @param listener Listening socket.
+     * @return Socket descriptor, or -1 if nothing was pending.
+     */
+    int acceptFrom(int listener);
+
+    /**
+     * @brief Makes a socket non-blocking.
+     * @param fd Socket descriptor.
+     * @return True on success.
+     */
+    bool setNonBlocking(int fd);
+
+    /**
+     * @brief Raises the limit on open descriptors as far as the system allows, for processes holding many sockets.
+     * @return The new limit.
+     */
+    long raiseFileLimit();
+
+    /**
+     * @class Connection
+     * @brief A non-blocking socket with buffered framed messages in both directions.
+     */
+    class Connection {
+    private:
+        int socket;                        ///< Socket descriptor, closed by the destructor.
+        std::vector<std::uint8_t> inbox;   ///< Bytes received but not yet unframed.
+        std::vector<std::uint8_t> outbox;  ///< Framed bytes not yet written.
+
+    public:
+        /**
+         * @brief Constructor for the Connection class.
+         * @param fd Connected non-blocking socket; the connection takes ownership.
+         */
+        explicit Connection(int fd);
+
+        /**
+         * @brief Closes the socket.
+         */
+        ~Connection();
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        /**
+         * @brief Gets the socket descriptor, for polling.
+         * @return Socket descriptor.
+         */
+        int fd() const;
+
+        /**
+         * @brief Queues a message; nothing is written until flush().
+         * @param type Message type.
+         * @param payload Message body.
+         */
+        void send(std::uint8_t type, const std::vector<std::uint8_t>& payload);
+
+        /**
+         * @brief Writes as much of the queued output as the socket accepts.
+         * @return False if the connection failed.
+         */
+        bool flush();
+
+        /**
+         * @brief Checks if queued output is waiting for the socket to become writable.
+         * @return True if there is unsent output.
+         */
+        bool wantsWrite() const;
+
+        /**
+         * @brief Reads whatever has arrived.
+         * @return False if the peer closed the connection or it failed.
+         */
+        bool receive();
+
+        /**
+         * @brief Takes the next complete message that has arrived.
+         * @param message Receives the message.
+         * @return False if no complete message is waiting.
+         */
+        bool next(protocol::Message& message);
+    };
+
+} // namespace net
+
+#endif // NET_H
@@ -0,0 +1,27 @@
+#ifndef NETWORKGAME_H
+#define NETWORKGAME_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+
+/**
+ * @file NetworkGame.h
+ * @brief Header file for playing on a game server instead of locally.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace networkGame {
+
+    /**
+     * @brief Joins a game server and plays or watches until the window is closed.
+     * The server decides every spin and event; the window only animates what it reports.
+     * @param window SFML RenderWindow for the game.
+     * @param address Address of the server, as accepted by net::connectTo.
+     * @param seat Seat to ask for: 1 or 2 to play, 0 to watch.
+     * @return Exit status of the program.
+     */
+    int play(sf::RenderWindow& window, const std::string& address, int seat);
+
+} // namespace networkGame
+
+#endif // NETWORKGAME_H
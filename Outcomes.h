@@ -0,0 +1,98 @@
+#ifndef OUTCOMES_H
+#define OUTCOMES_H
+
+#include <map>
+#include <vector>
+#include "Rules.h"
+
+/**
+ * @file Outcomes.h
+ * @brief Header file for the exact outcome engine, which computes final resource and graduation probabilities
+ * by dynamic programming instead of sampling.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Each player's spins and event draws are independent of the other player's, so a player's final resources
+ * depend only on their own path. The engine finds how many event spaces a player lands on with a DP over path
+ * index, convolves the event deck's effects that many times, and compares the two players' distributions to
+ * get the graduation result.
+ */
+
+namespace outcomes {
+
+    /**
+     * @brief A player's resource totals.
+     */
+    struct Resources {
+        int happiness; ///< Happiness total.
+        int debt;      ///< Debt total.
+        int gpa;       ///< GPA total.
+
+        /**
+         * @brief Orders resource totals so they can key a map.
+         * @param other Totals to compare with.
+         * @return True if these totals sort first.
+         */
+        bool operator<(const Resources& other) const {
+            if (happiness != other.happiness) {
+                return happiness < other.happiness;
+            }
+            if (debt != other.debt) {
+                return debt < other.debt;
+            }
+            return gpa < other.gpa;
+        }
+    };
+
+    /**
+     * @brief Exact distribution of where one player finishes.
+     */
+    struct PlayerOutcome {
+        std::vector<double> eventsLanded;             ///< Probability of landing on exactly k event spaces.
+        std::map<Resources, double> finals;           ///< Probability of each combination of final totals.
+        std::map<int, double> happiness;              ///< Distribution of final happiness.
+        std::map<int, double> debt;                   ///< Distribution of final debt.
+        std::map<int, double> gpa;                    ///< Distribution of final GPA.
+        double meanHappiness;                         ///< Expected final happiness.
+        double meanDebt;                              ///< Expected final debt.
+        double meanGpa;                               ///< Expected final GPA.
+        double meanSpins;                             ///< Expected number of spins to graduate.
+    };
+
+    /**
+     * @brief Exact graduation result for a pair of players.
+     */
+    struct GameOutcome {
+        double win[rules::playerCount]; ///< Probability that each player wins.
+        double tie;                     ///< Probability of a tie.
+        double scores[4][4];            ///< Probability of each pair of scores, indexed [player 1][player 2].
+    };
+
+    /**
+     * @brief Computes the distribution of one player's final resources.
+     * @param board Board being played.
+     * @param deck Event deck; each event is equally likely to be drawn.
+     * @param from Player's current state; its path, index and resources are the starting point.
+     * @return Exact distribution of the player's finish.
+     */
+    PlayerOutcome playerOutcome(const rules::Board& board, const rules::EventDeck& deck, const rules::PlayerState& from);
+
+    /**
+     * @brief Computes the distribution of one player's final resources from the start of a path.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @param path Path index.
+     * @return Exact distribution of the player's finish.
+     */
+    PlayerOutcome pathOutcome(const rules::Board& board, const rules::EventDeck& deck, int path);
+
+    /**
+     * @brief Computes the graduation result from both players' distributions, as rules::scores counts it.
+     * @param player1 Player 1's distribution.
+     * @param player2 Player 2's distribution.
+     * @return Exact graduation result.
+     */
+    GameOutcome gameOutcome(const PlayerOutcome& player1, const PlayerOutcome& player2);
+
+} // namespace outcomes
+
+#endif // OUTCOMES_H
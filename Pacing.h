@@ -0,0 +1,96 @@
+#ifndef PACING_H
+#define PACING_H
+
+#include <chrono>
+
+/**
+ * @file Pacing.h
+ * @brief Header file for the game clock, which every wait in the game's pacing goes through so a game can be
+ * played faster than real time, up to as fast as the machine allows, with the visuals still on.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Game time runs at a fixed multiple of real time. Markers stepping from space to space, the simulation's ticks,
+ * the wheel's spin animation and the graduation screen all measure and wait in game time, so at 4x a game plays
+ * four times faster and looks the same. At the fastest speed a wait does not sleep at all: it moves game time on
+ * to the moment being waited for. Frames are drawn at whatever rate the window manages; anything that happened
+ * between two frames, such as spin frames or marker steps, is simply not drawn.
+ */
+
+namespace pacing {
+
+    typedef std::chrono::steady_clock::time_point TimePoint; ///< A moment in game time.
+
+    const double fastest = 0.0; ///< Speed that plays as fast as possible, skipping every wait.
+
+    /**
+     * @brief Sets how fast game time runs. Called before anything reads the game clock.
+     * @param speed Multiple of real time, such as 1 for real time or 8 for eight times as fast, or fastest.
+     */
+    void setSpeed(double speed);
+
+    /**
+     * @brief Gets how fast game time runs.
+     * @return Multiple of real time, or fastest.
+     */
+    double speed();
+
+    /**
+     * @brief Gets the current game time. Safe to call from any thread.
+     * @return Game time; equal to the steady clock at real-time speed.
+     */
+    TimePoint now();
+
+    /**
+     * @brief Waits until a moment in game time. At the fastest speed, moves game time on to it instead.
+     * @param until Moment to wait for.
+     */
+    void sleepUntil(TimePoint until);
+
+    /**
+     * @brief Waits for a length of game time.
+     * @param length Game time to wait.
+     */
+    void sleepFor(std::chrono::steady_clock::duration length);
+
+    /**
+     * @class Clock
+     * @brief Measures game time elapsed, like sf::Clock does real time.
+     */
+    class Clock {
+    private:
+        TimePoint start; ///< Game time of the last restart.
+
+    public:
+        /**
+         * @brief Constructor for the Clock class. The clock starts at once.
+         */
+        Clock();
+
+        /**
+         * @brief Starts measuring again from now.
+         * @return Game time elapsed before the restart.
+         */
+        std::chrono::steady_clock::duration restart();
+
+        /**
+         * @brief Gets the game time elapsed since the clock started.
+         * @return Elapsed game time.
+         */
+        std::chrono::steady_clock::duration elapsed() const;
+
+        /**
+         * @brief Gets the game time elapsed since the clock started, in seconds.
+         * @return Elapsed game time in seconds.
+         */
+        float seconds() const;
+
+        /**
+         * @brief Gets the game time elapsed since the clock started, in milliseconds.
+         * @return Elapsed game time in milliseconds.
+         */
+        int milliseconds() const;
+    };
+
+} // namespace pacing
+
+#endif // PACING_H
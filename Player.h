@@ -4,6 +4,8 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <string>
+#include "SceneGraph.h"
+#include "Pacing.h"
 
 /**
  * @file Player.h
@@ -13,9 +15,9 @@
 
 /**
  * @class Player
- * @brief Represents the player character in the game.
+ * @brief Represents the player character in the game. Its marker is a dynamic scene node.
  */
-class Player {
+class Player : public SceneNode {
 private:
     sf::CircleShape marker; ///< Shape representing the player's position on the game board.
     bool isMoving;          ///< Flag indicating whether the player is currently in motion.
@@ -28,8 +30,8 @@ private:
 
     bool moved;             ///< Flag indicating whether the player has moved.
 
-    sf::Clock moveClock;    ///< Clock to manage movement delay.
-    float moveDelay;        ///< Duration of movement delay in seconds.
+    pacing::Clock moveClock; ///< Game clock to manage movement delay.
+    float moveDelay;        ///< Duration of movement delay in game seconds.
 
     // Resources
     int debt;               ///< Player's debt resource.
@@ -61,13 +63,37 @@ public:
     void update();
 
     /**
-     * @brief Draws the player on the specified SFML RenderWindow.
-     * @param window SFML RenderWindow to draw the player on.
+     * @brief Draws the player on the specified render target.
+     * @param window SFML RenderWindow or RenderTexture to draw the player on.
      */
-    void draw(sf::RenderWindow& window);
+    void draw(sf::RenderTarget& window);
+
+    /**
+     * @brief Gets the area covered by the player's marker.
+     * @return Bounding rectangle of the marker.
+     */
+    sf::FloatRect getBounds() const override;
+
+    /**
+     * @brief Draws the marker as part of the scene.
+     * @param target Render target to draw on.
+     */
+    void render(sf::RenderTarget& target) override;
 
     // void setPosition(const sf::Vector2f& position);
 
+    /**
+     * @brief Places the player on a space immediately, without animating or triggering an event.
+     * @param index Index of the space on the player's path.
+     */
+    void setSpaceIndex(int index);
+
+    /**
+     * @brief Gets the index of the space the player is on or moving towards.
+     * @return Index of the space on the player's path.
+     */
+    int getSpaceIndex() const;
+
     /**
      * @brief Retrieves the current position of the player.
      * @return Current position as an SFML Vector2f.
@@ -93,6 +119,12 @@ public:
      */
     int getMajor() const;
 
+    /**
+     * @brief Gets the player's movement path.
+     * @return Positions of the spaces on the player's path.
+     */
+    const std::vector<sf::Vector2f>& getPath() const;
+
     /**
      * @brief Sets the player's movement path.
      * @param spaces Vector of positions representing the movement path.
@@ -0,0 +1,83 @@
+#ifndef POLLER_H
+#define POLLER_H
+
+#include <vector>
+#if !defined(__linux__)
+#include <poll.h>
+#endif
+
+/**
+ * @file Poller.h
+ * @brief Header file for the socket readiness poller used by the session host and the load tester.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Uses epoll on Linux and falls back to poll() elsewhere. A poller belongs to one thread; only wake()
+ * may be called from other threads.
+ */
+
+/**
+ * @class Poller
+ * @brief Waits for any of a set of sockets to become readable or writable.
+ */
+class Poller {
+private:
+    int wakeRead;                 ///< Read end of the pipe that wake() writes to.
+    int wakeWrite;                ///< Write end of the pipe that wake() writes to.
+#if defined(__linux__)
+    int epoll;                    ///< epoll instance.
+#else
+    std::vector<pollfd> fds;      ///< Watched sockets, the wake pipe first.
+    std::vector<void*> tokens;    ///< Token of each watched socket, parallel to fds.
+#endif
+
+public:
+    /**
+     * @brief Constructor for the Poller class.
+     */
+    Poller();
+
+    /**
+     * @brief Closes the poller and its wake pipe. Watched sockets are left open.
+     */
+    ~Poller();
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    /**
+     * @brief Starts watching a socket.
+     * @param fd Socket descriptor.
+     * @param token Returned by wait() when the socket is ready; must not be null.
+     * @param writable True to also wait for the socket to become writable.
+     * @return False on error.
+     */
+    bool add(int fd, void* token, bool writable);
+
+    /**
+     * @brief Changes whether a watched socket is waited on for writability.
+     * @param fd Socket descriptor.
+     * @param token Token given to add().
+     * @param writable True to also wait for the socket to become writable.
+     */
+    void modify(int fd, void* token, bool writable);
+
+    /**
+     * @brief Stops watching a socket. Must be called before the socket is closed.
+     * @param fd Socket descriptor.
+     */
+    void remove(int fd);
+
+    /**
+     * @brief Waits until a watched socket is ready, wake() is called or the timeout passes.
+     * @param ready Receives the tokens of the ready sockets.
+     * @param timeoutMs Longest time to wait in milliseconds, or -1 to wait indefinitely.
+     */
+    void wait(std::vector<void*>& ready, int timeoutMs);
+
+    /**
+     * @brief Makes a wait() in progress on another thread return. Safe to call from any thread.
+     */
+    void wake();
+};
+
+#endif // POLLER_H
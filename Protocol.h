@@ -0,0 +1,140 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Rules.h"
+
+/**
+ * @file Protocol.h
+ * @brief Header file for the messages exchanged between the game server and its clients.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Each message is framed as a two byte little-endian payload length, a type byte and the payload.
+ * Integers inside payloads are varints; signed values are zigzag encoded first.
+ */
+
+namespace protocol {
+
+    /**
+     * @brief Message types.
+     */
+    enum MessageType : std::uint8_t {
+        Hello = 1,  ///< Client to server: requested seat (1 or 2, or 0 to watch), then optionally a table number.
+        ChoosePath, ///< Client to server: path index for the client's seat.
+        Spin,       ///< Client to server: spin for the client's seat.
+        Welcome,    ///< Server to client: seat granted (0 for spectators) and number of events in the deck.
+        State,      ///< Server to client: delta against the last state sent, then a checksum of the result.
+        Spun        ///< Server to client: player, spin and event index plus one (0 for no event).
+    };
+
+    const int fieldCount = 1 + 6 * rules::playerCount; ///< Number of integers a game state flattens into.
+
+    /**
+     * @brief A received message.
+     */
+    struct Message {
+        std::uint8_t type;                 ///< One of MessageType.
+        std::vector<std::uint8_t> payload; ///< Message body.
+    };
+
+    /**
+     * @brief Appends an unsigned varint.
+     * @param out Output bytes.
+     * @param value Value to append.
+     */
+    void putVarint(std::vector<std::uint8_t>& out, std::uint32_t value);
+
+    /**
+     * @brief Appends a signed value as a zigzag varint.
+     * @param out Output bytes.
+     * @param value Value to append.
+     */
+    void putSigned(std::vector<std::uint8_t>& out, std::int32_t value);
+
+    /**
+     * @brief Reads an unsigned varint.
+     * @param p Read position, advanced past the varint.
+     * @param end End of the input.
+     * @param value Receives the value.
+     * @return False if the input ends early or the varint is too long.
+     */
+    bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint32_t& value);
+
+    /**
+     * @brief Reads a zigzag varint.
+     * @param p Read position, advanced past the varint.
+     * @param end End of the input.
+     * @param value Receives the value.
+     * @return False if the input ends early.
+     */
+    bool getSigned(const std::uint8_t*& p, const std::uint8_t* end, std::int32_t& value);
+
+    /**
+     * @brief Flattens a game state into a fixed list of integers.
+     * @param state Game state.
+     * @param fields Receives fieldCount integers.
+     */
+    void flatten(const rules::GameState& state, std::int32_t fields[fieldCount]);
+
+    /**
+     * @brief Rebuilds a game state from flattened integers.
+     * @param fields fieldCount integers.
+     * @param state Receives the game state.
+     */
+    void unflatten(const std::int32_t fields[fieldCount], rules::GameState& state);
+
+    /**
+     * @brief Encodes the fields that changed between two states: a varint bitmask of changed fields, then the
+     * zigzag difference of each one.
+     * @param from State the receiver already has.
+     * @param to New state.
+     * @param out Output bytes.
+     * @return True if anything changed.
+     */
+    bool encodeDelta(const rules::GameState& from, const rules::GameState& to, std::vector<std::uint8_t>& out);
+
+    /**
+     * @brief Applies a delta produced by encodeDelta().
+     * @param p Read position, advanced past the delta.
+     * @param end End of the input.
+     * @param state State to update in place.
+     * @return False if the delta is malformed.
+     */
+    bool decodeDelta(const std::uint8_t*& p, const std::uint8_t* end, rules::GameState& state);
+
+    /**
+     * @brief Computes a checksum of a state so clients can confirm their copy matches the server's.
+     * @param state Game state.
+     * @return FNV-1a hash of the flattened state.
+     */
+    std::uint32_t checksum(const rules::GameState& state);
+
+    /**
+     * @brief Applies a State message and checks the result against the checksum the server sent with it.
+     * @param message State message.
+     * @param state Client's copy of the state, updated in place.
+     * @return False if the message is malformed or the states have diverged.
+     */
+    bool applyState(const Message& message, rules::GameState& state);
+
+    /**
+     * @brief Appends a framed message.
+     * @param out Output bytes.
+     * @param type Message type.
+     * @param payload Message body, at most 65535 bytes.
+     */
+    void frame(std::vector<std::uint8_t>& out, std::uint8_t type, const std::vector<std::uint8_t>& payload);
+
+    /**
+     * @brief Removes one complete message from the front of a receive buffer.
+     * @param in Received bytes.
+     * @param message Receives the message.
+     * @return False if no complete message has arrived yet.
+     */
+    bool unframe(std::vector<std::uint8_t>& in, Message& message);
+
+} // namespace protocol
+
+#endif // PROTOCOL_H
@@ -0,0 +1,183 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DrawList.h"
+
+/**
+ * @file Raster.h
+ * @brief Header file for the software rasteriser, which draws the game's draw lists into a framebuffer in memory
+ * so frames can be rendered and saved as PNG files on machines with no graphics card or display.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * The canvas draws the same triangles the draw lists send to the graphics card: filled rectangles and convex
+ * shapes, sprites and glyph quads, with their vertex colours and images, blended the way SFML's default alpha
+ * blending does. The canvas is split into square tiles; each draw first sorts its triangles into the tiles they
+ * touch, then worker threads take whole tiles, so no two threads ever write the same pixel and each tile keeps
+ * the painter's order of the list. The threads are started with the canvas and wait between draws. Pixels are
+ * blended four at a time with SSE2 where the compiler targets it.
+ *
+ * The canvas samples images in memory, never textures, so nothing needs an OpenGL context or a display. Tools
+ * switch the asset cache to memory mode first; images and glyph pages are then recorded as sf::Image, which the
+ * canvas reads as they are at the moment of drawing. Batches recorded with textures are skipped.
+ */
+
+namespace raster {
+
+    /**
+     * @brief Gets the instruction set pixels are blended with.
+     * @return "SSE2" or "scalar".
+     */
+    const char* blending();
+
+    /**
+     * @class Canvas
+     * @brief A framebuffer in memory that draw lists are rasterised into.
+     */
+    class Canvas {
+    public:
+        /**
+         * @brief A triangle set up for rasterising, in canvas pixels. A point is inside when every side's
+         * sign * (x * a + (y * b + c)) is positive; the red, green, blue, alpha, u and v at a point are
+         * base + x * dx + y * dy.
+         */
+        struct Triangle {
+            float a[3];             ///< Each side's x coefficient.
+            float b[3];             ///< Each side's y coefficient.
+            float c[3];             ///< Each side's constant.
+            float sign[3];          ///< 1, or -1 for a side whose coefficients are taken from its other end.
+            bool owns[3];           ///< True if pixels exactly on the side belong to this triangle.
+            float base[6];          ///< Each attribute at the origin.
+            float dx[6];            ///< Change of each attribute per pixel across.
+            float dy[6];            ///< Change of each attribute per pixel down.
+            bool flat;              ///< True if untextured and one colour all over.
+            const sf::Image* image; ///< Image sampled, or nullptr for plain colour.
+            bool smooth;            ///< True to filter between the image's texels.
+            int left;               ///< Leftmost pixel column it may cover.
+            int top;                ///< Topmost pixel row it may cover.
+            int right;              ///< Rightmost pixel column it may cover.
+            int bottom;             ///< Bottommost pixel row it may cover.
+        };
+
+    private:
+        static const int tileSize = 64; ///< Width and height of a tile in pixels.
+
+        unsigned width;                                  ///< Width in pixels.
+        unsigned height;                                 ///< Height in pixels.
+        std::vector<std::uint8_t> pixels;                ///< RGBA bytes, row by row.
+        std::vector<Triangle> triangles;                 ///< Triangles of the current draw.
+        std::vector<std::vector<std::uint32_t>> tiles;   ///< Triangles touching each tile, in drawing order.
+        bool skippedTextures;                            ///< True once a texture batch has been skipped.
+
+        std::vector<std::thread> workers;  ///< Threads helping the drawing thread with the tiles.
+        std::mutex mutex;                  ///< Guards the pass, the busy count and the stop flag.
+        std::condition_variable start;     ///< Wakes the workers for a pass or to stop.
+        std::condition_variable finished;  ///< Wakes the drawing thread when the last worker is done.
+        std::uint64_t pass;                ///< Number of passes started; each draw is one pass.
+        unsigned busy;                     ///< Workers still drawing tiles of the current pass.
+        bool stopping;                     ///< True when the workers should return.
+        std::atomic<std::size_t> nextTile; ///< Next tile nobody has started in the current pass.
+
+        /**
+         * @brief Transforms triangles and sorts them into the tiles they touch, after those already waiting.
+         * @param vertices Corners, three per triangle.
+         * @param count Number of vertices.
+         * @param image Image to sample, or nullptr for plain colour.
+         * @param smooth True to filter between the image's texels.
+         * @param transform Maps the vertices' positions onto canvas pixels.
+         */
+        void add(const sf::Vertex* vertices, std::size_t count, const sf::Image* image, bool smooth,
+                 const sf::Transform& transform);
+
+        /**
+         * @brief Draws every waiting triangle, spreading the tiles over the threads, and empties the tiles.
+         */
+        void flush();
+
+        /**
+         * @brief Takes tiles nobody has started and draws them, until none are left in the pass.
+         */
+        void drawTiles();
+
+        /**
+         * @brief Worker thread body: draws tiles in every pass until the canvas is destroyed.
+         */
+        void work();
+
+        /**
+         * @brief Draws the triangles of one tile.
+         * @param tile Index of the tile.
+         */
+        void drawTile(std::size_t tile);
+
+    public:
+        /**
+         * @brief Constructor for the Canvas class. The canvas starts transparent black.
+         * @param width Width in pixels.
+         * @param height Height in pixels.
+         * @param threads Threads to draw with, counting the one that draws, or 0 for one per core.
+         */
+        Canvas(unsigned width, unsigned height, unsigned threads = 0);
+
+        /**
+         * @brief Destructor for the Canvas class. Stops and joins the worker threads.
+         */
+        ~Canvas();
+
+        /**
+         * @brief Fills the canvas with one colour.
+         * @param color Colour to fill with.
+         */
+        void clear(const sf::Color& color = sf::Color::Black);
+
+        /**
+         * @brief Draws triangles that sample one image.
+         * @param vertices Corners, three per triangle, with texture coordinates in texels.
+         * @param count Number of vertices.
+         * @param image Image to sample, or nullptr for plain colour.
+         * @param smooth True to filter between the image's texels.
+         * @param transform Maps the vertices' positions onto canvas pixels.
+         */
+        void draw(const sf::Vertex* vertices, std::size_t count, const sf::Image* image, bool smooth = false,
+                  const sf::Transform& transform = sf::Transform::Identity);
+
+        /**
+         * @brief Builds a draw list if needed and draws every batch that is plain colour or samples an image, in
+         * order.
+         * @param list Draw list to draw.
+         * @param transform Maps the list's coordinates onto canvas pixels, for example to shrink a frame into a
+         * thumbnail.
+         */
+        void draw(DrawList& list, const sf::Transform& transform = sf::Transform::Identity);
+
+        /**
+         * @brief Gets the canvas size.
+         * @return Width and height in pixels.
+         */
+        sf::Vector2u getSize() const;
+
+        /**
+         * @brief Gets the framebuffer.
+         * @return RGBA bytes, row by row from the top.
+         */
+        const std::uint8_t* getPixels() const;
+
+        /**
+         * @brief Saves the canvas as an image file.
+         * @param file File name; the extension chooses the format, such as .png.
+         * @return False if the file could not be written.
+         */
+        bool saveToFile(const std::string& file) const;
+    };
+
+} // namespace raster
+
+#endif // RASTER_H
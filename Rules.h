@@ -0,0 +1,355 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * @file Rules.h
+ * @brief Header file for the headless game rules shared by the front end, the server and the tools.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Nothing here depends on SFML, so the rules can run without a window.
+ */
+
+namespace rules {
+
+    const int western = 0;      ///< Path index of the Western path, matching majorSelection::majorEvent.
+    const int ivey = 1;         ///< Path index of the Ivey path, matching majorSelection::majorEvent.
+    const int pathCount = 2;    ///< Number of paths a player can choose.
+    const int playerCount = 2;  ///< Number of players at a table.
+    const int wheelSize = 5;    ///< The wheel shows 1 to wheelSize.
+    const int sharedRoad = 2;   ///< Region of the spaces both paths share; regions 0 and 1 are the paths' own spaces.
+    const int regionCount = 3;  ///< Number of board regions, each with its own event deck.
+    const int maxBoardTiles = 1000; ///< Most tiles a board layout may have along either side.
+    const int maxTileSize = 1024;   ///< Largest tile in pixels, so every tile's pixel position fits an int.
+    const int maxEvents = 65535;    ///< Most events a deck may hold, so a deck index fits in 16 bits.
+    const int maxWeight = 10000;    ///< Largest weight an event may have, so a region's total fits the shuffle.
+
+    /**
+     * @brief Centre of a board space in board pixels, which are window pixels on the standard board.
+     */
+    struct Tile {
+        int x; ///< Horizontal position.
+        int y; ///< Vertical position.
+    };
+
+    /**
+     * @brief The spaces of both paths and which of them are event spaces.
+     */
+    struct Board {
+        std::vector<Tile> paths[pathCount];             ///< Spaces of each path, from start to graduation.
+        std::vector<Tile> eventSpaces;                  ///< Spaces that trigger an event when landed on.
+        std::vector<unsigned char> eventAt[pathCount];  ///< 1 where the space at that path index is an event space.
+        std::vector<unsigned char> regionAt[pathCount]; ///< Region of the space at that path index.
+        int columns;                                    ///< Width of the board in tiles.
+        int rows;                                       ///< Height of the board in tiles.
+        int tileSize;                                   ///< Width and height of a tile in pixels.
+
+        /**
+         * @brief Fills eventAt and regionAt from the paths and eventSpaces.
+         */
+        void markEvents();
+
+        /**
+         * @brief Loads a board layout. Lines are "size <columns> <rows>" (first and only once, at most
+         * maxBoardTiles each way), an optional "tile <pixels>" (40 by default, at most maxTileSize), "western" or
+         * "ivey" followed by waypoints "x,y" in tiles, and "event" followed by the tiles that are event spaces.
+         * Consecutive waypoints must share a row or a column and every tile between them joins the path; later
+         * lines for the same path carry on from where the last one stopped, so paths can split from and rejoin
+         * each other as often as wanted. Blank lines and lines starting with # are ignored.
+         * @param in Stream holding the layout.
+         * @param board Receives the board.
+         * @return False, after reporting the line on the console, if the layout is malformed.
+         */
+        static bool load(std::istream& in, Board& board);
+
+        /**
+         * @brief Gets the index of the last space on a path.
+         * @param path Path index.
+         * @return Index of the graduation space.
+         */
+        int lastIndex(int path) const;
+
+        /**
+         * @brief Gets the standard Western Wonderland board.
+         * @return The board drawn by GameBoard.
+         */
+        static const Board& standard();
+    };
+
+    /**
+     * @brief Represents an in-game event with associated attributes.
+     */
+    struct Event {
+        std::string description;          ///< Description of the event.
+        int happinessScore;               ///< Impact on player's happiness when the effect is constant.
+        int debtScore;                    ///< Impact on player's debt when the effect is constant.
+        int gpaScore;                     ///< Impact on player's GPA when the effect is constant.
+        std::vector<std::int32_t> effect; ///< Compiled effect from Effects.h, or empty when the scores above apply.
+        int weight;                       ///< Relative chance of being drawn, or copies in a shuffle bag.
+        unsigned regions;                 ///< Bit r set if the event can be drawn on region r's spaces.
+    };
+
+    /**
+     * @brief Changes an event makes to a player's resources.
+     */
+    struct Effect {
+        int happiness; ///< Change in happiness.
+        int debt;      ///< Change in debt.
+        int gpa;       ///< Change in GPA.
+    };
+
+    /**
+     * @brief The events that can be drawn in one region, with an alias table for drawing by weight in constant
+     * time whatever the deck size.
+     */
+    struct EventTable {
+        std::vector<std::uint16_t> events;    ///< Deck index of each column's own event.
+        std::vector<std::uint16_t> alias;     ///< Deck index of each column's alias event.
+        std::vector<std::uint32_t> threshold; ///< Chance out of 65536 of keeping the column's own event.
+        std::vector<std::uint32_t> ends;      ///< Running total of the weights up to and including each column.
+        int totalWeight;                      ///< Sum of the weights in the table.
+
+        /**
+         * @brief Builds the table from the events drawable in a region.
+         * @param deck Every event.
+         * @param region Region index.
+         */
+        void build(const std::vector<Event>& deck, int region);
+
+        /**
+         * @brief Draws an event by weight.
+         * @param bits Random bits.
+         * @return Deck index of the event; the table must not be empty.
+         */
+        int draw(std::uint32_t bits) const;
+
+        /**
+         * @brief Gets the event of one copy in the shuffle bag, where each event has as many copies as its weight.
+         * @param copy Copy index, below totalWeight.
+         * @return Deck index of the event.
+         */
+        int copy(std::uint32_t copy) const;
+    };
+
+    /**
+     * @brief Every event a player can draw.
+     */
+    struct EventDeck {
+        std::vector<Event> events;          ///< Events in file order.
+        EventTable tables[regionCount];     ///< Events drawable in each region.
+        bool shuffled;                      ///< True to deal each region's events like a shuffled pile, not repeat.
+
+        /**
+         * @brief Rebuilds the region tables after events change.
+         */
+        void build();
+
+        /**
+         * @brief Parses a deck in the events.txt format: a description line, then happiness, debt and GPA lines,
+         * then optional "when" condition, "weight" and "on" region lines, then a blank line. The three score lines
+         * may be expressions in the language described in Effects.h; an event whose effect fails to compile is
+         * reported and has none. A line reading "shuffle" in place of a description turns on the shuffle bag.
+         * Weights above maxWeight are reported and read as 1, and events past maxEvents are reported and left out.
+         * @param in Stream holding the deck.
+         * @return The parsed deck.
+         */
+        static EventDeck parse(std::istream& in);
+    };
+
+    /**
+     * @brief Mixes a seed and a counter into 32 random bits.
+     * Counter-based, so any position in the sequence can be reached without replaying it.
+     * @param seed Stream seed.
+     * @param counter Position in the stream.
+     * @return Random bits.
+     */
+    inline std::uint32_t mix(std::uint32_t seed, std::uint32_t counter) {
+        std::uint32_t h = seed ^ (counter * 0x9E3779B9u);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    /**
+     * @brief Maps random bits onto 0 to n - 1 using the top 16 bits, without division.
+     * @param bits Random bits.
+     * @param n Number of outcomes, at most 65536.
+     * @return Uniform value below n.
+     */
+    inline int uniform(std::uint32_t bits, std::uint32_t n) {
+        return static_cast<int>(((bits >> 16) * n) >> 16);
+    }
+
+    /**
+     * @brief Deterministic random number stream used for spins and event draws.
+     */
+    struct Rng {
+        std::uint32_t seed;    ///< Stream seed.
+        std::uint32_t counter; ///< Number of values drawn so far.
+
+        /**
+         * @brief Draws the next 32 random bits.
+         * @return Random bits.
+         */
+        std::uint32_t next() {
+            return mix(seed, counter++);
+        }
+    };
+
+    /**
+     * @brief Per-player state.
+     */
+    struct PlayerState {
+        int path;      ///< Path index the player is on.
+        int index;     ///< Index of the player's space on the path.
+        bool chosen;   ///< True once the player has chosen a path.
+        int happiness; ///< Player's happiness resource.
+        int debt;      ///< Player's debt resource.
+        int gpa;       ///< Player's GPA resource.
+    };
+
+    /**
+     * @brief Progress through one region's shuffled deck.
+     */
+    struct Bag {
+        std::uint32_t drawn; ///< Events dealt so far.
+        std::uint32_t key;   ///< Chooses the order of the current pass through the deck.
+    };
+
+    /**
+     * @brief Everything needed to continue a game.
+     */
+    struct GameState {
+        int turn;                              ///< Player whose turn it is, 0 or 1.
+        PlayerState players[playerCount];      ///< Both players.
+        Bag bags[regionCount];                 ///< Each region's shuffled deck; unused unless the deck is shuffled.
+    };
+
+    /**
+     * @brief What happened on one turn.
+     */
+    struct Turn {
+        int player; ///< Player who spun.
+        int spin;   ///< Wheel result, 1 to wheelSize.
+        int event;  ///< Index of the event drawn, or -1 if the player did not land on an event space.
+    };
+
+    /**
+     * @brief Creates the state at the start of a game. Player 1 starts on the Ivey path and player 2 on the
+     * Western path, as in main.cpp, until they choose.
+     * @return The starting state.
+     */
+    GameState newGame();
+
+    /**
+     * @brief Checks if a player has reached graduation.
+     * @param state Game state.
+     * @param board Board being played.
+     * @param player Player index.
+     * @return True if the player is on the last space of their path.
+     */
+    bool finished(const GameState& state, const Board& board, int player);
+
+    /**
+     * @brief Checks if both players have reached graduation.
+     * @param state Game state.
+     * @param board Board being played.
+     * @return True if the game is over.
+     */
+    bool gameOver(const GameState& state, const Board& board);
+
+    /**
+     * @brief Sets a player's path.
+     * @param state Game state.
+     * @param player Player index.
+     * @param path Path index.
+     * @return False if the player had already chosen or the path is not valid.
+     */
+    bool choosePath(GameState& state, int player, int path);
+
+    /**
+     * @brief Checks if the player whose turn it is may spin.
+     * @param state Game state.
+     * @param board Board being played.
+     * @return True if that player has chosen a path and the game is not over.
+     */
+    bool canSpin(const GameState& state, const Board& board);
+
+    /**
+     * @brief Draws a wheel result.
+     * @param rng Random number stream.
+     * @return Value from 1 to wheelSize.
+     */
+    int drawSpin(Rng& rng);
+
+    /**
+     * @brief Draws an event for a space in a region: by weight, or the next card of a shuffled deck.
+     * @param rng Random number stream.
+     * @param deck Event deck.
+     * @param region Region of the space landed on.
+     * @param bag That region's shuffled deck; advanced if the deck is shuffled.
+     * @return Index of the event, or -1 if the region has no events.
+     */
+    int drawEvent(Rng& rng, const EventDeck& deck, int region, Bag& bag);
+
+    /**
+     * @brief Works out what an event does to a player, from the player's state before the event.
+     * @param event Event landed on.
+     * @param player Player state.
+     * @return Changes to the player's resources.
+     */
+    Effect eventEffect(const Event& event, const PlayerState& player);
+
+    /**
+     * @brief Adds an event's effects to a player's resources.
+     * @param player Player state.
+     * @param event Event to apply.
+     */
+    void applyEvent(PlayerState& player, const Event& event);
+
+    /**
+     * @brief Moves the current player by a given spin, applies any event and passes the turn.
+     * @param state Game state.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @param spin Wheel result.
+     * @param rng Random number stream for the event draw.
+     * @return What happened.
+     */
+    Turn applySpin(GameState& state, const Board& board, const EventDeck& deck, int spin, Rng& rng);
+
+    /**
+     * @brief Spins for the current player and plays out the turn.
+     * @param state Game state.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @param rng Random number stream.
+     * @return What happened.
+     */
+    Turn playTurn(GameState& state, const Board& board, const EventDeck& deck, Rng& rng);
+
+    /**
+     * @brief Counts the resource categories each player wins, as Graduation::graduationEvent does.
+     * @param state Game state.
+     * @param score1 Receives player 1's score.
+     * @param score2 Receives player 2's score.
+     */
+    void scores(const GameState& state, int& score1, int& score2);
+
+    /**
+     * @brief Determines the winner.
+     * @param state Game state.
+     * @return 0 or 1 for the winning player, or -1 for a tie.
+     */
+    int winner(const GameState& state);
+
+} // namespace rules
+
+#endif // RULES_H
@@ -0,0 +1,170 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+/**
+ * @file SceneGraph.h
+ * @brief Header file for the retained scene graph that only redraws damaged regions of the window.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @class SceneNode
+ * @brief Something drawn on the game window that knows its bounds and whether it changed.
+ */
+class SceneNode {
+private:
+    bool dirty; ///< True if the node looks different from the last composed frame.
+
+public:
+    /**
+     * @brief Constructor for the SceneNode class. New nodes start dirty so they get drawn once.
+     */
+    SceneNode();
+
+    /**
+     * @brief Virtual destructor for derived nodes.
+     */
+    virtual ~SceneNode();
+
+    /**
+     * @brief Gets the area the node covers.
+     * @return Bounding rectangle in board coordinates, or window coordinates for an overlay.
+     */
+    virtual sf::FloatRect getBounds() const = 0;
+
+    /**
+     * @brief Draws the node.
+     * @param target Render target to draw on.
+     */
+    virtual void render(sf::RenderTarget& target) = 0;
+
+    /**
+     * @brief Flags the node for redrawing on the next composed frame.
+     */
+    void markDirty();
+
+    /**
+     * @brief Clears the dirty flag once the scene has recorded the change.
+     */
+    void markClean();
+
+    /**
+     * @brief Checks if the node changed since the last composed frame.
+     * @return True if the node is dirty.
+     */
+    bool isDirty() const;
+};
+
+/**
+ * @class Scene
+ * @brief Composes scene nodes into a cached frame, redrawing only the regions that changed.
+ */
+class Scene {
+private:
+    /**
+     * @brief A node together with what the scene remembers about it.
+     */
+    struct Entry {
+        SceneNode* node;         ///< The node, owned elsewhere.
+        sf::FloatRect lastBounds; ///< Bounds the node was last drawn at, in window coordinates.
+        bool isStatic;           ///< True if the node lives in the cached static layer.
+        bool isOverlay;          ///< True if the node is placed in window coordinates and ignores the camera.
+    };
+
+    std::vector<Entry> nodes;           ///< Nodes in drawing order, static ones first.
+    sf::RenderTexture staticLayer;      ///< Cached rendering of the static nodes.
+    sf::RenderTexture frame;            ///< Cached rendering of the whole scene.
+    sf::Vector2u size;                  ///< Size of the window in pixels.
+    sf::View camera;                    ///< Part of the board shown in the window.
+    bool fullRedraw;                    ///< True if the whole frame must be recomposed.
+    bool cameraMoved;                   ///< True if the static layer must be redrawn for a new camera.
+
+    /**
+     * @brief Works out where a node appears in the window.
+     * @param entry The node.
+     * @return Its bounds in window coordinates.
+     */
+    sf::FloatRect placeOf(const Entry& entry) const;
+
+    /**
+     * @brief Adds a rectangle to a damage list, merging it with any rectangle it touches.
+     * @param damage Damage list.
+     * @param rect Damaged rectangle.
+     */
+    void addDamage(std::vector<sf::FloatRect>& damage, const sf::FloatRect& rect) const;
+
+    /**
+     * @brief Restricts drawing on a render target to one region.
+     * @param target Render target to clip.
+     * @param region Region to draw into, in window coordinates.
+     * @param throughCamera True to draw board coordinates through the camera, false for window coordinates.
+     */
+    void clipTo(sf::RenderTarget& target, const sf::FloatRect& region, bool throughCamera) const;
+
+public:
+    /**
+     * @brief Constructor for the Scene class.
+     * @param width Width of the window in pixels.
+     * @param height Height of the window in pixels.
+     */
+    Scene(unsigned width, unsigned height);
+
+    /**
+     * @brief Adds a node that rarely changes, such as the board. It is cached in its own layer.
+     * @param node Node to add; must outlive the scene.
+     */
+    void addStatic(SceneNode& node);
+
+    /**
+     * @brief Adds a node that changes during play, such as a marker. Drawn above every static node.
+     * @param node Node to add; must outlive the scene.
+     */
+    void addDynamic(SceneNode& node);
+
+    /**
+     * @brief Adds a dynamic node that stays put in the window when the camera moves, such as the wheel.
+     * @param node Node to add; must outlive the scene.
+     */
+    void addOverlay(SceneNode& node);
+
+    /**
+     * @brief Moves the camera. The whole window is redrawn on the next frame if the view changed.
+     * @param view Part of the board to show; it must not be rotated.
+     */
+    void setCamera(const sf::View& view);
+
+    /**
+     * @brief Gets the camera.
+     * @return Part of the board shown, the window itself until setCamera() is called.
+     */
+    const sf::View& getCamera() const;
+
+    /**
+     * @brief Forces the next frame to be recomposed in full, e.g. after a popup drew over the window.
+     */
+    void invalidate();
+
+    /**
+     * @brief Recomposes the damaged regions into the cached frame without showing it.
+     * @return True if the frame changed.
+     */
+    bool compose();
+
+    /**
+     * @brief Gets the cached frame, for drawing the scene somewhere other than a whole window.
+     * @return Texture holding the last composed frame.
+     */
+    const sf::Texture& getFrame() const;
+
+    /**
+     * @brief Recomposes the damaged regions and shows the frame.
+     * @param window SFML RenderWindow to present on.
+     * @return True if a frame was displayed, false if nothing changed and display() was skipped.
+     */
+    bool present(sf::RenderWindow& window);
+};
+
+#endif // SCENEGRAPH_H
@@ -0,0 +1,217 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "Bot.h"
+#include "Channels.h"
+#include "History.h"
+#include "Journal.h"
+#include "Rules.h"
+#include "Telemetry.h"
+#include "Wheel.h"
+
+/**
+ * @file Simulation.h
+ * @brief Header file for the simulation thread that runs a local game: the rules, the markers' movement and the
+ * computer player, kept apart from drawing so a slow frame never changes the game's timing.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @class Simulation
+ * @brief Runs a local game on its own thread. The render thread sends it input through a queue and draws the
+ * snapshots it publishes through a triple buffer.
+ */
+class Simulation {
+public:
+    /**
+     * @brief What the player asked for.
+     */
+    enum InputKind : std::uint8_t {
+        ChoosePath, ///< A player picked a path.
+        Spin,       ///< The player whose turn it is spun.
+        EventSeen,  ///< The popup for the latest event was closed.
+        Rewind      ///< Go back (negative value) or forward again (positive value) by that many turns.
+    };
+
+    /**
+     * @brief One piece of input, small enough to copy through the queue.
+     */
+    struct Input {
+        std::uint8_t kind;  ///< An InputKind.
+        std::int8_t player; ///< Player index for ChoosePath.
+        std::int8_t value;  ///< Path index for ChoosePath, or turns to move for Rewind.
+    };
+
+    /**
+     * @brief Everything the render thread needs to draw one moment of the game. Plain data, so publishing is a
+     * copy and the render thread can never see it half written.
+     */
+    struct Snapshot {
+        std::uint64_t tick;                   ///< Simulation tick the snapshot was taken on.
+        rules::GameState state;               ///< Rules state, with each turn's event already applied.
+        int shown[rules::playerCount];        ///< Space each marker stands on; it walks up to its player's index.
+        int spins;                            ///< Spins so far; a new one tells the render thread to spin the wheel.
+        rules::Turn lastTurn;                 ///< The latest spin.
+        int events;                           ///< Events landed on so far; a new one is shown in a popup.
+        int eventPlayer;                      ///< Player who landed on the latest event.
+        int event;                            ///< Deck index of the latest event.
+        rules::Effect effect;                 ///< What the latest event did.
+        rules::Effect unseen[rules::playerCount]; ///< Effect of an event each marker has not reached yet.
+        int turn;                             ///< Turns played to reach this state, less any rewound.
+        int turns;                            ///< Turns that can be gone forward to again, counting this one.
+        bool spinReady;                       ///< True if a Spin sent now would be played, not ignored.
+    };
+
+private:
+    const rules::Board& board;     ///< Board being played.
+    const rules::EventDeck& deck;  ///< Event deck.
+    const Wheel& wheel;            ///< Wheel, for how long each spin animation lasts.
+    Bot* bot;                      ///< Computer playing player 2, or nullptr.
+    telemetry::Log& log;           ///< Per-game telemetry; ignores records unless opened.
+    journal::Writer* journal;      ///< Autosave journal, or nullptr.
+    std::uint32_t layout;          ///< Fingerprint of the board and deck, saved with every journal entry.
+
+    SpscQueue<Input> input;             ///< Input from the render thread.
+    TripleBuffer<Snapshot> snapshots;   ///< Snapshots for the render thread.
+    std::thread thread;                 ///< Simulation thread.
+    std::atomic<bool> running;          ///< Cleared to stop the thread.
+
+    // Owned by the simulation thread once it starts
+    Snapshot now;                                        ///< Current moment of the game.
+    rules::Rng rng;                                      ///< Spin and event stream.
+    history::Timeline timeline;                          ///< Every turn, for rewinding.
+    std::chrono::steady_clock::time_point nextStep[rules::playerCount]; ///< When each marker takes its next step.
+    int pendingEvent;                                    ///< Event waiting for its marker to arrive, or -1.
+    int seenEvents;                                      ///< Event popups the render thread has closed.
+    bool changed;                                        ///< True if the current moment is unpublished.
+    bool botThinking;                                    ///< True while the bot chooses its path.
+    bool ended;                                          ///< True once the result has been recorded.
+    std::uint32_t saved;                                 ///< Journal entries since the game started.
+
+    /**
+     * @brief Runs ticks until stopped.
+     */
+    void run();
+
+    /**
+     * @brief Acts on one piece of input.
+     * @param in The input.
+     * @param at Time of the tick.
+     */
+    void handle(const Input& in, std::chrono::steady_clock::time_point at);
+
+    /**
+     * @brief Plays a turn for the player whose turn it is. Their marker sets off once the wheel has stopped.
+     * @param at Time of the tick.
+     */
+    void spin(std::chrono::steady_clock::time_point at);
+
+    /**
+     * @brief Takes the game back, or forward again, by a number of turns. The markers jump straight to their
+     * spaces. Against the bot, going back stops on a turn of the person playing.
+     * @param by Turns to move: negative to go back, positive to go forward again.
+     * @param at Time of the tick.
+     */
+    void rewind(int by, std::chrono::steady_clock::time_point at);
+
+    /**
+     * @brief Appends the state the game is in to the autosave journal, if there is one.
+     * @param kind A journal::Kind.
+     * @param player Player who chose or spun, or -1.
+     * @param value Path chosen, wheel result or turns rewound.
+     * @param event Event applied, or -1.
+     */
+    void save(std::uint8_t kind, int player, int value, int event);
+
+    /**
+     * @brief Moves the markers, lets the bot play and records the end of the game.
+     * @param at Time of the tick.
+     */
+    void advance(std::chrono::steady_clock::time_point at);
+
+    /**
+     * @brief Checks if nothing is animating or waiting to be seen, so the next spin may start.
+     * @param at Time of the tick.
+     * @return True if the game is waiting for a spin.
+     */
+    bool settled(std::chrono::steady_clock::time_point at) const;
+
+    /**
+     * @brief Checks if a Spin from the player would be played: the turn is a person's, paths are chosen, the game
+     * is not over and everything has settled.
+     * @param at Time of the tick.
+     * @return True if a spin would be taken.
+     */
+    bool spinnable(std::chrono::steady_clock::time_point at) const;
+
+public:
+    /**
+     * @brief Constructor for the Simulation class.
+     * @param board Board to play on.
+     * @param deck Event deck.
+     * @param wheel Wheel shown by the render thread.
+     * @param bot Computer playing player 2, or nullptr for two people.
+     * @param log Telemetry log, recorded to as producer 0.
+     * @param seed Seed of the spin and event stream.
+     */
+    Simulation(const rules::Board& board, const rules::EventDeck& deck, const Wheel& wheel, Bot* bot,
+               telemetry::Log& log, std::uint32_t seed);
+
+    /**
+     * @brief Destructor for the Simulation class. Stops the thread.
+     */
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    /**
+     * @brief Saves every change to the game to a journal from now on. Called before start().
+     * @param writer Open journal; must outlive the simulation thread.
+     */
+    void autosave(journal::Writer& writer);
+
+    /**
+     * @brief Carries on a game recovered from the journal instead of starting a new one, with the markers on
+     * their spaces and any event that was on its way already applied. Turns before it cannot be undone. Called
+     * before start().
+     * @param entry Latest entry of the game.
+     */
+    void resume(const journal::Entry& entry);
+
+    /**
+     * @brief Starts the simulation thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the simulation thread, recording the game as given up if it had not finished.
+     */
+    void stop();
+
+    /**
+     * @brief Sends input to the simulation without blocking. Called by the render thread only.
+     * @param in The input.
+     * @return False if the queue was full and the input was dropped.
+     */
+    bool send(const Input& in);
+
+    /**
+     * @brief Picks up the newest snapshot, if one was published since the last call. Called by the render thread
+     * only.
+     * @return True if latest() changed.
+     */
+    bool update();
+
+    /**
+     * @brief Gets the snapshot the render thread holds.
+     * @return The snapshot, unchanged until the next update().
+     */
+    const Snapshot& latest() const;
+};
+
+#endif // SIMULATION_H
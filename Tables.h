@@ -0,0 +1,50 @@
+#ifndef TABLES_H
+#define TABLES_H
+
+#include <SFML/Graphics.hpp>
+#include "Rules.h"
+
+/**
+ * @file Tables.h
+ * @brief Header file for the multi-table view, which plays several independent local games in one window, each
+ * table in its own part of it, for classrooms and events.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Every table has its own players, wheel, event deck stream and simulation thread, and composes its own retained
+ * scene at the size of the single-game window. The window only stretches each table's cached frame into its
+ * viewport, so a table whose game did not change costs one textured quad per frame, and nothing at all is drawn
+ * while every table is idle. Popups are drawn inside their table instead of taking over the window, so one table
+ * waiting on a popup never stops the others.
+ */
+
+namespace tables {
+
+    const int minTables = 4;  ///< Fewest tables the view shows.
+    const int maxTables = 16; ///< Most tables the view shows.
+
+    /**
+     * @brief Works out how big a window the grid needs: each table at the single-game size, shrunk as needed for
+     * the grid to fit on the desktop.
+     * @param count Number of tables, clamped between minTables and maxTables.
+     * @param tableSize Width and height of one table in pixels at full size.
+     * @return Size of the window in pixels.
+     */
+    sf::Vector2u windowSize(int count, unsigned tableSize);
+
+    /**
+     * @brief Plays a grid of tables until the window is closed. Clicking a table, or pressing Tab, chooses the
+     * table the keyboard plays: Space spins, W and I choose a path when asked, Enter or X closes an event, and U
+     * and Y undo and redo a turn.
+     * @param window SFML RenderWindow for the grid, sized with windowSize().
+     * @param layout Board every table plays on; must outlive the call.
+     * @param count Number of tables, clamped between minTables and maxTables.
+     * @param tableSize Width and height of one table's scene in pixels.
+     * @param botBudgetMs If above 0, the computer plays player 2 at every table, thinking for this many
+     * milliseconds per decision.
+     * @return Exit status of the program.
+     */
+    int play(sf::RenderWindow& window, const rules::Board& layout, int count, unsigned tableSize, double botBudgetMs);
+
+} // namespace tables
+
+#endif // TABLES_H
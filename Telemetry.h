@@ -0,0 +1,184 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Channels.h"
+#include "Rules.h"
+
+/**
+ * @file Telemetry.h
+ * @brief Header file for the per-game telemetry log: game threads push fixed-size records into lock-free rings and
+ * a writer thread turns them into one JSON line per game.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Each line holds the paths chosen, every turn's spin, event, resource changes and time taken, the graduation
+ * result and the game's length. Pushing never blocks or allocates: if the writer falls behind, records are
+ * dropped and counted rather than stalling the game.
+ *
+ * Undo and redo appear among the turns as {"rewound":N}: the game went to the state after the first N turns of
+ * its current line of play, and the next turn played replaces every turn after the Nth, so a reader keeps a
+ * position into the turns and drops those after it when a turn follows. A game taken back after it ended gets
+ * another line when it ends again, whose turns carry on from the earlier line's.
+ */
+
+namespace telemetry {
+
+    /**
+     * @brief What a record describes.
+     */
+    enum Kind : std::uint8_t {
+        Started,   ///< A game began.
+        Chose,     ///< A player chose a path.
+        Played,    ///< A player took a turn.
+        Rewound,   ///< The game was taken back or forward to another turn.
+        Ended,     ///< Both players graduated.
+        Abandoned  ///< The game was given up before graduation.
+    };
+
+    /**
+     * @brief One thing that happened in a game. Trivially copyable, so a push is a plain copy.
+     */
+    struct Record {
+        std::uint64_t game;     ///< Game the record belongs to.
+        std::int64_t micros;    ///< Steady clock time in microseconds.
+        std::uint8_t kind;      ///< A Kind.
+        std::int8_t player;     ///< Player index, or the winner for Ended (-1 for a tie).
+        std::int8_t value;      ///< Path chosen or wheel result.
+        std::int32_t event;     ///< Event drawn, or -1; decks hold up to rules::maxEvents.
+        std::int32_t change[3]; ///< Happiness, debt and GPA change for Played; both scores for Ended; the turn
+                                ///< gone to first for Rewound.
+    };
+
+    /**
+     * @brief Makes a record that a game began.
+     * @param game Game id.
+     * @return The record.
+     */
+    Record started(std::uint64_t game);
+
+    /**
+     * @brief Makes a record of a path choice.
+     * @param game Game id.
+     * @param player Player index.
+     * @param path Path index.
+     * @return The record.
+     */
+    Record chose(std::uint64_t game, int player, int path);
+
+    /**
+     * @brief Makes a record of a turn.
+     * @param game Game id.
+     * @param turn What happened.
+     * @param before The player before the turn.
+     * @param after The player after the turn.
+     * @return The record.
+     */
+    Record played(std::uint64_t game, const rules::Turn& turn, const rules::PlayerState& before,
+                  const rules::PlayerState& after);
+
+    /**
+     * @brief Makes a record of an undo or redo.
+     * @param game Game id.
+     * @param turn Turns played to reach the state gone to.
+     * @return The record.
+     */
+    Record rewound(std::uint64_t game, int turn);
+
+    /**
+     * @brief Makes a record of the graduation result.
+     * @param game Game id.
+     * @param state Finished game.
+     * @return The record.
+     */
+    Record ended(std::uint64_t game, const rules::GameState& state);
+
+    /**
+     * @brief Makes a record that a game was given up.
+     * @param game Game id.
+     * @return The record.
+     */
+    Record abandoned(std::uint64_t game);
+
+    /**
+     * @class Log
+     * @brief Telemetry file fed by one ring per game thread and written by a background thread, which batches
+     * writes and syncs the file to disk about once a second.
+     */
+    class Log {
+    private:
+        std::vector<std::unique_ptr<SpscQueue<Record>>> rings; ///< One ring per producer.
+        int fd;                                   ///< Log file, or -1 when closed.
+        std::thread writer;                       ///< Thread draining the rings.
+        std::atomic<bool> stopping;               ///< Set to make the writer drain and stop.
+        std::atomic<std::uint64_t> dropped;       ///< Records lost because a ring was full.
+        std::int64_t openedMicros;                ///< Steady clock time when the log was opened.
+        std::int64_t openedUnixMs;                ///< Wall clock time when the log was opened.
+
+        /**
+         * @brief Runs the writer thread until the log is closed.
+         */
+        void run();
+
+    public:
+        /**
+         * @brief Constructor for the Log class. The log starts closed, and records are ignored until it is opened.
+         */
+        Log();
+
+        /**
+         * @brief Destructor for the Log class. Closes the log.
+         */
+        ~Log();
+
+        Log(const Log&) = delete;
+        Log& operator=(const Log&) = delete;
+
+        /**
+         * @brief Opens a file for appending and starts the writer.
+         * @param path File name.
+         * @param producers Number of threads that will record, each with its own index.
+         * @param capacity Records each producer's ring holds.
+         * @return False if the file could not be opened.
+         */
+        bool open(const std::string& path, int producers = 1, std::size_t capacity = 4096);
+
+        /**
+         * @brief Queues a record without blocking. Does nothing while the log is closed.
+         * @param producer Index of the calling thread, below the number given to open().
+         * @param record Record to queue.
+         */
+        void record(int producer, const Record& record);
+
+        /**
+         * @brief Writes out everything queued, syncs the file and stops the writer.
+         */
+        void close();
+
+        /**
+         * @brief Checks if the log is open.
+         * @return True if records are being written.
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Gets the number of records lost because the writer fell behind.
+         * @return Records dropped so far.
+         */
+        std::uint64_t droppedCount() const;
+    };
+
+    /**
+     * @brief Reads the steady clock in microseconds, the time base of records.
+     * @return Current time.
+     */
+    std::int64_t now();
+
+} // namespace telemetry
+
+#endif // TELEMETRY_H
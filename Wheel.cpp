@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include <vector>
@@ -5,6 +6,10 @@
 #include <cstdlib>
 #include <cmath>
 #include "Wheel.h"
+#include "Assets.h"
+#include "Glyphs.h"
+#include "Latency.h"
+#include "Pacing.h"
 
 /**
  * @file Wheel.cpp
@@ -13,20 +18,15 @@
 
 /**
  * @brief Default constructor for the Wheel class.
- * Initializes the wheel with numbers and loads the font.
+ * Initializes the wheel with numbers and takes the font from the asset cache.
  */
-Wheel::Wheel() {
+Wheel::Wheel() : font(assets::font("Arial.ttf")), arrowAngle(0) {
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
 
     // Initialize the wheel with numbers from 1 to 5
     for (int i = 1; i <= 5; ++i) {
         numbers.push_back(i);
     }
-
-    // Load font for text rendering
-    if (!font.loadFromFile("Arial.ttf")) {
-        std::cerr << "Failed to load font" << std::endl;
-    }
 }
 
 /**
@@ -35,14 +35,24 @@ Wheel::Wheel() {
  * @return Pair containing the spin result (number) and arrow angle.
  */
 std::pair<int, float> Wheel::SpinWheel(sf::RenderWindow& window) {
-    int totalRotations = 5 * numbers.size();
-    totalRotations += std::rand() % numbers.size();
+    return SpinWheelTo(GetSpinResult(std::rand() % numbers.size()), window);
+}
 
-    // Spin the wheel animation
-    for (int i = 0; i < totalRotations; ++i) {
+/**
+ * @brief Spins the wheel so it stops on a result decided elsewhere, such as by the game server.
+ * @param result Number the wheel should stop on.
+ * @param window SFML RenderWindow for drawing the wheel animation.
+ * @return Pair containing the spin result (number) and arrow angle.
+ */
+std::pair<int, float> Wheel::SpinWheelTo(int result, sf::RenderWindow& window) {
+    int totalRotations = SpinMillis(result) / spinFrameMillis;
+
+    // Spin the wheel animation in game time; frames that went by while the last one was drawn are skipped
+    pacing::Clock clock;
+    for (int i = 0; i < totalRotations; i = clock.milliseconds() / spinFrameMillis) {
         DrawWheel(i * (360.0f / numbers.size()), window);
-        window.display();
-        sf::sleep(sf::milliseconds(50));
+        latency::display(window);
+        pacing::sleepFor(std::chrono::milliseconds((i + 1) * spinFrameMillis - clock.milliseconds()));
     }
 
     // Calculate the arrow angle and spin result
@@ -52,6 +62,33 @@ std::pair<int, float> Wheel::SpinWheel(sf::RenderWindow& window) {
     return std::make_pair(spinResult, arrowAngle);
 }
 
+/**
+ * @brief Gets how long the spin animation for a result lasts: five full turns, then on to the result's segment,
+ * one segment per frame.
+ * @param result Number the wheel stops on.
+ * @return Length of the animation in milliseconds.
+ */
+int Wheel::SpinMillis(int result) const {
+    int index = 0;
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        if (numbers[i] == result) {
+            index = static_cast<int>(i);
+        }
+    }
+    return (5 * static_cast<int>(numbers.size()) + index) * spinFrameMillis;
+}
+
+/**
+ * @brief Gets where the arrow points part way through the spin animation, which moves on one segment per frame.
+ * @param result Number the wheel stops on.
+ * @param elapsedMillis Time since the spin started in milliseconds.
+ * @return Arrow angle in degrees.
+ */
+float Wheel::SpinAngle(int result, int elapsedMillis) const {
+    int frames = std::min(std::max(elapsedMillis, 0) / spinFrameMillis, SpinMillis(result) / spinFrameMillis);
+    return frames * (360.0f / numbers.size());
+}
+
 /**
  * @brief Retrieves the spin result based on the wheel index.
  * @param index Index of the wheel segment where the arrow stops.
@@ -62,11 +99,41 @@ int Wheel::GetSpinResult(int index) {
 }
 
 /**
- * @brief Draws the wheel with segments and the spinning arrow.
+ * @brief Gets the numbers on the wheel.
+ * @return Numbers on the wheel's segments.
+ */
+const std::vector<int>& Wheel::GetNumbers() const {
+    return numbers;
+}
+
+/**
+ * @brief Draws the wheel with segments and the spinning arrow. The segments, numbers and arrow are recorded into
+ * a draw list on their own layers and drawn with one call each.
  * @param arrowAngle Angle of the spinning arrow.
- * @param window SFML RenderWindow for drawing.
+ * @param window SFML RenderWindow or RenderTexture for drawing.
  */
-void Wheel::DrawWheel(float arrowAngle, sf::RenderWindow& window) {
+void Wheel::DrawWheel(float arrowAngle, sf::RenderTarget& window) {
+    recordFrame(arrowAngle);
+    frame.draw(window);
+}
+
+/**
+ * @brief Draws the wheel with segments and the spinning arrow into a software canvas.
+ * @param arrowAngle Angle of the spinning arrow.
+ * @param canvas Canvas to draw on.
+ * @param transform Maps window pixels onto the canvas.
+ */
+void Wheel::DrawWheel(float arrowAngle, raster::Canvas& canvas, const sf::Transform& transform) {
+    recordFrame(arrowAngle);
+    canvas.draw(frame, transform);
+}
+
+/**
+ * @brief Records the segments on layer 0, the numbers on layer 1 and the arrow on layer 2 of the frame.
+ * @param arrowAngle Angle of the spinning arrow.
+ */
+void Wheel::recordFrame(float arrowAngle) {
+    frame.clear();
     float angleStep = 360.0f / numbers.size();
     float currentAngle = 0.0f;
 
@@ -83,18 +150,18 @@ void Wheel::DrawWheel(float arrowAngle, sf::RenderWindow& window) {
                                           90.0f + 70.0f * std::sin((currentAngle + angleStep) * 3.14159265 / 180)));
         segment.setFillColor(colors[i % 3]);
 
-        window.draw(segment);
+        frame.shape(segment, 0);
 
         sf::Text numberText(std::to_string(numbers[i]), font, 20);
         numberText.setFillColor(sf::Color::Black);
         float x = 90.0f + 32.0f * std::cos((currentAngle + angleStep / 2) * 3.14159265 / 180);
         float y = 90.0f + 32.0f * std::sin((currentAngle + angleStep / 2) * 3.14159265 / 180);
 
-        sf::FloatRect textBounds = numberText.getLocalBounds();
+        sf::FloatRect textBounds = glyphs::bounds(numberText);
         numberText.setOrigin(textBounds.left + textBounds.width / 2.0f, textBounds.top + textBounds.height / 2.0f);
         numberText.setPosition(x, y);
 
-        window.draw(numberText);
+        frame.text(numberText, 1);
 
         currentAngle += angleStep;
     }
@@ -108,5 +175,40 @@ void Wheel::DrawWheel(float arrowAngle, sf::RenderWindow& window) {
                                     90.0f + 70.0f * std::sin((arrowAngle + angleStep) * 3.14159265 / 180)));
     arrow.setFillColor(sf::Color(238, 227, 224, 128));
 
-    window.draw(arrow);
+    frame.shape(arrow, 2);
+}
+
+/**
+ * @brief Sets the angle the arrow rests at between spins.
+ * @param angle Arrow angle in degrees.
+ */
+void Wheel::SetArrowAngle(float angle) {
+    if (angle != arrowAngle) {
+        arrowAngle = angle;
+        markDirty();
+    }
+}
+
+/**
+ * @brief Gets the angle the arrow rests at between spins.
+ * @return Arrow angle in degrees.
+ */
+float Wheel::GetArrowAngle() const {
+    return arrowAngle;
+}
+
+/**
+ * @brief Gets the area covered by the wheel segments and arrow.
+ * @return Bounding rectangle of the wheel.
+ */
+sf::FloatRect Wheel::getBounds() const {
+    return sf::FloatRect(20.0f, 20.0f, 140.0f, 140.0f);
+}
+
+/**
+ * @brief Draws the wheel at its resting angle as part of the scene.
+ * @param target Render target to draw on.
+ */
+void Wheel::render(sf::RenderTarget& target) {
+    DrawWheel(arrowAngle, target);
 }
@@ -6,6 +6,9 @@
 #include <ctime>
 #include <cstdlib>
 #include <cmath>
+#include "SceneGraph.h"
+#include "DrawList.h"
+#include "Raster.h"
 
 /**
  * @file Wheel.h
@@ -15,9 +18,9 @@
 
 /**
  * @class Wheel
- * @brief Represents a spinning wheel game.
+ * @brief Represents a spinning wheel game. Drawn as a dynamic scene node at its last resting angle.
  */
-class Wheel {
+class Wheel : public SceneNode {
 
 public:
     /**
@@ -32,6 +35,30 @@ public:
      */
     std::pair<int, float> SpinWheel(sf::RenderWindow& window);
 
+    /**
+     * @brief Spins the wheel so it stops on a given result.
+     * @param result Number the wheel should stop on.
+     * @param window SFML RenderWindow for drawing the wheel.
+     * @return A pair containing the index and angle of the wheel result.
+     */
+    std::pair<int, float> SpinWheelTo(int result, sf::RenderWindow& window);
+
+    /**
+     * @brief Gets how long the spin animation for a result lasts.
+     * @param result Number the wheel stops on.
+     * @return Length of SpinWheelTo's animation in milliseconds.
+     */
+    int SpinMillis(int result) const;
+
+    /**
+     * @brief Gets where the arrow points part way through the spin animation for a result, for drawing the spin
+     * without blocking.
+     * @param result Number the wheel stops on.
+     * @param elapsedMillis Time since the spin started in milliseconds.
+     * @return Arrow angle in degrees, the resting angle SpinWheelTo returns once the animation is over.
+     */
+    float SpinAngle(int result, int elapsedMillis) const;
+
     /**
      * @brief Gets the spin result at a specified index.
      * @param index Index of the spin result to retrieve.
@@ -39,12 +66,50 @@ public:
      */
     int GetSpinResult(int index);
 
+    /**
+     * @brief Gets the numbers on the wheel, each equally likely to be spun.
+     * @return Numbers on the wheel's segments.
+     */
+    const std::vector<int>& GetNumbers() const;
+
     /**
      * @brief Draws the spinning wheel with an arrow indicating the result.
      * @param arrowAngle Angle of the arrow indicating the wheel result.
-     * @param window SFML RenderWindow for drawing the wheel.
+     * @param window SFML RenderWindow or RenderTexture for drawing the wheel.
      */
-    void DrawWheel(float arrowAngle, sf::RenderWindow& window);
+    void DrawWheel(float arrowAngle, sf::RenderTarget& window);
+
+    /**
+     * @brief Draws the spinning wheel into a software canvas, for rendering without a window.
+     * @param arrowAngle Angle of the arrow indicating the wheel result.
+     * @param canvas Canvas to draw the wheel on.
+     * @param transform Maps window pixels onto the canvas.
+     */
+    void DrawWheel(float arrowAngle, raster::Canvas& canvas, const sf::Transform& transform = sf::Transform::Identity);
+
+    /**
+     * @brief Sets the angle the arrow rests at between spins.
+     * @param angle Arrow angle in degrees.
+     */
+    void SetArrowAngle(float angle);
+
+    /**
+     * @brief Gets the angle the arrow rests at between spins.
+     * @return Arrow angle in degrees.
+     */
+    float GetArrowAngle() const;
+
+    /**
+     * @brief Gets the area covered by the wheel.
+     * @return Bounding rectangle of the wheel.
+     */
+    sf::FloatRect getBounds() const override;
+
+    /**
+     * @brief Draws the wheel at its resting angle as part of the scene.
+     * @param target Render target to draw on.
+     */
+    void render(sf::RenderTarget& target) override;
 
     /**
      * @brief Runs the spinning wheel game.
@@ -52,9 +117,18 @@ public:
     void Run();
 
 private:
-    sf::RenderWindow window; ///< SFML RenderWindow for drawing the wheel.
-    sf::Font font;           ///< Font for text rendering.
+    static const int spinFrameMillis = 50; ///< Time each frame of the spin animation is shown.
+
+    const sf::Font& font;    ///< Font for text rendering, owned by the asset cache.
     std::vector<int> numbers; ///< Vector containing the wheel result numbers.
+    float arrowAngle;         ///< Angle the arrow rests at between spins.
+    DrawList frame;           ///< Segments, numbers and arrow of the frame being drawn.
+
+    /**
+     * @brief Records the segments, numbers and arrow of one frame into the frame's draw list.
+     * @param arrowAngle Angle of the spinning arrow.
+     */
+    void recordFrame(float arrowAngle);
 
 };
 
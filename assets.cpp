@@ -0,0 +1,497 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <SFML/Graphics.hpp>
+#include "Assets.h"
+#include "Atlas.h"
+#include "Embedded.h"
+#include "Glyphs.h"
+#include "Latency.h"
+#include "Metrics.h"
+
+/**
+ * @file assets.cpp
+ * @brief Implementation file for the shared asset cache and its background loader.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    /**
+     * @brief A single cached image or font.
+     */
+    struct Asset {
+        std::string file;     ///< File name the asset is loaded from.
+        bool isFont;          ///< True for fonts, false for images.
+        bool decoded;         ///< Set by the decoding thread once the file has been read. Guarded by the loader mutex.
+        bool failed;          ///< True if the file could not be read. Guarded by the loader mutex.
+        bool resident;        ///< True once the asset can be used for drawing. Render thread only.
+        bool preloaded;       ///< True if the asset counts towards the loading screen progress.
+        sf::Image image;      ///< Decoded pixels waiting to be uploaded, or kept for good in memory mode.
+        std::unique_ptr<sf::Texture> texture; ///< Texture the image is uploaded to, made on upload or first use.
+        sf::Font font;        ///< Parsed font.
+        std::vector<unsigned char> bytes; ///< File contents when they are not embedded as-is. Fonts keep reading from them.
+    };
+
+    /**
+     * @brief Cache contents and the state shared with the worker threads.
+     */
+    struct Loader {
+        std::mutex mutex;                                     ///< Guards the queue and the decoded flags.
+        std::condition_variable decodedSignal;                ///< Notified whenever an asset finishes decoding.
+        std::map<std::string, std::unique_ptr<Asset>> cache;  ///< Every asset ever requested, by file name.
+        std::vector<Asset*> queue;                            ///< Assets waiting for a worker, in request order.
+        size_t next = 0;                                      ///< Index of the next queued asset to decode.
+        size_t preloaded = 0;                                 ///< Number of assets passed to preload().
+        size_t ready = 0;                                     ///< Number of preloaded assets that are resident.
+        std::vector<std::thread> workers;                     ///< Decoding threads.
+        std::vector<atlas::Region> packed;                    ///< Regions of the prebuilt atlas, empty if there is none.
+        std::vector<atlas::Region> unpacked;                  ///< Fallback scales for when there is no prebuilt atlas.
+        bool indexRead = false;                               ///< True once the atlas index has been looked for.
+
+        /**
+         * @brief Waits for the workers so none outlive the cache.
+         */
+        ~Loader() {
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+    };
+
+    Loader loader;
+    bool memory = false; ///< True if images and glyphs stay in memory. Set before anything is loaded.
+
+    /**
+     * @brief Reads a whole file from disk.
+     * @param path Path of the file.
+     * @param bytes Receives the file contents.
+     * @return True if the file was read.
+     */
+    bool readFile(const std::string& path, std::vector<unsigned char>& bytes) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    /**
+     * @brief Finds the bytes of an asset. Safe to call from any thread.
+     * Looks in the WW_ASSET_DIR development override first, then in the executable, then in the working directory.
+     * @param file File name of the asset.
+     * @param storage Holds the bytes when they had to be read or decompressed.
+     * @param data Receives a pointer to the bytes, either into storage or into the executable.
+     * @param size Receives the number of bytes.
+     * @return True if the asset was found.
+     */
+    bool readAsset(const std::string& file, std::vector<unsigned char>& storage, const unsigned char*& data, std::size_t& size) {
+        const char* overrideDir = std::getenv("WW_ASSET_DIR");
+        bool found = overrideDir && readFile(std::string(overrideDir) + "/" + file, storage);
+
+        if (!found) {
+            const embedded::File* embeddedFile = embedded::find(file);
+            if (embeddedFile && !embeddedFile->compressed) {
+                data = embeddedFile->data;
+                size = embeddedFile->size;
+                return true;
+            }
+            if (embeddedFile) {
+                found = embedded::decompress(embeddedFile->data, embeddedFile->size, embeddedFile->rawSize, storage);
+            } else {
+                found = readFile(file, storage);
+            }
+        }
+
+        data = storage.data();
+        size = storage.size();
+        return found;
+    }
+
+    /**
+     * @brief Reads and decodes the asset's file. Safe to call from any thread.
+     * @param asset Asset to decode.
+     * @return True if the file was read successfully.
+     */
+    bool decode(Asset& asset) {
+        const unsigned char* data;
+        std::size_t size;
+        if (!readAsset(asset.file, asset.bytes, data, size)) {
+            return false;
+        }
+
+        if (asset.isFont) {
+            if (memory) {
+                glyphs::add(asset.font, data, size);
+            }
+            return asset.font.loadFromMemory(data, size);
+        }
+        bool ok = asset.image.loadFromMemory(data, size);
+        std::vector<unsigned char>().swap(asset.bytes); // Only the decoded pixels are needed from here on
+        return ok;
+    }
+
+    /**
+     * @brief Worker thread body: decodes queued assets until the queue is empty.
+     */
+    void decodeWorker() {
+        while (true) {
+            Asset* asset;
+            {
+                std::lock_guard<std::mutex> lock(loader.mutex);
+                if (loader.next == loader.queue.size()) {
+                    return;
+                }
+                asset = loader.queue[loader.next++];
+            }
+
+            bool ok = decode(*asset);
+
+            {
+                std::lock_guard<std::mutex> lock(loader.mutex);
+                asset->decoded = true;
+                asset->failed = !ok;
+            }
+            loader.decodedSignal.notify_all();
+        }
+    }
+
+    /**
+     * @brief Adds an asset to the cache without decoding it. Caller must hold the loader mutex.
+     * @param file File name of the asset.
+     * @param isFont True for fonts, false for images.
+     * @return The new or existing cache entry.
+     */
+    Asset& insert(const std::string& file, bool isFont) {
+        std::unique_ptr<Asset>& slot = loader.cache[file];
+        if (!slot) {
+            slot.reset(new Asset());
+            slot->file = file;
+            slot->isFont = isFont;
+            slot->decoded = false;
+            slot->failed = false;
+            slot->resident = false;
+            slot->preloaded = false;
+        }
+        return *slot;
+    }
+
+    /**
+     * @brief Uploads an image to a new texture. Render thread only.
+     * @param asset Decoded image.
+     */
+    void makeTexture(Asset& asset) {
+        asset.texture.reset(new sf::Texture());
+        if (asset.failed) {
+            return;
+        }
+        asset.texture->loadFromImage(asset.image);
+        if (asset.file == atlas::imageFile) {
+            asset.texture->generateMipmap();
+            asset.texture->setSmooth(true);
+        }
+    }
+
+    /**
+     * @brief Makes a decoded asset usable for drawing. Images are uploaded, unless they stay in memory. Render
+     * thread only.
+     * @param asset Decoded asset.
+     */
+    void upload(Asset& asset) {
+        if (asset.failed) {
+            std::cerr << asset.file << " failed to load" << std::endl;
+        } else if (!asset.isFont && !memory) {
+            makeTexture(asset);
+            asset.image = sf::Image(); // The pixels now live on the GPU
+        }
+        asset.resident = true;
+        if (asset.preloaded) {
+            ++loader.ready;
+        }
+    }
+
+    /**
+     * @brief Reads the atlas index the first time it is needed. Caller must hold the loader mutex.
+     */
+    void readAtlasIndex() {
+        if (!loader.indexRead) {
+            std::istringstream index(assets::text(atlas::indexFile));
+            atlas::readIndex(index, loader.packed);
+            loader.unpacked = atlas::layout();
+            loader.indexRead = true;
+        }
+    }
+
+    /**
+     * @brief Looks up an image in a region table.
+     * @param regions Table to search.
+     * @param file Source image file name.
+     * @return The matching region, or nullptr if the image is not in the table.
+     */
+    const atlas::Region* findRegion(const std::vector<atlas::Region>& regions, const std::string& file) {
+        for (const auto& region : regions) {
+            if (region.file == file) {
+                return &region;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Finds where an image is drawn from.
+     * @param file File name of the source image.
+     * @param inAtlas Set to true if the image was packed into the prebuilt atlas.
+     * @return Its region in the atlas, its fallback scale, or nullptr if it has neither.
+     */
+    const atlas::Region* locate(const std::string& file, bool& inAtlas) {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        readAtlasIndex();
+        const atlas::Region* region = findRegion(loader.packed, file);
+        inAtlas = region != nullptr;
+        return inAtlas ? region : findRegion(loader.unpacked, file);
+    }
+
+    /**
+     * @brief Finds an asset and makes sure it is resident, decoding on the calling thread if nobody queued it.
+     * @param file File name of the asset.
+     * @param isFont True for fonts, false for images.
+     * @return The resident cache entry.
+     */
+    Asset& acquire(const std::string& file, bool isFont) {
+        std::unique_lock<std::mutex> lock(loader.mutex);
+        bool queued = loader.cache.count(file) != 0;
+        Asset& asset = insert(file, isFont);
+        metrics::assetLookup(asset.resident);
+        if (asset.resident) {
+            return asset;
+        }
+
+        if (!queued) {
+            lock.unlock();
+            bool ok = decode(asset);
+            lock.lock();
+            asset.decoded = true;
+            asset.failed = !ok;
+        }
+
+        // A worker may still be busy with it
+        loader.decodedSignal.wait(lock, [&asset] { return asset.decoded; });
+        lock.unlock();
+
+        upload(asset);
+        return asset;
+    }
+}
+
+/**
+ * @brief Switches the cache to memory mode.
+ */
+void assets::keepInMemory() {
+    memory = true;
+}
+
+/**
+ * @brief Checks if the cache keeps images and glyphs in memory.
+ * @return True in memory mode.
+ */
+bool assets::inMemory() {
+    return memory;
+}
+
+/**
+ * @brief Queues images and fonts for decoding and starts the worker threads.
+ * @param images File names of the images to decode.
+ * @param fonts File names of the fonts to parse.
+ */
+void assets::preload(const std::vector<std::string>& images, const std::vector<std::string>& fonts) {
+    std::lock_guard<std::mutex> lock(loader.mutex);
+    readAtlasIndex();
+
+    // Images that were packed at build time are decoded once, as part of the atlas
+    std::vector<std::string> files;
+    for (const auto& file : images) {
+        files.push_back(findRegion(loader.packed, file) ? atlas::imageFile : file);
+    }
+
+    for (const auto& file : files) {
+        if (loader.cache.count(file) == 0) {
+            Asset& asset = insert(file, false);
+            asset.preloaded = true;
+            loader.queue.push_back(&asset);
+            ++loader.preloaded;
+        }
+    }
+    for (const auto& file : fonts) {
+        if (loader.cache.count(file) == 0) {
+            Asset& asset = insert(file, true);
+            asset.preloaded = true;
+            loader.queue.push_back(&asset);
+            ++loader.preloaded;
+        }
+    }
+
+    // One worker per core, but never more than there are files to read
+    size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = std::min(workerCount, loader.queue.size() - loader.next);
+    for (size_t i = 0; i < workerCount; ++i) {
+        loader.workers.push_back(std::thread(decodeWorker));
+    }
+}
+
+/**
+ * @brief Uploads every decoded image to a texture.
+ * @return Fraction of preloaded assets that are resident.
+ */
+float assets::pump() {
+    std::vector<Asset*> decoded;
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        for (size_t i = 0; i < loader.next; ++i) {
+            if (loader.queue[i]->decoded && !loader.queue[i]->resident) {
+                decoded.push_back(loader.queue[i]);
+            }
+        }
+    }
+
+    for (Asset* asset : decoded) {
+        upload(*asset);
+    }
+
+    if (loader.preloaded == 0) {
+        return 1.0f;
+    }
+    return static_cast<float>(loader.ready) / loader.preloaded;
+}
+
+/**
+ * @brief Draws a progress bar until every preloaded asset is resident.
+ * @param window SFML RenderWindow to draw the loading screen on.
+ */
+void assets::loadingScreen(sf::RenderWindow& window) {
+    // Progress bar centred in the window
+    sf::RectangleShape track(sf::Vector2f(window.getSize().x * 0.6f, 12));
+    track.setFillColor(sf::Color(241, 241, 241));
+    track.setPosition((window.getSize().x - track.getSize().x) / 2, (window.getSize().y - track.getSize().y) / 2);
+
+    sf::RectangleShape bar(sf::Vector2f(0, track.getSize().y));
+    bar.setFillColor(sf::Color(79, 38, 131));
+    bar.setPosition(track.getPosition());
+
+    while (window.isOpen()) {
+        float progress = pump();
+
+        sf::Event event;
+        while (latency::pollEvent(window, event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                return;
+            }
+        }
+
+        bar.setSize(sf::Vector2f(track.getSize().x * progress, track.getSize().y));
+
+        window.clear();
+        window.draw(track);
+        window.draw(bar);
+        latency::display(window);
+
+        if (progress >= 1.0f) {
+            return;
+        }
+        sf::sleep(sf::milliseconds(5));
+    }
+}
+
+/**
+ * @brief Gets a texture from the cache, loading it first if needed.
+ * @param file File name of the image.
+ * @return Reference to the cached texture.
+ */
+const sf::Texture& assets::texture(const std::string& file) {
+    Asset& asset = acquire(file, false);
+    if (!asset.texture) {
+        makeTexture(asset); // Failed images and images kept in memory have none yet
+    }
+    return *asset.texture;
+}
+
+/**
+ * @brief Gets a font from the cache, loading it first if needed.
+ * @param file File name of the font.
+ * @return Reference to the cached font.
+ */
+const sf::Font& assets::font(const std::string& file) {
+    return acquire(file, true).font;
+}
+
+/**
+ * @brief Creates a sprite that draws an image at its on-screen size.
+ * Uses the prebuilt atlas when there is one, otherwise scales the full-size texture.
+ * @param file File name of the source image.
+ * @return Sprite ready to be positioned and drawn.
+ */
+sf::Sprite assets::sprite(const std::string& file) {
+    bool inAtlas;
+    const atlas::Region* region = locate(file, inAtlas);
+    if (inAtlas) {
+        return sf::Sprite(texture(atlas::imageFile), region->rect);
+    }
+
+    sf::Sprite sprite(texture(file));
+    if (region) {
+        sprite.setScale(region->scale, region->scale);
+    }
+    return sprite;
+}
+
+/**
+ * @brief Records an image as sprite() draws it: from the atlas, or scaled from its own image. Outside memory mode
+ * the sprite itself is recorded.
+ * @param list Draw list to record into.
+ * @param file File name of the source image.
+ * @param position Where the image's top left corner goes.
+ * @param layer Layer to draw on.
+ */
+void assets::record(DrawList& list, const std::string& file, const sf::Vector2f& position, int layer) {
+    if (!memory) {
+        sf::Sprite shown = sprite(file);
+        shown.setPosition(position);
+        list.sprite(shown, layer);
+        return;
+    }
+
+    bool inAtlas;
+    const atlas::Region* region = locate(file, inAtlas);
+    const sf::Image& image = acquire(inAtlas ? atlas::imageFile : file, false).image;
+    sf::Transform transform;
+    transform.translate(position);
+    if (!inAtlas && region) {
+        transform.scale(region->scale, region->scale);
+    }
+    const sf::IntRect whole(0, 0, static_cast<int>(image.getSize().x), static_cast<int>(image.getSize().y));
+    list.image(image, inAtlas ? region->rect : whole, transform, inAtlas, layer); // Only the atlas is smoothed
+}
+
+/**
+ * @brief Reads a text asset such as the event deck.
+ * @param file File name of the asset.
+ * @return Contents of the file, or an empty string if it could not be found.
+ */
+std::string assets::text(const std::string& file) {
+    std::vector<unsigned char> storage;
+    const unsigned char* data;
+    std::size_t size;
+    if (!readAsset(file, storage, data, size)) {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(data), size);
+}
@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <SFML/Graphics.hpp>
+#include "Atlas.h"
+
+/**
+ * @file atlas.cpp
+ * @brief Implementation file for packing the game's images into a texture atlas.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const unsigned padding = 2; ///< Pixels between regions, filled with copies of their edges so mipmaps do not bleed.
+
+    /**
+     * @brief Source pixels that contribute to one destination pixel along one axis.
+     */
+    struct Span {
+        unsigned first;             ///< First contributing source pixel.
+        std::vector<float> weights; ///< Normalised weight of each contributing source pixel.
+    };
+
+    /**
+     * @brief Computes the area-averaging filter along one axis.
+     * @param sourceSize Number of source pixels.
+     * @param targetSize Number of destination pixels.
+     * @param scale Scale factor from source to destination.
+     * @return One span per destination pixel.
+     */
+    std::vector<Span> filterSpans(unsigned sourceSize, unsigned targetSize, float scale) {
+        std::vector<Span> spans(targetSize);
+        for (unsigned d = 0; d < targetSize; ++d) {
+            float start = d / scale;
+            float end = std::min((d + 1) / scale, static_cast<float>(sourceSize));
+            unsigned first = std::min(static_cast<unsigned>(start), sourceSize - 1);
+
+            float total = 0;
+            spans[d].first = first;
+            for (unsigned s = first; s < end || s == first; ++s) {
+                float weight = std::min(s + 1.0f, end) - std::max(static_cast<float>(s), start);
+                weight = std::max(weight, 0.0001f);
+                spans[d].weights.push_back(weight);
+                total += weight;
+            }
+            for (auto& weight : spans[d].weights) {
+                weight /= total;
+            }
+        }
+        return spans;
+    }
+
+    /**
+     * @brief Rounds up to the next power of two.
+     * @param value Value to round.
+     * @return Smallest power of two not below value.
+     */
+    unsigned nextPowerOfTwo(unsigned value) {
+        unsigned result = 1;
+        while (result < value) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Copies an image into the atlas and repeats its edge pixels into the padding around it.
+     * @param atlas Destination atlas.
+     * @param image Image to place.
+     * @param x Left edge of the region.
+     * @param y Top edge of the region.
+     */
+    void blit(sf::Image& atlas, const sf::Image& image, unsigned x, unsigned y) {
+        atlas.copy(image, x, y);
+
+        sf::Vector2u size = image.getSize();
+        for (unsigned p = 1; p <= padding; ++p) {
+            for (unsigned i = 0; i < size.x; ++i) {
+                if (y >= p) {
+                    atlas.setPixel(x + i, y - p, image.getPixel(i, 0));
+                }
+                if (y + size.y - 1 + p < atlas.getSize().y) {
+                    atlas.setPixel(x + i, y + size.y - 1 + p, image.getPixel(i, size.y - 1));
+                }
+            }
+            for (unsigned j = 0; j < size.y; ++j) {
+                if (x >= p) {
+                    atlas.setPixel(x - p, y + j, image.getPixel(0, j));
+                }
+                if (x + size.x - 1 + p < atlas.getSize().x) {
+                    atlas.setPixel(x + size.x - 1 + p, y + j, image.getPixel(size.x - 1, j));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lists every image that goes into the atlas.
+ * The scales match the ones the screens used to apply to the full-size images every frame.
+ * @return Regions with their rects left empty.
+ */
+std::vector<atlas::Region> atlas::layout() {
+    std::vector<Region> regions;
+    regions.push_back({"westernUniversity.jpg", 0.9f, sf::Vector2u(440, 440), sf::IntRect()}); // only the window-sized corner is ever visible
+    regions.push_back({"westernLogo.png", 1.0f, sf::Vector2u(0, 0), sf::IntRect()});
+    regions.push_back({"iveyLogo.png", 0.3f, sf::Vector2u(0, 0), sf::IntRect()});
+    return regions;
+}
+
+/**
+ * @brief Resamples an image with an area-averaging filter and crops it.
+ * Colours are averaged with premultiplied alpha so transparent pixels do not darken the edges of logos.
+ * @param source Image to resample.
+ * @param scale Scale factor.
+ * @param maxSize Crop size after scaling, or zero for no limit.
+ * @return The scaled image.
+ */
+sf::Image atlas::resample(const sf::Image& source, float scale, sf::Vector2u maxSize) {
+    sf::Vector2u sourceSize = source.getSize();
+    unsigned width = std::max(1u, static_cast<unsigned>(std::lround(sourceSize.x * scale)));
+    unsigned height = std::max(1u, static_cast<unsigned>(std::lround(sourceSize.y * scale)));
+    if (maxSize.x > 0) {
+        width = std::min(width, maxSize.x);
+    }
+    if (maxSize.y > 0) {
+        height = std::min(height, maxSize.y);
+    }
+
+    std::vector<Span> columns = filterSpans(sourceSize.x, width, scale);
+    std::vector<Span> rows = filterSpans(sourceSize.y, height, scale);
+
+    // Horizontal pass over only the source rows that some destination row needs
+    unsigned firstRow = rows.front().first;
+    unsigned lastRow = rows.back().first + rows.back().weights.size();
+    std::vector<float> horizontal(width * (lastRow - firstRow) * 4, 0.0f);
+    const sf::Uint8* pixels = source.getPixelsPtr();
+    for (unsigned y = firstRow; y < lastRow; ++y) {
+        for (unsigned x = 0; x < width; ++x) {
+            float* out = &horizontal[((y - firstRow) * width + x) * 4];
+            for (size_t k = 0; k < columns[x].weights.size(); ++k) {
+                const sf::Uint8* in = pixels + (y * sourceSize.x + columns[x].first + k) * 4;
+                float weight = columns[x].weights[k] * in[3] / 255.0f;
+                out[0] += in[0] * weight;
+                out[1] += in[1] * weight;
+                out[2] += in[2] * weight;
+                out[3] += columns[x].weights[k] * in[3];
+            }
+        }
+    }
+
+    // Vertical pass, then undo the alpha premultiplication
+    sf::Image result;
+    result.create(width, height, sf::Color::Transparent);
+    for (unsigned y = 0; y < height; ++y) {
+        for (unsigned x = 0; x < width; ++x) {
+            float sum[4] = {0, 0, 0, 0};
+            for (size_t k = 0; k < rows[y].weights.size(); ++k) {
+                const float* in = &horizontal[((rows[y].first + k - firstRow) * width + x) * 4];
+                for (int c = 0; c < 4; ++c) {
+                    sum[c] += in[c] * rows[y].weights[k];
+                }
+            }
+            if (sum[3] > 0) {
+                float unpremultiply = 255.0f / sum[3];
+                result.setPixel(x, y, sf::Color(static_cast<sf::Uint8>(std::min(255.0f, sum[0] * unpremultiply + 0.5f)),
+                                                static_cast<sf::Uint8>(std::min(255.0f, sum[1] * unpremultiply + 0.5f)),
+                                                static_cast<sf::Uint8>(std::min(255.0f, sum[2] * unpremultiply + 0.5f)),
+                                                static_cast<sf::Uint8>(std::min(255.0f, sum[3] + 0.5f))));
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Scales each source image to its on-screen size and shelf-packs them into one image.
+ * @param sources Decoded images, in the same order as regions.
+ * @param regions Regions from layout(); their rects are filled in.
+ * @return The atlas image.
+ */
+sf::Image atlas::pack(const std::vector<sf::Image>& sources, std::vector<Region>& regions) {
+    std::vector<sf::Image> scaled;
+    unsigned widest = 0;
+    unsigned area = 0;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        scaled.push_back(resample(sources[i], regions[i].scale, regions[i].maxSize));
+        sf::Vector2u size = scaled.back().getSize();
+        widest = std::max(widest, size.x + 2 * padding);
+        area += (size.x + 2 * padding) * (size.y + 2 * padding);
+    }
+
+    // Tallest images first so each shelf wastes as little height as possible
+    std::vector<size_t> order(regions.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&scaled](size_t a, size_t b) {
+        return scaled[a].getSize().y > scaled[b].getSize().y;
+    });
+
+    unsigned atlasWidth = nextPowerOfTwo(std::max(widest, static_cast<unsigned>(std::sqrt(static_cast<float>(area)))));
+    unsigned shelfX = 0;
+    unsigned shelfY = 0;
+    unsigned shelfHeight = 0;
+    for (size_t i : order) {
+        sf::Vector2u size = scaled[i].getSize();
+        if (shelfX + size.x + 2 * padding > atlasWidth) {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        regions[i].rect = sf::IntRect(shelfX + padding, shelfY + padding, size.x, size.y);
+        shelfX += size.x + 2 * padding;
+        shelfHeight = std::max(shelfHeight, size.y + 2 * padding);
+    }
+
+    sf::Image result;
+    result.create(atlasWidth, nextPowerOfTwo(shelfY + shelfHeight), sf::Color::Transparent);
+    for (size_t i = 0; i < regions.size(); ++i) {
+        blit(result, scaled[i], regions[i].rect.left, regions[i].rect.top);
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the region table, one region per line with the file name last.
+ * @param file Output file name.
+ * @param regions Packed regions.
+ * @return True if the file was written.
+ */
+bool atlas::writeIndex(const std::string& file, const std::vector<Region>& regions) {
+    std::ofstream out(file);
+    for (const auto& region : regions) {
+        out << region.rect.left << ' ' << region.rect.top << ' ' << region.rect.width << ' ' << region.rect.height << ' '
+            << region.scale << ' ' << region.maxSize.x << ' ' << region.maxSize.y << ' ' << region.file << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Reads a region table written by writeIndex().
+ * @param in Stream holding the table.
+ * @param regions Receives the packed regions.
+ * @return True if at least one region was read.
+ */
+bool atlas::readIndex(std::istream& in, std::vector<Region>& regions) {
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        Region region;
+        if (fields >> region.rect.left >> region.rect.top >> region.rect.width >> region.rect.height
+                   >> region.scale >> region.maxSize.x >> region.maxSize.y) {
+            fields >> std::ws;
+            std::getline(fields, region.file);
+            regions.push_back(region);
+        }
+    }
+    return !regions.empty();
+}
@@ -0,0 +1,36 @@
+#include <iostream>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "Atlas.h"
+
+/**
+ * @file atlasTool.cpp
+ * @brief Build step that packs the game's images into atlas.png and atlas.txt.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @brief Loads every image in the atlas layout, packs them and writes the atlas files.
+ * @return Exit status of the program.
+ */
+int main() {
+    std::vector<atlas::Region> regions = atlas::layout();
+    std::vector<sf::Image> sources(regions.size());
+
+    for (size_t i = 0; i < regions.size(); ++i) {
+        if (!sources[i].loadFromFile(regions[i].file)) {
+            std::cerr << regions[i].file << " failed to load" << std::endl;
+            return 1;
+        }
+    }
+
+    sf::Image packed = atlas::pack(sources, regions);
+    if (!packed.saveToFile(atlas::imageFile) || !atlas::writeIndex(atlas::indexFile, regions)) {
+        std::cerr << "Failed to write the atlas" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << regions.size() << " images into a " << packed.getSize().x << "x" << packed.getSize().y
+              << " atlas" << std::endl;
+    return 0;
+}
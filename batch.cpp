@@ -0,0 +1,389 @@
+#include <algorithm>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "Batch.h"
+
+/**
+ * @file batch.cpp
+ * @brief Implementation file for the batch simulator.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+#if defined(__AVX512F__)
+    /**
+     * @brief AVX-512 operations on 16 lanes of 32-bit integers.
+     */
+    struct Avx512 {
+        typedef __m512i Int;   ///< One value per lane.
+        typedef __mmask16 Mask; ///< One bit per lane.
+        static const int lanes = 16; ///< Lanes in a vector.
+        static const char* name() { return "AVX-512"; }
+        static Int load(const std::int32_t* p) { return _mm512_load_si512(p); }
+        static void store(std::int32_t* p, Int a) { _mm512_store_si512(p, a); }
+        static Int set(std::int32_t value) { return _mm512_set1_epi32(value); }
+        static Int add(Int a, Int b) { return _mm512_add_epi32(a, b); }
+        static Int sub(Int a, Int b) { return _mm512_sub_epi32(a, b); }
+        static Int mullo(Int a, Int b) { return _mm512_mullo_epi32(a, b); }
+        static Int bitXor(Int a, Int b) { return _mm512_xor_si512(a, b); }
+        static Int min(Int a, Int b) { return _mm512_min_epi32(a, b); }
+        template <int n> static Int shr(Int a) { return _mm512_srli_epi32(a, n); }
+        template <int n> static Int shl(Int a) { return _mm512_slli_epi32(a, n); }
+        static Mask eq(Int a, Int b) { return _mm512_cmpeq_epi32_mask(a, b); }
+        static Mask lt(Int a, Int b) { return _mm512_cmplt_epi32_mask(a, b); }
+        static Mask both(Mask a, Mask b) { return a & b; }
+        static Mask butNot(Mask a, Mask b) { return a & ~b; }
+        static Int select(Mask m, Int a, Int b) { return _mm512_mask_blend_epi32(m, b, a); }
+        static unsigned bits(Mask m) { return m; }
+        static Int gather(const std::int32_t* base, Int index) {
+            return _mm512_i32gather_epi32(index, base, 4);
+        }
+
+        /**
+         * @brief Gets the high 32 bits of each lane's unsigned 64-bit product: even lanes from one widening
+         * multiply and odd lanes from another after shifting them down.
+         */
+        static Int mulhi(Int a, Int b) {
+            Int even = _mm512_srli_epi64(_mm512_mul_epu32(a, b), 32);
+            Int odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+            return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+        }
+    };
+    typedef Avx512 Best; ///< Widest instruction set in this build.
+#elif defined(__AVX2__)
+    /**
+     * @brief AVX2 operations on 8 lanes of 32-bit integers. Masks are vectors with every bit of a lane set.
+     */
+    struct Avx2 {
+        typedef __m256i Int;  ///< One value per lane.
+        typedef __m256i Mask; ///< All ones in a lane that is set.
+        static const int lanes = 8; ///< Lanes in a vector.
+        static const char* name() { return "AVX2"; }
+        static Int load(const std::int32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void store(std::int32_t* p, Int a) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), a); }
+        static Int set(std::int32_t value) { return _mm256_set1_epi32(value); }
+        static Int add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+        static Int sub(Int a, Int b) { return _mm256_sub_epi32(a, b); }
+        static Int mullo(Int a, Int b) { return _mm256_mullo_epi32(a, b); }
+        static Int bitXor(Int a, Int b) { return _mm256_xor_si256(a, b); }
+        static Int min(Int a, Int b) { return _mm256_min_epi32(a, b); }
+        template <int n> static Int shr(Int a) { return _mm256_srli_epi32(a, n); }
+        template <int n> static Int shl(Int a) { return _mm256_slli_epi32(a, n); }
+        static Mask eq(Int a, Int b) { return _mm256_cmpeq_epi32(a, b); }
+        static Mask lt(Int a, Int b) { return _mm256_cmpgt_epi32(b, a); }
+        static Mask both(Mask a, Mask b) { return _mm256_and_si256(a, b); }
+        static Mask butNot(Mask a, Mask b) { return _mm256_andnot_si256(b, a); }
+        static Int select(Mask m, Int a, Int b) { return _mm256_blendv_epi8(b, a, m); }
+        static unsigned bits(Mask m) { return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m))); }
+        static Int gather(const std::int32_t* base, Int index) {
+            return _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), index, 4);
+        }
+
+        /**
+         * @brief Gets the high 32 bits of each lane's unsigned 64-bit product: even lanes from one widening
+         * multiply and odd lanes from another after shifting them down.
+         */
+        static Int mulhi(Int a, Int b) {
+            Int even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+            Int odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+            return _mm256_blend_epi32(even, odd, 0xAA);
+        }
+    };
+    typedef Avx2 Best; ///< Widest instruction set in this build.
+#endif
+
+    /**
+     * @brief A lane's share of the kernel's state, one row of lanes per field.
+     */
+    enum Field {
+        Seed, Counter, Turn, Path0, Path1, Last0, Last1, Index0, Index1, Happiness0, Happiness1, Debt0, Debt1, Gpa0,
+        Gpa1, Live, fieldCount
+    };
+
+    /**
+     * @brief Mixes each lane's seed and counter into 32 random bits, as rules::mix does.
+     * @tparam V Vector operations.
+     * @param seed Stream seeds.
+     * @param counter Positions in the streams.
+     * @return Random bits.
+     */
+    template <typename V>
+    typename V::Int mix(typename V::Int seed, typename V::Int counter) {
+        typename V::Int h = V::bitXor(seed, V::mullo(counter, V::set(static_cast<std::int32_t>(0x9E3779B9u))));
+        h = V::bitXor(h, V::template shr<16>(h));
+        h = V::mullo(h, V::set(static_cast<std::int32_t>(0x85EBCA6Bu)));
+        h = V::bitXor(h, V::template shr<13>(h));
+        h = V::mullo(h, V::set(static_cast<std::int32_t>(0xC2B2AE35u)));
+        return V::bitXor(h, V::template shr<16>(h));
+    }
+}
+
+/**
+ * @brief Constructor for the Simulator class. Flattens the board into tables of which alias table each space
+ * draws from, by path, and the deck's alias tables and effects into plain integer arrays the kernel can gather
+ * from. Each array ends with a spare zero, so lanes with nothing to draw can still gather safely.
+ * @param board Board being played.
+ * @param deck Event deck.
+ */
+batch::Simulator::Simulator(const rules::Board& board, const rules::EventDeck& deck)
+    : board(board), deck(deck), stride(0), anyScripted(false) {
+    std::int32_t regionOffset[rules::regionCount];
+    for (int r = 0; r < rules::regionCount; ++r) {
+        const rules::EventTable& table = deck.tables[r];
+        regionOffset[r] = static_cast<std::int32_t>(sides.size());
+        for (size_t c = 0; c < table.events.size(); ++c) {
+            sides.push_back(table.events[c] | table.alias[c] << 16);
+        }
+        threshold.insert(threshold.end(), table.threshold.begin(), table.threshold.end());
+    }
+    sides.push_back(0);
+    threshold.push_back(0);
+
+    for (int p = 0; p < rules::pathCount; ++p) {
+        last[p] = board.lastIndex(p);
+        stride = std::max(stride, last[p] + 1);
+    }
+    spaceSize.assign(rules::pathCount * stride, 0);
+    spaceOffset.assign(rules::pathCount * stride, 0);
+    for (int p = 0; p < rules::pathCount; ++p) {
+        for (int i = 0; i <= last[p]; ++i) {
+            const int region = board.regionAt[p][i];
+            if (board.eventAt[p][i] && !deck.events.empty()) {
+                spaceSize[p * stride + i] = static_cast<std::int32_t>(deck.tables[region].events.size());
+                spaceOffset[p * stride + i] = regionOffset[region];
+            }
+        }
+    }
+
+    for (const rules::Event& event : deck.events) {
+        happiness.push_back(event.happinessScore);
+        debt.push_back(event.debtScore);
+        gpa.push_back(event.gpaScore);
+        scripted.push_back(event.effect.empty() ? 0 : 1);
+        anyScripted = anyScripted || !event.effect.empty();
+    }
+    happiness.push_back(0);
+    debt.push_back(0);
+    gpa.push_back(0);
+    scripted.push_back(0);
+}
+
+/**
+ * @brief Gets the number of games the kernel plays at once in this build.
+ * @return Lanes per vector, or 1 without vector instructions.
+ */
+int batch::Simulator::lanes() {
+#if defined(__AVX512F__) || defined(__AVX2__)
+    return Best::lanes;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Gets the instruction set the kernel was built for.
+ * @return Its name.
+ */
+const char* batch::Simulator::instructionSet() {
+#if defined(__AVX512F__) || defined(__AVX2__)
+    return Best::name();
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * @brief Plays games to graduation with the fastest kernel this build and deck allow.
+ * @param states Games, played in place.
+ * @param rngs Random streams, advanced in place.
+ * @param count Number of games.
+ */
+void batch::Simulator::play(rules::GameState* states, rules::Rng* rngs, std::size_t count) const {
+#if defined(__AVX512F__) || defined(__AVX2__)
+    if (!deck.shuffled) {
+        playLanes<Best>(states, rngs, count);
+        return;
+    }
+#endif
+    playScalar(states, rngs, count);
+}
+
+/**
+ * @brief Plays games to graduation one at a time with rules::playTurn.
+ * @param states Games, played in place.
+ * @param rngs Random streams, advanced in place.
+ * @param count Number of games.
+ */
+void batch::Simulator::playScalar(rules::GameState* states, rules::Rng* rngs, std::size_t count) const {
+    for (std::size_t g = 0; g < count; ++g) {
+        while (!rules::gameOver(states[g], board)) {
+            rules::playTurn(states[g], board, deck, rngs[g]);
+        }
+    }
+}
+
+/**
+ * @brief Plays games on the vector kernel. Each pass of the loop is one rules::playTurn in every lane: the spin is
+ * drawn, the player whose turn it is moves unless they have graduated, an event is drawn in the lanes that landed
+ * on one, its effect is added, and the turn passes unless the other player has graduated. A lane whose game is
+ * over hands it back and takes the next one before the pass, so lanes only idle once the games run out.
+ * @tparam V Vector operations of one instruction set.
+ * @param states Games, played in place.
+ * @param rngs Random streams, advanced in place.
+ * @param count Number of games.
+ */
+template <typename V>
+void batch::Simulator::playLanes(rules::GameState* states, rules::Rng* rngs, std::size_t count) const {
+    typedef typename V::Int Int;
+    typedef typename V::Mask Mask;
+    alignas(64) std::int32_t lane[fieldCount][V::lanes];
+    alignas(64) std::int32_t drawn[V::lanes];
+    alignas(64) std::int32_t mover[V::lanes];
+    std::size_t game[V::lanes];
+    std::size_t next = 0;
+
+    // An empty lane holds a finished game, which never moves or draws
+    auto fill = [&](int l) {
+        if (next == count) {
+            lane[Live][l] = 0;
+            for (int p = 0; p < rules::playerCount; ++p) {
+                lane[Path0 + p][l] = 0;
+                lane[Last0 + p][l] = lane[Index0 + p][l] = last[0];
+            }
+            return;
+        }
+        const rules::GameState& state = states[next];
+        lane[Seed][l] = static_cast<std::int32_t>(rngs[next].seed);
+        lane[Counter][l] = static_cast<std::int32_t>(rngs[next].counter);
+        lane[Turn][l] = state.turn;
+        for (int p = 0; p < rules::playerCount; ++p) {
+            lane[Path0 + p][l] = state.players[p].path;
+            lane[Last0 + p][l] = last[state.players[p].path];
+            lane[Index0 + p][l] = state.players[p].index;
+            lane[Happiness0 + p][l] = state.players[p].happiness;
+            lane[Debt0 + p][l] = state.players[p].debt;
+            lane[Gpa0 + p][l] = state.players[p].gpa;
+        }
+        lane[Live][l] = 1;
+        game[l] = next++;
+    };
+    auto hand = [&](int l) {
+        rules::GameState& state = states[game[l]];
+        rngs[game[l]].counter = static_cast<std::uint32_t>(lane[Counter][l]);
+        state.turn = lane[Turn][l];
+        for (int p = 0; p < rules::playerCount; ++p) {
+            state.players[p].index = lane[Index0 + p][l];
+            state.players[p].happiness = lane[Happiness0 + p][l];
+            state.players[p].debt = lane[Debt0 + p][l];
+            state.players[p].gpa = lane[Gpa0 + p][l];
+        }
+    };
+    for (int l = 0; l < V::lanes; ++l) {
+        fill(l);
+    }
+
+    const Int zero = V::set(0);
+    const Int one = V::set(1);
+    const Int five = V::set(rules::wheelSize);
+    const Int strideV = V::set(stride);
+    while (true) {
+        const Int last0 = V::load(lane[Last0]);
+        const Int last1 = V::load(lane[Last1]);
+        Int index0 = V::load(lane[Index0]);
+        Int index1 = V::load(lane[Index1]);
+        const Mask live = V::eq(V::load(lane[Live]), one);
+        const unsigned finished = V::bits(V::both(live, V::both(V::eq(index0, last0), V::eq(index1, last1))));
+        if (finished) {
+            for (int l = 0; l < V::lanes; ++l) {
+                if (finished >> l & 1u) {
+                    hand(l);
+                    fill(l);
+                }
+            }
+            continue;
+        }
+        if (!V::bits(live)) {
+            break;
+        }
+
+        const Int seed = V::load(lane[Seed]);
+        Int counter = V::load(lane[Counter]);
+        Int turn = V::load(lane[Turn]);
+        const Int random = V::template shr<16>(mix<V>(seed, counter));
+        const Int spin = V::add(one, V::template shr<16>(V::mullo(random, five)));
+        counter = V::add(counter, one);
+
+        const Mask mine = V::eq(turn, one);
+        const Int path = V::select(mine, V::load(lane[Path1]), V::load(lane[Path0]));
+        const Int lastIndex = V::select(mine, last1, last0);
+        Int index = V::select(mine, index1, index0);
+        const Mask moving = V::butNot(live, V::eq(index, lastIndex));
+        index = V::select(moving, V::min(V::add(index, spin), lastIndex), index);
+        const Int space = V::add(V::mullo(path, strideV), index);
+        const Int columns = V::select(moving, V::gather(spaceSize.data(), space), zero);
+        const Mask landed = V::butNot(moving, V::eq(columns, zero));
+
+        Int happinessChange = zero;
+        Int debtChange = zero;
+        Int gpaChange = zero;
+        unsigned interpreted = 0;
+        if (V::bits(landed)) {
+            // An alias draw: the high half of bits * columns picks the column, the low half's top 16 bits the side
+            const Int bits = mix<V>(seed, counter);
+            counter = V::select(landed, V::add(counter, one), counter);
+            const Int at = V::add(V::gather(spaceOffset.data(), space), V::mulhi(bits, columns));
+            const Int coin = V::template shr<16>(V::mullo(bits, columns));
+            const Int both = V::gather(sides.data(), at);
+            const Int event = V::select(V::lt(coin, V::gather(threshold.data(), at)),
+                                        V::template shr<16>(V::template shl<16>(both)), V::template shr<16>(both));
+            Mask constant = landed;
+            if (anyScripted) {
+                const Mask isScripted = V::both(landed, V::eq(V::gather(scripted.data(), event), one));
+                constant = V::butNot(landed, isScripted);
+                interpreted = V::bits(isScripted);
+                if (interpreted) {
+                    V::store(drawn, event);
+                    V::store(mover, turn);
+                }
+            }
+            happinessChange = V::select(constant, V::gather(happiness.data(), event), zero);
+            debtChange = V::select(constant, V::gather(debt.data(), event), zero);
+            gpaChange = V::select(constant, V::gather(gpa.data(), event), zero);
+        }
+
+        index0 = V::select(mine, index0, index);
+        index1 = V::select(mine, index, index1);
+        V::store(lane[Index0], index0);
+        V::store(lane[Index1], index1);
+        V::store(lane[Happiness0], V::add(V::load(lane[Happiness0]), V::select(mine, zero, happinessChange)));
+        V::store(lane[Happiness1], V::add(V::load(lane[Happiness1]), V::select(mine, happinessChange, zero)));
+        V::store(lane[Debt0], V::add(V::load(lane[Debt0]), V::select(mine, zero, debtChange)));
+        V::store(lane[Debt1], V::add(V::load(lane[Debt1]), V::select(mine, debtChange, zero)));
+        V::store(lane[Gpa0], V::add(V::load(lane[Gpa0]), V::select(mine, zero, gpaChange)));
+        V::store(lane[Gpa1], V::add(V::load(lane[Gpa1]), V::select(mine, gpaChange, zero)));
+        V::store(lane[Counter], counter);
+
+        const Mask otherDone = V::eq(V::select(mine, index0, index1), V::select(mine, last0, last1));
+        V::store(lane[Turn], V::select(V::butNot(live, otherDone), V::sub(one, turn), turn));
+
+        // Scripted effects read the player's resources, so they run in the interpreter after the move
+        for (int l = 0; interpreted && l < V::lanes; ++l) {
+            if (interpreted >> l & 1u) {
+                const int p = mover[l];
+                rules::PlayerState player = rules::PlayerState();
+                player.path = lane[Path0 + p][l];
+                player.index = lane[Index0 + p][l];
+                player.chosen = true;
+                player.happiness = lane[Happiness0 + p][l];
+                player.debt = lane[Debt0 + p][l];
+                player.gpa = lane[Gpa0 + p][l];
+                rules::applyEvent(player, deck.events[drawn[l]]);
+                lane[Happiness0 + p][l] = player.happiness;
+                lane[Debt0 + p][l] = player.debt;
+                lane[Gpa0 + p][l] = player.gpa;
+            }
+        }
+    }
+}
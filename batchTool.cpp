@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Batch.h"
+#include "Rules.h"
+
+/**
+ * @file batchTool.cpp
+ * @brief Runs a balance sweep over every pair of paths on the batch simulator, checks each game against the scalar
+ * rules and compares their speed.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwBatch [--games N] [--seed N] [--threads N] [--events events.txt]
+ * N games are played for each pair of paths.
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock; ///< Clock used to time the kernels.
+
+    const char* const pathNames[rules::pathCount] = {"Western", "Ivey"}; ///< Path names by path index.
+
+    /**
+     * @brief Plays games with a kernel, splitting them evenly between threads.
+     * @param play Plays a range of games on one thread.
+     * @param count Number of games.
+     * @param threads Number of threads.
+     * @return Seconds taken.
+     */
+    template <typename Play>
+    double timed(Play play, std::size_t count, int threads) {
+        const Clock::time_point start = Clock::now();
+        std::vector<std::thread> workers;
+        const std::size_t share = (count + threads - 1) / threads;
+        for (int t = 0; t < threads; ++t) {
+            const std::size_t from = std::min(count, t * share);
+            workers.emplace_back(play, from, std::min(count, from + share) - from);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Checks if two games ended in exactly the same state with their streams in the same place.
+     * @param a One game.
+     * @param b The other game.
+     * @param rngA One game's stream.
+     * @param rngB The other game's stream.
+     * @return True if every field matches.
+     */
+    bool same(const rules::GameState& a, const rules::GameState& b, const rules::Rng& rngA, const rules::Rng& rngB) {
+        if (a.turn != b.turn || rngA.seed != rngB.seed || rngA.counter != rngB.counter) {
+            return false;
+        }
+        for (int p = 0; p < rules::playerCount; ++p) {
+            const rules::PlayerState& x = a.players[p];
+            const rules::PlayerState& y = b.players[p];
+            if (x.path != y.path || x.index != y.index || x.chosen != y.chosen || x.happiness != y.happiness ||
+                x.debt != y.debt || x.gpa != y.gpa) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Runs the sweep.
+ * @param argc Number of arguments.
+ * @param argv --games, --seed, --threads and --events options.
+ * @return Exit status of the program: 1 if the deck failed to load or any game differed between the kernels.
+ */
+int main(int argc, char* argv[]) {
+    std::size_t games = 1000000;
+    std::uint32_t seed = std::random_device()();
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string eventsFile = "events.txt";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--games") {
+            games = static_cast<std::size_t>(std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (arg == "--seed") {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (arg == "--threads") {
+            threads = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--events") {
+            eventsFile = argv[i + 1];
+        }
+    }
+
+    std::ifstream deckFile(eventsFile);
+    if (!deckFile) {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+    const rules::EventDeck deck = rules::EventDeck::parse(deckFile);
+    const rules::Board& board = rules::Board::standard();
+    const batch::Simulator simulator(board, deck);
+
+    // Every pair of paths gets its own games, each with its own stream
+    const std::size_t count = games * rules::pathCount * rules::pathCount;
+    std::vector<rules::GameState> start(count);
+    std::vector<rules::Rng> rngs(count);
+    for (std::size_t g = 0; g < count; ++g) {
+        start[g] = rules::newGame();
+        rules::choosePath(start[g], 0, static_cast<int>(g / games) / rules::pathCount);
+        rules::choosePath(start[g], 1, static_cast<int>(g / games) % rules::pathCount);
+        rngs[g] = {rules::mix(seed, static_cast<std::uint32_t>(g)), 0};
+    }
+
+    std::vector<rules::GameState> vector = start;
+    std::vector<rules::GameState> scalar = start;
+    std::vector<rules::Rng> vectorRngs = rngs;
+    std::vector<rules::Rng> scalarRngs = rngs;
+    const double vectorSeconds = timed([&](std::size_t from, std::size_t n) {
+        simulator.play(&vector[from], &vectorRngs[from], n);
+    }, count, threads);
+    const double scalarSeconds = timed([&](std::size_t from, std::size_t n) {
+        simulator.playScalar(&scalar[from], &scalarRngs[from], n);
+    }, count, threads);
+
+    std::size_t differ = 0;
+    for (std::size_t g = 0; g < count; ++g) {
+        if (!same(vector[g], scalar[g], vectorRngs[g], scalarRngs[g])) {
+            if (differ++ == 0) {
+                std::cerr << "Game " << g << " differs between the batch kernel and the scalar rules" << std::endl;
+            }
+        }
+    }
+
+    std::cout << "Seed " << seed << ", " << games << " games per pair of paths on " << threads << " threads"
+              << std::endl;
+    std::cout << "Graduation (player 1 path vs player 2 path): P1 wins / P2 wins / tie" << std::endl;
+    for (int pair = 0; pair < rules::pathCount * rules::pathCount; ++pair) {
+        std::size_t wins[3] = {0, 0, 0};
+        for (std::size_t g = pair * games; g < (pair + 1) * games; ++g) {
+            ++wins[rules::winner(vector[g]) + 1];
+        }
+        std::cout << "  " << pathNames[pair / rules::pathCount] << " vs " << pathNames[pair % rules::pathCount]
+                  << ": " << 100.0 * wins[1] / games << "% / " << 100.0 * wins[2] / games << "% / "
+                  << 100.0 * wins[0] / games << "%" << std::endl;
+    }
+    std::cout << simulator.instructionSet() << " kernel (" << batch::Simulator::lanes() << " lanes"
+              << (deck.shuffled ? ", shuffled deck played by the scalar rules" : "") << "): "
+              << static_cast<std::uint64_t>(count / vectorSeconds) << " games/s" << std::endl;
+    std::cout << "Scalar rules: " << static_cast<std::uint64_t>(count / scalarSeconds) << " games/s, a speed-up of "
+              << scalarSeconds / vectorSeconds << "x" << std::endl;
+    if (differ) {
+        std::cout << differ << " of " << count << " games differ from the scalar rules" << std::endl;
+        return 1;
+    }
+    std::cout << "All " << count << " games match the scalar rules" << std::endl;
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include <random>
+#include "Bot.h"
+
+/**
+ * @file bot.cpp
+ * @brief Implementation file for the computer player.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const int clockInterval = 32; ///< Rollouts between checks of the deadline.
+
+    /**
+     * @brief Plays a game to the end with random choices for anyone who has not chosen a path.
+     * @param state State to play from, changed in place.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @param rng Random number stream for spins, events and choices.
+     * @param player Player to score for.
+     * @return 2 if the player won, 1 for a tie and 0 for a loss.
+     */
+    int rollout(rules::GameState& state, const rules::Board& board, const rules::EventDeck& deck, rules::Rng& rng,
+                int player) {
+        for (int p = 0; p < rules::playerCount; ++p) {
+            if (!state.players[p].chosen) {
+                rules::choosePath(state, p, rules::uniform(rng.next(), rules::pathCount));
+            }
+        }
+        while (!rules::gameOver(state, board)) {
+            rules::playTurn(state, board, deck, rng);
+        }
+        int winner = rules::winner(state);
+        return winner == player ? 2 : (winner < 0 ? 1 : 0);
+    }
+}
+
+/**
+ * @brief Constructs a bot and starts its worker threads.
+ * @param board Board being played.
+ * @param deck Event deck.
+ * @param budget Time each decision may take.
+ * @param threads Number of worker threads, or 0 for one per hardware thread.
+ */
+Bot::Bot(const rules::Board& board, const rules::EventDeck& deck, std::chrono::microseconds budget,
+         unsigned int threads)
+    : board(board), deck(deck), budget(budget), player(0), seed(std::random_device()()), generation(0), busy(0),
+      choice(-1), rollouts(0), stopping(false) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (unsigned int i = 0; i < threads; ++i) {
+        workers.emplace_back(&Bot::work, this, static_cast<int>(i));
+    }
+}
+
+/**
+ * @brief Stops the worker threads.
+ */
+Bot::~Bot() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Body of each worker thread: waits for a decision, plays rollouts until the deadline and adds its tallies.
+ * @param id Worker number.
+ */
+void Bot::work(int id) {
+    unsigned int seen = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wakeWorkers.wait(guard, [&] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+
+        // Copy the decision so rollouts run without the lock
+        std::vector<rules::GameState> candidates = options;
+        int me = player;
+        Clock::time_point stop = deadline;
+        rules::Rng rng = {rules::mix(seed, static_cast<std::uint32_t>(id)), 0};
+        guard.unlock();
+
+        std::vector<long> myPoints(candidates.size(), 0);
+        std::vector<long> myPlays(candidates.size(), 0);
+        size_t next = 0;
+        for (int n = 0;; ++n) {
+            if (n % clockInterval == 0 && Clock::now() >= stop) {
+                break;
+            }
+            // Visit the options in turn so each gets the same share of the budget
+            rules::GameState state = candidates[next];
+            myPoints[next] += rollout(state, board, deck, rng, me);
+            ++myPlays[next];
+            next = (next + 1) % candidates.size();
+        }
+
+        guard.lock();
+        if (generation != seen) {
+            continue; // A newer decision started while this one ran; its tallies are stale
+        }
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            points[i] += myPoints[i];
+            plays[i] += myPlays[i];
+        }
+        if (--busy == 0) {
+            // Last worker out picks the option with the best average score
+            choice = 0;
+            rollouts = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                rollouts += plays[i];
+                if (plays[i] && (!plays[choice] || points[i] * plays[choice] > points[choice] * plays[i])) {
+                    choice = static_cast<int>(i);
+                }
+            }
+            finished.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief Starts deciding between options in the background.
+ * @param candidates State after each option is taken.
+ * @param player Player the bot decides for.
+ */
+void Bot::start(const std::vector<rules::GameState>& candidates, int player) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (candidates.empty()) {
+            choice = 0; // Nothing to decide
+            return;
+        }
+        options = candidates;
+        this->player = player;
+        deadline = Clock::now() + budget;
+        seed = rules::mix(seed, generation);
+        ++generation;
+        points.assign(candidates.size(), 0);
+        plays.assign(candidates.size(), 0);
+        busy = static_cast<int>(workers.size());
+        choice = -1;
+    }
+    wakeWorkers.notify_all();
+}
+
+/**
+ * @brief Starts choosing a path for a player in the background.
+ * @param state Current state.
+ * @param player Player the bot chooses for.
+ */
+void Bot::startPathChoice(const rules::GameState& state, int player) {
+    std::vector<rules::GameState> candidates(rules::pathCount, state);
+    for (int path = 0; path < rules::pathCount; ++path) {
+        rules::choosePath(candidates[path], player, path);
+    }
+    start(candidates, player);
+}
+
+/**
+ * @brief Checks if the decision is ready without waiting.
+ * @param result Receives the chosen option when ready.
+ * @return True if the decision is ready.
+ */
+bool Bot::poll(int& result) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (choice < 0) {
+        return false;
+    }
+    result = choice;
+    return true;
+}
+
+/**
+ * @brief Waits for the decision.
+ * @return The chosen option.
+ */
+int Bot::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [&] { return choice >= 0; });
+    return choice;
+}
+
+/**
+ * @brief Chooses a path, waiting up to the time budget.
+ * @param state Current state.
+ * @param player Player the bot chooses for.
+ * @return Path index.
+ */
+int Bot::choosePath(const rules::GameState& state, int player) {
+    startPathChoice(state, player);
+    return wait();
+}
+
+/**
+ * @brief Gets the number of rollouts behind the last decision.
+ * @return Rollouts played.
+ */
+long Bot::lastRollouts() {
+    std::lock_guard<std::mutex> guard(lock);
+    return rollouts;
+}
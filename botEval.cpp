@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Bot.h"
+#include "Rules.h"
+
+/**
+ * @file botEval.cpp
+ * @brief Plays the computer player against a random chooser and against itself and reports how it does.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwBotEval [--games N] [--budget MS] [--threads N] [--seed N] [--events events.txt]
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock; ///< Clock used to time decisions.
+
+    /**
+     * @brief Results of one matchup.
+     */
+    struct Tally {
+        int wins[rules::playerCount]; ///< Games won by each side.
+        int ties;                     ///< Tied games.
+        std::vector<double> decisionMs; ///< Time each bot decision took, in milliseconds.
+        long rollouts;                ///< Rollouts behind every bot decision.
+    };
+
+    /**
+     * @brief Plays one game in which each side chooses with its bot, or at random if it has none.
+     * @param bots Bot for each side, or nullptr for a random chooser.
+     * @param seat Player index side 0 plays; side 1 plays the other.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @param rng Random number stream for the game.
+     * @param tally Receives the result.
+     */
+    void playGame(Bot* bots[rules::playerCount], int seat, const rules::Board& board, const rules::EventDeck& deck,
+                  rules::Rng& rng, Tally& tally) {
+        rules::GameState state = rules::newGame();
+        for (int p = 0; p < rules::playerCount; ++p) {
+            int side = p == seat ? 0 : 1;
+            int path;
+            if (bots[side]) {
+                Clock::time_point start = Clock::now();
+                path = bots[side]->choosePath(state, p);
+                tally.decisionMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+                tally.rollouts += bots[side]->lastRollouts();
+            } else {
+                path = rules::uniform(rng.next(), rules::pathCount);
+            }
+            rules::choosePath(state, p, path);
+        }
+        while (!rules::gameOver(state, board)) {
+            rules::playTurn(state, board, deck, rng);
+        }
+
+        int winner = rules::winner(state);
+        if (winner < 0) {
+            ++tally.ties;
+        } else {
+            ++tally.wins[winner == seat ? 0 : 1];
+        }
+    }
+
+    /**
+     * @brief Prints the results of a matchup.
+     * @param name Name of the matchup.
+     * @param tally Results.
+     * @param games Games played.
+     */
+    void report(const std::string& name, Tally& tally, int games) {
+        std::sort(tally.decisionMs.begin(), tally.decisionMs.end());
+        double mean = 0;
+        for (double ms : tally.decisionMs) {
+            mean += ms;
+        }
+        size_t decisions = tally.decisionMs.size();
+        mean = decisions ? mean / decisions : 0;
+
+        std::cout << name << ": " << tally.wins[0] << " won, " << tally.wins[1] << " lost, " << tally.ties
+                  << " tied of " << games << " games" << std::endl;
+        if (decisions) {
+            std::cout << "  " << decisions << " decisions, mean " << mean << " ms, max " << tally.decisionMs.back()
+                      << " ms, " << tally.rollouts / static_cast<long>(decisions) << " rollouts each" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Runs the evaluation.
+ * @param argc Number of arguments.
+ * @param argv --games, --budget, --threads, --seed and --events options.
+ * @return Exit status of the program.
+ */
+int main(int argc, char* argv[]) {
+    int games = 1000;
+    double budgetMs = 5;
+    unsigned int threads = 0;
+    std::uint32_t seed = std::random_device()();
+    std::string eventsFile = "events.txt";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--games") {
+            games = std::atoi(argv[i + 1]);
+        } else if (arg == "--budget") {
+            budgetMs = std::atof(argv[i + 1]);
+        } else if (arg == "--threads") {
+            threads = static_cast<unsigned int>(std::atoi(argv[i + 1]));
+        } else if (arg == "--seed") {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (arg == "--events") {
+            eventsFile = argv[i + 1];
+        }
+    }
+
+    std::ifstream deckFile(eventsFile);
+    if (!deckFile) {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+    const rules::EventDeck deck = rules::EventDeck::parse(deckFile);
+    const rules::Board& board = rules::Board::standard();
+
+    std::chrono::microseconds budget(static_cast<long>(budgetMs * 1000));
+    Bot first(board, deck, budget, threads);
+    Bot second(board, deck, budget, threads);
+
+    // Both matchups play the same games, and each side takes each seat half the time
+    Tally versusRandom = Tally();
+    Tally versusBot = Tally();
+    for (int g = 0; g < games; ++g) {
+        Bot* withRandom[rules::playerCount] = {&first, nullptr};
+        Bot* withBot[rules::playerCount] = {&first, &second};
+        rules::Rng rng = {rules::mix(seed, g), 0};
+        playGame(withRandom, g % 2, board, deck, rng, versusRandom);
+        rng = {rules::mix(seed, g), 0};
+        playGame(withBot, g % 2, board, deck, rng, versusBot);
+    }
+
+    std::cout << "Budget " << budgetMs << " ms per decision, seed " << seed << std::endl;
+    report("Bot against random paths", versusRandom, games);
+    report("Bot against bot", versusBot, games);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include "Net.h"
+#include "Protocol.h"
+#include "Rules.h"
+
+/**
+ * @file client.cpp
+ * @brief Headless client that joins a game server, plays its seat automatically and checks every state update.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwClient [address] [--seat N]
+ * Seat 1 or 2 plays that player; seat 0 watches. Exits when the game is over.
+ */
+
+/**
+ * @brief Runs one headless client.
+ * @param argc Number of arguments.
+ * @param argv Address and --seat option.
+ * @return 0 if the game finished with every update verified.
+ */
+int main(int argc, char* argv[]) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::string address = net::defaultAddress;
+    int requested = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seat" && i + 1 < argc) {
+            requested = std::atoi(argv[++i]);
+        } else {
+            address = arg;
+        }
+    }
+
+    int fd = net::connectTo(address);
+    if (fd < 0) {
+        return 1;
+    }
+    net::Connection connection(fd);
+    std::vector<std::uint8_t> hello;
+    protocol::putVarint(hello, requested);
+    connection.send(protocol::Hello, hello);
+
+    const rules::Board& board = rules::Board::standard();
+    rules::GameState state = rules::GameState();
+    std::mt19937 gen(std::random_device{}());
+    int seat = -1;
+    bool synced = false;
+    bool waiting = false; // True while a request is in flight and its state update has not arrived
+    int updates = 0;
+
+    while (true) {
+        if (!connection.flush()) {
+            std::cerr << "Lost connection to the server" << std::endl;
+            return 1;
+        }
+        pollfd pfd = {fd, static_cast<short>(POLLIN | (connection.wantsWrite() ? POLLOUT : 0)), 0};
+        poll(&pfd, 1, 1000);
+        if (!connection.receive()) {
+            std::cerr << "Lost connection to the server" << std::endl;
+            return 1;
+        }
+
+        protocol::Message message;
+        while (connection.next(message)) {
+            const std::uint8_t* p = message.payload.data();
+            const std::uint8_t* end = p + message.payload.size();
+            std::uint32_t values[3] = {0, 0, 0};
+
+            if (message.type == protocol::Welcome && protocol::getVarint(p, end, values[0])) {
+                seat = static_cast<int>(values[0]);
+                std::cout << (seat ? "Seated as player " + std::to_string(seat) : std::string("Watching")) << std::endl;
+            } else if (message.type == protocol::State) {
+                if (!protocol::applyState(message, state)) {
+                    std::cerr << "State checksum mismatch after " << updates << " updates" << std::endl;
+                    return 1;
+                }
+                synced = true;
+                waiting = false;
+                ++updates;
+            } else if (message.type == protocol::Spun && protocol::getVarint(p, end, values[0]) &&
+                       protocol::getVarint(p, end, values[1]) && protocol::getVarint(p, end, values[2])) {
+                std::cout << "Player " << values[0] + 1 << " spun " << values[1]
+                          << (values[2] ? ", event " + std::to_string(values[2] - 1) : std::string()) << std::endl;
+            }
+        }
+
+        if (!synced) {
+            continue;
+        }
+        if (rules::gameOver(state, board)) {
+            int score1;
+            int score2;
+            rules::scores(state, score1, score2);
+            int winner = rules::winner(state);
+            std::cout << "Game over after " << updates << " verified updates: " << score1 << " to " << score2 << ", "
+                      << (winner < 0 ? std::string("tie") : "player " + std::to_string(winner + 1) + " wins")
+                      << std::endl;
+            return 0;
+        }
+
+        // Play this client's seat: pick a path once, then spin whenever it is our turn
+        if (seat > 0) {
+            int player = seat - 1;
+            if (!state.players[player].chosen && !waiting) {
+                std::vector<std::uint8_t> payload;
+                protocol::putVarint(payload, std::uniform_int_distribution<>(0, rules::pathCount - 1)(gen));
+                connection.send(protocol::ChoosePath, payload);
+                waiting = true;
+            } else if (state.turn == player && rules::canSpin(state, board) && !waiting) {
+                connection.send(protocol::Spin, std::vector<std::uint8_t>());
+                waiting = true;
+            }
+        }
+    }
+}
@@ -0,0 +1,295 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include "Assets.h"
+#include "DrawList.h"
+#include "Glyphs.h"
+
+/**
+ * @file drawList.cpp
+ * @brief Implementation file for the draw list.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @brief Constructor for the DrawList class.
+ */
+DrawList::DrawList() : built(true) {
+}
+
+/**
+ * @brief Removes every command.
+ */
+void DrawList::clear() {
+    commands.clear();
+    recorded.clear();
+    merged.clear();
+    batches.clear();
+    built = true;
+}
+
+/**
+ * @brief Checks if nothing has been recorded.
+ * @return True if the list is empty.
+ */
+bool DrawList::empty() const {
+    return commands.empty();
+}
+
+/**
+ * @brief Records a fan of triangles over a convex outline, each sharing the first corner.
+ * @param corners Outline in drawing order.
+ * @param count Number of corners.
+ * @param texture Texture, or nullptr for plain colour or an image.
+ * @param image Image in memory, or nullptr for plain colour or a texture.
+ * @param smooth True to filter between the image's texels.
+ * @param layer Layer to draw on.
+ */
+void DrawList::addFan(const sf::Vertex* corners, std::size_t count, const sf::Texture* texture, const sf::Image* image,
+                      bool smooth, int layer) {
+    if (count < 3) {
+        return;
+    }
+    const Command command = {layer, texture, image, image && smooth, recorded.size(), 3 * (count - 2)};
+    for (std::size_t i = 1; i + 1 < count; ++i) {
+        recorded.push_back(corners[0]);
+        recorded.push_back(corners[i]);
+        recorded.push_back(corners[i + 1]);
+    }
+    commands.push_back(command);
+    built = false;
+}
+
+/**
+ * @brief Records a filled rectangle.
+ * @param area Rectangle to fill.
+ * @param color Fill colour.
+ * @param layer Layer to draw on.
+ */
+void DrawList::rect(const sf::FloatRect& area, const sf::Color& color, int layer) {
+    if (color.a == 0) {
+        return;
+    }
+    const sf::Vertex corners[4] = {
+        sf::Vertex(sf::Vector2f(area.left, area.top), color),
+        sf::Vertex(sf::Vector2f(area.left + area.width, area.top), color),
+        sf::Vertex(sf::Vector2f(area.left + area.width, area.top + area.height), color),
+        sf::Vertex(sf::Vector2f(area.left, area.top + area.height), color)};
+    addFan(corners, 4, nullptr, nullptr, false, layer);
+}
+
+/**
+ * @brief Records the fill of a convex shape with its transform.
+ * @param shape Shape to fill.
+ * @param layer Layer to draw on.
+ */
+void DrawList::shape(const sf::Shape& shape, int layer) {
+    const sf::Color color = shape.getFillColor();
+    if (color.a == 0) {
+        return;
+    }
+    const sf::Transform& transform = shape.getTransform();
+    std::vector<sf::Vertex> corners;
+    for (std::size_t i = 0; i < shape.getPointCount(); ++i) {
+        corners.push_back(sf::Vertex(transform.transformPoint(shape.getPoint(i)), color));
+    }
+    addFan(corners.data(), corners.size(), nullptr, nullptr, false, layer);
+}
+
+/**
+ * @brief Records a sprite as a textured quad.
+ * @param sprite Sprite to draw.
+ * @param layer Layer to draw on.
+ */
+void DrawList::sprite(const sf::Sprite& sprite, int layer) {
+    const sf::Texture* texture = sprite.getTexture();
+    if (!texture) {
+        return;
+    }
+    addQuad(sprite.getTextureRect(), sprite.getTransform(), sprite.getColor(), texture, nullptr, false, layer);
+}
+
+/**
+ * @brief Records part of an image in memory as a quad.
+ * @param image Image to sample.
+ * @param rect Part of the image to draw, in texels.
+ * @param transform Places the quad.
+ * @param smooth True to filter between texels.
+ * @param layer Layer to draw on.
+ */
+void DrawList::image(const sf::Image& image, const sf::IntRect& rect, const sf::Transform& transform, bool smooth,
+                     int layer) {
+    addQuad(rect, transform, sf::Color::White, nullptr, &image, smooth, layer);
+}
+
+/**
+ * @brief Records a quad as big as a texture rectangle, as sf::Sprite draws it. A negative width or height flips the
+ * texture coordinates but not the quad.
+ * @param rect Part of the texture or image to draw, in texels.
+ * @param transform Places the quad.
+ * @param color Colour the texels are multiplied by.
+ * @param texture Texture, or nullptr for an image.
+ * @param image Image in memory, or nullptr for a texture.
+ * @param smooth True to filter between the image's texels.
+ * @param layer Layer to draw on.
+ */
+void DrawList::addQuad(const sf::IntRect& rect, const sf::Transform& transform, const sf::Color& color,
+                       const sf::Texture* texture, const sf::Image* image, bool smooth, int layer) {
+    const float width = static_cast<float>(std::abs(rect.width));
+    const float height = static_cast<float>(std::abs(rect.height));
+    const float left = static_cast<float>(rect.left);
+    const float top = static_cast<float>(rect.top);
+    const float right = left + rect.width;
+    const float bottom = top + rect.height;
+    const sf::Vertex corners[4] = {
+        sf::Vertex(transform.transformPoint(0, 0), color, sf::Vector2f(left, top)),
+        sf::Vertex(transform.transformPoint(width, 0), color, sf::Vector2f(right, top)),
+        sf::Vertex(transform.transformPoint(width, height), color, sf::Vector2f(right, bottom)),
+        sf::Vertex(transform.transformPoint(0, height), color, sf::Vector2f(left, bottom))};
+    addFan(corners, 4, texture, image, smooth, layer);
+}
+
+/**
+ * @brief Records a text's glyphs. Each glyph sits on the current baseline, which starts one character size down
+ * and moves down a line at every newline, as in sf::Text, and is padded by a pixel on each side so it is not
+ * clipped when smoothed.
+ * @param text Text to draw.
+ * @param layer Layer to draw on.
+ */
+void DrawList::text(const sf::Text& text, int layer) {
+    const sf::Font* font = text.getFont();
+    const sf::String& string = text.getString();
+    if (!font || string.isEmpty() || text.getFillColor().a == 0) {
+        return;
+    }
+    const unsigned size = text.getCharacterSize();
+    const bool bold = (text.getStyle() & sf::Text::Bold) != 0;
+    const float shear = (text.getStyle() & sf::Text::Italic) != 0 ? 0.209f : 0.0f;
+    float whitespace = glyphs::glyph(*font, L' ', size, bold).advance;
+    const float letterSpacing = (whitespace / 3.0f) * (text.getLetterSpacing() - 1.0f);
+    whitespace += letterSpacing;
+    const float lineSpacing = font->getLineSpacing(size) * text.getLineSpacing();
+    const sf::Transform& transform = text.getTransform();
+    const sf::Color color = text.getFillColor();
+    const float padding = 1.0f;
+
+    float x = 0;
+    float y = static_cast<float>(size);
+    sf::Uint32 previous = 0;
+    for (std::size_t i = 0; i < string.getSize(); ++i) {
+        const sf::Uint32 c = string[i];
+        if (c == L'\r') {
+            continue;
+        }
+        x += glyphs::kerning(*font, previous, c, size, bold);
+        previous = c;
+        if (c == L' ') {
+            x += whitespace;
+            continue;
+        }
+        if (c == L'\t') {
+            x += whitespace * 4;
+            continue;
+        }
+        if (c == L'\n') {
+            y += lineSpacing;
+            x = 0;
+            continue;
+        }
+
+        const sf::Glyph& glyph = glyphs::glyph(*font, c, size, bold);
+        const float left = glyph.bounds.left - padding;
+        const float top = glyph.bounds.top - padding;
+        const float right = glyph.bounds.left + glyph.bounds.width + padding;
+        const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+        const float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        const float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+        const sf::Vertex corners[4] = {
+            sf::Vertex(transform.transformPoint(x + left - shear * top, y + top), color, sf::Vector2f(u1, v1)),
+            sf::Vertex(transform.transformPoint(x + right - shear * top, y + top), color, sf::Vector2f(u2, v1)),
+            sf::Vertex(transform.transformPoint(x + right - shear * bottom, y + bottom), color, sf::Vector2f(u2, v2)),
+            sf::Vertex(transform.transformPoint(x + left - shear * bottom, y + bottom), color, sf::Vector2f(u1, v2))};
+        if (assets::inMemory()) {
+            addFan(corners, 4, nullptr, &glyphs::page(*font, size), true, layer);
+        } else {
+            addFan(corners, 4, &font->getTexture(size), nullptr, false, layer);
+        }
+        x += glyph.advance + letterSpacing;
+    }
+}
+
+/**
+ * @brief Sorts the commands by layer and texture or image, keeping recording order within each, and merges every run
+ * that shares a layer and texture or image into one batch.
+ * @return Batches in drawing order.
+ */
+const std::vector<DrawList::Batch>& DrawList::build() {
+    if (built) {
+        return batches;
+    }
+    std::vector<std::size_t> order(commands.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        const Command& x = commands[a];
+        const Command& y = commands[b];
+        if (x.layer != y.layer) {
+            return x.layer < y.layer;
+        }
+        if (x.texture != y.texture) {
+            return std::less<const sf::Texture*>()(x.texture, y.texture);
+        }
+        return x.image != y.image ? std::less<const sf::Image*>()(x.image, y.image) : x.smooth < y.smooth;
+    });
+
+    merged.clear();
+    batches.clear();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const Command& command = commands[order[i]];
+        const Command* before = i > 0 ? &commands[order[i - 1]] : nullptr;
+        if (!before || before->layer != command.layer || before->texture != command.texture ||
+            before->image != command.image || before->smooth != command.smooth) {
+            batches.push_back({command.texture, command.image, command.smooth, merged.size(), 0});
+        }
+        merged.insert(merged.end(), recorded.begin() + command.first,
+                      recorded.begin() + command.first + command.count);
+        batches.back().count += command.count;
+    }
+    built = true;
+    return batches;
+}
+
+/**
+ * @brief Gets the triangles of every batch.
+ * @return Vertices.
+ */
+const std::vector<sf::Vertex>& DrawList::vertices() const {
+    return merged;
+}
+
+/**
+ * @brief Builds the list if needed and draws every batch with one call each. Batches that sample images in memory
+ * are left to raster::Canvas.
+ * @param target Render target to draw on.
+ */
+void DrawList::draw(sf::RenderTarget& target) {
+    build();
+    for (const Batch& batch : batches) {
+        if (batch.image) {
+            continue;
+        }
+        target.draw(merged.data() + batch.first, batch.count, sf::Triangles, sf::RenderStates(batch.texture));
+    }
+}
+
+/**
+ * @brief Gets the number of commands recorded.
+ * @return Commands since the last clear().
+ */
+std::size_t DrawList::commandCount() const {
+    return commands.size();
+}
@@ -0,0 +1,576 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include "Effects.h"
+
+/**
+ * @file effects.cpp
+ * @brief Implementation file for the event effect compiler and interpreter.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const int maxStack = 32;   ///< Deepest stack a program may need; deeper expressions are rejected.
+    const int maxNesting = 64; ///< Deepest the compiler recurses, through brackets, calls, ?: and prefixes.
+
+    /**
+     * @brief Wrapping arithmetic, so overflowing expressions give a defined result.
+     */
+    std::int32_t wrap(std::int64_t value) {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(value));
+    }
+
+    /**
+     * @brief Applies a binary instruction. Shared by the interpreter and constant folding.
+     * @param op Instruction.
+     * @param a Left operand.
+     * @param b Right operand.
+     * @return Result.
+     */
+    std::int32_t binary(std::int32_t op, std::int32_t a, std::int32_t b) {
+        switch (op) {
+        case effects::Add: return wrap(static_cast<std::int64_t>(a) + b);
+        case effects::Sub: return wrap(static_cast<std::int64_t>(a) - b);
+        case effects::Mul: return wrap(static_cast<std::int64_t>(a) * b);
+        case effects::Div: return b == 0 ? 0 : wrap(static_cast<std::int64_t>(a) / b);
+        case effects::Mod: return b == 0 ? 0 : static_cast<std::int32_t>(static_cast<std::int64_t>(a) % b);
+        case effects::Less: return a < b;
+        case effects::LessEqual: return a <= b;
+        case effects::Equal: return a == b;
+        case effects::NotEqual: return a != b;
+        case effects::And: return a && b;
+        case effects::Or: return a || b;
+        case effects::Min: return a < b ? a : b;
+        case effects::Max: return a > b ? a : b;
+        default: return 0;
+        }
+    }
+
+    /**
+     * @brief Applies a unary instruction. Shared by the interpreter and constant folding.
+     * @param op Instruction.
+     * @param a Operand.
+     * @return Result.
+     */
+    std::int32_t unary(std::int32_t op, std::int32_t a) {
+        switch (op) {
+        case effects::Neg: return wrap(-static_cast<std::int64_t>(a));
+        case effects::Not: return !a;
+        case effects::Abs: return wrap(a < 0 ? -static_cast<std::int64_t>(a) : a);
+        default: return 0;
+        }
+    }
+
+    /**
+     * @class Compiler
+     * @brief Recursive descent compiler from one expression to stack code, folding constant subexpressions.
+     *
+     * Grammar, lowest precedence first:
+     *     select  := or ["?" select ":" select]
+     *     or      := and {"||" and}
+     *     and     := compare {"&&" compare}
+     *     compare := sum {("<" | "<=" | ">" | ">=" | "==" | "!=") sum}
+     *     sum     := product {("+" | "-") product}
+     *     product := prefix {("*" | "/" | "%") prefix}
+     *     prefix  := ("-" | "+" | "!") prefix | primary
+     *     primary := number | name | name "(" select {"," select} ")" | "(" select ")"
+     */
+    class Compiler {
+    private:
+        const std::string& text;           ///< Expression being compiled.
+        size_t pos;                        ///< Next character to read.
+        std::vector<std::int32_t>& code;   ///< Code being emitted.
+        std::vector<size_t> starts;        ///< Start of each value-producing instruction sequence still on the stack.
+        int depth;                         ///< Current stack depth.
+        int deepest;                       ///< Deepest stack depth reached.
+        int nesting;                       ///< Calls to select() and prefix() still running.
+        std::string error;                 ///< First error, or empty.
+
+        /**
+         * @brief Skips whitespace.
+         */
+        void skipSpaces() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+            }
+        }
+
+        /**
+         * @brief Consumes a token if it comes next.
+         * @param token Token text.
+         * @return True if the token was consumed.
+         */
+        bool accept(const char* token) {
+            skipSpaces();
+            size_t length = std::char_traits<char>::length(token);
+            if (text.compare(pos, length, token) != 0) {
+                return false;
+            }
+            // "<" must not match the start of "<=", and so on
+            if (length == 1 && pos + 1 < text.size() && text[pos + 1] == '=' && (token[0] == '<' || token[0] == '>')) {
+                return false;
+            }
+            pos += length;
+            return true;
+        }
+
+        /**
+         * @brief Consumes a token, recording an error if it does not come next.
+         * @param token Token text.
+         */
+        void expect(const char* token) {
+            if (!accept(token)) {
+                fail(std::string("expected '") + token + "'");
+            }
+        }
+
+        /**
+         * @brief Records an error unless one was already recorded.
+         * @param message Error description.
+         */
+        void fail(const std::string& message) {
+            if (error.empty()) {
+                error = message + " at column " + std::to_string(pos + 1);
+            }
+        }
+
+        /**
+         * @brief Checks if a value on the stack is a single Push.
+         * @param value Index into starts.
+         * @return True if the value is a constant.
+         */
+        bool isConstant(size_t value) const {
+            size_t end = value + 1 < starts.size() ? starts[value + 1] : code.size();
+            return code[starts[value]] == effects::Push && starts[value] + 2 == end;
+        }
+
+        /**
+         * @brief Emits an instruction that pushes one value.
+         * @param op Push or Load.
+         * @param operand Constant or input index.
+         */
+        void pushValue(std::int32_t op, std::int32_t operand) {
+            starts.push_back(code.size());
+            code.push_back(op);
+            code.push_back(operand);
+            deepest = std::max(deepest, ++depth);
+        }
+
+        /**
+         * @brief Emits an instruction that pops count values and pushes one, folding it if every operand is a
+         * constant.
+         * @param op Instruction.
+         * @param count Number of operands, 1 to 3.
+         */
+        void combine(std::int32_t op, int count) {
+            if (starts.size() < static_cast<size_t>(count)) {
+                return; // Only after an error
+            }
+            const size_t first = starts.size() - count;
+            bool constant = true;
+            for (size_t v = first; v < starts.size(); ++v) {
+                constant = constant && isConstant(v);
+            }
+            if (constant) {
+                std::int32_t values[3];
+                for (int i = 0; i < count; ++i) {
+                    values[i] = code[starts[first + i] + 1];
+                }
+                std::int32_t result = count == 1 ? unary(op, values[0])
+                                    : count == 2 ? binary(op, values[0], values[1])
+                                                 : (values[0] ? values[1] : values[2]);
+                code.resize(starts[first]);
+                starts.resize(first);
+                depth -= count;
+                pushValue(effects::Push, result);
+                return;
+            }
+            code.push_back(op);
+            starts.resize(first + 1); // The operands and the instruction now form one value
+            depth -= count - 1;
+        }
+
+        /**
+         * @brief Goes one level deeper into the expression, failing once it is nested too deeply, so a long run of
+         * brackets or signs is an error rather than a stack overflow. Every recursive rule passes through select()
+         * or prefix(), which call this first and leave() on the way out.
+         * @return False, after pushing a placeholder value, if the expression is nested too deeply.
+         */
+        bool enter() {
+            if (++nesting <= maxNesting) {
+                return true;
+            }
+            fail("expression nested too deeply");
+            pushValue(effects::Push, 0);
+            --nesting;
+            return false;
+        }
+
+        /**
+         * @brief Comes back up one level.
+         */
+        void leave() {
+            --nesting;
+        }
+
+        /**
+         * @brief Compiles c ? a : b.
+         */
+        void select() {
+            if (!enter()) {
+                return;
+            }
+            logicalOr();
+            if (accept("?")) {
+                select();
+                expect(":");
+                select();
+                combine(effects::Select, 3);
+            }
+            leave();
+        }
+
+        /**
+         * @brief Compiles ||.
+         */
+        void logicalOr() {
+            logicalAnd();
+            while (accept("||")) {
+                logicalAnd();
+                combine(effects::Or, 2);
+            }
+        }
+
+        /**
+         * @brief Compiles &&.
+         */
+        void logicalAnd() {
+            compare();
+            while (accept("&&")) {
+                compare();
+                combine(effects::And, 2);
+            }
+        }
+
+        /**
+         * @brief Compiles comparisons.
+         */
+        void compare() {
+            sum();
+            while (true) {
+                if (accept("<=")) {
+                    sum();
+                    combine(effects::LessEqual, 2);
+                } else if (accept(">=")) {
+                    sum();
+                    combine(effects::Less, 2); // a >= b is !(a < b)
+                    combine(effects::Not, 1);
+                } else if (accept("<")) {
+                    sum();
+                    combine(effects::Less, 2);
+                } else if (accept(">")) {
+                    sum();
+                    combine(effects::LessEqual, 2); // a > b is !(a <= b)
+                    combine(effects::Not, 1);
+                } else if (accept("==")) {
+                    sum();
+                    combine(effects::Equal, 2);
+                } else if (accept("!=")) {
+                    sum();
+                    combine(effects::NotEqual, 2);
+                } else {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Compiles + and -.
+         */
+        void sum() {
+            product();
+            while (true) {
+                if (accept("+")) {
+                    product();
+                    combine(effects::Add, 2);
+                } else if (accept("-")) {
+                    product();
+                    combine(effects::Sub, 2);
+                } else {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Compiles *, / and %.
+         */
+        void product() {
+            prefix();
+            while (true) {
+                if (accept("*")) {
+                    prefix();
+                    combine(effects::Mul, 2);
+                } else if (accept("/")) {
+                    prefix();
+                    combine(effects::Div, 2);
+                } else if (accept("%")) {
+                    prefix();
+                    combine(effects::Mod, 2);
+                } else {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Compiles unary operators.
+         */
+        void prefix() {
+            if (!enter()) {
+                return;
+            }
+            if (accept("-")) {
+                prefix();
+                combine(effects::Neg, 1);
+            } else if (accept("!")) {
+                prefix();
+                combine(effects::Not, 1);
+            } else if (accept("+")) {
+                prefix();
+            } else {
+                primary();
+            }
+            leave();
+        }
+
+        /**
+         * @brief Compiles numbers, names, calls and parentheses.
+         */
+        void primary() {
+            skipSpaces();
+            if (!error.empty() || pos >= text.size()) {
+                fail("expected a value");
+                pushValue(effects::Push, 0);
+                return;
+            }
+            if (accept("(")) {
+                select();
+                expect(")");
+                return;
+            }
+            if (std::isdigit(static_cast<unsigned char>(text[pos]))) {
+                size_t end = pos;
+                while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) {
+                    ++end;
+                }
+                long long value = std::atoll(text.substr(pos, end - pos).c_str());
+                pos = end;
+                pushValue(effects::Push, wrap(value));
+                return;
+            }
+            size_t end = pos;
+            while (end < text.size() && (std::isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_')) {
+                ++end;
+            }
+            std::string name = text.substr(pos, end - pos);
+            pos = end;
+            if (name == "happiness") {
+                pushValue(effects::Load, effects::Happiness);
+            } else if (name == "debt") {
+                pushValue(effects::Load, effects::Debt);
+            } else if (name == "gpa") {
+                pushValue(effects::Load, effects::Gpa);
+            } else if (name == "path") {
+                pushValue(effects::Load, effects::Path);
+            } else if (name == "space") {
+                pushValue(effects::Load, effects::Space);
+            } else if (name == "western") {
+                pushValue(effects::Push, 0);
+            } else if (name == "ivey") {
+                pushValue(effects::Push, 1);
+            } else if (name == "min" || name == "max") {
+                expect("(");
+                select();
+                expect(",");
+                select();
+                expect(")");
+                combine(name == "min" ? effects::Min : effects::Max, 2);
+            } else if (name == "abs") {
+                expect("(");
+                select();
+                expect(")");
+                combine(effects::Abs, 1);
+            } else if (name == "clamp") {
+                // clamp(x, lo, hi) is min(max(x, lo), hi)
+                expect("(");
+                select();
+                expect(",");
+                select();
+                combine(effects::Max, 2);
+                expect(",");
+                select();
+                expect(")");
+                combine(effects::Min, 2);
+            } else {
+                fail(name.empty() ? "unexpected character" : "unknown name '" + name + "'");
+                pushValue(effects::Push, 0);
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructs a compiler that appends to the given code.
+         * @param text Expression to compile.
+         * @param code Code to append to.
+         */
+        Compiler(const std::string& text, std::vector<std::int32_t>& code)
+            : text(text), pos(0), code(code), depth(0), deepest(0), nesting(0) {
+        }
+
+        /**
+         * @brief Compiles the whole expression, leaving its value on the stack.
+         * @param constant Receives the value if the expression folded to a constant.
+         * @return True if the expression folded to a constant.
+         */
+        bool compile(std::int32_t& constant) {
+            select();
+            skipSpaces();
+            if (pos < text.size()) {
+                fail("unexpected '" + text.substr(pos, 1) + "'");
+            }
+            if (deepest > maxStack) {
+                fail("expression too deep");
+            }
+            bool folded = starts.size() == 1 && isConstant(0);
+            if (folded) {
+                constant = code[starts[0] + 1];
+            }
+            return folded;
+        }
+
+        /**
+         * @brief Gets the first error.
+         * @return Error message, or empty if the expression compiled.
+         */
+        const std::string& getError() const {
+            return error;
+        }
+    };
+}
+
+/**
+ * @brief Compiles an event's effect into bytecode.
+ * @param expressions Happiness, debt and GPA expressions.
+ * @param condition Condition expression, or empty for none.
+ * @param code Receives the program, or nothing if the effect is constant.
+ * @param constants Receives the three values if the effect is constant, otherwise zeros.
+ * @param error Receives a description of the first syntax error.
+ * @return False on a syntax error.
+ */
+bool effects::compile(const std::string expressions[outputCount], const std::string& condition,
+                      std::vector<std::int32_t>& code, std::int32_t constants[outputCount], std::string& error) {
+    static const char* const names[outputCount] = {"happiness", "debt", "GPA"};
+    code.clear();
+    bool constant = true;
+
+    if (condition.find_first_not_of(" \t\r") != std::string::npos) {
+        std::int32_t value = 0;
+        Compiler compiler(condition, code);
+        bool folded = compiler.compile(value);
+        if (!compiler.getError().empty()) {
+            error = "condition: " + compiler.getError();
+            code.clear();
+            return false;
+        }
+        if (folded) {
+            code.clear();
+            if (!value) {
+                // Never applies: the effect is no change
+                for (int i = 0; i < outputCount; ++i) {
+                    constants[i] = 0;
+                }
+                return true;
+            }
+        } else {
+            constant = false;
+            code.push_back(ExitIfZero);
+        }
+    }
+
+    for (int i = 0; i < outputCount; ++i) {
+        const size_t start = code.size();
+        Compiler compiler(expressions[i], code);
+        bool folded = compiler.compile(constants[i]);
+        if (!compiler.getError().empty()) {
+            error = std::string(names[i]) + ": " + compiler.getError();
+            code.clear();
+            constants[0] = constants[1] = constants[2] = 0;
+            return false;
+        }
+        constant = constant && folded;
+        if (folded && constants[i] == 0) {
+            code.resize(start); // Outputs start at 0
+        } else {
+            code.push_back(Store);
+            code.push_back(i);
+        }
+    }
+    code.push_back(Halt);
+
+    if (constant) {
+        code.clear();
+    } else {
+        constants[0] = constants[1] = constants[2] = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a compiled effect.
+ * @param code Program from compile().
+ * @param inputs inputCount input values.
+ * @param outputs Receives the three deltas; all 0 if the condition fails.
+ */
+void effects::run(const std::int32_t* code, const std::int32_t inputs[inputCount], std::int32_t outputs[outputCount]) {
+    std::int32_t stack[maxStack];
+    int top = -1;
+    for (int i = 0; i < outputCount; ++i) {
+        outputs[i] = 0;
+    }
+    for (const std::int32_t* pc = code;;) {
+        const std::int32_t op = *pc++;
+        switch (op) {
+        case Halt:
+            return;
+        case Push:
+            stack[++top] = *pc++;
+            break;
+        case Load:
+            stack[++top] = inputs[*pc++];
+            break;
+        case Neg:
+        case Not:
+        case Abs:
+            stack[top] = unary(op, stack[top]);
+            break;
+        case Select:
+            top -= 2;
+            stack[top] = stack[top] ? stack[top + 1] : stack[top + 2];
+            break;
+        case Store:
+            outputs[*pc++] = stack[top--];
+            break;
+        case ExitIfZero:
+            if (!stack[top--]) {
+                return;
+            }
+            break;
+        default:
+            --top;
+            stack[top] = binary(op, stack[top], stack[top + 1]);
+            break;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Embedded.h"
+
+/**
+ * @file embedTool.cpp
+ * @brief Build step that turns asset files into embeddedAssets.cpp for WW_EMBED_ASSETS builds.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @brief Reads a whole file.
+ * @param file File name.
+ * @param bytes Receives the file contents.
+ * @return True if the file was read.
+ */
+bool readFile(const std::string& file, std::vector<unsigned char>& bytes) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * @brief Writes each asset as a constant byte array, compressing the ones that shrink by at least an eighth.
+ * Usage: embedTool output.cpp asset1 asset2 ...
+ * @param argc Number of arguments.
+ * @param argv Output file followed by the asset files to embed.
+ * @return Exit status of the program.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " embeddedAssets.cpp asset..." << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(argv[1]);
+    out << "// Generated by embedTool. Do not edit.\n"
+        << "#include \"Embedded.h\"\n\n"
+        << "namespace {\n";
+
+    std::vector<std::string> entries;
+    for (int i = 2; i < argc; ++i) {
+        std::vector<unsigned char> raw;
+        if (!readFile(argv[i], raw)) {
+            std::cerr << argv[i] << " failed to load" << std::endl;
+            return 1;
+        }
+
+        // Images are already compressed; text and fonts usually are not
+        std::vector<unsigned char> packed = embedded::compress(raw);
+        bool compressed = packed.size() + packed.size() / 8 < raw.size();
+        const std::vector<unsigned char>& stored = compressed ? packed : raw;
+
+        out << "    const unsigned char file" << i - 2 << "[] = {";
+        for (size_t b = 0; b < stored.size(); ++b) {
+            out << (b % 20 == 0 ? "\n        " : "") << static_cast<int>(stored[b]) << ",";
+        }
+        if (stored.empty()) {
+            out << "0";
+        }
+        out << "\n    };\n";
+
+        entries.push_back("{\"" + std::string(argv[i]) + "\", file" + std::to_string(i - 2) + ", " +
+                          std::to_string(stored.size()) + ", " + std::to_string(raw.size()) + ", " +
+                          (compressed ? "true" : "false") + "}");
+
+        std::cout << argv[i] << ": " << raw.size() << " bytes"
+                  << (compressed ? ", compressed to " + std::to_string(packed.size()) : ", stored") << std::endl;
+    }
+
+    out << "}\n\n"
+        << "namespace embedded {\n"
+        << "    extern const File files[] = {\n";
+    for (const auto& entry : entries) {
+        out << "        " << entry << ",\n";
+    }
+    out << "    };\n"
+        << "    extern const std::size_t fileCount = " << entries.size() << ";\n"
+        << "}\n";
+
+    return out ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+#include <cstring>
+#include "Embedded.h"
+
+/**
+ * @file embedded.cpp
+ * @brief Implementation file for looking up and decompressing embedded assets.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Compressed data is a list of sequences. Each starts with a token byte whose high nibble is the literal
+ * count and low nibble the match length minus 4; a nibble of 15 is followed by extra length bytes that are
+ * added until one is below 255. The literals follow, then a two byte little-endian match offset. The last
+ * sequence has literals only.
+ */
+
+#ifdef WW_EMBED_ASSETS
+namespace embedded {
+    extern const File files[];     ///< Table defined by the generated embeddedAssets.cpp.
+    extern const std::size_t fileCount; ///< Number of entries in files.
+}
+#endif
+
+namespace {
+
+    const std::size_t minMatch = 4;       ///< Shortest match worth encoding.
+    const std::size_t maxOffset = 65535;  ///< Furthest back a match may start.
+    const int hashBits = 16;              ///< Size of the match finder table, as a power of two.
+
+    /**
+     * @brief Hashes the four bytes at p for the match finder.
+     * @param p Pointer to at least four bytes.
+     * @return Index into the match finder table.
+     */
+    std::size_t hash(const unsigned char* p) {
+        unsigned int value;
+        std::memcpy(&value, p, sizeof(value));
+        return (value * 2654435761u) >> (32 - hashBits);
+    }
+
+    /**
+     * @brief Appends a length that did not fit in its token nibble.
+     * @param output Compressed bytes.
+     * @param length Length minus 15.
+     */
+    void writeLength(std::vector<unsigned char>& output, std::size_t length) {
+        while (length >= 255) {
+            output.push_back(255);
+            length -= 255;
+        }
+        output.push_back(static_cast<unsigned char>(length));
+    }
+
+    /**
+     * @brief Reads a length that did not fit in its token nibble.
+     * @param ip Read position, advanced past the length bytes.
+     * @param end End of the compressed data.
+     * @param length Receives the total length, starting from 15.
+     * @return False if the data ends early.
+     */
+    bool readLength(const unsigned char*& ip, const unsigned char* end, std::size_t& length) {
+        unsigned char byte;
+        do {
+            if (ip == end) {
+                return false;
+            }
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    /**
+     * @brief Appends one sequence of literals and an optional match.
+     * @param output Compressed bytes.
+     * @param literals First literal byte.
+     * @param literalCount Number of literal bytes.
+     * @param offset Distance back to the match, ignored if matchLength is 0.
+     * @param matchLength Length of the match, or 0 for the final sequence.
+     */
+    void writeSequence(std::vector<unsigned char>& output, const unsigned char* literals, std::size_t literalCount,
+                       std::size_t offset, std::size_t matchLength) {
+        std::size_t matchCode = matchLength ? matchLength - minMatch : 0;
+        unsigned char token = static_cast<unsigned char>(((literalCount < 15 ? literalCount : 15) << 4) |
+                                                         (matchCode < 15 ? matchCode : 15));
+        output.push_back(token);
+        if (literalCount >= 15) {
+            writeLength(output, literalCount - 15);
+        }
+        output.insert(output.end(), literals, literals + literalCount);
+
+        if (matchLength) {
+            output.push_back(static_cast<unsigned char>(offset & 0xff));
+            output.push_back(static_cast<unsigned char>(offset >> 8));
+            if (matchCode >= 15) {
+                writeLength(output, matchCode - 15);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Looks up an embedded file by name.
+ * @param name File name of the asset.
+ * @return The embedded file, or nullptr.
+ */
+const embedded::File* embedded::find(const std::string& name) {
+#ifdef WW_EMBED_ASSETS
+    for (std::size_t i = 0; i < fileCount; ++i) {
+        if (name == files[i].name) {
+            return &files[i];
+        }
+    }
+#else
+    (void)name;
+#endif
+    return nullptr;
+}
+
+/**
+ * @brief Compresses bytes using a greedy single-probe match finder.
+ * @param input Bytes to compress.
+ * @return Compressed bytes.
+ */
+std::vector<unsigned char> embedded::compress(const std::vector<unsigned char>& input) {
+    std::vector<unsigned char> output;
+    std::vector<std::size_t> table(std::size_t(1) << hashBits, static_cast<std::size_t>(-1));
+
+    const unsigned char* base = input.data();
+    std::size_t size = input.size();
+    std::size_t anchor = 0; // Start of the pending literals
+    std::size_t pos = 0;
+
+    while (size >= minMatch && pos + minMatch <= size) {
+        std::size_t h = hash(base + pos);
+        std::size_t candidate = table[h];
+        table[h] = pos;
+
+        if (candidate != static_cast<std::size_t>(-1) && pos - candidate <= maxOffset &&
+            std::memcmp(base + candidate, base + pos, minMatch) == 0) {
+            std::size_t length = minMatch;
+            while (pos + length < size && base[candidate + length] == base[pos + length]) {
+                ++length;
+            }
+            writeSequence(output, base + anchor, pos - anchor, pos - candidate, length);
+            pos += length;
+            anchor = pos;
+        } else {
+            ++pos;
+        }
+    }
+
+    writeSequence(output, base + anchor, size - anchor, 0, 0);
+    return output;
+}
+
+/**
+ * @brief Decompresses data produced by compress(), checking every bound.
+ * @param data Compressed bytes.
+ * @param size Number of compressed bytes.
+ * @param rawSize Size of the original data.
+ * @param output Receives the original bytes.
+ * @return True if the data decoded to exactly rawSize bytes.
+ */
+bool embedded::decompress(const unsigned char* data, std::size_t size, std::size_t rawSize, std::vector<unsigned char>& output) {
+    output.clear();
+    output.reserve(rawSize);
+
+    const unsigned char* ip = data;
+    const unsigned char* end = data + size;
+    while (ip < end) {
+        unsigned char token = *ip++;
+
+        std::size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(ip, end, literalCount)) {
+            return false;
+        }
+        if (static_cast<std::size_t>(end - ip) < literalCount || output.size() + literalCount > rawSize) {
+            return false;
+        }
+        output.insert(output.end(), ip, ip + literalCount);
+        ip += literalCount;
+
+        if (ip == end) {
+            break; // Final sequence has no match
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        std::size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        std::size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(ip, end, matchLength)) {
+            return false;
+        }
+        matchLength += minMatch;
+
+        if (offset == 0 || offset > output.size() || output.size() + matchLength > rawSize) {
+            return false;
+        }
+        // Byte by byte, since a match may overlap the bytes it produces
+        std::size_t from = output.size() - offset;
+        for (std::size_t i = 0; i < matchLength; ++i) {
+            output.push_back(output[from + i]);
+        }
+    }
+    return output.size() == rawSize;
+}
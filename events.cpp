@@ -1,11 +1,16 @@
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <random>
 #include <sstream>
 #include <string>
 #include <SFML/Graphics.hpp>
 #include "Events.h"
+#include "Assets.h"
+#include "DrawList.h"
+#include "Glyphs.h"
+#include "Latency.h"
+#include "Metrics.h"
+#include "Rules.h"
 
 /**
  * @file events.cpp
@@ -13,23 +18,6 @@
  * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
  */
 
-/**
- * @brief Represents an in-game event with associated attributes.
- */
-struct Event {
-    std::string description; ///< Description of the event.
-    int happinessScore;      ///< Impact on player's happiness.
-    int debtScore;           ///< Impact on player's debt.
-    int gpaScore;            ///< Impact on player's GPA.
-};
-
-/**
- * @brief Reads an event from a file.
- * @param file Input file stream.
- * @return Event object containing the details of the read event.
- */
-Event readEvent(std::ifstream& file);
-
 /**
  * @brief Wraps text to fit within a specified width.
  * @param str Input string to be wrapped.
@@ -47,19 +35,52 @@ namespace events {
      * @param window SFML RenderWindow to display the event popup.
      * @param message Message to be displayed in the popup window.
      * @param player Player object representing the game state.
+     * @return Index of the event drawn, or -1 if none could be drawn.
      */
-    void playerEvent(sf::RenderWindow& window, const std::string& message, Player& player);
-}
+    int playerEvent(sf::RenderWindow& window, const std::string& message, Player& player);
+
+    /**
+     * @brief Builds the rules view of a player, for working out event effects.
+     * @param player Player on the board.
+     * @return The player's path, space and resources.
+     */
+    rules::PlayerState playerState(const Player& player);
+
+    /**
+     * @brief Displays the popup for one event until the player closes it.
+     * @param window SFML RenderWindow to display the event popup.
+     * @param selectedEvent Event to describe.
+     * @param effect Changes the event made, from rules::eventEffect.
+     */
+    void eventPopup(sf::RenderWindow& window, const rules::Event& selectedEvent, const rules::Effect& effect);
+
+    /**
+     * @brief Records the popup for one event into a draw list.
+     * @param popup Draw list to record into.
+     * @param size Size of the target the popup is drawn on.
+     * @param selectedEvent Event to describe.
+     * @param effect Changes the event made.
+     * @return Bounds of the close button.
+     */
+    sf::FloatRect recordPopup(DrawList& popup, const sf::Vector2u& size, const rules::Event& selectedEvent,
+                              const rules::Effect& effect);
+
+    /**
+     * @brief Sets the board events are drawn on.
+     * @param board Board being played.
+     */
+    void useBoard(const rules::Board& board);
 
-Event readEvent(std::ifstream& file) {
-    Event event;
-    getline(file, event.description); // Read event description
+    /**
+     * @brief Gets the event deck, parsed from events.txt the first time it is needed.
+     * @return The shared event deck.
+     */
+    const rules::EventDeck& deck();
+}
 
-    // Read the three numbers
-    file >> event.happinessScore >> event.debtScore >> event.gpaScore;
-    file.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Skip to the next line
+namespace {
 
-    return event;
+    const rules::Board* currentBoard = &rules::Board::standard(); ///< Board events are drawn on.
 }
 
 std::string wrapText(const std::string& str, const sf::Font& font, unsigned int charSize, unsigned int maxLineWidth) {
@@ -70,7 +91,7 @@ std::string wrapText(const std::string& str, const sf::Font& font, unsigned int
 
     while (words >> word) {
         sf::Text tempText(line + word, font, charSize);
-        if (tempText.getLocalBounds().width > maxLineWidth) {
+        if (glyphs::bounds(tempText).width > maxLineWidth) {
             wrappedText += line + "\n";
             line = "";
         }
@@ -80,38 +101,80 @@ std::string wrapText(const std::string& str, const sf::Font& font, unsigned int
     return wrappedText;
 }
 
-void events::playerEvent(sf::RenderWindow& window, const std::string& message, Player& player) {
-    // Load fonts
-    sf::Font font;
-    if (!font.loadFromFile("Montserrat Medium 500.ttf")) {
-        std::cerr << "Montserrat font failed to load" << std::endl;
+rules::PlayerState events::playerState(const Player& player) {
+    rules::PlayerState state = rules::PlayerState();
+    state.path = rules::western;
+    state.index = player.getSpaceIndex();
+    state.chosen = true;
+    state.happiness = player.getHappiness();
+    state.debt = player.getDebt();
+    state.gpa = player.getGPA();
+
+    // Loaded layouts may share any stretch of road, so compare the whole path
+    const std::vector<rules::Tile>& ivey = currentBoard->paths[rules::ivey];
+    const std::vector<sf::Vector2f>& path = player.getPath();
+    bool same = path.size() == ivey.size();
+    for (size_t i = 0; same && i < path.size(); ++i) {
+        same = path[i].x == ivey[i].x && path[i].y == ivey[i].y;
     }
+    if (same) {
+        state.path = rules::ivey;
+    }
+    return state;
+}
+
+void events::useBoard(const rules::Board& board) {
+    currentBoard = &board;
+}
 
-    // Read event text from file and store in a vector
-    std::ifstream file("events.txt");
-    std::vector<Event> events;
-    while (file.peek() != EOF) {
-        events.push_back(readEvent(file));
-        file.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Skip empty lines between events
+const rules::EventDeck& events::deck() {
+    // Read event text from the deck once and keep it for every later event
+    static const rules::EventDeck deck = []() -> rules::EventDeck {
+        std::istringstream file(assets::text("events.txt"));
+        return rules::EventDeck::parse(file);
+    }();
+    return deck;
+}
+
+int events::playerEvent(sf::RenderWindow& window, const std::string& message, Player& player) {
+    const rules::EventDeck& eventDeck = deck();
+    const rules::PlayerState state = playerState(player);
+
+    // Draw from the deck for the region of the space the player landed on
+    static rules::Rng rng = {std::random_device()(), 0};
+    static rules::Bag bags[rules::regionCount] = {};
+    const int region = currentBoard->regionAt[state.path][state.index];
+    const int index = rules::drawEvent(rng, eventDeck, region, bags[region]);
+    if (index < 0) {
+        return -1; // No events can be drawn here
     }
-    file.close();
+    const rules::Event& selectedEvent = eventDeck.events[index];
+
+    // Work out the effect from the player's state; the setters add the amount they are given
+    const rules::Effect effect = rules::eventEffect(selectedEvent, state);
+    player.setHappiness(effect.happiness);
+    player.setDebt(effect.debt);
+    player.setGPA(effect.gpa);
+
+    eventPopup(window, selectedEvent, effect);
+    return index;
+}
 
-    // Randomly select an event
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(0, events.size() - 1);
-    Event selectedEvent = events[distrib(gen)];
+sf::FloatRect events::recordPopup(DrawList& popup, const sf::Vector2u& size, const rules::Event& selectedEvent,
+                                  const rules::Effect& effect) {
+    // Fonts
+    const sf::Font& font = assets::font("Montserrat Medium 500.ttf");
 
     // Apply text wrapping to the selected event description
-    const unsigned int maxLineWidth = window.getSize().x * 0.65f;  // Maximum line width in pixels
+    const unsigned int maxLineWidth = size.x * 0.65f;  // Maximum line width in pixels
     const unsigned int charSize = 24;       // Character size for the font
     std::string wrappedDescription = wrapText(selectedEvent.description, font, charSize, maxLineWidth);
 
     // Calculate position and size for popup window and text
-    float popupWidth = window.getSize().x * 0.75f;
-    float popupHeight = window.getSize().y * 0.9f;
-    float popupX = (window.getSize().x - popupWidth) / 2;
-    float popupY = (window.getSize().y - popupHeight) / 2;
+    float popupWidth = size.x * 0.75f;
+    float popupHeight = size.y * 0.9f;
+    float popupX = (size.x - popupWidth) / 2;
+    float popupY = (size.y - popupHeight) / 2;
 
     // Create popup background
     sf::RectangleShape background;
@@ -130,9 +193,9 @@ void events::playerEvent(sf::RenderWindow& window, const std::string& message, P
     // Display resources associated with the event
     sf::Text text2;
     text2.setFont(font);
-    text2.setString("Happiness: " + std::to_string(selectedEvent.happinessScore) +
-                   "\nDebt: " + std::to_string(selectedEvent.debtScore) +
-                   "\nGPA: " + std::to_string(selectedEvent.gpaScore));
+    text2.setString("Happiness: " + std::to_string(effect.happiness) +
+                   "\nDebt: " + std::to_string(effect.debt) +
+                   "\nGPA: " + std::to_string(effect.gpa));
     text2.setCharacterSize(20);
     text2.setFillColor(sf::Color::White);
     text2.setPosition(popupX + 20, popupY + 300);
@@ -140,26 +203,37 @@ void events::playerEvent(sf::RenderWindow& window, const std::string& message, P
     // Create a close button
     sf::RectangleShape closeButton(sf::Vector2f(50, 50));
     closeButton.setFillColor(sf::Color::Red);
-    closeButton.setPosition(window.getSize().x - 60, 10); // Adjust position as needed
+    closeButton.setPosition(size.x - 60, 10); // Adjust position as needed
+
+    // The close button sits outside the background, so both share a batch
+    popup.shape(background, 0);
+    popup.shape(closeButton, 0);
+    popup.text(text, 1);
+    popup.text(text2, 1);
+    return closeButton.getGlobalBounds();
+}
 
-    bool closeEventWindow = false;  // Flag to control the event window closure
+void events::eventPopup(sf::RenderWindow& window, const rules::Event& selectedEvent, const rules::Effect& effect) {
+    metrics::PopupTimer onScreen(metrics::EventPopup);
 
-    // Get the scores
-    player.setHappiness(player.getHappiness() + selectedEvent.happinessScore);
-    player.setDebt(player.getDebt() + selectedEvent.debtScore);
-    player.setGPA(player.getGPA() + selectedEvent.gpaScore);
+    // Record the popup once and replay it every frame
+    DrawList popup;
+    const sf::FloatRect closeButton = recordPopup(popup, window.getSize(), selectedEvent, effect);
+
+    bool closeEventWindow = false;  // Flag to control the event window closure
 
     while (window.isOpen()) {
         sf::Event event;
-        while (window.pollEvent(event)) {
+        while (latency::pollEvent(window, event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
             // Check if the close button is clicked
             if (event.type == sf::Event::MouseButtonPressed) {
                 if (event.mouseButton.button == sf::Mouse::Left) {
-                    if (closeButton.getGlobalBounds().contains(event.mouseButton.x, event.mouseButton.y)) {
+                    if (closeButton.contains(event.mouseButton.x, event.mouseButton.y)) {
                         closeEventWindow = true;  // Set the flag to close the event window
+                        latency::pressed(latency::PopupClose);
                     }
                 }
             }
@@ -169,10 +243,7 @@ void events::playerEvent(sf::RenderWindow& window, const std::string& message, P
             break;  // Exit the loop to close the event window
         }
 
-        window.draw(background);
-        window.draw(text);
-        window.draw(text2);
-        window.draw(closeButton);
-        window.display();
+        popup.draw(window);
+        latency::display(window);
     }
 }
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include "game.h"
+#include "Assets.h"
+#include "DrawList.h"
+#include "Latency.h"
+#include "Metrics.h"
 
 /**
  * @file gamestart.cpp
@@ -19,22 +23,13 @@ namespace gamestart {
 }
 
 bool gamestart::gamestart(sf::RenderWindow& window) {
-    // Load the popup image
-    sf::Texture popupImage;
-    if (!popupImage.loadFromFile("westernUniversity.jpg")) {
-        std::cerr << "Image failed to load" << std::endl;
-    }
+    metrics::PopupTimer onScreen(metrics::StartPopup);
 
-    // Create a sprite for the popup image
-    sf::Sprite popupSprite(popupImage);
-    float scale = 0.9f;
-    popupSprite.setScale(scale, scale);
+    // Create a sprite for the popup image, already at its on-screen size
+    sf::Sprite popupSprite = assets::sprite("westernUniversity.jpg");
 
-    // Load font for text
-    sf::Font font;
-    if (!font.loadFromFile("Lobster.ttf")) {
-        std::cerr << "Lobster font failed to load" << std::endl;
-    }
+    // Font for text
+    const sf::Font& font = assets::font("Lobster.ttf");
 
     // Create welcome text
     sf::Text welcomeText("Welcome \n to \n Western \n Wonderland!", font, 50);
@@ -57,24 +52,34 @@ bool gamestart::gamestart(sf::RenderWindow& window) {
     buttonText.setFillColor(sf::Color::Black);
     buttonText.setPosition(startButton.getPosition().x + 25, startButton.getPosition().y + 15);
 
+    // Record the popup once; the welcome text sits well above the start button, so they share a layer
+    DrawList popup;
+    popup.sprite(popupSprite, 0);
+    popup.shape(background, 0);
+    popup.text(welcomeText, 1);
+    popup.shape(startButton, 1);
+    popup.text(buttonText, 2);
+
     // Main loop for the popup
     while (window.isOpen()) {
         window.clear();
 
         // Draw elements
-        window.draw(popupSprite);
-        window.draw(background);
-        window.draw(welcomeText);
-        window.draw(startButton);
-        window.draw(buttonText);
+        popup.draw(window);
 
         // Handle events
         sf::Event event;
-        while (window.pollEvent(event)) {
+        while (latency::pollEvent(window, event)) {
             if (event.type == sf::Event::Closed) {
                 window.close();
                 return false;
             }
+
+            // Clicks also arrive as events, which is how scripted input presses the button
+            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left &&
+                startButton.getGlobalBounds().contains(event.mouseButton.x, event.mouseButton.y)) {
+                return true;
+            }
         }
 
         // Check if the start button is clicked
@@ -85,7 +90,7 @@ bool gamestart::gamestart(sf::RenderWindow& window) {
             }
         }
 
-        window.display();
+        latency::display(window);
     }
 
     return false;
@@ -1,6 +1,10 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include "GameBoard.h"
+#include "Assets.h"
+#include "Rules.h"
 
 /**
  * @file GameBoard.cpp
@@ -8,79 +12,171 @@
  * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
  */
 
+namespace {
+
+    const sf::Color Crossing(123, 123, 123);     ///< Spaces where the paths split or join.
+    const sf::Color Road(90, 90, 90);            ///< Spaces both paths share.
+    const sf::Color WesternPurple(79, 38, 131);  ///< Spaces only on the Western path.
+    const sf::Color IveyGreen(3, 70, 56);        ///< Spaces only on the Ivey path.
+    const sf::Color EventColour(67, 87, 31);     ///< Event spaces.
+
+    /**
+     * @brief A tile of a loaded layout and the colour it is drawn in.
+     */
+    struct Paint {
+        std::uint64_t key; ///< Chunk, then row and column, so sorting groups tiles by chunk.
+        int x;             ///< Column.
+        int y;             ///< Row.
+        int rank;          ///< Higher ranks win when several colours land on one tile.
+        sf::Color color;   ///< Fill colour.
+    };
+}
+
 /**
- * @brief Constructs a GameBoard object with default settings.
+ * @brief Constructs a GameBoard object for a board.
+ * @param board Board to draw.
  */
-GameBoard::GameBoard()
-    : tileSize(40),
-      boardSize(11),
+GameBoard::GameBoard(const rules::Board& board)
+    : tileSize(board.tileSize),
+      boardSize(board.columns),
       customColor1(sf::Color(249, 249, 249)),
-      customColor2(sf::Color(241, 241, 241)) {
-
-    // Ivey path
-    iveyPath.push_back(sf::Vector2f(220, 420)); // start
-    iveyPath.push_back(sf::Vector2f(220, 380)); // crossing 1
-    iveyPath.push_back(sf::Vector2f(260, 380));
-    iveyPath.push_back(sf::Vector2f(300, 380));
-    iveyPath.push_back(sf::Vector2f(340, 380));
-    iveyPath.push_back(sf::Vector2f(380, 380));
-    iveyPath.push_back(sf::Vector2f(380, 340));
-    iveyPath.push_back(sf::Vector2f(380, 300));
-    iveyPath.push_back(sf::Vector2f(380, 260));
-    iveyPath.push_back(sf::Vector2f(340, 260));
-    iveyPath.push_back(sf::Vector2f(300, 260));
-    iveyPath.push_back(sf::Vector2f(260, 260)); // crossing 2
-    iveyPath.push_back(sf::Vector2f(260, 220));
-    iveyPath.push_back(sf::Vector2f(260, 180));
-    iveyPath.push_back(sf::Vector2f(300, 180));
-    iveyPath.push_back(sf::Vector2f(340, 180));
-    iveyPath.push_back(sf::Vector2f(380, 180));
-    iveyPath.push_back(sf::Vector2f(380, 140));
-    iveyPath.push_back(sf::Vector2f(380, 100));
-    iveyPath.push_back(sf::Vector2f(340, 100));
-    iveyPath.push_back(sf::Vector2f(300, 100));
-    iveyPath.push_back(sf::Vector2f(260, 100));
-    iveyPath.push_back(sf::Vector2f(220, 100));
-    iveyPath.push_back(sf::Vector2f(180, 100)); //end
-
-    // Western path
-    westernPath.push_back(sf::Vector2f(220, 420)); // start
-    westernPath.push_back(sf::Vector2f(220, 380)); // crossing 1
-    westernPath.push_back(sf::Vector2f(180, 380));
-    westernPath.push_back(sf::Vector2f(140, 380));
-    westernPath.push_back(sf::Vector2f(100, 380));
-    westernPath.push_back(sf::Vector2f(60, 380));
-    westernPath.push_back(sf::Vector2f(60, 340));
-    westernPath.push_back(sf::Vector2f(60, 300));
-    westernPath.push_back(sf::Vector2f(60, 260));
-    westernPath.push_back(sf::Vector2f(60, 220));
-    westernPath.push_back(sf::Vector2f(100, 220));
-    westernPath.push_back(sf::Vector2f(140, 220));
-    westernPath.push_back(sf::Vector2f(180, 220));
-    westernPath.push_back(sf::Vector2f(180, 260));
-    westernPath.push_back(sf::Vector2f(220, 260));
-    westernPath.push_back(sf::Vector2f(260, 260)); // crossing 2
-    westernPath.push_back(sf::Vector2f(260, 220));
-    westernPath.push_back(sf::Vector2f(260, 180));
-    westernPath.push_back(sf::Vector2f(300, 180));
-    westernPath.push_back(sf::Vector2f(340, 180));
-    westernPath.push_back(sf::Vector2f(380, 180));
-    westernPath.push_back(sf::Vector2f(380, 140));
-    westernPath.push_back(sf::Vector2f(380, 100));
-    westernPath.push_back(sf::Vector2f(340, 100));
-    westernPath.push_back(sf::Vector2f(300, 100));
-    westernPath.push_back(sf::Vector2f(260, 100));
-    westernPath.push_back(sf::Vector2f(220, 100));
-    westernPath.push_back(sf::Vector2f(180, 100)); //end
-
-    // Event spaces
-    eventSpaces.push_back(sf::Vector2f(140, 380)); // first Western square - missing others
-    eventSpaces.push_back(sf::Vector2f(340, 380)); // first Ivey
-    eventSpaces.push_back(sf::Vector2f(380, 300)); // second Ivey
-    eventSpaces.push_back(sf::Vector2f(60, 300));
-    eventSpaces.push_back(sf::Vector2f(140, 220));
-    eventSpaces.push_back(sf::Vector2f(300, 180));
-    eventSpaces.push_back(sf::Vector2f(380, 140));
+      customColor2(sf::Color(241, 241, 241)),
+      layout(board),
+      pictured(&board == &rules::Board::standard()),
+      chunkColumns(0),
+      chunkRows(0) {
+
+    // Paths and event spaces come from the headless rules so both agree on the board
+    for (const auto& tile : layout.paths[rules::ivey]) {
+        iveyPath.push_back(sf::Vector2f(tile.x, tile.y));
+    }
+    for (const auto& tile : layout.paths[rules::western]) {
+        westernPath.push_back(sf::Vector2f(tile.x, tile.y));
+    }
+    for (const auto& tile : layout.eventSpaces) {
+        eventSpaces.push_back(sf::Vector2f(tile.x, tile.y));
+    }
+    if (!pictured) {
+        buildChunks();
+    }
+}
+
+/**
+ * @brief Gets the board being drawn.
+ * @return The rules view of the board.
+ */
+const rules::Board& GameBoard::getLayout() const {
+    return layout;
+}
+
+/**
+ * @brief Colours every tile of a loaded layout the way the standard board is coloured and bakes them into one
+ * vertex buffer per chunk. Tiles off both paths stay empty, so a chunk costs nothing to draw if no path crosses it.
+ */
+void GameBoard::buildChunks() {
+    chunkColumns = (layout.columns + chunkTiles - 1) / chunkTiles;
+    chunkRows = (layout.rows + chunkTiles - 1) / chunkTiles;
+    chunks.resize(static_cast<size_t>(chunkColumns) * chunkRows);
+
+    std::vector<Paint> paints;
+    auto paint = [&](const rules::Tile& tile, int rank, const sf::Color& color) {
+        const int x = tile.x / tileSize;
+        const int y = tile.y / tileSize;
+        const std::uint64_t chunk = static_cast<std::uint64_t>(y / chunkTiles) * chunkColumns + x / chunkTiles;
+        paints.push_back({(chunk << 20 | static_cast<std::uint64_t>(y % chunkTiles)) << 20 | x % chunkTiles,
+                          x, y, rank, color});
+    };
+    for (int path = 0; path < rules::pathCount; ++path) {
+        const std::vector<rules::Tile>& tiles = layout.paths[path];
+        const std::vector<unsigned char>& region = layout.regionAt[path];
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            if (region[i] != rules::sharedRoad) {
+                paint(tiles[i], 0, path == rules::western ? WesternPurple : IveyGreen);
+            } else if ((i > 0 && region[i - 1] != rules::sharedRoad) ||
+                       (i + 1 < tiles.size() && region[i + 1] != rules::sharedRoad)) {
+                paint(tiles[i], 2, Crossing);
+            } else {
+                paint(tiles[i], 1, Road);
+            }
+        }
+        paint(tiles.front(), 4, sf::Color::Green);
+        paint(tiles.back(), 4, sf::Color::Red);
+    }
+    for (const auto& tile : layout.eventSpaces) {
+        paint(tile, 3, EventColour);
+    }
+
+    // Keep the highest ranked colour of each tile, then give every chunk its quads
+    std::sort(paints.begin(), paints.end(), [](const Paint& a, const Paint& b) {
+        return a.key != b.key ? a.key < b.key : a.rank > b.rank;
+    });
+    const bool buffered = sf::VertexBuffer::isAvailable();
+    const float size = static_cast<float>(tileSize);
+    std::vector<sf::Vertex> quads;
+    for (size_t i = 0; i < paints.size();) {
+        const std::uint64_t chunk = paints[i].key >> 40;
+        quads.clear();
+        for (; i < paints.size() && paints[i].key >> 40 == chunk; ++i) {
+            if (i > 0 && paints[i].key == paints[i - 1].key) {
+                continue;
+            }
+            const sf::Vector2f corner(paints[i].x * size, paints[i].y * size);
+            quads.push_back(sf::Vertex(corner, paints[i].color));
+            quads.push_back(sf::Vertex(corner + sf::Vector2f(size, 0), paints[i].color));
+            quads.push_back(sf::Vertex(corner + sf::Vector2f(size, size), paints[i].color));
+            quads.push_back(sf::Vertex(corner + sf::Vector2f(0, size), paints[i].color));
+        }
+
+        Chunk& target = chunks[chunk];
+        target.count = quads.size();
+        target.buffer.setPrimitiveType(sf::Quads);
+        target.buffer.setUsage(sf::VertexBuffer::Static);
+        if (buffered && target.buffer.create(quads.size()) && target.buffer.update(quads.data())) {
+            continue;
+        }
+        target.vertices = sf::VertexArray(sf::Quads, quads.size());
+        for (size_t v = 0; v < quads.size(); ++v) {
+            target.vertices[v] = quads[v];
+        }
+    }
+}
+
+/**
+ * @brief Draws the chunks that overlap the target's view, walking only the rows and columns of chunks in view so
+ * the cost follows the visible area rather than the size of the board.
+ * @param target Render target to draw on.
+ */
+void GameBoard::drawChunks(sf::RenderTarget& target) {
+    const sf::View& view = target.getView();
+    const sf::FloatRect seen(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+    sf::FloatRect shown;
+    if (!seen.intersects(getBounds(), shown)) {
+        return;
+    }
+
+    sf::RectangleShape ground(sf::Vector2f(shown.width, shown.height));
+    ground.setPosition(shown.left, shown.top);
+    ground.setFillColor(customColor2);
+    target.draw(ground);
+
+    const float chunkSize = static_cast<float>(tileSize * chunkTiles);
+    const int firstColumn = static_cast<int>(shown.left / chunkSize);
+    const int firstRow = static_cast<int>(shown.top / chunkSize);
+    const int lastColumn = std::min(chunkColumns - 1, static_cast<int>((shown.left + shown.width) / chunkSize));
+    const int lastRow = std::min(chunkRows - 1, static_cast<int>((shown.top + shown.height) / chunkSize));
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            Chunk& chunk = chunks[static_cast<size_t>(row) * chunkColumns + column];
+            if (chunk.count == 0) {
+                continue;
+            }
+            if (chunk.vertices.getVertexCount() > 0) {
+                target.draw(chunk.vertices);
+            } else {
+                target.draw(chunk.buffer, 0, chunk.count);
+            }
+        }
+    }
 }
 
 /**
@@ -108,27 +204,59 @@ const std::vector<sf::Vector2f>& GameBoard::getEventSpaces() const {
 }
 
 /**
- * @brief Draws the game board on the specified SFML RenderWindow.
- * @param window SFML RenderWindow to draw the game board on.
+ * @brief Gets the area covered by the board.
+ * @return Bounding rectangle of all tiles.
  */
-void GameBoard::draw(sf::RenderWindow &window) {
-    sf::Color Crossing(123, 123, 123);
-    sf::Color Road(90, 90, 90);
-    sf::Color WesternPurple(79, 38, 131);
-    sf::Color IveyGreen(3, 70, 56);
-    sf::Color EventColour(67, 87, 31);
-
-    sf::Texture background;
-    if (!background.loadFromFile("westernUniversity.jpg")) {
-        // Handle error if the image can't be loaded
+sf::FloatRect GameBoard::getBounds() const {
+    return sf::FloatRect(0, 0, tileSize * layout.columns, tileSize * layout.rows);
+}
+
+/**
+ * @brief Draws the board as part of the scene.
+ * @param target Render target to draw on.
+ */
+void GameBoard::render(sf::RenderTarget& target) {
+    draw(target);
+}
+
+/**
+ * @brief Draws the game board on the specified render target, over the campus picture for the standard board.
+ * @param window SFML RenderWindow or RenderTexture to draw the game board on.
+ */
+void GameBoard::draw(sf::RenderTarget &window) {
+    if (!pictured) {
+        drawChunks(window);
+        return;
+    }
+    if (picture.empty()) {
+        recordPicture();
     }
+    picture.draw(window);
+}
 
-    sf::Sprite backgroundImage;
-    backgroundImage.setTexture(background);
+/**
+ * @brief Draws the standard game board into a software canvas, over the campus picture.
+ * @param canvas Canvas to draw the game board on.
+ * @param transform Maps board pixels onto the canvas.
+ * @return False for a loaded layout, whose tiles are only in vertex buffers.
+ */
+bool GameBoard::draw(raster::Canvas& canvas, const sf::Transform& transform) {
+    if (!pictured) {
+        return false;
+    }
+    if (picture.empty()) {
+        recordPicture();
+    }
+    canvas.draw(picture, transform);
+    return true;
+}
 
-    float scale = 0.9f;
-    backgroundImage.setScale(scale, scale);
-    window.draw(backgroundImage);
+/**
+ * @brief Records the campus picture and the coloured squares of the standard board into the draw list. Transparent
+ * squares are skipped, so the whole board replays as two batches.
+ */
+void GameBoard::recordPicture() {
+    assets::record(picture, "westernUniversity.jpg");
 
     for (int i = 0; i < boardSize; ++i) {
         for (int j = 0; j < boardSize; ++j) {
@@ -189,7 +317,7 @@ void GameBoard::draw(sf::RenderWindow &window) {
                 square.setFillColor(EventColour);
             }
 
-            window.draw(square);
+            picture.shape(square, 1);
         }
     }
 }
@@ -0,0 +1,684 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GameStore.h"
+
+/**
+ * @file gameStore.cpp
+ * @brief Implementation file for the columnar store of simulated game results.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const std::uint32_t fileMagic = 0x53475757;  ///< "WWGS" at the start of a store file.
+    const std::uint32_t blockMagic = 0x31425757; ///< "WWB1" at the start of every block.
+    const std::uint32_t version = 2;             ///< Format version written after the file magic; 2 added checksums.
+    const std::size_t fileHeaderBytes = 12;      ///< Magic, version and column count.
+    const std::size_t blockHeaderBytes = 4 * (3 + store::columnCount); ///< Magic, rows, column lengths and checksum.
+    const std::uint64_t checksumBasis = 14695981039346656037ull; ///< FNV-1a offset basis.
+    const std::uint64_t checksumPrime = 1099511628211ull;        ///< FNV-1a prime.
+
+    /**
+     * @brief How a column's values are turned into bytes.
+     */
+    enum Encoding {
+        Byte,   ///< One signed byte per value.
+        Varint, ///< Unsigned LEB128 varint.
+        Zigzag, ///< Varint of the value with its sign folded into the lowest bit.
+        Delta   ///< Zigzag of the difference from the column's previous value in the block.
+    };
+
+    const Encoding encodings[store::columnCount] = {Delta,  Byte,   Byte,   Byte,   Varint, Zigzag, Zigzag, Zigzag,
+                                                    Zigzag, Zigzag, Zigzag, Varint, Varint, Delta,  Delta};
+    const char* const columnNames[store::columnCount] = {
+        "game",   "path1",  "path2", "winner",      "spins",       "happiness1", "happiness2", "debt1",
+        "debt2",  "gpa1",   "gpa2",  "eventCount1", "eventCount2", "events1",    "events2"};
+
+    /**
+     * @brief Appends a 32-bit value, lowest byte first.
+     * @param out Buffer to append to.
+     * @param value Value.
+     */
+    void put32(std::string& out, std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out += static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    /**
+     * @brief Reads a 32-bit value stored lowest byte first.
+     * @param p First byte.
+     * @return The value.
+     */
+    std::uint32_t get32(const unsigned char* p) {
+        return p[0] | p[1] << 8 | p[2] << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+    }
+
+    /**
+     * @brief Continues a block checksum over some bytes. This is 64-bit FNV-1a taken eight bytes at a time, read
+     * lowest byte first, with the last few bytes one at a time, so checking a block costs little next to reading it.
+     * @param hash Checksum so far, or checksumBasis to start.
+     * @param p First byte.
+     * @param count Number of bytes.
+     * @return The checksum including the bytes.
+     */
+    std::uint64_t checksum(std::uint64_t hash, const unsigned char* p, std::size_t count) {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            hash = (hash ^ (get32(p + i) | static_cast<std::uint64_t>(get32(p + i + 4)) << 32)) * checksumPrime;
+        }
+        for (; i < count; ++i) {
+            hash = (hash ^ p[i]) * checksumPrime;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Works out the checksum stored at the end of a block header: the block's row count, column lengths
+     * and columns, folded to 32 bits.
+     * @param header Block header.
+     * @param columns The block's columns, straight after the header in the file.
+     * @param length Total length of the columns.
+     * @return The checksum.
+     */
+    std::uint32_t blockChecksum(const unsigned char* header, const unsigned char* columns, std::size_t length) {
+        const std::uint64_t hash = checksum(checksum(checksumBasis, header + 4, blockHeaderBytes - 8), columns,
+                                            length);
+        return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+    }
+
+    /**
+     * @brief Appends a varint: seven bits per byte, lowest first, with the top bit set on all but the last byte.
+     * @param out Buffer to append to.
+     * @param value Value.
+     */
+    void putVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    /**
+     * @brief Folds a signed value's sign into its lowest bit, so small negative values stay small.
+     * @param value Value.
+     * @return The folded value.
+     */
+    std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    /**
+     * @brief Undoes zigzag().
+     * @param value Folded value.
+     * @return The signed value.
+     */
+    std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    /**
+     * @brief Writes a whole buffer, retrying short writes.
+     * @param fd File to write to.
+     * @param data Bytes to write.
+     * @return False if the write failed.
+     */
+    bool writeAll(int fd, const std::string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks a file header and walks the blocks after it, one header at a time. A block counts if its header
+     * is whole, its columns fit in the file and its checksum matches; the walk stops at the first that does not.
+     * @param size Length of the file.
+     * @param read Called with an offset and a length to get those bytes of the file, or nullptr if they could not
+     * be read. The bytes only need to last until the next call.
+     * @param visit Called with each complete block's offset, row count and column lengths.
+     * @return Bytes up to the end of the last complete block, or 0 if the file is not a store of this version.
+     */
+    template <typename Read, typename Visit>
+    std::size_t walkBlocks(std::size_t size, Read read, Visit visit) {
+        const unsigned char* file = size >= fileHeaderBytes ? read(0, fileHeaderBytes) : nullptr;
+        if (!file || get32(file) != fileMagic || get32(file + 4) != version ||
+            get32(file + 8) != store::columnCount) {
+            return 0;
+        }
+        std::size_t at = fileHeaderBytes;
+        while (size - at >= blockHeaderBytes) {
+            const unsigned char* bytes = read(at, blockHeaderBytes);
+            if (!bytes || get32(bytes) != blockMagic) {
+                break;
+            }
+            unsigned char header[blockHeaderBytes];
+            std::memcpy(header, bytes, blockHeaderBytes); // The columns may be read into the same buffer
+
+            std::uint32_t lengths[store::columnCount];
+            std::size_t length = 0;
+            for (int c = 0; c < store::columnCount; ++c) {
+                lengths[c] = get32(header + 8 + 4 * c);
+                length += lengths[c];
+            }
+            const std::uint32_t rows = get32(header + 4);
+            if (length > size - at - blockHeaderBytes || rows > store::blockRows) {
+                break; // Cut short by a crash while the block was written
+            }
+            const unsigned char* columns = read(at + blockHeaderBytes, length);
+            if (!columns || blockChecksum(header, columns, length) != get32(header + blockHeaderBytes - 4)) {
+                break; // Written as zeros or garbage by a crash, or damaged since
+            }
+            visit(at, rows, lengths);
+            at += blockHeaderBytes + length;
+        }
+        return at;
+    }
+}
+
+/**
+ * @brief Gets a column's name as the tools print it.
+ * @param column Column.
+ * @return The name.
+ */
+const char* store::columnName(Column column) {
+    return columnNames[column];
+}
+
+/**
+ * @brief Constructor for the BlockBuilder class.
+ */
+store::BlockBuilder::BlockBuilder() : last(), rows(0) {
+}
+
+/**
+ * @brief Adds a game to the block, appending each of its values to its column.
+ * @param row The game.
+ */
+void store::BlockBuilder::add(const Row& row) {
+    const std::int64_t values[Events1] = {static_cast<std::int64_t>(row.game), row.paths[0], row.paths[1],
+                                          row.winner, row.spins, row.happiness[0], row.happiness[1], row.debt[0],
+                                          row.debt[1], row.gpa[0], row.gpa[1],
+                                          static_cast<std::int64_t>(row.events[0].size()),
+                                          static_cast<std::int64_t>(row.events[1].size())};
+    for (int c = 0; c < Events1; ++c) {
+        std::string& out = columns[c];
+        switch (encodings[c]) {
+        case Byte:
+            out += static_cast<char>(values[c]);
+            break;
+        case Varint:
+            putVarint(out, static_cast<std::uint64_t>(values[c]));
+            break;
+        case Zigzag:
+            putVarint(out, zigzag(values[c]));
+            break;
+        case Delta:
+            putVarint(out, zigzag(values[c] - last[c]));
+            last[c] = values[c];
+            break;
+        }
+    }
+
+    // Sorted ids make the differences small, and repeats cost a single zero byte
+    for (int p = 0; p < 2; ++p) {
+        const int c = Events1 + p;
+        sorted.assign(row.events[p].begin(), row.events[p].end());
+        std::sort(sorted.begin(), sorted.end());
+        for (std::uint16_t event : sorted) {
+            putVarint(columns[c], zigzag(event - last[c]));
+            last[c] = event;
+        }
+    }
+    ++rows;
+}
+
+/**
+ * @brief Gets the number of games in the block.
+ * @return Games added since the last finish().
+ */
+std::uint32_t store::BlockBuilder::size() const {
+    return rows;
+}
+
+/**
+ * @brief Appends the finished block and starts a new empty one.
+ * @param out Buffer to append to.
+ */
+void store::BlockBuilder::finish(std::string& out) {
+    const std::size_t start = out.size();
+    put32(out, blockMagic);
+    put32(out, rows);
+    for (int c = 0; c < columnCount; ++c) {
+        put32(out, static_cast<std::uint32_t>(columns[c].size()));
+    }
+    put32(out, 0); // Checksum, filled in below
+    for (int c = 0; c < columnCount; ++c) {
+        out += columns[c];
+        columns[c].clear();
+        last[c] = 0;
+    }
+    rows = 0;
+
+    const unsigned char* block = reinterpret_cast<const unsigned char*>(out.data()) + start;
+    const std::uint32_t sum = blockChecksum(block, block + blockHeaderBytes, out.size() - start - blockHeaderBytes);
+    for (int i = 0; i < 4; ++i) {
+        out[start + blockHeaderBytes - 4 + i] = static_cast<char>(sum >> (8 * i));
+    }
+}
+
+/**
+ * @brief Constructor for the Writer class.
+ */
+store::Writer::Writer() : fd(-1) {
+}
+
+/**
+ * @brief Destructor for the Writer class.
+ */
+store::Writer::~Writer() {
+    close();
+}
+
+/**
+ * @brief Opens a store file for appending. A new file gets a header; an existing one is checked and cut back to
+ * its last complete block, so the next block follows straight on from it. Blocks are read one at a time, so
+ * checking a large store takes no more memory than its largest block.
+ * @param path File name.
+ * @return False if the file could not be opened or is not a store.
+ */
+bool store::Writer::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        std::cerr << "Cannot open store " << path << std::endl;
+        close();
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+
+    std::string buffer;
+    auto read = [this, &buffer](std::size_t at, std::size_t length) -> const unsigned char* {
+        buffer.resize(length);
+        std::size_t done = 0;
+        while (done < length) {
+            ssize_t n = ::pread(fd, &buffer[done], length - done, static_cast<off_t>(at + done));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return nullptr;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        return reinterpret_cast<const unsigned char*>(buffer.data());
+    };
+
+    std::size_t end = 0;
+    if (size == 0) {
+        std::string header;
+        put32(header, fileMagic);
+        put32(header, version);
+        put32(header, columnCount);
+        end = header.size();
+        if (!writeAll(fd, header)) {
+            end = 0;
+        }
+    } else {
+        end = walkBlocks(size, read, [](std::size_t, std::uint32_t, const std::uint32_t*) {});
+        if (end == 0) {
+            std::cerr << path << " is not a game store, or was written by another version" << std::endl;
+        } else if (end < size) {
+            std::cerr << "Dropping " << size - end << " bytes of unfinished or damaged blocks from " << path
+                      << std::endl;
+        }
+    }
+    if (end == 0 || ::ftruncate(fd, static_cast<off_t>(end)) != 0 || ::lseek(fd, 0, SEEK_END) < 0) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Appends a block in one write, so blocks from different threads never interleave.
+ * @param block Encoded block.
+ * @return False if the write failed.
+ */
+bool store::Writer::append(const std::string& block) {
+    std::lock_guard<std::mutex> lock(writing);
+    if (fd < 0 || !writeAll(fd, block)) {
+        std::cerr << "Failed to write to the store" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Syncs the file to disk and closes it.
+ * @return False if the sync failed.
+ */
+bool store::Writer::close() {
+    if (fd < 0) {
+        return true;
+    }
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    fd = -1;
+    return synced;
+}
+
+/**
+ * @brief Constructor for the Reader class.
+ */
+store::Reader::Reader() : fd(-1), data(nullptr), size(0), rows(0) {
+}
+
+/**
+ * @brief Destructor for the Reader class.
+ */
+store::Reader::~Reader() {
+    close();
+}
+
+/**
+ * @brief Maps a store file and finds its blocks.
+ * @param path File name.
+ * @return False if the file could not be read or is not a store.
+ */
+bool store::Reader::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        std::cerr << "Cannot open store " << path << std::endl;
+        close();
+        return false;
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size > 0) {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Cannot map store " << path << std::endl;
+            close();
+            return false;
+        }
+        data = static_cast<const unsigned char*>(mapped);
+        ::madvise(mapped, size, MADV_SEQUENTIAL);
+    }
+
+    const unsigned char* mapped = data;
+    auto read = [mapped](std::size_t at, std::size_t) { return mapped + at; };
+    const std::size_t end = walkBlocks(size, read, [this](std::size_t at, std::uint32_t count,
+                                                          const std::uint32_t* bytes) {
+        Block block;
+        block.rows = count;
+        std::size_t offset = at + blockHeaderBytes;
+        for (int c = 0; c < columnCount; ++c) {
+            block.offset[c] = offset;
+            block.bytes[c] = bytes[c];
+            offset += bytes[c];
+        }
+        blocks.push_back(block);
+        rows += count;
+    });
+    if (end == 0) {
+        std::cerr << path << " is not a game store, or was written by another version" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Unmaps and closes the file.
+ */
+void store::Reader::close() {
+    if (data) {
+        ::munmap(const_cast<unsigned char*>(data), size);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    fd = -1;
+    data = nullptr;
+    size = 0;
+    blocks.clear();
+    rows = 0;
+}
+
+/**
+ * @brief Gets the number of games in the store.
+ * @return Games in every complete block.
+ */
+std::uint64_t store::Reader::rowCount() const {
+    return rows;
+}
+
+/**
+ * @brief Gets the number of blocks in the store.
+ * @return Complete blocks.
+ */
+std::size_t store::Reader::blockCount() const {
+    return blocks.size();
+}
+
+/**
+ * @brief Gets the number of games in a block.
+ * @param block Block index.
+ * @return Games in the block.
+ */
+std::uint32_t store::Reader::blockRows(std::size_t block) const {
+    return blocks[block].rows;
+}
+
+/**
+ * @brief Gets the space a column takes across the whole store.
+ * @param column Column.
+ * @return Encoded bytes.
+ */
+std::uint64_t store::Reader::columnBytes(Column column) const {
+    std::uint64_t total = 0;
+    for (const Block& block : blocks) {
+        total += block.bytes[column];
+    }
+    return total;
+}
+
+/**
+ * @brief Decodes one column of a block. Only reads the mapped file, so any number of threads may decode at once.
+ * @param block Block index.
+ * @param column Column.
+ * @param values Receives the column's values.
+ * @return False if the column is corrupt.
+ */
+bool store::Reader::decode(std::size_t block, Column column, std::vector<std::int64_t>& values) const {
+    values.clear();
+    const unsigned char* p = data + blocks[block].offset[column];
+    const unsigned char* const end = p + blocks[block].bytes[column];
+    const Encoding encoding = encodings[column];
+    if (encoding == Byte) {
+        values.reserve(end - p);
+        for (; p < end; ++p) {
+            values.push_back(static_cast<signed char>(*p));
+        }
+        return values.size() == blocks[block].rows;
+    }
+
+    values.reserve(column >= Events1 ? (end - p) : blocks[block].rows);
+    std::int64_t previous = 0;
+    while (p < end) {
+        std::uint64_t value = 0;
+        int shift = 0;
+        while (p < end && (*p & 0x80) && shift < 63) {
+            value |= static_cast<std::uint64_t>(*p++ & 0x7F) << shift;
+            shift += 7;
+        }
+        if (p == end) {
+            std::cerr << "Store column " << columnNames[column] << " is corrupt in block " << block << std::endl;
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(*p++) << shift;
+
+        if (encoding == Varint) {
+            values.push_back(static_cast<std::int64_t>(value));
+        } else if (encoding == Zigzag) {
+            values.push_back(unzigzag(value));
+        } else {
+            previous += unzigzag(value);
+            values.push_back(previous);
+        }
+    }
+    if (column < Events1 && values.size() != blocks[block].rows) {
+        std::cerr << "Store column " << columnNames[column] << " is corrupt in block " << block << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the number of groups a key can have.
+ * @param key Key.
+ * @return Size of the vector aggregate() fills.
+ */
+std::size_t store::groupCount(Key key) {
+    switch (key) {
+    case ByPair:
+        return 4;
+    case ByPath:
+        return 2;
+    case ByEvent:
+        return 65536;
+    case ByWinner:
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief Scans a store on several threads and totals every group. Each thread keeps its own totals and decodes
+ * only the columns the key needs, a block at a time; the totals are added together at the end.
+ * @param reader Open store.
+ * @param key What to group by.
+ * @param threads Number of threads to scan with.
+ * @param groups Receives the totals.
+ * @return False if a block is corrupt.
+ */
+bool store::aggregate(const Reader& reader, Key key, int threads, std::vector<Aggregate>& groups) {
+    const std::size_t count = groupCount(key);
+    threads = std::max(1, std::min<int>(threads, static_cast<int>(reader.blockCount())));
+    std::vector<std::vector<Aggregate>> partial(threads, std::vector<Aggregate>(count, Aggregate()));
+    std::atomic<std::size_t> nextBlock(0);
+    std::atomic<bool> failed(false);
+
+    auto scan = [&](int thread) {
+        std::vector<Aggregate>& totals = partial[thread];
+        std::vector<std::int64_t> columns[columnCount];
+        const Column byPlayer[2][5] = {{Path1, Happiness1, Debt1, Gpa1, EventCount1},
+                                       {Path2, Happiness2, Debt2, Gpa2, EventCount2}};
+        for (std::size_t b = nextBlock++; b < reader.blockCount() && !failed; b = nextBlock++) {
+            bool ok = reader.decode(b, Path1, columns[Path1]) && reader.decode(b, Winner, columns[Winner]) &&
+                      reader.decode(b, Spins, columns[Spins]);
+            const int players = key == ByPath || key == ByEvent ? 2 : 1;
+            for (int p = 0; p < players; ++p) {
+                for (Column c : byPlayer[p]) {
+                    ok = ok && (c == EventCount1 || c == EventCount2 || reader.decode(b, c, columns[c]));
+                }
+            }
+            if (key == ByPair) {
+                ok = ok && reader.decode(b, Path2, columns[Path2]);
+            }
+            if (key == ByEvent) {
+                ok = ok && reader.decode(b, EventCount1, columns[EventCount1]) &&
+                     reader.decode(b, EventCount2, columns[EventCount2]) &&
+                     reader.decode(b, Events1, columns[Events1]) && reader.decode(b, Events2, columns[Events2]);
+            }
+            if (!ok) {
+                failed = true;
+                break;
+            }
+
+            std::size_t eventAt[2] = {0, 0};
+            for (std::uint32_t r = 0; r < reader.blockRows(b); ++r) {
+                const std::int64_t winner = columns[Winner][r];
+                for (int p = 0; p < players; ++p) {
+                    const std::int64_t path = columns[byPlayer[p][0]][r];
+                    auto add = [&](std::size_t group) {
+                        if (group >= count) {
+                            return;
+                        }
+                        Aggregate& total = totals[group];
+                        ++total.rows;
+                        total.won += winner == p;
+                        total.lost += winner == 1 - p;
+                        total.tied += winner < 0;
+                        total.happiness += columns[byPlayer[p][1]][r];
+                        total.debt += columns[byPlayer[p][2]][r];
+                        total.gpa += columns[byPlayer[p][3]][r];
+                        total.spins += columns[Spins][r];
+                    };
+
+                    if (key == ByPair) {
+                        add(static_cast<std::size_t>(path * 2 + columns[Path2][r]));
+                    } else if (key == ByPath) {
+                        add(static_cast<std::size_t>(path));
+                    } else if (key == ByWinner) {
+                        add(static_cast<std::size_t>(winner + 1));
+                    } else {
+                        // The ids are in increasing order within a game, so a repeat follows its first copy
+                        const std::vector<std::int64_t>& events = columns[Events1 + p];
+                        const std::int64_t landed = columns[byPlayer[p][4]][r];
+                        for (std::int64_t e = 0; e < landed && eventAt[p] < events.size(); ++e, ++eventAt[p]) {
+                            if (e == 0 || events[eventAt[p]] != events[eventAt[p] - 1]) {
+                                add(static_cast<std::size_t>(events[eventAt[p]]));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(scan, t);
+    }
+    scan(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    groups.assign(count, Aggregate());
+    for (const std::vector<Aggregate>& totals : partial) {
+        for (std::size_t g = 0; g < count; ++g) {
+            groups[g].rows += totals[g].rows;
+            groups[g].won += totals[g].won;
+            groups[g].lost += totals[g].lost;
+            groups[g].tied += totals[g].tied;
+            groups[g].happiness += totals[g].happiness;
+            groups[g].debt += totals[g].debt;
+            groups[g].gpa += totals[g].gpa;
+            groups[g].spins += totals[g].spins;
+        }
+    }
+    return !failed;
+}
@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include FT_OUTLINE_H
+#include FT_BITMAP_H
+#include "Assets.h"
+#include "Glyphs.h"
+
+/**
+ * @file glyphs.cpp
+ * @brief Implementation file for the glyph cache.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const unsigned firstPageSize = 128; ///< Width and height of a new page, as sf::Font starts its textures.
+    const unsigned maxPageSize = 8192;  ///< Largest width or height a page grows to.
+    const unsigned padding = 2;         ///< Transparent texels around each glyph, as sf::Font leaves.
+    const FT_Pos boldWeight = 1 << 6;   ///< How much bold glyphs are thickened, in 26.6 fixed point.
+
+    /**
+     * @brief A glyph with the hinting offsets kerning needs.
+     */
+    struct Rendered {
+        sf::Glyph glyph; ///< Metrics and place on the page.
+        int lsbDelta;    ///< Left side bearing change from hinting, in 26.6 fixed point.
+        int rsbDelta;    ///< Right side bearing change from hinting, in 26.6 fixed point.
+    };
+
+    /**
+     * @brief A row of glyphs on a page.
+     */
+    struct Row {
+        unsigned top;    ///< Top of the row in texels.
+        unsigned width;  ///< Texels used so far from the left.
+        unsigned height; ///< Height of the row in texels.
+    };
+
+    /**
+     * @brief The glyphs of one character size.
+     */
+    struct Page {
+        sf::Image image;                           ///< White texels with the glyphs' coverage as alpha.
+        unsigned nextRow;                          ///< Top of the next row to open.
+        std::vector<Row> rows;                     ///< Rows opened so far.
+        std::map<std::uint64_t, Rendered> glyphs;  ///< Glyphs rendered so far, by bold flag and code point.
+    };
+
+    /**
+     * @brief A font's file opened with FreeType, and its pages.
+     */
+    struct Face {
+        std::vector<unsigned char> bytes; ///< Contents of the font file, which FreeType keeps reading from.
+        FT_Face face;                     ///< The opened face, or nullptr until first used or if it failed.
+        bool failed;                      ///< True if FreeType could not open the file.
+        std::map<unsigned, Page> pages;   ///< Pages by character size.
+    };
+
+    /**
+     * @brief Every font handed to the cache.
+     */
+    struct Cache {
+        std::mutex mutex;                                        ///< Guards the map, which add() may grow.
+        std::map<const sf::Font*, std::unique_ptr<Face>> faces;  ///< Faces by the font they belong to.
+        FT_Library library = nullptr;                            ///< FreeType, started with the first face.
+
+        /**
+         * @brief Closes every face and FreeType itself.
+         */
+        ~Cache() {
+            for (auto& entry : faces) {
+                if (entry.second->face) {
+                    FT_Done_Face(entry.second->face);
+                }
+            }
+            if (library) {
+                FT_Done_FreeType(library);
+            }
+        }
+    };
+
+    Cache cache;
+
+    /**
+     * @brief Finds a font's face, opening it the first time.
+     * @param font The font.
+     * @return The face, or nullptr if the font was not handed to the cache or could not be opened.
+     */
+    Face* open(const sf::Font& font) {
+        Face* face;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            auto found = cache.faces.find(&font);
+            if (found == cache.faces.end()) {
+                std::cerr << "No file was given for a font drawn in memory" << std::endl;
+                found = cache.faces.insert(std::make_pair(&font, std::unique_ptr<Face>(new Face()))).first;
+                found->second->face = nullptr;
+                found->second->failed = true;
+            }
+            face = found->second.get();
+        }
+        if (face->face || face->failed) {
+            return face->face ? face : nullptr;
+        }
+
+        if (!cache.library && FT_Init_FreeType(&cache.library) != 0) {
+            cache.library = nullptr;
+        }
+        if (!cache.library || FT_New_Memory_Face(cache.library, face->bytes.data(),
+                                                 static_cast<FT_Long>(face->bytes.size()), 0, &face->face) != 0) {
+            std::cerr << "FreeType could not open a font" << std::endl;
+            face->face = nullptr;
+            face->failed = true;
+            return nullptr;
+        }
+        FT_Select_Charmap(face->face, FT_ENCODING_UNICODE);
+        return face;
+    }
+
+    /**
+     * @brief Sets the size glyphs are loaded at.
+     * @param face The face.
+     * @param size Character size in pixels.
+     * @return False if the face has no such size.
+     */
+    bool setSize(FT_Face face, unsigned size) {
+        return face->size->metrics.x_ppem == size || FT_Set_Pixel_Sizes(face, 0, size) == 0;
+    }
+
+    /**
+     * @brief Gets a size's page, making a transparent white one the first time. The top left texels are opaque
+     * white, as on sf::Font's pages.
+     * @param face The face.
+     * @param size Character size in pixels.
+     * @return The page.
+     */
+    Page& pageOf(Face& face, unsigned size) {
+        auto found = face.pages.find(size);
+        if (found != face.pages.end()) {
+            return found->second;
+        }
+        Page& page = face.pages[size];
+        page.image.create(firstPageSize, firstPageSize, sf::Color(255, 255, 255, 0));
+        for (unsigned y = 0; y < 2; ++y) {
+            for (unsigned x = 0; x < 2; ++x) {
+                page.image.setPixel(x, y, sf::Color::White);
+            }
+        }
+        page.nextRow = 3;
+        return page;
+    }
+
+    /**
+     * @brief Finds room for a glyph, in the row whose height suits it best or else in a new row, doubling the page
+     * until the row fits. The old texels keep their place when the page grows.
+     * @param page The page.
+     * @param width Width of the glyph with its padding.
+     * @param height Height of the glyph with its padding.
+     * @return Where the glyph goes, or an empty rectangle if the page is full.
+     */
+    sf::IntRect place(Page& page, unsigned width, unsigned height) {
+        Row* row = nullptr;
+        float bestRatio = 0;
+        for (Row& candidate : page.rows) {
+            const float ratio = static_cast<float>(height) / candidate.height;
+            if (ratio < 0.7f || ratio > 1.0f || width > page.image.getSize().x - candidate.width || ratio < bestRatio) {
+                continue;
+            }
+            row = &candidate;
+            bestRatio = ratio;
+        }
+
+        if (!row) {
+            const unsigned rowHeight = height + height / 10;
+            while (page.nextRow + rowHeight >= page.image.getSize().y || width >= page.image.getSize().x) {
+                const sf::Vector2u size = page.image.getSize();
+                if (size.x * 2 > maxPageSize || size.y * 2 > maxPageSize) {
+                    std::cerr << "A glyph page is full" << std::endl;
+                    return sf::IntRect();
+                }
+                sf::Image larger;
+                larger.create(size.x * 2, size.y * 2, sf::Color(255, 255, 255, 0));
+                larger.copy(page.image, 0, 0);
+                page.image = larger;
+            }
+            const Row opened = {page.nextRow, 0, rowHeight};
+            page.rows.push_back(opened);
+            page.nextRow += rowHeight;
+            row = &page.rows.back();
+        }
+
+        const sf::IntRect rect(static_cast<int>(row->width), static_cast<int>(row->top), static_cast<int>(width),
+                               static_cast<int>(height));
+        row->width += width;
+        return rect;
+    }
+
+    /**
+     * @brief Renders a glyph onto its page the way sf::Font does: auto-hinted, thickened for bold, and padded with
+     * transparent texels.
+     * @param face The face.
+     * @param page Page of the size.
+     * @param character Unicode code point.
+     * @param size Character size in pixels.
+     * @param bold True for the bold glyph.
+     * @return The glyph; empty if FreeType could not render it.
+     */
+    Rendered render(FT_Face face, Page& page, sf::Uint32 character, unsigned size, bool bold) {
+        Rendered rendered = Rendered();
+        FT_Glyph description;
+        const FT_Int32 flags = FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT;
+        if (!setSize(face, size) || FT_Load_Char(face, character, flags) != 0 ||
+            FT_Get_Glyph(face->glyph, &description) != 0) {
+            return rendered;
+        }
+
+        const bool outline = description->format == FT_GLYPH_FORMAT_OUTLINE;
+        if (outline && bold) {
+            FT_Outline_Embolden(&reinterpret_cast<FT_OutlineGlyph>(description)->outline, boldWeight);
+        }
+        FT_Glyph_To_Bitmap(&description, FT_RENDER_MODE_NORMAL, 0, 1);
+        FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(description);
+        FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+        if (!outline && bold) {
+            FT_Bitmap_Embolden(cache.library, &bitmap, boldWeight, boldWeight);
+        }
+
+        rendered.glyph.advance = static_cast<float>(bitmapGlyph->root.advance.x >> 16);
+        if (bold) {
+            rendered.glyph.advance += static_cast<float>(boldWeight) / (1 << 6);
+        }
+        rendered.lsbDelta = static_cast<int>(face->glyph->lsb_delta);
+        rendered.rsbDelta = static_cast<int>(face->glyph->rsb_delta);
+
+        const unsigned width = bitmap.width;
+        const unsigned height = bitmap.rows;
+        const sf::IntRect rect = width > 0 && height > 0 ? place(page, width + 2 * padding, height + 2 * padding)
+                                                         : sf::IntRect();
+        if (rect.width > 0) {
+            rendered.glyph.textureRect = sf::IntRect(rect.left + padding, rect.top + padding, width, height);
+            rendered.glyph.bounds = sf::FloatRect(static_cast<float>(bitmapGlyph->left),
+                                                  static_cast<float>(-bitmapGlyph->top), static_cast<float>(width),
+                                                  static_cast<float>(height));
+
+            // The padding is already transparent white; only the coverage goes into the alpha
+            const unsigned char* row = bitmap.buffer;
+            for (unsigned y = 0; y < height; ++y, row += bitmap.pitch) {
+                for (unsigned x = 0; x < width; ++x) {
+                    const bool mono = bitmap.pixel_mode == FT_PIXEL_MODE_MONO;
+                    const sf::Uint8 alpha = mono ? ((row[x / 8] & (1 << (7 - x % 8))) ? 255 : 0) : row[x];
+                    page.image.setPixel(rendered.glyph.textureRect.left + x, rendered.glyph.textureRect.top + y,
+                                        sf::Color(255, 255, 255, alpha));
+                }
+            }
+        }
+        FT_Done_Glyph(description);
+        return rendered;
+    }
+
+    /**
+     * @brief Gets a glyph from the cache, rendering it the first time.
+     * @param font The font.
+     * @param character Unicode code point.
+     * @param size Character size in pixels.
+     * @param bold True for the bold glyph.
+     * @return The glyph, or an empty one if the font cannot be rendered.
+     */
+    const Rendered& lookup(const sf::Font& font, sf::Uint32 character, unsigned size, bool bold) {
+        static const Rendered missing = Rendered();
+        Face* face = open(font);
+        if (!face) {
+            return missing;
+        }
+        Page& page = pageOf(*face, size);
+        const std::uint64_t key = (static_cast<std::uint64_t>(bold) << 32) | character;
+        auto found = page.glyphs.find(key);
+        if (found == page.glyphs.end()) {
+            found = page.glyphs.insert(std::make_pair(key, render(face->face, page, character, size, bold))).first;
+        }
+        return found->second;
+    }
+}
+
+/**
+ * @brief Copies a font's file into the cache; FreeType opens it the first time a glyph is asked for.
+ * @param font The parsed font.
+ * @param data Contents of the font file.
+ * @param size Number of bytes.
+ */
+void glyphs::add(const sf::Font& font, const unsigned char* data, std::size_t size) {
+    std::unique_ptr<Face> face(new Face());
+    face->bytes.assign(data, data + size);
+    face->face = nullptr;
+    face->failed = false;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.faces[&font] = std::move(face);
+}
+
+/**
+ * @brief Gets a glyph from the cache in memory mode, or from the font otherwise.
+ * @param font Font of the glyph.
+ * @param character Unicode code point.
+ * @param size Character size in pixels.
+ * @param bold True for the bold glyph.
+ * @return The glyph.
+ */
+const sf::Glyph& glyphs::glyph(const sf::Font& font, sf::Uint32 character, unsigned size, bool bold) {
+    if (!assets::inMemory()) {
+        return font.getGlyph(character, size, bold);
+    }
+    return lookup(font, character, size, bold).glyph;
+}
+
+/**
+ * @brief Gets the kerning between two characters: the font's kerning pair plus the hinting offsets of the two
+ * glyphs, rounded to a whole pixel, as sf::Font::getKerning() works it out.
+ * @param font Font of the characters.
+ * @param first Character on the left.
+ * @param second Character on the right.
+ * @param size Character size in pixels.
+ * @param bold True for bold glyphs.
+ * @return Offset to add to the pen position, in pixels.
+ */
+float glyphs::kerning(const sf::Font& font, sf::Uint32 first, sf::Uint32 second, unsigned size, bool bold) {
+    if (!assets::inMemory()) {
+        return font.getKerning(first, second, size, bold);
+    }
+    if (first == 0 || second == 0) {
+        return 0;
+    }
+    Face* face = open(font);
+    if (!face || !setSize(face->face, size)) {
+        return 0;
+    }
+    const float firstRsbDelta = static_cast<float>(lookup(font, first, size, bold).rsbDelta);
+    const float secondLsbDelta = static_cast<float>(lookup(font, second, size, bold).lsbDelta);
+
+    FT_Vector pair = {0, 0};
+    if (FT_HAS_KERNING(face->face)) {
+        FT_Get_Kerning(face->face, FT_Get_Char_Index(face->face, first), FT_Get_Char_Index(face->face, second),
+                       FT_KERNING_UNFITTED, &pair);
+    }
+    if (!FT_IS_SCALABLE(face->face)) {
+        return static_cast<float>(pair.x);
+    }
+    return std::floor((secondLsbDelta - firstRsbDelta + static_cast<float>(pair.x) + 32) / 64);
+}
+
+/**
+ * @brief Gets the page a size's glyphs are rendered on.
+ * @param font The font.
+ * @param size Character size in pixels.
+ * @return The page, or an empty image if the font cannot be rendered.
+ */
+const sf::Image& glyphs::page(const sf::Font& font, unsigned size) {
+    static const sf::Image empty;
+    Face* face = open(font);
+    return face ? pageOf(*face, size).image : empty;
+}
+
+/**
+ * @brief Works out the bounds of a text the way sf::Text does: spaces, tabs and line breaks stretch them to the pen
+ * position, and each glyph to its box, slanted for italics.
+ * @param text The text.
+ * @return Bounds before the text's transform.
+ */
+sf::FloatRect glyphs::bounds(const sf::Text& text) {
+    const sf::Font* font = text.getFont();
+    if (!assets::inMemory()) {
+        return text.getLocalBounds();
+    }
+    const sf::String& string = text.getString();
+    if (!font || string.isEmpty()) {
+        return sf::FloatRect();
+    }
+    const unsigned size = text.getCharacterSize();
+    const bool bold = (text.getStyle() & sf::Text::Bold) != 0;
+    const float shear = (text.getStyle() & sf::Text::Italic) != 0 ? 0.209f : 0.0f;
+    float whitespace = glyph(*font, L' ', size, bold).advance;
+    const float letterSpacing = (whitespace / 3.0f) * (text.getLetterSpacing() - 1.0f);
+    whitespace += letterSpacing;
+    const float lineSpacing = font->getLineSpacing(size) * text.getLineSpacing();
+
+    float x = 0;
+    float y = static_cast<float>(size);
+    float minX = static_cast<float>(size);
+    float minY = static_cast<float>(size);
+    float maxX = 0;
+    float maxY = 0;
+    sf::Uint32 previous = 0;
+    for (std::size_t i = 0; i < string.getSize(); ++i) {
+        const sf::Uint32 c = string[i];
+        if (c == L'\r') {
+            continue;
+        }
+        x += kerning(*font, previous, c, size, bold);
+        previous = c;
+        if (c == L' ' || c == L'\t' || c == L'\n') {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            if (c == L'\n') {
+                y += lineSpacing;
+                x = 0;
+            } else {
+                x += c == L' ' ? whitespace : whitespace * 4;
+            }
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        const sf::Glyph& shown = glyph(*font, c, size, bold);
+        const float left = shown.bounds.left;
+        const float top = shown.bounds.top;
+        const float right = left + shown.bounds.width;
+        const float bottom = top + shown.bounds.height;
+        minX = std::min(minX, x + left - shear * bottom);
+        maxX = std::max(maxX, x + right - shear * top);
+        minY = std::min(minY, y + top);
+        maxY = std::max(maxY, y + bottom);
+        x += shown.advance + letterSpacing;
+    }
+    return sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+}
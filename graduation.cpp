@@ -1,6 +1,11 @@
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include "Graduation.h"
+#include "Assets.h"
+#include "DrawList.h"
+#include "Latency.h"
+#include "Metrics.h"
+#include "Pacing.h"
 
 /**
  * @file Graduation.cpp
@@ -16,15 +21,8 @@
  * @param player2 Second player object representing the game state.
  */
 void Graduation::graduationEvent(sf::RenderWindow& window, const std::string& message, Player& player1, Player& player2) {
-    sf::Font font;
-    if (!font.loadFromFile("Montserrat Medium 500.ttf")) {
-        std::cerr << "Montserrat font failed to load" << std::endl;
-    }
-
-    sf::Font arialFont;
-    if (!font.loadFromFile("Arial.ttf")) {
-        std::cerr << "Arial font failed to load" << std::endl;
-    }
+    metrics::PopupTimer onScreen(metrics::GraduationPopup);
+    const sf::Font& font = assets::font("Montserrat Medium 500.ttf");
 
     // for graduation text
     sf::Text text;
@@ -102,25 +100,29 @@ void Graduation::graduationEvent(sf::RenderWindow& window, const std::string& me
     background.setFillColor(sf::Color(91, 10, 125));
     background.setPosition((window.getSize().x - background.getSize().x) / 2, (window.getSize().y - background.getSize().y) / 2);
 
-    sf::Clock timer;
-    timer.restart();
+    // Record the popup once and replay it every frame
+    DrawList popup;
+    popup.shape(background, 0);
+    popup.text(text, 1);
+    popup.text(text2, 1);
+    popup.text(text3, 1);
+    popup.text(text4, 1);
+
+    pacing::Clock timer;
 
-    // pop up should be opened for 15 seconds and then will close
-    while (timer.getElapsedTime().asSeconds() < 15.0f) {
+    // pop up should be opened for 15 seconds of game time and then will close
+    while (timer.seconds() < 15.0f) {
         sf::Event event;
-        while (window.pollEvent(event)) {
+        while (latency::pollEvent(window, event)) {
             if (event.type == sf::Event::Closed) {
                 window.close();
                 return;
             }
         }
 
-        window.draw(background);
-        window.draw(text);
-        window.draw(text2);
-        window.draw(text3);
-        window.draw(text4);
-        window.display();
+        popup.draw(window);
+        latency::display(window);
+        pacing::sleepFor(std::chrono::milliseconds(1)); // Moves game time on at the fastest speed
     }
 }
 
@@ -0,0 +1,167 @@
+#include <cstring>
+#include "History.h"
+
+/**
+ * @file history.cpp
+ * @brief Implementation file for the game timeline.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const std::uint32_t indexMask = 0x0fffffff; ///< Bits of a version's place holding the space.
+    const std::uint32_t moverBit = 1u << 28;    ///< Set when the version holds player 2.
+    const std::uint32_t pathBit = 1u << 29;     ///< Set when that player is on the Ivey path.
+    const std::uint32_t chosenBit = 1u << 30;   ///< Set once that player has chosen.
+    const std::uint32_t turnBit = 1u << 31;     ///< Set when player 2 spins next.
+}
+
+/**
+ * @brief Constructs an empty timeline.
+ */
+history::Timeline::Timeline() : seed(0), current(0) {
+}
+
+/**
+ * @brief Packs one player's state into a version.
+ * @param state Game state.
+ * @param player Player whose state is kept.
+ * @param counter Random stream position.
+ * @param other Version holding the other player.
+ * @param bags Bag set in force.
+ * @return The version.
+ */
+history::Timeline::Version history::Timeline::pack(const rules::GameState& state, int player,
+                                                   std::uint32_t counter, std::uint32_t other, std::uint32_t bags) {
+    const rules::PlayerState& p = state.players[player];
+    Version version;
+    version.happiness = p.happiness;
+    version.debt = p.debt;
+    version.gpa = p.gpa;
+    version.counter = counter;
+    version.other = other;
+    version.bags = bags;
+    version.place = (static_cast<std::uint32_t>(p.index) & indexMask) | (player == 1 ? moverBit : 0) |
+                    (p.path == rules::ivey ? pathBit : 0) | (p.chosen ? chosenBit : 0) |
+                    (state.turn == 1 ? turnBit : 0);
+    return version;
+}
+
+/**
+ * @brief Unpacks a version's player into a game state.
+ * @param version The version.
+ * @param state Game state whose player is overwritten.
+ */
+void history::Timeline::unpack(const Version& version, rules::GameState& state) {
+    rules::PlayerState& p = state.players[(version.place & moverBit) ? 1 : 0];
+    p.path = (version.place & pathBit) ? rules::ivey : rules::western;
+    p.index = static_cast<int>(version.place & indexMask);
+    p.chosen = (version.place & chosenBit) != 0;
+    p.happiness = version.happiness;
+    p.debt = version.debt;
+    p.gpa = version.gpa;
+}
+
+/**
+ * @brief Starts the timeline from the state before the first spin. The two roots each hold one player and point
+ * at each other, so turn 0 is found like any other turn.
+ * @param state Game state.
+ * @param rng Random stream.
+ */
+void history::Timeline::start(const rules::GameState& state, const rules::Rng& rng) {
+    versions.clear();
+    bagSets.clear();
+    BagSet set;
+    std::memcpy(set.bags, state.bags, sizeof(set.bags));
+    bagSets.push_back(set);
+    const int second = 1 - state.turn;
+    versions.push_back(pack(state, second, rng.counter, 1, 0));
+    versions.push_back(pack(state, state.turn, rng.counter, 0, 0));
+    seed = rng.seed;
+    current = 0;
+}
+
+/**
+ * @brief Checks if the timeline was started.
+ * @return True once start() was called.
+ */
+bool history::Timeline::started() const {
+    return !versions.empty();
+}
+
+/**
+ * @brief Records a turn just played, dropping any turns ahead of the current one. The new version links to the
+ * version holding the other player at the current turn, and shares the current bag set unless the turn changed
+ * a bag.
+ * @param state Game state after the turn.
+ * @param rng Random stream after the turn.
+ * @param mover Player who spun.
+ */
+void history::Timeline::record(const rules::GameState& state, const rules::Rng& rng, int mover) {
+    if (!started()) {
+        return;
+    }
+    const std::uint32_t headIndex = static_cast<std::uint32_t>(current + 1);
+    versions.resize(headIndex + 1);
+    const Version head = versions[headIndex];
+    const bool headIsMover = ((head.place & moverBit) ? 1 : 0) == mover;
+    const std::uint32_t other = headIsMover ? head.other : headIndex;
+
+    // Bag sets after the head's were only used by dropped turns
+    std::uint32_t bags = head.bags;
+    bagSets.resize(bags + 1);
+    if (std::memcmp(bagSets[bags].bags, state.bags, sizeof(state.bags)) != 0) {
+        BagSet set;
+        std::memcpy(set.bags, state.bags, sizeof(set.bags));
+        bagSets.push_back(set);
+        bags = static_cast<std::uint32_t>(bagSets.size() - 1);
+    }
+
+    versions.push_back(pack(state, mover, rng.counter, other, bags));
+    ++current;
+}
+
+/**
+ * @brief Gets the number of turns recorded.
+ * @return Turns since start().
+ */
+std::size_t history::Timeline::turns() const {
+    return versions.empty() ? 0 : versions.size() - 2;
+}
+
+/**
+ * @brief Gets the turn the game is on.
+ * @return Turns played before the current state.
+ */
+std::size_t history::Timeline::position() const {
+    return current;
+}
+
+/**
+ * @brief Brings back the game as it was after a turn from the turn's version and the one it links to.
+ * @param turn Turn to go to.
+ * @param state Receives the game state.
+ * @param rng Receives the random stream.
+ * @return False if the turn is out of range.
+ */
+bool history::Timeline::restore(std::size_t turn, rules::GameState& state, rules::Rng& rng) {
+    if (!started() || turn > turns()) {
+        return false;
+    }
+    const Version& version = versions[turn + 1];
+    unpack(versions[version.other], state);
+    unpack(version, state);
+    state.turn = (version.place & turnBit) ? 1 : 0;
+    std::memcpy(state.bags, bagSets[version.bags].bags, sizeof(state.bags));
+    rng = {seed, version.counter};
+    current = turn;
+    return true;
+}
+
+/**
+ * @brief Gets the memory the timeline holds.
+ * @return Bytes used by its records.
+ */
+std::size_t history::Timeline::bytes() const {
+    return versions.size() * sizeof(Version) + bagSets.size() * sizeof(BagSet);
+}
@@ -0,0 +1,499 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Net.h"
+#include "Poller.h"
+#include "Protocol.h"
+#include "Rules.h"
+#include "Telemetry.h"
+
+/**
+ * @file host.cpp
+ * @brief Session host: runs thousands of tables in one process on a fixed pool of worker threads.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwHost [address] [--workers N] [--seed N] [--events events.txt] [--telemetry games.ndjson]
+ *
+ * Clients say hello with a seat and a table number. Each table belongs to worker (table % workers), which
+ * owns its session and every connection at it, so sessions need no locks. The first worker accepts new
+ * connections and hands each one to the table's worker once its hello arrives. The board and event deck
+ * are shared read-only by every worker.
+ */
+
+namespace {
+
+    struct Session;
+
+    /**
+     * @brief A connected client.
+     */
+    struct Peer {
+        net::Connection connection; ///< Socket to the client.
+        Session* session;           ///< Table the client sits at, or nullptr before its hello.
+        std::uint32_t table;        ///< Table number from the hello.
+        int seat;                   ///< Seat requested, then granted: 1 or 2 for players, 0 for spectators.
+        bool closed;                ///< True once the connection has failed or been closed.
+        bool queued;                ///< True while the peer is in its worker's list of peers to flush.
+        bool writing;               ///< True while the poller waits for the socket to become writable.
+        rules::GameState sent;      ///< State the client has been sent so far.
+
+        /**
+         * @brief Constructor for the Peer struct.
+         * @param fd Connected non-blocking socket.
+         */
+        explicit Peer(int fd)
+            : connection(fd), session(nullptr), table(0), seat(0), closed(false), queued(false), writing(false),
+              sent() {
+        }
+    };
+
+    /**
+     * @brief One table: its state machine and the clients at it. Kept small so thousands fit in cache.
+     */
+    struct Session {
+        rules::GameState state;   ///< Authoritative state.
+        rules::Rng rng;           ///< Spin and event stream.
+        std::vector<Peer*> peers; ///< Players and spectators at the table.
+        bool dirty;               ///< True if clients have not been sent the latest state.
+        std::uint64_t game;       ///< Number of the game being played, for telemetry.
+    };
+
+    /**
+     * @brief What every worker shares.
+     */
+    struct Shared {
+        const rules::Board& board;       ///< Board being played, read-only.
+        const rules::EventDeck& deck;    ///< Event deck, read-only.
+        std::uint32_t seed;              ///< Host seed; each table's stream is derived from it.
+        std::atomic<long> connections;   ///< Open connections.
+        std::atomic<long> tables;        ///< Tables with someone at them.
+        std::atomic<long> turns;         ///< Turns played since the host started.
+        std::atomic<std::uint64_t> games; ///< Games started since the host started, which numbers them.
+        telemetry::Log& log;             ///< Per-game telemetry; each worker records with its own index.
+    };
+
+    /**
+     * @class Worker
+     * @brief Drives the sessions and connections of its tables from one poller.
+     */
+    class Worker {
+    private:
+        Shared& shared;                                   ///< State shared by every worker.
+        int index;                                        ///< This worker's position in workers.
+        std::vector<std::unique_ptr<Worker>>& workers;   ///< Every worker, to hand connections to.
+        int listener;                                     ///< Listening socket, or -1 if this worker does not accept.
+        Poller poller;                                    ///< Readiness of this worker's sockets.
+        std::mutex mailboxLock;                           ///< Guards mailbox.
+        std::vector<Peer*> mailbox;                       ///< Connections handed over by other workers.
+        std::unordered_map<std::uint32_t, Session> sessions; ///< Tables owned by this worker.
+        std::vector<Session*> dirty;                      ///< Sessions whose clients need the latest state.
+        std::vector<Peer*> touched;                       ///< Peers with output to flush or that have closed.
+        std::thread thread;                               ///< Thread running this worker.
+
+        /**
+         * @brief Adds a peer to the list of peers to flush.
+         * @param peer Peer to flush.
+         */
+        void touch(Peer* peer) {
+            if (!peer->queued) {
+                peer->queued = true;
+                touched.push_back(peer);
+            }
+        }
+
+        /**
+         * @brief Marks a session's clients as needing the latest state.
+         * @param session Session that changed.
+         */
+        void markDirty(Session& session) {
+            if (!session.dirty) {
+                session.dirty = true;
+                dirty.push_back(&session);
+            }
+        }
+
+        /**
+         * @brief Seats a peer at its table, creating the table if nobody is there yet.
+         * @param peer Peer that said hello.
+         */
+        void join(Peer* peer) {
+            auto found = sessions.find(peer->table);
+            if (found == sessions.end()) {
+                rules::Rng rng = {rules::mix(shared.seed, peer->table), 0};
+                Session fresh = {rules::newGame(), rng, {}, false, shared.games++};
+                found = sessions.emplace(peer->table, std::move(fresh)).first;
+                ++shared.tables;
+                shared.log.record(index, telemetry::started(found->second.game));
+            }
+            Session& session = found->second;
+
+            // Grant the requested seat if nobody holds it, otherwise let the client watch
+            int seat = (peer->seat == 1 || peer->seat == 2) ? peer->seat : 0;
+            for (const Peer* other : session.peers) {
+                if (other->seat == seat) {
+                    seat = 0;
+                }
+            }
+            peer->seat = seat;
+            peer->session = &session;
+            peer->sent = rules::GameState(); // The first delta is the full state
+            session.peers.push_back(peer);
+
+            std::vector<std::uint8_t> payload;
+            protocol::putVarint(payload, seat);
+            protocol::putVarint(payload, static_cast<std::uint32_t>(shared.deck.events.size()));
+            peer->connection.send(protocol::Welcome, payload);
+            markDirty(session);
+            touch(peer);
+        }
+
+        /**
+         * @brief Removes a closed peer from its table and frees it.
+         * @param peer Peer to remove.
+         */
+        void leave(Peer* peer) {
+            poller.remove(peer->connection.fd());
+            --shared.connections;
+
+            Session* session = peer->session;
+            if (session) {
+                std::vector<Peer*>& peers = session->peers;
+                for (size_t i = 0; i < peers.size(); ++i) {
+                    if (peers[i] == peer) {
+                        peers[i] = peers.back();
+                        peers.pop_back();
+                        break;
+                    }
+                }
+
+                bool seated = false;
+                for (const Peer* other : peers) {
+                    seated = seated || other->seat > 0;
+                }
+                if (peers.empty()) {
+                    if (session->dirty) {
+                        for (size_t i = 0; i < dirty.size(); ++i) {
+                            if (dirty[i] == session) {
+                                dirty[i] = dirty.back();
+                                dirty.pop_back();
+                                break;
+                            }
+                        }
+                    }
+                    if (!rules::gameOver(session->state, shared.board)) {
+                        shared.log.record(index, telemetry::abandoned(session->game));
+                    }
+                    sessions.erase(peer->table);
+                    --shared.tables;
+                } else if (!seated && rules::gameOver(session->state, shared.board)) {
+                    // Once a finished game has no players left, set the table up for the next one
+                    session->state = rules::newGame();
+                    session->game = shared.games++;
+                    shared.log.record(index, telemetry::started(session->game));
+                    markDirty(*session);
+                }
+            }
+            delete peer;
+        }
+
+        /**
+         * @brief Acts on one message from a seated client.
+         * @param peer Client that sent the message.
+         * @param message Received message.
+         */
+        void handle(Peer* peer, const protocol::Message& message) {
+            Session& session = *peer->session;
+            const std::uint8_t* p = message.payload.data();
+            std::uint32_t value = 0;
+
+            if (message.type == protocol::ChoosePath && peer->seat > 0 &&
+                protocol::getVarint(p, p + message.payload.size(), value)) {
+                if (rules::choosePath(session.state, peer->seat - 1, static_cast<int>(value))) {
+                    const int player = peer->seat - 1;
+                    shared.log.record(index, telemetry::chose(session.game, player, static_cast<int>(value)));
+                    markDirty(session);
+                }
+            } else if (message.type == protocol::Spin && peer->seat > 0 && session.state.turn == peer->seat - 1 &&
+                       rules::canSpin(session.state, shared.board)) {
+                const rules::PlayerState before = session.state.players[session.state.turn];
+                rules::Turn turn = rules::playTurn(session.state, shared.board, shared.deck, session.rng);
+                ++shared.turns;
+                const rules::PlayerState& after = session.state.players[turn.player];
+                shared.log.record(index, telemetry::played(session.game, turn, before, after));
+                if (rules::gameOver(session.state, shared.board)) {
+                    shared.log.record(index, telemetry::ended(session.game, session.state));
+                }
+
+                std::vector<std::uint8_t> payload;
+                protocol::putVarint(payload, turn.player);
+                protocol::putVarint(payload, turn.spin);
+                protocol::putVarint(payload, turn.event + 1);
+                for (Peer* other : session.peers) {
+                    other->connection.send(protocol::Spun, payload);
+                    touch(other);
+                }
+                markDirty(session);
+            }
+        }
+
+        /**
+         * @brief Reads a peer's input and acts on it.
+         * @param peer Peer whose socket is ready.
+         * @return False if the peer was handed to another worker and must not be touched again.
+         */
+        bool process(Peer* peer) {
+            touch(peer);
+            if (!peer->connection.receive()) {
+                peer->closed = true;
+            }
+
+            protocol::Message message;
+            while (!peer->closed && peer->connection.next(message)) {
+                if (peer->session) {
+                    handle(peer, message);
+                    continue;
+                }
+
+                // The first message must be a hello naming the seat and table
+                const std::uint8_t* p = message.payload.data();
+                const std::uint8_t* end = p + message.payload.size();
+                std::uint32_t seat = 0;
+                std::uint32_t table = 0;
+                if (message.type != protocol::Hello || !protocol::getVarint(p, end, seat)) {
+                    peer->closed = true;
+                    break;
+                }
+                if (p != end && !protocol::getVarint(p, end, table)) {
+                    peer->closed = true;
+                    break;
+                }
+                peer->seat = static_cast<int>(seat);
+                peer->table = table;
+
+                Worker* owner = workers[table % workers.size()].get();
+                if (owner != this) {
+                    // Anything after the hello stays buffered in the connection and travels with it
+                    for (size_t i = 0; i < touched.size(); ++i) {
+                        if (touched[i] == peer) {
+                            touched.erase(touched.begin() + i);
+                            break;
+                        }
+                    }
+                    peer->queued = false;
+                    poller.remove(peer->connection.fd());
+                    owner->hand(peer);
+                    return false;
+                }
+                join(peer);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Sends every dirty session's clients what changed since their last update.
+         */
+        void broadcast() {
+            for (Session* session : dirty) {
+                session->dirty = false;
+                std::uint32_t sum = protocol::checksum(session->state);
+                for (Peer* peer : session->peers) {
+                    std::vector<std::uint8_t> payload;
+                    if (protocol::encodeDelta(peer->sent, session->state, payload)) {
+                        for (int b = 0; b < 4; ++b) {
+                            payload.push_back(static_cast<std::uint8_t>(sum >> (8 * b)));
+                        }
+                        peer->connection.send(protocol::State, payload);
+                        peer->sent = session->state;
+                        touch(peer);
+                    }
+                }
+            }
+            dirty.clear();
+        }
+
+        /**
+         * @brief Flushes touched peers, watches for writability where output is left over and removes closed peers.
+         */
+        void finish() {
+            std::vector<Peer*> peers;
+            peers.swap(touched);
+            for (Peer* peer : peers) {
+                peer->queued = false;
+                if (!peer->closed && !peer->connection.flush()) {
+                    peer->closed = true;
+                }
+                if (peer->closed) {
+                    leave(peer);
+                } else if (peer->writing != peer->connection.wantsWrite()) {
+                    peer->writing = peer->connection.wantsWrite();
+                    poller.modify(peer->connection.fd(), peer, peer->writing);
+                }
+            }
+        }
+
+        /**
+         * @brief Runs the worker's event loop forever.
+         */
+        void run() {
+            std::vector<void*> ready;
+            std::vector<Peer*> arrivals;
+            while (true) {
+                poller.wait(ready, -1);
+
+                // Take over connections whose table belongs to this worker
+                {
+                    std::lock_guard<std::mutex> guard(mailboxLock);
+                    arrivals.swap(mailbox);
+                }
+                for (Peer* peer : arrivals) {
+                    peer->writing = peer->connection.wantsWrite();
+                    poller.add(peer->connection.fd(), peer, peer->writing);
+                    join(peer);
+                    process(peer);
+                }
+                arrivals.clear();
+
+                for (void* token : ready) {
+                    if (token == &listener) {
+                        int fd;
+                        while ((fd = net::acceptFrom(listener)) >= 0) {
+                            Peer* peer = new Peer(fd);
+                            poller.add(fd, peer, false);
+                            ++shared.connections;
+                        }
+                    } else {
+                        process(static_cast<Peer*>(token));
+                    }
+                }
+
+                // Leaving can reset a table, which needs another broadcast
+                while (!dirty.empty() || !touched.empty()) {
+                    broadcast();
+                    finish();
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructor for the Worker class.
+         * @param shared State shared by every worker.
+         * @param workers Every worker, including this one.
+         * @param listener Listening socket if this worker accepts connections, otherwise -1.
+         */
+        Worker(Shared& shared, std::vector<std::unique_ptr<Worker>>& workers, int listener)
+            : shared(shared), index(static_cast<int>(workers.size())), workers(workers), listener(listener) {
+            if (listener >= 0) {
+                poller.add(listener, &this->listener, false);
+            }
+        }
+
+        /**
+         * @brief Starts the worker's thread.
+         */
+        void start() {
+            thread = std::thread(&Worker::run, this);
+        }
+
+        /**
+         * @brief Hands a connection to this worker. Safe to call from any thread.
+         * @param peer Connection that said hello to one of this worker's tables.
+         */
+        void hand(Peer* peer) {
+            {
+                std::lock_guard<std::mutex> guard(mailboxLock);
+                mailbox.push_back(peer);
+            }
+            poller.wake();
+        }
+
+        /**
+         * @brief Waits for the worker's thread, which never returns.
+         */
+        void join() {
+            thread.join();
+        }
+    };
+}
+
+/**
+ * @brief Runs the session host until it is killed.
+ * @param argc Number of arguments.
+ * @param argv Address, --workers, --seed, --events and --telemetry options.
+ * @return Exit status of the program.
+ */
+int main(int argc, char* argv[]) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::string address = net::defaultAddress;
+    std::string eventsFile = "events.txt";
+    std::string telemetryFile;
+    std::uint32_t seed = std::random_device()();
+    unsigned int workerCount = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) {
+            workerCount = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--events" && i + 1 < argc) {
+            eventsFile = argv[++i];
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetryFile = argv[++i];
+        } else {
+            address = arg;
+        }
+    }
+    if (workerCount == 0) {
+        workerCount = 1;
+    }
+
+    std::ifstream deckFile(eventsFile);
+    if (!deckFile) {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+    const rules::EventDeck deck = rules::EventDeck::parse(deckFile);
+
+    long fileLimit = net::raiseFileLimit();
+    int listener = net::listenOn(address);
+    if (listener < 0) {
+        return 1;
+    }
+    std::cout << "Hosting Western Wonderland on " << address << " with " << workerCount << " workers, "
+              << sizeof(Session) << " bytes per table, up to " << fileLimit << " open sockets" << std::endl;
+
+    telemetry::Log log;
+    if (!telemetryFile.empty() && !log.open(telemetryFile, static_cast<int>(workerCount))) {
+        return 1;
+    }
+    Shared shared = {rules::Board::standard(), deck, seed, {0}, {0}, {0}, {0}, log};
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(new Worker(shared, workers, i == 0 ? listener : -1));
+    }
+    for (auto& worker : workers) {
+        worker->start();
+    }
+
+    // Report load every few seconds
+    long lastTurns = 0;
+    const int interval = 5;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(interval));
+        long turns = shared.turns;
+        std::cout << shared.tables << " tables, " << shared.connections << " connections, "
+                  << (turns - lastTurns) / interval << " turns/s" << std::endl;
+        lastTurns = turns;
+    }
+}
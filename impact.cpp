@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include "Impact.h"
+
+/**
+ * @file impact.cpp
+ * @brief Implementation file for the event impact analyser.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const std::uint32_t redrawSalt = 0x5BD1E995u; ///< Separates the stream of replacement draws from the game's own.
+
+    /**
+     * @brief An event drawn during a game.
+     */
+    struct Draw {
+        std::int32_t event;   ///< Deck index of the event.
+        std::int32_t index;   ///< Space the player landed on; paths may be longer than 16 bits can count.
+        std::uint8_t player;  ///< Player who drew it.
+        std::uint8_t region;  ///< Region of the space.
+    };
+
+    /**
+     * @brief Draws the replacement for a removed event from the rest of its region, by weight. The draw picks one
+     * of the region's weight units leaving out the removed event's, so it has exactly the chances of a weighted
+     * deck without the event. A shuffled deck without it would also deal the rest of its pile in another order,
+     * which no single draw can reproduce, so Remove is only offered for decks drawn by weight. The bits come from
+     * a stream of their own, so every other spin and draw of the game stays the same.
+     * @param deck Event deck.
+     * @param region Region of the space.
+     * @param removed Deck index of the removed event.
+     * @param seed Seed of the game's stream.
+     * @param position Which draw of the game is replaced.
+     * @return Deck index of the replacement, or -1 if the region has no other event.
+     */
+    int redraw(const rules::EventDeck& deck, int region, int removed, std::uint32_t seed, std::uint32_t position) {
+        const rules::EventTable& table = deck.tables[region];
+        const std::size_t column = std::lower_bound(table.events.begin(), table.events.end(), removed) -
+                                   table.events.begin();
+        const std::uint32_t start = column ? table.ends[column - 1] : 0;
+        const std::uint32_t weight = table.ends[column] - start;
+        const std::uint32_t rest = static_cast<std::uint32_t>(table.totalWeight) - weight;
+        if (rest == 0) {
+            return -1;
+        }
+
+        // 64 random bits keep the bias of the remainder below one part in 2^32
+        const std::uint32_t salted = seed ^ redrawSalt;
+        const std::uint64_t bits = static_cast<std::uint64_t>(rules::mix(salted, 2 * position)) << 32 |
+                                   rules::mix(salted, 2 * position + 1);
+        std::uint32_t unit = static_cast<std::uint32_t>(bits % rest);
+        if (unit >= start) {
+            unit += weight; // Step over the removed event's units
+        }
+        return table.copy(unit);
+    }
+
+    /**
+     * @brief Replays one player's resources from the events drawn in a game, with one event taken out.
+     * @param start Player's state when the game began.
+     * @param draws Every event drawn in the game, in order.
+     * @param player Player index.
+     * @param deck Event deck.
+     * @param out Deck index of the event taken out, or -1 to replay the game as played.
+     * @param variant How the event is taken out.
+     * @param seed Seed of the game's stream.
+     * @return The player's state at the end, with the index of the last space landed on.
+     */
+    rules::PlayerState replay(const rules::PlayerState& start, const std::vector<Draw>& draws, int player,
+                              const rules::EventDeck& deck, int out, impact::Variant variant, std::uint32_t seed) {
+        rules::PlayerState state = start;
+        for (std::size_t k = 0; k < draws.size(); ++k) {
+            const Draw& draw = draws[k];
+            if (draw.player != player) {
+                continue;
+            }
+            int event = draw.event;
+            if (event == out) {
+                if (variant == impact::Neutralise) {
+                    continue;
+                }
+                event = redraw(deck, draw.region, out, seed, static_cast<std::uint32_t>(k));
+                if (event < 0) {
+                    continue;
+                }
+            }
+            state.index = draw.index; // Effects may read the space landed on
+            rules::applyEvent(state, deck.events[event]);
+        }
+        return state;
+    }
+
+    /**
+     * @brief Plays a range of games and adds their impact to a partial report.
+     * @param board Board to play on.
+     * @param deck Event deck.
+     * @param variant How each event is taken out.
+     * @param games Games per pair of paths.
+     * @param seed Seed the games' streams are derived from.
+     * @param from First game.
+     * @param to One past the last game.
+     * @param part Report to add to; its events must be zeroed and sized to the deck.
+     */
+    void playRange(const rules::Board& board, const rules::EventDeck& deck, impact::Variant variant,
+                   std::uint64_t games, std::uint32_t seed, std::uint64_t from, std::uint64_t to,
+                   impact::Report& part) {
+        std::vector<Draw> draws;
+        std::vector<int> drawn;
+        for (std::uint64_t g = from; g < to; ++g) {
+            const int pair = static_cast<int>(g / games);
+            rules::GameState state = rules::newGame();
+            rules::choosePath(state, 0, pair / rules::pathCount);
+            rules::choosePath(state, 1, pair % rules::pathCount);
+            const rules::GameState start = state;
+            const std::uint32_t gameSeed = rules::mix(seed, static_cast<std::uint32_t>(g));
+            rules::Rng rng = {gameSeed, 0};
+
+            // Play the game once with the full deck, noting every draw
+            draws.clear();
+            while (!rules::gameOver(state, board)) {
+                const rules::Turn turn = rules::playTurn(state, board, deck, rng);
+                if (turn.event >= 0) {
+                    const rules::PlayerState& player = state.players[turn.player];
+                    const Draw draw = {static_cast<std::int32_t>(turn.event),
+                                       static_cast<std::int32_t>(player.index),
+                                       static_cast<std::uint8_t>(turn.player),
+                                       board.regionAt[player.path][player.index]};
+                    draws.push_back(draw);
+                }
+            }
+
+            const int won = rules::winner(state);
+            bool matched = true;
+            for (int p = 0; p < rules::playerCount; ++p) {
+                const int path = state.players[p].path;
+                ++part.seats[path];
+                part.wins[path] += won == p;
+
+                // Replaying the full deck must give what the rules gave, or the differences below mean nothing
+                const rules::PlayerState again = replay(start.players[p], draws, p, deck, -1, variant, gameSeed);
+                matched = matched && again.happiness == state.players[p].happiness &&
+                          again.debt == state.players[p].debt && again.gpa == state.players[p].gpa;
+            }
+            part.mismatched += !matched;
+
+            // Only the events this game drew can change its result, and only for the players who drew them
+            drawn.clear();
+            for (const Draw& draw : draws) {
+                drawn.push_back(draw.event);
+            }
+            std::sort(drawn.begin(), drawn.end());
+            drawn.erase(std::unique(drawn.begin(), drawn.end()), drawn.end());
+            for (int event : drawn) {
+                rules::GameState variantState = state;
+                for (int p = 0; p < rules::playerCount; ++p) {
+                    const bool drew = std::any_of(draws.begin(), draws.end(), [&](const Draw& draw) {
+                        return draw.event == event && draw.player == p;
+                    });
+                    if (drew) {
+                        const rules::PlayerState again = replay(start.players[p], draws, p, deck, event, variant,
+                                                                gameSeed);
+                        variantState.players[p].happiness = again.happiness;
+                        variantState.players[p].debt = again.debt;
+                        variantState.players[p].gpa = again.gpa;
+                    }
+                }
+
+                const int variantWon = rules::winner(variantState);
+                std::int64_t change[rules::pathCount] = {0, 0};
+                for (int p = 0; p < rules::playerCount; ++p) {
+                    change[state.players[p].path] += (variantWon == p) - (won == p);
+                }
+                impact::EventImpact& result = part.events[event];
+                ++result.games;
+                for (int path = 0; path < rules::pathCount; ++path) {
+                    result.change[path] += change[path];
+                    result.squares[path] += change[path] * change[path];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the chance of winning on a path with the full deck.
+ * @param path Path index.
+ * @return Wins per player on the path, or 0 if nobody played it.
+ */
+double impact::Report::baseline(int path) const {
+    return seats[path] ? static_cast<double>(wins[path]) / seats[path] : 0.0;
+}
+
+/**
+ * @brief Gets how much taking an event out changes the chance of winning on a path. Games that never drew the
+ * event count as no change.
+ * @param event Deck index.
+ * @param path Path index.
+ * @return Change in wins per player on the path.
+ */
+double impact::Report::change(int event, int path) const {
+    return seats[path] ? static_cast<double>(events[event].change[path]) / seats[path] : 0.0;
+}
+
+/**
+ * @brief Gets the half-width of the confidence interval of change(). The games are independent, so the sum of
+ * their differences has the games' variance times the number of games.
+ * @param event Deck index.
+ * @param path Path index.
+ * @param z Standard normal quantile of the confidence level.
+ * @return Half-width of the interval.
+ */
+double impact::Report::margin(int event, int path, double z) const {
+    if (games < 2 || seats[path] == 0) {
+        return 0.0;
+    }
+    const double sum = static_cast<double>(events[event].change[path]);
+    const double variance = (events[event].squares[path] - sum * sum / games) / (games - 1);
+    return z * std::sqrt(std::max(variance, 0.0) * games) / seats[path];
+}
+
+/**
+ * @brief Plays games for every pair of paths, games per pair in a row, splits them evenly between threads and
+ * adds up each thread's counts.
+ * @param board Board to play on.
+ * @param deck Event deck.
+ * @param variant How each event is taken out.
+ * @param games Games per pair of paths.
+ * @param seed Seed the games' streams are derived from.
+ * @param threads Threads to play on, or 0 for one per core.
+ * @return The impact of every event.
+ */
+impact::Report impact::analyse(const rules::Board& board, const rules::EventDeck& deck, Variant variant,
+                               std::uint64_t games, std::uint32_t seed, unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const std::uint64_t count = games * rules::pathCount * rules::pathCount;
+    const std::uint64_t share = (count + threads - 1) / threads;
+
+    Report empty = Report();
+    empty.events.assign(deck.events.size(), EventImpact());
+    std::vector<Report> parts(threads, empty);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        const std::uint64_t from = std::min(count, t * share);
+        const std::uint64_t to = std::min(count, from + share);
+        workers.emplace_back(playRange, std::cref(board), std::cref(deck), variant, games, seed, from, to,
+                             std::ref(parts[t]));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    Report report = empty;
+    report.games = count;
+    for (const Report& part : parts) {
+        for (int path = 0; path < rules::pathCount; ++path) {
+            report.seats[path] += part.seats[path];
+            report.wins[path] += part.wins[path];
+        }
+        report.mismatched += part.mismatched;
+        for (std::size_t e = 0; e < part.events.size(); ++e) {
+            report.events[e].games += part.events[e].games;
+            for (int path = 0; path < rules::pathCount; ++path) {
+                report.events[e].change[path] += part.events[e].change[path];
+                report.events[e].squares[path] += part.events[e].squares[path];
+            }
+        }
+    }
+    return report;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Impact.h"
+#include "Rules.h"
+
+/**
+ * @file impactTool.cpp
+ * @brief Ranks the events in a deck by how much they decide games: how much each changes the chance of winning
+ * on each path, with 95% confidence intervals, measured by replaying seeded games with each event taken out.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwImpact [--games N] [--seed N] [--threads N] [--events events.txt] [--remove] [--top N] [--csv file]
+ * N games are played for each pair of paths. Events are neutralised (drawn but doing nothing) unless --remove
+ * takes them out of the deck. --csv writes every event's figures to a file.
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock; ///< Clock used to time the analysis.
+
+    const char* const pathNames[rules::pathCount] = {"Western", "Ivey"}; ///< Path names by path index.
+    const std::size_t shownLength = 48; ///< Characters of an event's description shown in the table.
+
+    /**
+     * @brief Checks if an event's interval on a path leaves out zero, so the change is unlikely to be noise.
+     * @param report The analysis.
+     * @param event Deck index.
+     * @param path Path index.
+     * @return True if the change is significant at the confidence level.
+     */
+    bool significant(const impact::Report& report, int event, int path) {
+        return std::fabs(report.change(event, path)) > report.margin(event, path);
+    }
+
+    /**
+     * @brief Quotes a field for a CSV file.
+     * @param text Field text.
+     * @return The text in double quotes, with its own double quotes doubled.
+     */
+    std::string quoted(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            out += c == '"' ? std::string("\"\"") : std::string(1, c);
+        }
+        return out + "\"";
+    }
+
+    /**
+     * @brief Writes every event's figures to a CSV file.
+     * @param file File name.
+     * @param deck Event deck.
+     * @param report The analysis.
+     * @return False if the file could not be written.
+     */
+    bool writeCsv(const std::string& file, const rules::EventDeck& deck, const impact::Report& report) {
+        std::ofstream out(file);
+        if (!out) {
+            return false;
+        }
+        out << "event,description,games_drawn";
+        for (int path = 0; path < rules::pathCount; ++path) {
+            out << "," << pathNames[path] << "_change," << pathNames[path] << "_margin";
+        }
+        out << std::endl;
+        for (std::size_t e = 0; e < deck.events.size(); ++e) {
+            out << e << "," << quoted(deck.events[e].description) << "," << report.events[e].games;
+            for (int path = 0; path < rules::pathCount; ++path) {
+                out << "," << report.change(static_cast<int>(e), path) << ","
+                    << report.margin(static_cast<int>(e), path);
+            }
+            out << std::endl;
+        }
+        return static_cast<bool>(out);
+    }
+}
+
+/**
+ * @brief Runs the analysis.
+ * @param argc Number of arguments.
+ * @param argv --games, --seed, --threads, --events, --remove, --top and --csv options.
+ * @return Exit status of the program: 1 if the deck failed to load, the CSV could not be written or a replayed
+ * game differed from the rules.
+ */
+int main(int argc, char* argv[]) {
+    std::uint64_t games = 100000;
+    std::uint32_t seed = std::random_device()();
+    unsigned threads = 0;
+    std::string eventsFile = "events.txt";
+    impact::Variant variant = impact::Neutralise;
+    std::size_t top = 20;
+    std::string csvFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--remove") {
+            variant = impact::Remove;
+        } else if (i + 1 >= argc) {
+            break;
+        } else if (arg == "--games") {
+            games = std::max<std::uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--seed") {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--threads") {
+            threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--events") {
+            eventsFile = argv[++i];
+        } else if (arg == "--top") {
+            top = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--csv") {
+            csvFile = argv[++i];
+        }
+    }
+
+    std::ifstream deckFile(eventsFile);
+    if (!deckFile) {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+    const rules::EventDeck deck = rules::EventDeck::parse(deckFile);
+    if (variant == impact::Remove && deck.shuffled) {
+        std::cerr << "--remove needs a deck drawn by weight; shuffled decks can only be neutralised" << std::endl;
+        return 1;
+    }
+
+    const Clock::time_point start = Clock::now();
+    const impact::Report report = impact::analyse(rules::Board::standard(), deck, variant, games, seed, threads);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "Seed " << seed << ", " << games << " games per pair of paths, each event "
+              << (variant == impact::Remove ? "removed" : "neutralised") << " in turn" << std::endl;
+    std::cout << "Win chance with the full deck:";
+    for (int path = 0; path < rules::pathCount; ++path) {
+        std::cout << " " << pathNames[path] << " " << 100.0 * report.baseline(path) << "%";
+    }
+    std::cout << std::endl;
+
+    // Largest change on either path first
+    std::vector<int> order(deck.events.size());
+    for (std::size_t e = 0; e < order.size(); ++e) {
+        order[e] = static_cast<int>(e);
+    }
+    auto largest = [&](int e) {
+        return std::max(std::fabs(report.change(e, rules::western)), std::fabs(report.change(e, rules::ivey)));
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return largest(a) > largest(b); });
+
+    std::cout << "Change in win chance without each event, with 95% confidence intervals (* leaves out 0):"
+              << std::endl;
+    for (std::size_t i = 0; i < std::min(top, order.size()); ++i) {
+        const int e = order[i];
+        std::cout << "  " << e << " " << deck.events[e].description.substr(0, shownLength) << " (drawn in "
+                  << 100.0 * report.events[e].games / report.games << "% of games):";
+        for (int path = 0; path < rules::pathCount; ++path) {
+            std::cout << " " << pathNames[path] << " " << 100.0 * report.change(e, path) << "% +/- "
+                      << 100.0 * report.margin(e, path) << "%" << (significant(report, e, path) ? "*" : "");
+        }
+        std::cout << std::endl;
+    }
+
+    std::size_t deciding = 0;
+    for (std::size_t e = 0; e < deck.events.size(); ++e) {
+        const int event = static_cast<int>(e);
+        deciding += significant(report, event, rules::western) || significant(report, event, rules::ivey);
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::cout << deciding << " of " << deck.events.size() << " events change the win chance significantly; "
+              << report.games << " games on " << threads << " threads in " << seconds << " s ("
+              << static_cast<std::uint64_t>(report.games / seconds) << " games/s)" << std::endl;
+
+    if (!csvFile.empty() && !writeCsv(csvFile, deck, report)) {
+        std::cerr << csvFile << " could not be written" << std::endl;
+        return 1;
+    }
+    if (report.mismatched) {
+        std::cerr << report.mismatched << " games replayed differently from the rules" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,368 @@
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Journal.h"
+
+/**
+ * @file journal.cpp
+ * @brief Implementation file for the autosave journal.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const std::size_t queueCapacity = 256;  ///< Entries the simulation can queue before the writer catches up.
+    const std::uint32_t compactEvery = 64;  ///< Entries written between snapshots.
+    const int idleMillis = 5;               ///< Writer's sleep when the queue is empty.
+    const char* const snapSuffix = ".snap"; ///< Added to the journal's name for the snapshot.
+    const char* const tempSuffix = ".tmp";  ///< Added to the snapshot's name while it is being written.
+    const std::int32_t version = 2;         ///< Journal format, hashed into every fingerprint; bump when Entry changes.
+
+    /**
+     * @brief Computes an entry's checksum.
+     * @param entry The entry.
+     * @return FNV-1a hash of every byte before the check field.
+     */
+    std::uint32_t checksum(const journal::Entry& entry) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&entry);
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < offsetof(journal::Entry, check); ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Adds bytes to an FNV-1a hash.
+     * @param hash Hash so far.
+     * @param data First byte.
+     * @param size Number of bytes.
+     */
+    void hashBytes(std::uint32_t& hash, const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    }
+
+    /**
+     * @brief Adds a number to an FNV-1a hash, lowest byte first, so every machine gets the same hash.
+     * @param hash Hash so far.
+     * @param value The number.
+     */
+    void hashInt(std::uint32_t& hash, std::int32_t value) {
+        const std::uint32_t bits = static_cast<std::uint32_t>(value);
+        const unsigned char bytes[4] = {static_cast<unsigned char>(bits), static_cast<unsigned char>(bits >> 8),
+                                        static_cast<unsigned char>(bits >> 16), static_cast<unsigned char>(bits >> 24)};
+        hashBytes(hash, bytes, sizeof(bytes));
+    }
+
+    /**
+     * @brief Adds a list of tiles to an FNV-1a hash, count first.
+     * @param hash Hash so far.
+     * @param tiles The tiles.
+     */
+    void hashTiles(std::uint32_t& hash, const std::vector<rules::Tile>& tiles) {
+        hashInt(hash, static_cast<std::int32_t>(tiles.size()));
+        for (const rules::Tile& tile : tiles) {
+            hashInt(hash, tile.x);
+            hashInt(hash, tile.y);
+        }
+    }
+
+    /**
+     * @brief Checks that a saved state fits a board, so resuming it cannot index past the board's paths.
+     * @param state Saved state.
+     * @param board Board it would be resumed on.
+     * @return True if the turn, paths and spaces are all on the board.
+     */
+    bool fits(const rules::GameState& state, const rules::Board& board) {
+        if (state.turn < 0 || state.turn >= rules::playerCount) {
+            return false;
+        }
+        for (const rules::PlayerState& player : state.players) {
+            if (player.path < 0 || player.path >= rules::pathCount || player.index < 0 ||
+                player.index > board.lastIndex(player.path)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes a whole buffer, retrying short writes.
+     * @param fd File to write to.
+     * @param data First byte to write.
+     * @param size Number of bytes.
+     * @return False if the write failed.
+     */
+    bool writeAll(int fd, const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        std::size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::write(fd, bytes + done, size - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads the intact entries of a file, in order, stopping at the first torn or corrupt one.
+     * @param file File name.
+     * @param visit Called with each intact entry.
+     * @tparam Visit Callable taking a const journal::Entry&.
+     */
+    template <typename Visit>
+    void readEntries(const std::string& file, Visit visit) {
+        std::FILE* in = std::fopen(file.c_str(), "rb");
+        if (!in) {
+            return;
+        }
+        std::vector<journal::Entry> entries(64);
+        std::size_t n;
+        bool intact = true;
+        while (intact && (n = std::fread(entries.data(), sizeof(journal::Entry), entries.size(), in)) > 0) {
+            for (std::size_t i = 0; i < n && intact; ++i) {
+                intact = entries[i].check == checksum(entries[i]);
+                if (intact) {
+                    visit(entries[i]);
+                }
+            }
+        }
+        std::fclose(in);
+    }
+
+    /**
+     * @brief Syncs the directory holding a file, so a rename into it survives a power cut.
+     * @param file File name.
+     */
+    void syncDirectory(const std::string& file) {
+        const std::size_t slash = file.rfind('/');
+        const std::string directory = slash == std::string::npos ? "." : file.substr(0, slash + 1);
+        int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+}
+
+/**
+ * @brief Hashes the journal's format version, the board's size, paths and event spaces, then whether the deck is
+ * shuffled and each event.
+ * @param board Board being played.
+ * @param deck Event deck.
+ * @return FNV-1a hash of them all.
+ */
+std::uint32_t journal::fingerprint(const rules::Board& board, const rules::EventDeck& deck) {
+    std::uint32_t hash = 2166136261u;
+    hashInt(hash, version);
+    hashInt(hash, board.columns);
+    hashInt(hash, board.rows);
+    for (int path = 0; path < rules::pathCount; ++path) {
+        hashTiles(hash, board.paths[path]);
+    }
+    hashTiles(hash, board.eventSpaces);
+    hashInt(hash, deck.shuffled);
+    hashInt(hash, static_cast<std::int32_t>(deck.events.size()));
+    for (const rules::Event& event : deck.events) {
+        hashInt(hash, static_cast<std::int32_t>(event.description.size()));
+        hashBytes(hash, event.description.data(), event.description.size());
+        hashInt(hash, event.happinessScore);
+        hashInt(hash, event.debtScore);
+        hashInt(hash, event.gpaScore);
+        hashInt(hash, static_cast<std::int32_t>(event.effect.size()));
+        for (std::int32_t word : event.effect) {
+            hashInt(hash, word);
+        }
+        hashInt(hash, event.weight);
+        hashInt(hash, static_cast<std::int32_t>(event.regions));
+    }
+    return hash;
+}
+
+/**
+ * @brief Replays the snapshot and then the journal. Entries numbered at or below the latest one kept are left
+ * over from before a compaction and skipped; a Started entry begins a new game. The latest entry is only resumed
+ * if it was saved with this board and deck and its players stand on spaces of this board.
+ * @param path Journal file.
+ * @param board Board the game would be resumed on.
+ * @param deck Event deck it would be resumed with.
+ * @param entry Receives the latest intact entry.
+ * @return True if there is an unfinished game to resume.
+ */
+bool journal::recover(const std::string& path, const rules::Board& board, const rules::EventDeck& deck,
+                      Entry& entry) {
+    bool found = false;
+    auto visit = [&](const Entry& next) {
+        if (next.kind == Started || !found || next.sequence > entry.sequence) {
+            entry = next;
+            found = true;
+        }
+    };
+    readEntries(path + snapSuffix, visit);
+    readEntries(path, visit);
+    if (!found || entry.kind == Ended) {
+        return false;
+    }
+    if (entry.layout != fingerprint(board, deck)) {
+        std::cerr << "Autosave " << path << " was made with another version, board or event deck; starting a new game"
+                  << std::endl;
+        return false;
+    }
+    if (!fits(entry.state, board)) {
+        std::cerr << "Autosave " << path << " holds spaces the board does not have; starting a new game"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs a closed journal.
+ */
+journal::Writer::Writer() : queue(queueCapacity), fd(-1), stopping(false), dropped(0) {
+}
+
+/**
+ * @brief Destructor for the Writer class.
+ */
+journal::Writer::~Writer() {
+    close();
+}
+
+/**
+ * @brief Opens the journal for appending and starts the writer.
+ * @param file Journal file name.
+ * @return False if the file could not be opened.
+ */
+bool journal::Writer::open(const std::string& file) {
+    close();
+    fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot open autosave journal " << file << std::endl;
+        return false;
+    }
+    path = file;
+    stopping = false;
+    writer = std::thread(&Writer::run, this);
+    return true;
+}
+
+/**
+ * @brief Queues an entry without blocking, counting it as dropped if the queue is full. Entries hold the whole
+ * state, so a dropped one only delays the next save.
+ * @param entry Entry to queue.
+ */
+void journal::Writer::append(const Entry& entry) {
+    if (fd < 0) {
+        return;
+    }
+    if (!queue.push(entry)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes out everything queued, syncs the file and stops the writer.
+ */
+void journal::Writer::close() {
+    if (fd < 0) {
+        return;
+    }
+    stopping = true;
+    writer.join();
+    ::close(fd);
+    fd = -1;
+    if (dropped > 0) {
+        std::cerr << dropped << " autosave entries were dropped" << std::endl;
+    }
+}
+
+/**
+ * @brief Checks if the journal is open.
+ * @return True if entries are being written.
+ */
+bool journal::Writer::isOpen() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Writes the snapshot under a temporary name, syncs it and renames it over the old one, then empties the
+ * journal. A crash at any point leaves either the old snapshot and the full journal or the new snapshot, which
+ * the entries still in the journal are older than.
+ * @param latest The newest entry written.
+ * @return False if the snapshot could not be written.
+ */
+bool journal::Writer::compact(const Entry& latest) {
+    const std::string snap = path + snapSuffix;
+    const std::string temp = snap + tempSuffix;
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        return false;
+    }
+    const bool written = writeAll(out, &latest, sizeof(latest)) && ::fsync(out) == 0;
+    ::close(out);
+    if (!written || std::rename(temp.c_str(), snap.c_str()) != 0) {
+        std::cerr << "Autosave snapshot failed" << std::endl;
+        return false;
+    }
+    syncDirectory(snap);
+    if (::ftruncate(fd, 0) == 0) {
+        ::fsync(fd);
+    }
+    return true;
+}
+
+/**
+ * @brief Drains the queue, appends each batch with one write and commits it with one sync, and compacts the
+ * journal every compactEvery entries. A Started entry drops the earlier game's journal and snapshot first.
+ */
+void journal::Writer::run() {
+    std::vector<Entry> batch;
+    std::uint32_t sinceSnapshot = 0;
+
+    while (true) {
+        // Read the flag first, so every entry pushed before close() is drained below
+        const bool stop = stopping.load();
+        Entry entry;
+        while (queue.pop(entry)) {
+            if (entry.kind == Started) {
+                batch.clear();
+                std::remove((path + snapSuffix).c_str());
+                if (::ftruncate(fd, 0) != 0) {
+                    std::cerr << "Cannot empty autosave journal " << path << std::endl;
+                }
+                sinceSnapshot = 0;
+            }
+            batch.push_back(entry);
+            batch.back().check = checksum(batch.back()); // Over the bytes that will be written, padding and all
+        }
+
+        if (!batch.empty()) {
+            if (!writeAll(fd, batch.data(), batch.size() * sizeof(Entry)) || ::fsync(fd) != 0) {
+                std::cerr << "Autosave write failed" << std::endl;
+            }
+            sinceSnapshot += static_cast<std::uint32_t>(batch.size());
+            if (sinceSnapshot >= compactEvery && compact(batch.back())) {
+                sinceSnapshot = 0;
+            }
+            batch.clear();
+        }
+        if (stop) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(idleMillis));
+    }
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include "LandingOdds.h"
+
+/**
+ * @file landingOdds.cpp
+ * @brief Implementation file for the landing odds overlay.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+    const float shadeHalfSize = 18.0f; ///< Half the side of a shaded square; spaces are 40 pixels apart.
+}
+
+/**
+ * @brief Constructs an overlay that is hidden and tracks nothing yet.
+ * @param wheelNumbers Numbers on the wheel.
+ * @param eventSpaces Positions of the event spaces.
+ * @param spins Number of spins ahead to look.
+ */
+LandingOdds::LandingOdds(const std::vector<int>& wheelNumbers, const std::vector<sf::Vector2f>& eventSpaces, int spins)
+    : eventSpaces(eventSpaces), index(-1), spins(std::max(spins, 1)), shading(sf::Quads), visible(false) {
+    for (int number : wheelNumbers) {
+        if (number >= static_cast<int>(spin.size())) {
+            spin.resize(number + 1, 0.0);
+        }
+        spin[number] += 1.0 / wheelNumbers.size();
+    }
+}
+
+/**
+ * @brief Extends the position distributions by convolving the last one with the spin distribution.
+ * @param upTo Number of spins to extend to.
+ */
+void LandingOdds::convolve(int upTo) {
+    const int last = static_cast<int>(path.size()) - 1;
+    while (static_cast<int>(position.size()) <= upTo) {
+        const std::vector<double>& before = position.back();
+        std::vector<double> after(path.size(), 0.0);
+        for (int i = 0; i <= last; ++i) {
+            if (before[i] == 0) {
+                continue;
+            }
+            if (i == last) {
+                after[i] += before[i]; // Graduated players stay put
+                continue;
+            }
+            for (size_t number = 1; number < spin.size(); ++number) {
+                after[std::min(i + static_cast<int>(number), last)] += before[i] * spin[number];
+            }
+        }
+        position.push_back(after);
+    }
+}
+
+/**
+ * @brief Rebuilds the landing chances and the vertex array.
+ */
+void LandingOdds::rebuild() {
+    const int last = static_cast<int>(path.size()) - 1;
+    landing.assign(path.size(), 0.0);
+    for (int i = 0; i < last; ++i) {
+        // Moves only go forward, so landing on a space on different spins are separate outcomes
+        for (int s = 1; s <= spins; ++s) {
+            landing[i] += position[s][i];
+        }
+    }
+    if (last >= 0 && index < last) {
+        landing[last] = position[spins][last];
+    }
+
+    shading.clear();
+    bounds = sf::FloatRect();
+    bool first = true;
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (landing[i] <= 0) {
+            continue;
+        }
+        bool isEvent = std::find(eventSpaces.begin(), eventSpaces.end(), path[i]) != eventSpaces.end();
+        sf::Uint8 alpha = static_cast<sf::Uint8>(40 + 180 * std::min(landing[i], 1.0));
+        sf::Color color = isEvent ? sf::Color(255, 200, 0, alpha) : sf::Color(255, 255, 255, alpha);
+
+        sf::Vector2f centre = path[i];
+        shading.append(sf::Vertex(centre + sf::Vector2f(-shadeHalfSize, -shadeHalfSize), color));
+        shading.append(sf::Vertex(centre + sf::Vector2f(shadeHalfSize, -shadeHalfSize), color));
+        shading.append(sf::Vertex(centre + sf::Vector2f(shadeHalfSize, shadeHalfSize), color));
+        shading.append(sf::Vertex(centre + sf::Vector2f(-shadeHalfSize, shadeHalfSize), color));
+
+        sf::FloatRect square(centre.x - shadeHalfSize, centre.y - shadeHalfSize, 2 * shadeHalfSize, 2 * shadeHalfSize);
+        if (first) {
+            bounds = square;
+            first = false;
+        } else {
+            float left = std::min(bounds.left, square.left);
+            float top = std::min(bounds.top, square.top);
+            float right = std::max(bounds.left + bounds.width, square.left + square.width);
+            float bottom = std::max(bounds.top + bounds.height, square.top + square.height);
+            bounds = sf::FloatRect(left, top, right - left, bottom - top);
+        }
+    }
+    markDirty();
+}
+
+/**
+ * @brief Follows a player, recomputing only if the path or space changed.
+ * @param playerPath Path the player follows.
+ * @param spaceIndex Space the player is on or moving to.
+ */
+void LandingOdds::track(const std::vector<sf::Vector2f>& playerPath, int spaceIndex) {
+    if (spaceIndex == index && playerPath == path) {
+        return;
+    }
+    path = playerPath;
+    index = spaceIndex;
+    position.assign(1, std::vector<double>(path.size(), 0.0));
+    position[0][index] = 1.0;
+    convolve(spins);
+    rebuild();
+}
+
+/**
+ * @brief Changes how many spins ahead to look, reusing the distributions already computed.
+ * @param count Number of spins, at least 1.
+ */
+void LandingOdds::setSpins(int count) {
+    spins = std::max(count, 1);
+    if (index < 0) {
+        return;
+    }
+    convolve(spins);
+    rebuild();
+}
+
+/**
+ * @brief Shows or hides the overlay.
+ * @param show True to show the overlay.
+ */
+void LandingOdds::setVisible(bool show) {
+    if (show != visible) {
+        visible = show;
+        markDirty();
+    }
+}
+
+/**
+ * @brief Checks if the overlay is shown.
+ * @return True if the overlay is shown.
+ */
+bool LandingOdds::isVisible() const {
+    return visible;
+}
+
+/**
+ * @brief Gets the chance of landing on a space within the next spins.
+ * @param space Index of the space.
+ * @return Probability from 0 to 1.
+ */
+double LandingOdds::chance(int space) const {
+    return (space >= 0 && space < static_cast<int>(landing.size())) ? landing[space] : 0.0;
+}
+
+/**
+ * @brief Gets the area covered by the shading.
+ * @return Bounding rectangle, empty while hidden.
+ */
+sf::FloatRect LandingOdds::getBounds() const {
+    return visible ? bounds : sf::FloatRect();
+}
+
+/**
+ * @brief Draws the shading as part of the scene.
+ * @param target Render target to draw on.
+ */
+void LandingOdds::render(sf::RenderTarget& target) {
+    if (visible) {
+        target.draw(shading, sf::BlendAlpha);
+    }
+}
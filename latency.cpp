@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "Latency.h"
+#include "Metrics.h"
+
+/**
+ * @file latency.cpp
+ * @brief Implementation file for the input-to-photon latency mode.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    /**
+     * @brief A scripted event and when to hand it out.
+     */
+    struct Scripted {
+        std::int64_t micros; ///< Time after enable() the event is due.
+        sf::Event event;     ///< The event.
+    };
+
+    const char* const inputNames[latency::inputCount] = {"spin", "major pick", "resource view", "popup close"};
+    const int bucketCount = 12; ///< Histogram buckets: under 1 ms, then doubling up to 1024 ms and over.
+
+    bool on = false;                                  ///< True once enabled.
+    std::int64_t startMicros = 0;                     ///< Time enable() was called.
+    std::vector<Scripted> script;                     ///< Scripted events in time order.
+    size_t nextScripted = 0;                          ///< Next scripted event to hand out.
+    std::int64_t polledAt[latency::inputCount];       ///< Poll time of the input waiting to be shown, or -1.
+    bool tagged[latency::inputCount];                 ///< True if the next frame shows that input.
+    std::vector<std::int64_t> samples[latency::inputCount]; ///< Measured latencies in microseconds.
+
+    /**
+     * @brief Reads the steady clock.
+     * @return Current time in microseconds.
+     */
+    std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Looks up a key by the name used in scripts.
+     * @param name A letter or "Space".
+     * @param key Receives the key.
+     * @return False if the name is not a known key.
+     */
+    bool keyNamed(const std::string& name, sf::Keyboard::Key& key) {
+        if (name == "Space") {
+            key = sf::Keyboard::Space;
+            return true;
+        }
+        if (name.size() == 1 && std::toupper(name[0]) >= 'A' && std::toupper(name[0]) <= 'Z') {
+            key = static_cast<sf::Keyboard::Key>(sf::Keyboard::A + (std::toupper(name[0]) - 'A'));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Gets the value below which a share of sorted samples fall.
+     * @param sorted Samples in increasing order; not empty.
+     * @param share Share from 0 to 1.
+     * @return The percentile in milliseconds.
+     */
+    double percentile(const std::vector<std::int64_t>& sorted, double share) {
+        size_t index = static_cast<size_t>(share * (sorted.size() - 1) + 0.5);
+        return sorted[index] / 1000.0;
+    }
+}
+
+/**
+ * @brief Turns the latency mode on, loading the script if one is given.
+ * @param file Script file, or empty.
+ * @return False if the script could not be read.
+ */
+bool latency::enable(const std::string& file) {
+    script.clear();
+    nextScripted = 0;
+    if (!file.empty()) {
+        std::ifstream in(file);
+        if (!in) {
+            std::cerr << "Cannot open latency script " << file << std::endl;
+            return false;
+        }
+        std::string line;
+        int number = 0;
+        while (std::getline(in, line)) {
+            ++number;
+            std::istringstream words(line.substr(0, line.find('#')));
+            double ms;
+            std::string action;
+            if (!(words >> ms)) {
+                continue; // Blank or comment
+            }
+            Scripted scripted = {static_cast<std::int64_t>(ms * 1000), sf::Event()};
+            std::string name;
+            bool ok = static_cast<bool>(words >> action);
+            if (ok && (action == "press" || action == "release")) {
+                scripted.event.type = action == "press" ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+                ok = words >> name && keyNamed(name, scripted.event.key.code);
+            } else if (ok && action == "click") {
+                scripted.event.type = sf::Event::MouseButtonPressed;
+                scripted.event.mouseButton.button = sf::Mouse::Left;
+                ok = static_cast<bool>(words >> scripted.event.mouseButton.x >> scripted.event.mouseButton.y);
+            } else if (ok && action == "quit") {
+                scripted.event.type = sf::Event::Closed;
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                std::cerr << "Latency script line " << number << " is malformed: " << line << std::endl;
+                return false;
+            }
+            script.push_back(scripted);
+        }
+        std::stable_sort(script.begin(), script.end(), [](const Scripted& a, const Scripted& b) {
+            return a.micros < b.micros;
+        });
+    }
+
+    for (int i = 0; i < inputCount; ++i) {
+        polledAt[i] = -1;
+        tagged[i] = false;
+        samples[i].clear();
+    }
+    startMicros = now();
+    on = true;
+    return true;
+}
+
+/**
+ * @brief Checks if the latency mode is on.
+ * @return True once enabled.
+ */
+bool latency::enabled() {
+    return on;
+}
+
+/**
+ * @brief Polls the window, handing out due scripted events first.
+ * @param window Window to poll.
+ * @param event Receives the event.
+ * @return True if an event was returned.
+ */
+bool latency::pollEvent(sf::RenderWindow& window, sf::Event& event) {
+    if (nextScripted < script.size() && now() - startMicros >= script[nextScripted].micros) {
+        event = script[nextScripted++].event;
+        return true;
+    }
+    return window.pollEvent(event);
+}
+
+/**
+ * @brief Notes the poll time of an input.
+ * @param input Kind of input.
+ */
+void latency::pressed(Input input) {
+    if (on) {
+        polledAt[input] = now();
+        tagged[input] = false;
+    }
+}
+
+/**
+ * @brief Tags the next displayed frame with the waiting input of this kind.
+ * @param input Kind of input.
+ */
+void latency::reflect(Input input) {
+    if (on && polledAt[input] >= 0) {
+        tagged[input] = true;
+    }
+}
+
+/**
+ * @brief Shows the frame, then takes the time display() returned as the moment the tagged inputs reached the
+ * screen.
+ * @param window Window to display.
+ */
+void latency::display(sf::RenderWindow& window) {
+    window.display();
+    metrics::frameShown();
+    if (!on) {
+        return;
+    }
+    const std::int64_t shown = now();
+    for (int i = 0; i < inputCount; ++i) {
+        if (tagged[i]) {
+            samples[i].push_back(shown - polledAt[i]);
+            polledAt[i] = -1;
+            tagged[i] = false;
+        }
+    }
+}
+
+/**
+ * @brief Writes a histogram with power-of-two millisecond buckets and the 50th, 90th and 99th percentiles for
+ * each kind of input.
+ * @param out Stream to write to.
+ */
+void latency::report(std::ostream& out) {
+    out << "Input-to-photon latency" << std::endl;
+    for (int i = 0; i < inputCount; ++i) {
+        std::vector<std::int64_t> sorted = samples[i];
+        std::sort(sorted.begin(), sorted.end());
+        out << "  " << inputNames[i] << ": " << sorted.size() << " samples";
+        if (sorted.empty()) {
+            out << std::endl;
+            continue;
+        }
+        out << std::fixed << std::setprecision(1) << ", p50 " << percentile(sorted, 0.5) << " ms, p90 "
+            << percentile(sorted, 0.9) << " ms, p99 " << percentile(sorted, 0.99) << " ms, max "
+            << sorted.back() / 1000.0 << " ms" << std::endl;
+
+        int counts[bucketCount] = {};
+        for (std::int64_t micros : sorted) {
+            int bucket = 0;
+            while (bucket < bucketCount - 1 && micros >= (1000LL << bucket)) {
+                ++bucket;
+            }
+            ++counts[bucket];
+        }
+        for (int b = 0; b < bucketCount; ++b) {
+            if (counts[b] == 0) {
+                continue;
+            }
+            std::ostringstream range;
+            if (b == 0) {
+                range << "< 1";
+            } else if (b == bucketCount - 1) {
+                range << ">= " << (1 << (b - 1));
+            } else {
+                range << (1 << (b - 1)) << "-" << (1 << b);
+            }
+            out << "    " << std::setw(10) << range.str() << " ms " << std::setw(6) << counts[b] << " "
+                << std::string(std::max<size_t>(1, counts[b] * 40 / sorted.size()), '#') << std::endl;
+        }
+    }
+    out.unsetf(std::ios::fixed);
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Net.h"
+#include "Poller.h"
+#include "Protocol.h"
+#include "Rules.h"
+
+/**
+ * @file loadTest.cpp
+ * @brief Load tester for the session host: plays many tables at once from one process.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwLoadTest [address] [--tables N] [--first T]
+ *
+ * Opens two connections per table, tables T to T + N - 1, and plays every game to the end, checking each
+ * state update against the host's checksum. Prints throughput and request latency when all games are over.
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock; ///< Clock used to time requests.
+
+    /**
+     * @brief One simulated player.
+     */
+    struct Bot {
+        net::Connection connection; ///< Socket to the host.
+        int player;                 ///< Player index the bot plays, 0 or 1.
+        rules::GameState state;     ///< Bot's copy of its table's state.
+        bool synced;                ///< True once the first state has arrived.
+        bool waiting;               ///< True while a request is waiting for its state update.
+        bool writing;               ///< True while the poller waits for the socket to become writable.
+        bool done;                  ///< True once the bot's game is over or its connection failed.
+        Clock::time_point sentAt;   ///< When the request in flight was sent.
+
+        /**
+         * @brief Constructor for the Bot struct.
+         * @param fd Connected non-blocking socket.
+         * @param player Player index the bot plays.
+         */
+        Bot(int fd, int player)
+            : connection(fd), player(player), state(), synced(false), waiting(false), writing(false), done(false) {
+        }
+    };
+}
+
+/**
+ * @brief Runs the load test.
+ * @param argc Number of arguments.
+ * @param argv Address, --tables and --first options.
+ * @return 0 if every game finished with every update verified.
+ */
+int main(int argc, char* argv[]) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::string address = net::defaultAddress;
+    int tables = 1000;
+    std::uint32_t first = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tables" && i + 1 < argc) {
+            tables = std::atoi(argv[++i]);
+        } else if (arg == "--first" && i + 1 < argc) {
+            first = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            address = arg;
+        }
+    }
+
+    long fileLimit = net::raiseFileLimit();
+    if (fileLimit >= 0 && 2L * tables + 16 > fileLimit) {
+        std::cerr << "Only " << fileLimit << " sockets may be open; use fewer tables" << std::endl;
+        return 1;
+    }
+
+    const rules::Board& board = rules::Board::standard();
+    std::mt19937 gen(std::random_device{}());
+    Poller poller;
+    std::vector<std::unique_ptr<Bot>> bots;
+    Clock::time_point start = Clock::now();
+
+    for (int t = 0; t < tables; ++t) {
+        for (int player = 0; player < rules::playerCount; ++player) {
+            int fd = net::connectTo(address);
+            if (fd < 0) {
+                return 1;
+            }
+            bots.emplace_back(new Bot(fd, player));
+            std::vector<std::uint8_t> hello;
+            protocol::putVarint(hello, player + 1);
+            protocol::putVarint(hello, first + t);
+            bots.back()->connection.send(protocol::Hello, hello);
+            bots.back()->connection.flush();
+            poller.add(fd, bots.back().get(), false);
+        }
+    }
+    Clock::time_point connected = Clock::now();
+
+    size_t remaining = bots.size();
+    long updates = 0;
+    long failures = 0;
+    std::vector<double> latencies; // Microseconds from each request to its state update
+    std::vector<void*> ready;
+
+    while (remaining > 0) {
+        poller.wait(ready, 10000);
+        if (ready.empty()) {
+            std::cerr << "No progress for 10 seconds with " << remaining << " players still in play" << std::endl;
+            break;
+        }
+
+        for (void* token : ready) {
+            Bot& bot = *static_cast<Bot*>(token);
+            if (bot.done) {
+                continue;
+            }
+            bool alive = bot.connection.receive();
+
+            protocol::Message message;
+            while (bot.connection.next(message)) {
+                if (message.type != protocol::State) {
+                    continue;
+                }
+                if (!protocol::applyState(message, bot.state)) {
+                    ++failures;
+                }
+                if (bot.waiting) {
+                    latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - bot.sentAt).count());
+                }
+                bot.synced = true;
+                bot.waiting = false;
+                ++updates;
+            }
+
+            // Pick a path once, then spin whenever it is this bot's turn
+            if (bot.synced && !bot.waiting && !rules::gameOver(bot.state, board)) {
+                if (!bot.state.players[bot.player].chosen) {
+                    std::vector<std::uint8_t> payload;
+                    protocol::putVarint(payload, std::uniform_int_distribution<>(0, rules::pathCount - 1)(gen));
+                    bot.connection.send(protocol::ChoosePath, payload);
+                    bot.waiting = true;
+                } else if (bot.state.turn == bot.player && rules::canSpin(bot.state, board)) {
+                    bot.connection.send(protocol::Spin, std::vector<std::uint8_t>());
+                    bot.waiting = true;
+                }
+                if (bot.waiting) {
+                    bot.sentAt = Clock::now();
+                }
+            }
+
+            alive = bot.connection.flush() && alive;
+            if (!alive || (bot.synced && rules::gameOver(bot.state, board))) {
+                if (!alive) {
+                    ++failures;
+                }
+                bot.done = true;
+                poller.remove(bot.connection.fd());
+                --remaining;
+            } else if (bot.writing != bot.connection.wantsWrite()) {
+                bot.writing = bot.connection.wantsWrite();
+                poller.modify(bot.connection.fd(), &bot, bot.writing);
+            }
+        }
+    }
+
+    double connectSeconds = std::chrono::duration<double>(connected - start).count();
+    double playSeconds = std::chrono::duration<double>(Clock::now() - connected).count();
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+
+    std::cout << tables << " tables, " << bots.size() << " connections opened in " << connectSeconds << " s" << std::endl;
+    std::cout << bots.size() - remaining << " players finished in " << playSeconds << " s, " << updates
+              << " state updates (" << static_cast<long>(updates / playSeconds) << "/s), " << failures
+              << " failures" << std::endl;
+    std::cout << "Request latency: p50 " << percentile(0.5) << " us, p99 " << percentile(0.99) << " us, max "
+              << percentile(1.0) << " us" << std::endl;
+    return (remaining == 0 && failures == 0) ? 0 : 1;
+}
@@ -1,14 +1,35 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
 #include "Wheel.h"
 #include "Graduation.h"
 #include "Player.h"
 #include "GameBoard.h"
+#include "Journal.h"
 #include "Events.h"
 #include "game.h"
 #include "majorSelection.h"
 #include "ResourceDisplay.h"
+#include "Assets.h"
+#include "SceneGraph.h"
+#include "LandingOdds.h"
+#include "NetworkGame.h"
+#include "Net.h"
+#include "Bot.h"
+#include "Latency.h"
+#include "Metrics.h"
+#include "Pacing.h"
+#include "Rules.h"
+#include "Simulation.h"
+#include "Tables.h"
+#include "Telemetry.h"
 
 /**
  * @file main.cpp
@@ -21,19 +42,125 @@ const int TILE_SIZE = 40;                  /**< Size of each tile in pixels. */
 const int BOARD_SIZE = 11;                 /**< Size of the game board (number of tiles in each dimension). */
 const int WINDOW_WIDTH = TILE_SIZE * BOARD_SIZE; /**< Width of the game window. */
 const int WINDOW_HEIGHT = TILE_SIZE * BOARD_SIZE; /**< Height of the game window. */
+const float PAN_STEP = 0.125f;             /**< Fraction of the view an arrow key pans a loaded board by. */
+const float ZOOM_STEP = 1.25f;             /**< Change in view size for one notch of the mouse wheel. */
 
 /**
  * @brief Main function to run the Western Wonderland game.
+ * Pass --connect [address] to join a game server instead of playing locally, and --seat 1 or 2 to choose a
+ * player (0 watches). Pass --bot [ms] to play alone against the computer, which plays player 2 and may think
+ * for the given number of milliseconds per decision (5 by default). Pass --telemetry file to append a JSON line
+ * describing each local game to the file. Pass --board layout.txt to play on a board loaded from a layout file,
+ * which the window shows through a camera that follows the current player and can be panned and zoomed. Pass
+ * --latency [script] to time each input until the frame showing it is on screen, optionally playing back
+ * scripted input, and print latency histograms on exit. Pass --tables N to play 4 to 16 independent local games in
+ * one window, each table in its own part of it. Pass --metrics [address] to serve live counters and histograms in
+ * the Prometheus text format on a local socket, 127.0.0.1:9464 by default. Pass --autosave [file] to journal every
+ * change to a local game and carry on an unfinished game from the journal at the next launch. Pass --speed N to
+ * play local games N times faster than real time with the visuals on, or --speed max to play as fast as possible.
+ * @param argc Number of arguments.
+ * @param argv Command line arguments.
  * @return Exit status of the program.
  */
-int main() {
-    int turn = 1; 
+int main(int argc, char* argv[]) {
+    std::string serverAddress;
+    int seat = 0;
+    double botBudgetMs = 0;
+    std::string telemetryFile;
+    std::string boardFile;
+    bool measureLatency = false;
+    std::string latencyScript;
+    int tableCount = 0;
+    std::string metricsAddress;
+    std::string autosaveFile;
+    double speed = 1.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bot") {
+            botBudgetMs = (i + 1 < argc && argv[i + 1][0] != '-') ? std::atof(argv[++i]) : 5;
+        } else if (arg == "--connect") {
+            serverAddress = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : net::defaultAddress;
+        } else if (arg == "--seat" && i + 1 < argc) {
+            seat = std::atoi(argv[++i]);
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetryFile = argv[++i];
+        } else if (arg == "--board" && i + 1 < argc) {
+            boardFile = argv[++i];
+        } else if (arg == "--latency") {
+            measureLatency = true;
+            latencyScript = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "";
+        } else if (arg == "--tables" && i + 1 < argc) {
+            tableCount = std::atoi(argv[++i]);
+        } else if (arg == "--metrics") {
+            metricsAddress = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : metrics::defaultAddress;
+        } else if (arg == "--autosave") {
+            autosaveFile = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "westernwonderland.journal";
+        } else if (arg == "--speed" && i + 1 < argc) {
+            std::string value = argv[++i];
+            speed = value == "max" ? pacing::fastest : std::atof(value.c_str());
+            if (speed != pacing::fastest && speed <= 0) {
+                std::cerr << "--speed takes a positive multiple of real time or max" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Loaded layouts can be far bigger than the window, so they are seen through a camera
+    rules::Board loadedBoard;
+    const rules::Board* layout = &rules::Board::standard();
+    if (!boardFile.empty()) {
+        std::ifstream file(boardFile);
+        if (!file || !rules::Board::load(file, loadedBoard)) {
+            std::cerr << boardFile << " failed to load" << std::endl;
+            return 1;
+        }
+        layout = &loadedBoard;
+    }
+    const bool roaming = layout != &rules::Board::standard();
+    if (measureLatency && !latency::enable(latencyScript)) {
+        return 1;
+    }
+    if (!metricsAddress.empty() && !metrics::serve(events::deck().events.size(), metricsAddress)) {
+        return 1;
+    }
 
-    sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Western Wonderland");
+    // A grid of tables shows each at the single-game size, shrunk if the grid would not fit on the desktop
+    sf::Vector2u windowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+    if (tableCount > 0) {
+        windowSize = tables::windowSize(tableCount, WINDOW_WIDTH);
+    }
+    sf::RenderWindow window(sf::VideoMode(windowSize.x, windowSize.y), "Western Wonderland");
+
+    // Decode every image and font in the background while the loading screen is up
+    assets::preload({"westernUniversity.jpg", "westernLogo.png", "iveyLogo.png"},
+                    {"Lobster.ttf", "Arial.ttf", "Montserrat Medium 500.ttf"});
+    assets::loadingScreen(window);
+
+    // Play on a server, which decides every spin and event
+    if (!serverAddress.empty()) {
+        int status = gamestart::gamestart(window) ? networkGame::play(window, serverAddress, seat) : 0;
+        if (latency::enabled()) {
+            latency::report(std::cout);
+        }
+        return status;
+    }
+
+    events::useBoard(*layout);
 
-    GameBoard board;
+    // Markers, ticks, the wheel and graduation wait in game time from here on; network games keep the server's pace
+    pacing::setSpeed(speed);
+
+    // Several local games in one window, sharing the board, deck and assets
+    if (tableCount > 0) {
+        int status = tables::play(window, *layout, tableCount, WINDOW_WIDTH, botBudgetMs);
+        if (latency::enabled()) {
+            latency::report(std::cout);
+        }
+        return status;
+    }
+
+    GameBoard board(*layout);
     Wheel wheel;
-    float arrowAngle = 0;
 
     Player player1(board.getIveyPath(), sf::Color::Red);
     Player player2(board.getWesternPath(), sf::Color::Blue);
@@ -47,111 +174,259 @@ int main() {
     player2.setGPA(0);
     player2.setDebt(0);
 
+    // Retained scene: the board is cached, markers and the wheel are redrawn only when they change
+    Scene scene(WINDOW_WIDTH, WINDOW_HEIGHT);
+    scene.addStatic(board);
+    LandingOdds odds(wheel.GetNumbers(), board.getEventSpaces());
+    scene.addDynamic(odds); // Above the board, below the markers
+    scene.addDynamic(player1);
+    scene.addDynamic(player2);
+    scene.addOverlay(wheel); // Stays put when the camera moves
+
+    // The camera starts on the current player's marker at one window pixel per board pixel
+    sf::View camera(sf::FloatRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT));
+    bool following = roaming;
+    bool dragging = false;
+    sf::Vector2i dragFrom;
+    const float widest = std::max(board.getBounds().width, board.getBounds().height);
+
+    // The computer plays player 2 in single-player mode; it thinks on worker threads of its own
+    std::unique_ptr<Bot> bot;
+    if (botBudgetMs > 0) {
+        bot.reset(new Bot(*layout, events::deck(),
+                          std::chrono::microseconds(static_cast<long>(botBudgetMs * 1000))));
+    }
+
+    // A game left unfinished by a crash or power cut carries on where its journal ends, skipping the start screen
+    journal::Entry saved;
+    const bool resuming = !autosaveFile.empty() && journal::recover(autosaveFile, *layout, events::deck(), saved);
+
     // Display major selection screen
-    bool startClicked = gamestart::gamestart(window);
-    int majorClicked;
-    int majorChosen1 = 0;
-    int majorChosen2 = 0;
+    bool startClicked = resuming || gamestart::gamestart(window);
+
+    // Telemetry is written by a background thread; the simulation only queues records
+    telemetry::Log log;
+    if (!telemetryFile.empty()) {
+        log.open(telemetryFile);
+    }
+
+    // So is the autosave journal, so saving never waits on the disk
+    journal::Writer journal;
+    if (!autosaveFile.empty()) {
+        journal.open(autosaveFile);
+    }
+
+    // The rules, the markers' timing and the bot run on the simulation thread. This thread polls input, sends it
+    // over and draws whatever the simulation last published, so a slow frame or popup never holds up the game.
+    Simulation simulation(*layout, events::deck(), wheel, bot.get(), log, std::random_device()());
+    Player* players[rules::playerCount] = {&player1, &player2};
+    bool pathShown[rules::playerCount] = {false, false};
+    bool asked[rules::playerCount] = {false, bot != nullptr};
+    int spinsShown = 0;
+    int eventsShown = 0;
+    std::uint64_t spinSentTick = ~std::uint64_t(0); // Tick of the snapshot a spin was last sent against
+
+    // Carry on the recovered game without asking for paths already chosen, and journal every change from here on
+    if (resuming) {
+        simulation.resume(saved);
+        for (int p = 0; p < rules::playerCount; ++p) {
+            asked[p] = asked[p] || saved.state.players[p].chosen;
+        }
+    }
+    if (journal.isOpen()) {
+        simulation.autosave(journal);
+    }
+
+    // Brings a marker and its resources in line with the latest snapshot
+    auto showPlayer = [&](int p) {
+        const Simulation::Snapshot& snapshot = simulation.latest();
+        const rules::PlayerState& state = snapshot.state.players[p];
+        Player& player = *players[p];
+        if (state.chosen && !pathShown[p]) {
+            player.setPath(state.path == rules::western ? board.getWesternPath() : board.getIveyPath());
+            pathShown[p] = true;
+        }
+        if (player.getPosition() != player.getPath()[snapshot.shown[p]]) {
+            player.setSpaceIndex(snapshot.shown[p]);
+        }
+
+        // Leave out an event still on its way, and remember the setters add the amount they are given
+        const rules::Effect& unseen = snapshot.unseen[p];
+        player.setHappiness(state.happiness - unseen.happiness - player.getHappiness());
+        player.setDebt(state.debt - unseen.debt - player.getDebt());
+        player.setGPA(state.gpa - unseen.gpa - player.getGPA());
+    };
 
     if (startClicked) {
+        simulation.start();
         while (window.isOpen()) {
+            simulation.update();
+            const Simulation::Snapshot& snapshot = simulation.latest();
+            showPlayer(0);
+            showPlayer(1);
+
             // Check for graduation event and calculate scores
             if (player1.finished() && player2.finished()) {
                 Graduation::graduationEvent(window, "Graduation", player1, player2);
+                scene.invalidate();
             }
 
-            // Update and draw game elements
-            window.clear();
-            board.draw(window);
-            player1.update();
-            player2.update();
-            player1.draw(window);
-            player2.draw(window);
-            wheel.DrawWheel(arrowAngle, window);
+            // Redraw whatever changed
+            Player& current = *players[snapshot.state.turn];
+            odds.track(current.getPath(), snapshot.state.players[snapshot.state.turn].index);
+            if (following) {
+                camera.setCenter(current.getPosition());
+            }
+            scene.setCamera(camera);
+            if (!scene.present(window)) {
+                sf::sleep(sf::milliseconds(1)); // Nothing changed, so the previous frame is still on screen
+            }
 
-            window.display();
+            // Popups and the spin animation draw straight onto the window, so the next frame is recomposed in full
+            bool popupShown = false;
+
+            // Spin the wheel to each new result; the simulation starts the marker once the animation would end
+            if (snapshot.spins != spinsShown) {
+                latency::reflect(latency::Spin);
+                std::pair<int, float> result = wheel.SpinWheelTo(snapshot.lastTurn.spin, window);
+                wheel.SetArrowAngle(result.second);
+                spinsShown = snapshot.spins;
+                popupShown = true;
+            }
+
+            // Show each event once its marker has stopped on it
+            if (snapshot.events != eventsShown) {
+                events::eventPopup(window, events::deck().events[snapshot.event], snapshot.effect);
+                latency::reflect(latency::PopupClose);
+                simulation.send({Simulation::EventSeen, 0, 0});
+                eventsShown = snapshot.events;
+                popupShown = true;
+            }
+
+            // Major selection for each person playing, player 1 first
+            for (int p = 0; p < rules::playerCount; ++p) {
+                if (!asked[p] && (p == 0 || asked[0])) {
+                    int majorClicked = majorSelection::majorEvent(window, "Player " + std::to_string(p + 1) +
+                                                                          " Choose Your Path");
+                    latency::reflect(latency::MajorPick);
+                    popupShown = true;
+                    if (majorClicked == rules::western || majorClicked == rules::ivey) {
+                        simulation.send({Simulation::ChoosePath, static_cast<std::int8_t>(p),
+                                         static_cast<std::int8_t>(majorClicked)});
+                        asked[p] = true;
+                    }
+                }
+            }
 
             // Handle events
             sf::Event event;
-            while (window.pollEvent(event)) {
+            while (latency::pollEvent(window, event)) {
                 if (event.type == sf::Event::Closed) {
                     window.close();
                 }
 
-                // Major selection for Player 1
-                if (player1.getPosition() == (sf::Vector2f(220, 420)) && majorChosen1 == 0) {
-                    majorClicked = majorSelection::majorEvent(window, "Player 1 Choose Your Path");
-                    if (majorClicked == 0) {
-                        player1.setPath(board.getWesternPath());
-                        majorChosen1 = 1;
-                    } else if (majorClicked == 1 && majorChosen1 == 0) {
-                        player1.setPath(board.getIveyPath());
-                        majorChosen1 = 1;
-                    }
-                }
-
-                // Major selection for Player 2
-                if (player2.getPosition() == (sf::Vector2f(220, 420)) && majorChosen2 == 0) {
-                    majorClicked = majorSelection::majorEvent(window, "Player 2 Choose Your Path");
-                    if (majorClicked == 0) {
-                        player2.setPath(board.getWesternPath());
-                        majorChosen2 = 1;
-                    } else if (majorClicked == 1 && majorChosen2 == 0) {
-                        player2.setPath(board.getIveyPath());
-                        majorChosen2 = 1;
-                    }
+                if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus) {
+                    scene.invalidate();
                 }
 
                 // Display resources for Player 1
                 if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A) {
+                    latency::pressed(latency::ResourceView);
+                    latency::reflect(latency::ResourceView);
                     ResourceDisplay::resourceDisplay(window, player1, "Resources");
+                    latency::reflect(latency::PopupClose);
+                    popupShown = true;
                 }
 
                 // Display resources for Player 2
                 if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B) {
+                    latency::pressed(latency::ResourceView);
+                    latency::reflect(latency::ResourceView);
                     ResourceDisplay::resourceDisplay(window, player2, "Resources");
+                    latency::reflect(latency::PopupClose);
+                    popupShown = true;
+                }
+
+                // Show or hide the landing odds of the player whose turn it is
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::O) {
+                    odds.setVisible(!odds.isVisible());
                 }
 
-                // Spin the wheel on Space key release
-                if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Space) {
-                    std::pair<int, float> result = wheel.SpinWheel(window);
-                    int spinResult = result.first;
-                    arrowAngle = result.second;
-
-                    if (turn == 1 && !player1.finished()) {
-                        player1.move(spinResult);
-                        if (!player2.finished()) {
-                            turn = 2;
-                        }
-                    } else if (turn == 2 && !player2.finished()) {
-                        player2.move(spinResult);
-                        if (!player1.finished()) {
-                            turn = 1;
-                        }
+                // On a loaded board, the arrow keys and dragging pan, the mouse wheel zooms and C follows again
+                if (roaming && event.type == sf::Event::KeyPressed) {
+                    sf::Vector2f step = camera.getSize() * PAN_STEP;
+                    if (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right) {
+                        camera.move(event.key.code == sf::Keyboard::Left ? -step.x : step.x, 0);
+                        following = false;
+                    } else if (event.key.code == sf::Keyboard::Up || event.key.code == sf::Keyboard::Down) {
+                        camera.move(0, event.key.code == sf::Keyboard::Up ? -step.y : step.y);
+                        following = false;
+                    } else if (event.key.code == sf::Keyboard::C) {
+                        following = true;
                     }
                 }
+                if (roaming && event.type == sf::Event::MouseWheelScrolled) {
+                    // Zoom about the board point under the cursor, between a few tiles and the whole board
+                    sf::Vector2i cursor(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                    sf::Vector2f before = window.mapPixelToCoords(cursor, camera);
+                    float factor = event.mouseWheelScroll.delta > 0 ? 1 / ZOOM_STEP : ZOOM_STEP;
+                    float width = std::min(std::max(camera.getSize().x * factor, 4.0f * layout->tileSize),
+                                           std::max(widest, static_cast<float>(WINDOW_WIDTH)));
+                    camera.zoom(width / camera.getSize().x);
+                    if (!following) {
+                        camera.move(before - window.mapPixelToCoords(cursor, camera));
+                    }
+                }
+                if (roaming && event.type == sf::Event::MouseButtonPressed &&
+                    event.mouseButton.button == sf::Mouse::Left) {
+                    dragging = true;
+                    dragFrom = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+                }
+                if (event.type == sf::Event::MouseButtonReleased) {
+                    dragging = false;
+                }
+                if (dragging && event.type == sf::Event::MouseMoved) {
+                    sf::Vector2i to(event.mouseMove.x, event.mouseMove.y);
+                    camera.move(window.mapPixelToCoords(dragFrom, camera) - window.mapPixelToCoords(to, camera));
+                    dragFrom = to;
+                    following = false;
+                }
 
-                // Event trigger for Player 1
-                if (player1.onEvent(board.getEventSpaces()) && player1.justMoved() == true) {
-                    events::playerEvent(window, "event", player1);
+                // U takes back the last turn and Y plays it again; the simulation ignores both mid-move
+                if (event.type == sf::Event::KeyPressed &&
+                    (event.key.code == sf::Keyboard::U || event.key.code == sf::Keyboard::Y)) {
+                    simulation.send({Simulation::Rewind, 0,
+                                     static_cast<std::int8_t>(event.key.code == sf::Keyboard::U ? -1 : 1)});
                 }
 
-                // Event trigger for Player 2
-                if (player2.onEvent(board.getEventSpaces()) && player2.justMoved() == true) {
-                    events::playerEvent(window, "event", player2);
+                // Spin the wheel on Space key release, only when the simulation would take the spin and has not
+                // yet been sent one for this snapshot, so an ignored press is never left waiting to be timed
+                if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Space &&
+                    snapshot.spinReady && snapshot.tick != spinSentTick) {
+                    latency::pressed(latency::Spin);
+                    simulation.send({Simulation::Spin, 0, 0});
+                    spinSentTick = snapshot.tick;
                 }
             }
+
+            if (popupShown) {
+                scene.invalidate();
+            }
         }
+        simulation.stop();
 
         // Display final game state
         window.clear();
+        window.setView(scene.getCamera());
         board.draw(window);
-        wheel.DrawWheel(arrowAngle, window);
-        player1.update();
-        player2.update();
         player1.draw(window);
         player2.draw(window);
+        window.setView(window.getDefaultView());
+        wheel.DrawWheel(wheel.GetArrowAngle(), window);
         window.display();
     }
+    if (latency::enabled()) {
+        latency::report(std::cout);
+    }
     return 0;
 }
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <SFML/Graphics.hpp>
 #include "majorSelection.h"
+#include "Assets.h"
+#include "DrawList.h"
+#include "Latency.h"
+#include "Metrics.h"
 
 /**
  * @file majorSelection.cpp
@@ -15,51 +19,19 @@
  * @return 1 if the player selects Ivey, 0 if the player selects Western, false if the window is closed.
  */
 int majorSelection::majorEvent(sf::RenderWindow& window, const std::string& message) {
-    // Load popup image
-    sf::Texture popupImage;
-    if (!popupImage.loadFromFile("westernUniversity.jpg")) {
-        std::cerr << "Image failed to load" << std::endl;
-    }
+    metrics::PopupTimer onScreen(metrics::MajorPopup);
 
     // Create a sprite for the popup background
-    sf::Sprite popupSprite;
-    popupSprite.setTexture(popupImage);
-
-    float scale = 0.9f; // Adjust this value to control the size
-    popupSprite.setScale(scale, scale);
-
-    // Load Western logo button image
-    sf::Texture westernButton;
-    if (!westernButton.loadFromFile("westernLogo.png")) {
-        std::cerr << "Western image failed to load" << std::endl;
-    }
+    sf::Sprite popupSprite = assets::sprite("westernUniversity.jpg");
 
     // Create a sprite for the Western logo button
-    sf::Sprite westernSprite;
-    westernSprite.setTexture(westernButton);
-
-    // Load Ivey logo button image
-    sf::Texture iveyButton;
-    if (!iveyButton.loadFromFile("iveyLogo.png")) {
-        std::cerr << "Ivey image failed to load" << std::endl;
-    }
+    sf::Sprite westernSprite = assets::sprite("westernLogo.png");
 
     // Create a sprite for the Ivey logo button
-    sf::Sprite iveySprite;
-    iveySprite.setTexture(iveyButton);
+    sf::Sprite iveySprite = assets::sprite("iveyLogo.png");
 
-    float iveyScale = 0.3f; // Adjust this value to control the size
-    iveySprite.setScale(iveyScale, iveyScale);
-
-    // Load fonts
-    sf::Font font;
-    if (!font.loadFromFile("Montserrat Medium 500.ttf")) {
-        std::cerr << "Montserrat font failed to load" << std::endl;
-    }
-    sf::Font arialFont;
-    if (!arialFont.loadFromFile("Arial.ttf")) {
-        std::cerr << "Arial font failed to load" << std::endl;
-    }
+    // Fonts
+    const sf::Font& font = assets::font("Montserrat Medium 500.ttf");
 
     // Create text for different options
     sf::Text text;
@@ -101,18 +73,22 @@ int majorSelection::majorEvent(sf::RenderWindow& window, const std::string& mess
     background.setFillColor(sf::Color::Transparent);
     background.setPosition((window.getSize().x - background.getSize().x) / 2, (window.getSize().y - background.getSize().y) / 2);
 
+    // Record the popup once: the picture, then both logos, then the text on top
+    DrawList popup;
+    popup.sprite(popupSprite, 0);
+    popup.shape(background, 0);
+    popup.sprite(westernSprite, 1);
+    popup.sprite(iveySprite, 1);
+    popup.text(text, 2);
+    popup.text(text2, 2);
+    popup.text(text3, 2);
+
     while (window.isOpen()) {
         window.clear();  // Clear the window at the beginning of each loop
-        window.draw(popupSprite);
-        window.draw(background);
-        window.draw(westernSprite);
-        window.draw(iveySprite);
-        window.draw(text);
-        window.draw(text2);
-        window.draw(text3);
+        popup.draw(window);
 
         sf::Event event;
-        while (window.pollEvent(event)) {
+        while (latency::pollEvent(window, event)) {
             if (event.type == sf::Event::Closed) {
                 window.close();
                 return false;
@@ -121,15 +97,17 @@ int majorSelection::majorEvent(sf::RenderWindow& window, const std::string& mess
             // Check for key presses to select a major
             if (event.type == sf::Event::KeyPressed) {
                 if (event.key.code == sf::Keyboard::I) {
+                    latency::pressed(latency::MajorPick);
                     return 1; // Ivey selected
                 }
                 else if (event.key.code == sf::Keyboard::W) {
+                    latency::pressed(latency::MajorPick);
                     return 0; // Western selected
                 }
             }
         }  
 
-        window.display();
+        latency::display(window);
     }
     return false;
 }
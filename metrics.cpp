@@ -0,0 +1,375 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include "Metrics.h"
+#include "Net.h"
+
+/**
+ * @file metrics.cpp
+ * @brief Implementation file for the live metrics endpoint.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const int maxBuckets = 12;          ///< Most buckets a histogram has, counting the +Inf one.
+    const int pollMillis = 100;         ///< Longest the exporter waits before checking if it should stop.
+    const int sendTimeoutMillis = 1000; ///< Longest the exporter waits on a slow scraper.
+
+    const double frameBounds[] = {0.001, 0.002, 0.004, 0.008, 0.0167, 0.0333, 0.05, 0.1, 0.25}; ///< Seconds.
+    const double popupBounds[] = {0.5, 1, 2, 5, 10, 30, 60};                                      ///< Seconds.
+    const char* const popupNames[metrics::popupCount] = {"event", "resources", "major", "graduation", "start"};
+
+    /**
+     * @brief A counter on a cache line of its own, so threads counting different things never share a line.
+     */
+    struct alignas(64) Counter {
+        std::atomic<std::uint64_t> value; ///< The count.
+    };
+
+    /**
+     * @brief A histogram of durations. Each observation lands in one bucket; the exporter adds them up into the
+     * cumulative buckets Prometheus expects.
+     */
+    struct alignas(64) Histogram {
+        std::atomic<std::uint64_t> buckets[maxBuckets]; ///< Observations per bucket, the last one unbounded.
+        std::atomic<std::uint64_t> sumMicros;           ///< Sum of the observations in microseconds.
+        std::atomic<std::uint64_t> count;               ///< Number of observations.
+    };
+
+    std::atomic<bool> on(false);       ///< True once serve() has succeeded.
+    std::atomic<bool> stopping(false); ///< Tells the exporter thread to finish.
+    int listener = -1;                 ///< Listening socket, or -1.
+
+    /**
+     * @brief The thread answering scrapes, stopped on the way out of the program if nobody stopped it sooner.
+     */
+    struct Exporter {
+        std::thread thread; ///< The thread, if running.
+
+        /**
+         * @brief Stops the thread, as a thread still running when it is destroyed would end the program.
+         */
+        ~Exporter() {
+            metrics::stop();
+        }
+    };
+
+    Counter frames = {};                                        ///< Frames put on screen.
+    Counter spins = {};                                         ///< Spins of the wheel.
+    Counter games = {};                                         ///< Games played to graduation.
+    Counter assetHits = {};                                     ///< Asset lookups that found the asset resident.
+    Counter assetMisses = {};                                   ///< Asset lookups that had to wait for a decode.
+    Counter uncounted = {};                                     ///< Events shown whose index is not in the deck.
+    std::unique_ptr<std::atomic<std::uint64_t>[]> events;       ///< Times each event was shown, set up by serve().
+    std::size_t eventCount = 0;                                 ///< Number of counters in events.
+    Histogram frameTimes = {};                                  ///< Time between frames.
+    Histogram popupTimes[metrics::popupCount] = {};             ///< Time on screen of each kind of popup.
+    std::chrono::steady_clock::time_point lastFrame;            ///< Time the last frame was shown.
+    bool framed = false;                                        ///< True once a frame has been shown.
+    Exporter exporter;                                          ///< Thread answering scrapes, destroyed first.
+
+    /**
+     * @brief Adds an observation to a histogram.
+     * @param histogram Histogram to add to.
+     * @param bounds Upper bounds of every bucket but the last.
+     * @param boundCount Number of bounds.
+     * @param seconds The observation.
+     */
+    void observe(Histogram& histogram, const double* bounds, int boundCount, double seconds) {
+        int bucket = 0;
+        while (bucket < boundCount && seconds > bounds[bucket]) {
+            ++bucket;
+        }
+        histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        histogram.sumMicros.fetch_add(static_cast<std::uint64_t>(seconds * 1e6), std::memory_order_relaxed);
+        histogram.count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Reads a counter.
+     * @param counter The counter.
+     * @return Its value.
+     */
+    std::uint64_t load(const std::atomic<std::uint64_t>& counter) {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Writes the help and type lines that start a metric.
+     * @param out Stream to write to.
+     * @param name Name of the metric.
+     * @param type "counter" or "histogram".
+     * @param help What the metric counts.
+     */
+    void header(std::ostream& out, const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+    }
+
+    /**
+     * @brief Writes the series of one histogram.
+     * @param out Stream to write to.
+     * @param name Name of the metric.
+     * @param labels Labels to put before le, each followed by a comma, or empty.
+     * @param histogram The histogram.
+     * @param bounds Upper bounds of every bucket but the last.
+     * @param boundCount Number of bounds.
+     */
+    void writeHistogram(std::ostream& out, const char* name, const std::string& labels, const Histogram& histogram,
+                        const double* bounds, int boundCount) {
+        std::uint64_t cumulative = 0;
+        for (int i = 0; i <= boundCount; ++i) {
+            cumulative += load(histogram.buckets[i]);
+            out << name << "_bucket{" << labels << "le=\"";
+            if (i < boundCount) {
+                out << bounds[i];
+            } else {
+                out << "+Inf";
+            }
+            out << "\"} " << cumulative << '\n';
+        }
+        const std::string braced = labels.empty() ? "" : "{" + labels.substr(0, labels.size() - 1) + "}";
+        out << name << "_sum" << braced << ' ' << load(histogram.sumMicros) / 1e6 << '\n';
+        out << name << "_count" << braced << ' ' << load(histogram.count) << '\n';
+    }
+
+    /**
+     * @brief Writes all of a buffer to a non-blocking socket, waiting for it to drain when it is full.
+     * @param fd Socket descriptor.
+     * @param data Bytes to write.
+     * @return False if the scraper went away or stalled.
+     */
+    bool sendAll(int fd, const std::string& data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = write(fd, data.data() + sent, data.size() - sent);
+            if (n > 0) {
+                sent += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                return false;
+            }
+            pollfd out = {fd, POLLOUT, 0};
+            if (poll(&out, 1, sendTimeoutMillis) <= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Answers one scraper: waits briefly for its request, whatever it asks for, and sends the metrics.
+     * @param fd Connected socket, closed before returning.
+     */
+    void answer(int fd) {
+        pollfd in = {fd, POLLIN, 0};
+        if (poll(&in, 1, sendTimeoutMillis) > 0) {
+            char request[1024];
+            while (read(fd, request, sizeof(request)) > 0) {
+            }
+        }
+        const std::string body = metrics::scrape();
+        std::ostringstream response;
+        response << "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " << body.size()
+                 << "\r\nConnection: close\r\n\r\n" << body;
+        sendAll(fd, response.str());
+        close(fd);
+    }
+
+    /**
+     * @brief Body of the exporter thread: accepts scrapers one at a time until told to stop.
+     */
+    void exportLoop() {
+        while (!stopping.load()) {
+            pollfd waiting = {listener, POLLIN, 0};
+            if (poll(&waiting, 1, pollMillis) <= 0) {
+                continue;
+            }
+            int fd;
+            while ((fd = net::acceptFrom(listener)) >= 0) {
+                answer(fd);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Listens on the address, sets up a counter for every event in the deck, then starts counting and the
+ * exporter thread. The counters are allocated once, before counting is switched on, and never again.
+ * @param deckSize Events in the loaded deck.
+ * @param address Address to listen on.
+ * @return False if the address could not be listened on.
+ */
+bool metrics::serve(std::size_t deckSize, const std::string& address) {
+    if (on.load()) {
+        return true;
+    }
+    listener = net::listenOn(address);
+    if (listener < 0) {
+        std::cerr << "Failed to serve metrics on " << address << std::endl;
+        return false;
+    }
+    events.reset(new std::atomic<std::uint64_t>[deckSize]());
+    eventCount = deckSize;
+    stopping.store(false);
+    on.store(true, std::memory_order_release); // Publishes the counters to every thread that sees counting on
+    exporter.thread = std::thread(exportLoop);
+    return true;
+}
+
+/**
+ * @brief Tells the exporter thread to finish, waits for it and closes the listening socket.
+ */
+void metrics::stop() {
+    if (!exporter.thread.joinable()) {
+        return;
+    }
+    stopping.store(true);
+    exporter.thread.join();
+    close(listener);
+    listener = -1;
+}
+
+/**
+ * @brief Checks if metrics are being counted.
+ * @return True once serve() has succeeded.
+ */
+bool metrics::enabled() {
+    return on.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts a frame and adds the time since the previous one to the frame time histogram.
+ */
+void metrics::frameShown() {
+    if (!enabled()) {
+        return;
+    }
+    const std::chrono::steady_clock::time_point shown = std::chrono::steady_clock::now();
+    if (framed) {
+        observe(frameTimes, frameBounds, sizeof(frameBounds) / sizeof(frameBounds[0]),
+                std::chrono::duration<double>(shown - lastFrame).count());
+    }
+    lastFrame = shown;
+    framed = true;
+    frames.value.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts a spin of the wheel.
+ */
+void metrics::spun() {
+    if (enabled()) {
+        spins.value.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Counts an event shown to a player.
+ * @param id Index of the event in the deck.
+ */
+void metrics::eventShown(int id) {
+    if (!on.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (id >= 0 && static_cast<std::size_t>(id) < eventCount) {
+        events[id].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        uncounted.value.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Counts a lookup in the asset cache.
+ * @param hit True if the asset was already resident.
+ */
+void metrics::assetLookup(bool hit) {
+    if (enabled()) {
+        (hit ? assetHits : assetMisses).value.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Counts a game played to graduation.
+ */
+void metrics::gameCompleted() {
+    if (enabled()) {
+        games.value.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Adds a popup's time on screen to the histogram for its kind.
+ * @param kind Kind of popup.
+ * @param seconds Time from opening to closing.
+ */
+void metrics::popupClosed(Popup kind, double seconds) {
+    if (enabled() && kind >= 0 && kind < popupCount) {
+        observe(popupTimes[kind], popupBounds, sizeof(popupBounds) / sizeof(popupBounds[0]), seconds);
+    }
+}
+
+/**
+ * @brief Writes every metric in the Prometheus text format. Events that were never shown are left out, as a
+ * labelled counter only appears once it is first counted.
+ * @return The metrics.
+ */
+std::string metrics::scrape() {
+    std::ostringstream out;
+    header(out, "westernwonderland_frames_total", "counter", "Frames put on screen.");
+    out << "westernwonderland_frames_total " << load(frames.value) << '\n';
+    header(out, "westernwonderland_frame_seconds", "histogram", "Time between frames put on screen.");
+    writeHistogram(out, "westernwonderland_frame_seconds", "", frameTimes, frameBounds,
+                   sizeof(frameBounds) / sizeof(frameBounds[0]));
+    header(out, "westernwonderland_spins_total", "counter", "Spins of the wheel.");
+    out << "westernwonderland_spins_total " << load(spins.value) << '\n';
+
+    header(out, "westernwonderland_events_total", "counter", "Events shown, by index in the event deck.");
+    for (std::size_t id = 0; id < eventCount; ++id) {
+        const std::uint64_t count = load(events[id]);
+        if (count > 0) {
+            out << "westernwonderland_events_total{event=\"" << id << "\"} " << count << '\n';
+        }
+    }
+    header(out, "westernwonderland_events_uncounted_total", "counter",
+           "Events shown whose index is not in the loaded deck.");
+    out << "westernwonderland_events_uncounted_total " << load(uncounted.value) << '\n';
+
+    header(out, "westernwonderland_asset_cache_hits_total", "counter", "Asset lookups that found the asset resident.");
+    out << "westernwonderland_asset_cache_hits_total " << load(assetHits.value) << '\n';
+    header(out, "westernwonderland_asset_cache_misses_total", "counter", "Asset lookups that waited for a decode.");
+    out << "westernwonderland_asset_cache_misses_total " << load(assetMisses.value) << '\n';
+
+    header(out, "westernwonderland_popup_seconds", "histogram", "Time popups stayed on screen, by kind.");
+    for (int kind = 0; kind < popupCount; ++kind) {
+        writeHistogram(out, "westernwonderland_popup_seconds", std::string("kind=\"") + popupNames[kind] + "\",",
+                       popupTimes[kind], popupBounds, sizeof(popupBounds) / sizeof(popupBounds[0]));
+    }
+
+    header(out, "westernwonderland_games_completed_total", "counter", "Games played to graduation.");
+    out << "westernwonderland_games_completed_total " << load(games.value) << '\n';
+    return out.str();
+}
+
+/**
+ * @brief Constructs a timer and notes when the popup opened.
+ * @param kind Kind of popup.
+ */
+metrics::PopupTimer::PopupTimer(Popup kind) : kind(kind), opened(std::chrono::steady_clock::now()) {
+}
+
+/**
+ * @brief Records the popup's time on screen.
+ */
+metrics::PopupTimer::~PopupTimer() {
+    if (enabled()) {
+        popupClosed(kind, std::chrono::duration<double>(std::chrono::steady_clock::now() - opened).count());
+    }
+}
@@ -0,0 +1,322 @@
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Net.h"
+
+/**
+ * @file net.cpp
+ * @brief Implementation file for the socket helpers.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const char* const unixPrefix = "unix:"; ///< Prefix of Unix-domain socket addresses.
+
+    /**
+     * @brief Checks if an address names a Unix-domain socket.
+     * @param address Address to check.
+     * @return True for "unix:" addresses.
+     */
+    bool isUnix(const std::string& address) {
+        return address.compare(0, std::strlen(unixPrefix), unixPrefix) == 0;
+    }
+
+    /**
+     * @brief Fills in a Unix-domain socket address.
+     * @param address Address starting with "unix:".
+     * @param out Receives the socket address.
+     * @return False if the path is too long.
+     */
+    bool unixAddress(const std::string& address, sockaddr_un& out) {
+        std::string path = address.substr(std::strlen(unixPrefix));
+        std::memset(&out, 0, sizeof(out));
+        out.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(out.sun_path)) {
+            std::cerr << "Socket path is too long: " << path << std::endl;
+            return false;
+        }
+        std::strcpy(out.sun_path, path.c_str());
+        return true;
+    }
+
+    /**
+     * @brief Resolves a "host:port" address.
+     * @param address Address to resolve.
+     * @param passive True to resolve for listening.
+     * @return Resolved addresses, or nullptr on error. Free with freeaddrinfo.
+     */
+    addrinfo* tcpAddress(const std::string& address, bool passive) {
+        size_t colon = address.rfind(':');
+        if (colon == std::string::npos) {
+            std::cerr << "Address must be unix:/path or host:port, got " << address << std::endl;
+            return nullptr;
+        }
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+        addrinfo* result = nullptr;
+        std::string host = address.substr(0, colon);
+        std::string port = address.substr(colon + 1);
+        int error = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (error != 0) {
+            std::cerr << "Cannot resolve " << address << ": " << gai_strerror(error) << std::endl;
+            return nullptr;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Turns off Nagle's algorithm so small state updates go out immediately.
+     * @param fd TCP socket.
+     */
+    void setNoDelay(int fd) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+}
+
+/**
+ * @brief Makes a socket non-blocking.
+ * @param fd Socket descriptor.
+ * @return True on success.
+ */
+bool net::setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Opens a non-blocking listening socket.
+ * @param address Address to listen on.
+ * @return Socket descriptor, or -1 on error.
+ */
+int net::listenOn(const std::string& address) {
+    int fd = -1;
+    if (isUnix(address)) {
+        sockaddr_un local;
+        if (!unixAddress(address, local)) {
+            return -1;
+        }
+        unlink(local.sun_path); // Remove a socket left behind by an earlier server
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        addrinfo* result = tcpAddress(address, true);
+        for (addrinfo* ai = result; ai && fd < 0; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            int on = 1;
+            if (fd >= 0) {
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            }
+            if (fd >= 0 && bind(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (result) {
+            freeaddrinfo(result);
+        }
+    }
+
+    if (fd < 0 || listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd)) {
+        std::cerr << "Cannot listen on " << address << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Connects to a server and makes the socket non-blocking.
+ * @param address Address of the server.
+ * @return Socket descriptor, or -1 on error.
+ */
+int net::connectTo(const std::string& address) {
+    int fd = -1;
+    if (isUnix(address)) {
+        sockaddr_un remote;
+        if (!unixAddress(address, remote)) {
+            return -1;
+        }
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        addrinfo* result = tcpAddress(address, false);
+        for (addrinfo* ai = result; ai && fd < 0; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (result) {
+            freeaddrinfo(result);
+        }
+        if (fd >= 0) {
+            setNoDelay(fd);
+        }
+    }
+
+    if (fd < 0 || !setNonBlocking(fd)) {
+        std::cerr << "Cannot connect to " << address << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Accepts a pending connection and makes it non-blocking.
+ * @param listener Listening socket.
+ * @return Socket descriptor, or -1 if nothing was pending.
+ */
+int net::acceptFrom(int listener) {
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) {
+        return -1;
+    }
+    setNoDelay(fd); // Fails harmlessly on Unix-domain sockets
+    if (!setNonBlocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Raises the soft limit on open descriptors to the hard limit.
+ * @return The new limit.
+ */
+long net::raiseFileLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return -1;
+    }
+#if defined(__APPLE__)
+    if (limit.rlim_max > OPEN_MAX) {
+        limit.rlim_max = OPEN_MAX; // macOS refuses soft limits above OPEN_MAX
+    }
+#endif
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return static_cast<long>(limit.rlim_cur);
+}
+
+/**
+ * @brief Constructs a connection that owns the given socket.
+ * @param fd Connected non-blocking socket.
+ */
+net::Connection::Connection(int fd) : socket(fd) {
+}
+
+/**
+ * @brief Closes the socket.
+ */
+net::Connection::~Connection() {
+    close(socket);
+}
+
+/**
+ * @brief Gets the socket descriptor.
+ * @return Socket descriptor.
+ */
+int net::Connection::fd() const {
+    return socket;
+}
+
+/**
+ * @brief Queues a message.
+ * @param type Message type.
+ * @param payload Message body.
+ */
+void net::Connection::send(std::uint8_t type, const std::vector<std::uint8_t>& payload) {
+    protocol::frame(outbox, type, payload);
+}
+
+/**
+ * @brief Writes as much of the queued output as the socket accepts.
+ * @return False if the connection failed.
+ */
+bool net::Connection::flush() {
+    size_t written = 0;
+    while (written < outbox.size()) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = ::send(socket, outbox.data() + written, outbox.size() - written, MSG_NOSIGNAL);
+#else
+        ssize_t n = ::write(socket, outbox.data() + written, outbox.size() - written);
+#endif
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        written += n;
+    }
+    outbox.erase(outbox.begin(), outbox.begin() + written);
+    return true;
+}
+
+/**
+ * @brief Checks if queued output is waiting.
+ * @return True if there is unsent output.
+ */
+bool net::Connection::wantsWrite() const {
+    return !outbox.empty();
+}
+
+/**
+ * @brief Reads whatever has arrived.
+ * @return False if the peer closed the connection or it failed.
+ */
+bool net::Connection::receive() {
+    std::uint8_t buffer[4096];
+    while (true) {
+        ssize_t n = ::read(socket, buffer, sizeof(buffer));
+        if (n > 0) {
+            inbox.insert(inbox.end(), buffer, buffer + n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+/**
+ * @brief Takes the next complete message that has arrived.
+ * @param message Receives the message.
+ * @return False if no complete message is waiting.
+ */
+bool net::Connection::next(protocol::Message& message) {
+    return protocol::unframe(inbox, message);
+}
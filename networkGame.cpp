@@ -0,0 +1,227 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "NetworkGame.h"
+#include "Net.h"
+#include "Protocol.h"
+#include "Rules.h"
+#include "Wheel.h"
+#include "Graduation.h"
+#include "Player.h"
+#include "GameBoard.h"
+#include "Events.h"
+#include "majorSelection.h"
+#include "ResourceDisplay.h"
+#include "SceneGraph.h"
+#include "Latency.h"
+#include "Metrics.h"
+
+/**
+ * @file networkGame.cpp
+ * @brief Implementation file for playing on a game server.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    /**
+     * @brief Brings a player's path and resources in line with the server's state.
+     * @param player Player to update.
+     * @param state Player's state on the server.
+     * @param board Board, for the paths.
+     */
+    void syncPlayer(Player& player, const rules::PlayerState& state, const GameBoard& board) {
+        if (state.chosen) {
+            player.setPath(state.path == rules::western ? board.getWesternPath() : board.getIveyPath());
+        }
+
+        // The setters add the amount they are given
+        player.setHappiness(state.happiness - player.getHappiness());
+        player.setDebt(state.debt - player.getDebt());
+        player.setGPA(state.gpa - player.getGPA());
+    }
+}
+
+/**
+ * @brief Joins a game server and plays or watches until the window is closed.
+ * @param window SFML RenderWindow for the game.
+ * @param address Address of the server.
+ * @param seat Seat to ask for: 1 or 2 to play, 0 to watch.
+ * @return Exit status of the program.
+ */
+int networkGame::play(sf::RenderWindow& window, const std::string& address, int seat) {
+    int fd = net::connectTo(address);
+    if (fd < 0) {
+        return 1;
+    }
+    net::Connection connection(fd);
+    std::vector<std::uint8_t> hello;
+    protocol::putVarint(hello, seat);
+    connection.send(protocol::Hello, hello);
+
+    GameBoard board;
+    Wheel wheel;
+    Player player1(board.getIveyPath(), sf::Color::Red);
+    Player player2(board.getWesternPath(), sf::Color::Blue);
+    Player* players[rules::playerCount] = {&player1, &player2};
+
+    Scene scene(window.getSize().x, window.getSize().y);
+    scene.addStatic(board);
+    scene.addDynamic(player1);
+    scene.addDynamic(player2);
+    scene.addDynamic(wheel);
+
+    const rules::Board& rulesBoard = rules::Board::standard();
+    rules::GameState state = rules::GameState();
+    bool synced = false;
+    bool choiceSent = false;
+    bool graduated = false;
+    bool spinRequested = false; // A Spin was sent and the server has not answered yet
+    int pendingEvent[rules::playerCount] = {-1, -1}; // Event to show once the marker arrives
+    rules::Effect pendingEffect[rules::playerCount] = {}; // What that event did
+
+    while (window.isOpen()) {
+        bool popupShown = false;
+
+        if (!connection.receive() || !connection.flush()) {
+            std::cerr << "Lost connection to the server" << std::endl;
+            return 1;
+        }
+
+        protocol::Message message;
+        while (connection.next(message)) {
+            const std::uint8_t* p = message.payload.data();
+            const std::uint8_t* end = p + message.payload.size();
+            std::uint32_t values[3] = {0, 0, 0};
+
+            if (message.type == protocol::Welcome && protocol::getVarint(p, end, values[0]) &&
+                protocol::getVarint(p, end, values[1])) {
+                seat = static_cast<int>(values[0]);
+                window.setTitle(seat ? "Western Wonderland - Player " + std::to_string(seat)
+                                     : std::string("Western Wonderland - Watching"));
+                if (values[1] != events::deck().events.size()) {
+                    std::cerr << "The server's events.txt differs from this one" << std::endl;
+                }
+            } else if (message.type == protocol::State) {
+                if (!protocol::applyState(message, state)) {
+                    std::cerr << "State from the server failed its checksum" << std::endl;
+                    return 1;
+                }
+                for (int i = 0; i < rules::playerCount; ++i) {
+                    syncPlayer(*players[i], state.players[i], board);
+                    if (!synced) {
+                        players[i]->setSpaceIndex(state.players[i].index); // Joined a game in progress
+                    }
+                }
+                synced = true;
+                spinRequested = false;
+            } else if (message.type == protocol::Spun && protocol::getVarint(p, end, values[0]) &&
+                       protocol::getVarint(p, end, values[1]) && protocol::getVarint(p, end, values[2]) &&
+                       values[0] < static_cast<std::uint32_t>(rules::playerCount)) {
+                spinRequested = false;
+                latency::reflect(latency::Spin);
+                metrics::spun();
+                std::pair<int, float> result = wheel.SpinWheelTo(static_cast<int>(values[1]), window);
+                wheel.SetArrowAngle(result.second);
+                players[values[0]]->move(result.first);
+                pendingEvent[values[0]] = static_cast<int>(values[2]) - 1;
+                const int mover = static_cast<int>(values[0]);
+                if (pendingEvent[mover] >= 0 && pendingEvent[mover] < static_cast<int>(events::deck().events.size())) {
+                    // The state still holds the player before the move, which the effect is worked out from
+                    rules::PlayerState before = state.players[mover];
+                    const int landed = before.index + static_cast<int>(values[1]);
+                    before.index = std::min(landed, rulesBoard.lastIndex(before.path));
+                    pendingEffect[mover] = rules::eventEffect(events::deck().events[pendingEvent[mover]], before);
+                }
+                popupShown = true;
+            }
+        }
+
+        // Check for graduation event and calculate scores
+        if (synced && !graduated && rules::gameOver(state, rulesBoard) && player1.finished() && player2.finished()) {
+            Graduation::graduationEvent(window, "Graduation", player1, player2);
+            metrics::gameCompleted();
+            graduated = true;
+            popupShown = true;
+        }
+
+        // Update game elements and redraw whatever changed
+        player1.update();
+        player2.update();
+        if (!scene.present(window)) {
+            sf::sleep(sf::milliseconds(1)); // Nothing changed, so the previous frame is still on screen
+        }
+
+        // Show the event each player landed on once their marker gets there
+        for (int i = 0; i < rules::playerCount; ++i) {
+            if (pendingEvent[i] >= 0 && players[i]->justMoved()) {
+                if (pendingEvent[i] < static_cast<int>(events::deck().events.size())) {
+                    metrics::eventShown(pendingEvent[i]);
+                    events::eventPopup(window, events::deck().events[pendingEvent[i]], pendingEffect[i]);
+                    latency::reflect(latency::PopupClose);
+                    popupShown = true;
+                }
+                pendingEvent[i] = -1;
+            }
+        }
+
+        // Major selection for this client's player
+        if (synced && seat > 0 && !state.players[seat - 1].chosen && !choiceSent) {
+            int majorClicked = majorSelection::majorEvent(window, "Player " + std::to_string(seat) + " Choose Your Path");
+            latency::reflect(latency::MajorPick);
+            std::vector<std::uint8_t> payload;
+            protocol::putVarint(payload, majorClicked);
+            connection.send(protocol::ChoosePath, payload);
+            choiceSent = true;
+            popupShown = true;
+        }
+
+        // Handle events
+        sf::Event event;
+        while (latency::pollEvent(window, event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+            }
+
+            if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus) {
+                scene.invalidate();
+            }
+
+            // Display resources for Player 1
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::A) {
+                latency::pressed(latency::ResourceView);
+                latency::reflect(latency::ResourceView);
+                ResourceDisplay::resourceDisplay(window, player1, "Resources");
+                latency::reflect(latency::PopupClose);
+                popupShown = true;
+            }
+
+            // Display resources for Player 2
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B) {
+                latency::pressed(latency::ResourceView);
+                latency::reflect(latency::ResourceView);
+                ResourceDisplay::resourceDisplay(window, player2, "Resources");
+                latency::reflect(latency::PopupClose);
+                popupShown = true;
+            }
+
+            // Ask the server to spin on Space key release; the wheel turns when the result comes back. The state
+            // only changes once the server answers, so one request is sent at a time; otherwise a second release
+            // would play an extra turn once the other player has graduated and the turn stays with this seat
+            if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Space && seat > 0 &&
+                !spinRequested && state.turn == seat - 1 && rules::canSpin(state, rulesBoard) &&
+                player1.justMoved() && player2.justMoved()) {
+                latency::pressed(latency::Spin);
+                connection.send(protocol::Spin, std::vector<std::uint8_t>());
+                spinRequested = true;
+            }
+        }
+
+        if (popupShown) {
+            scene.invalidate();
+        }
+    }
+    return 0;
+}
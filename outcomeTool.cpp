@@ -0,0 +1,123 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "Outcomes.h"
+#include "Rules.h"
+
+/**
+ * @file outcomeTool.cpp
+ * @brief Prints exact final resource and graduation probabilities for every pair of path choices.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwOutcomes [events.txt] [--check N]
+ * With --check, N games per pair of paths are also simulated with the game rules to confirm the exact figures.
+ */
+
+namespace {
+
+    const char* const pathNames[rules::pathCount] = {"Western", "Ivey"}; ///< Path names by path index.
+
+    /**
+     * @brief Prints one resource's distribution on a line.
+     * @param name Resource name.
+     * @param distribution Probability of each total.
+     * @param mean Expected total.
+     */
+    void printDistribution(const std::string& name, const std::map<int, double>& distribution, double mean) {
+        std::cout << "  " << name << ": mean " << mean << " |";
+        for (const auto& entry : distribution) {
+            std::cout << " " << entry.first << ":" << entry.second * 100 << "%";
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief Runs the outcome tool.
+ * @param argc Number of arguments.
+ * @param argv Event deck file name and --check option.
+ * @return Exit status of the program.
+ */
+int main(int argc, char* argv[]) {
+    std::string eventsFile = "events.txt";
+    int checkGames = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--check" && i + 1 < argc) {
+            checkGames = std::atoi(argv[++i]);
+        } else {
+            eventsFile = arg;
+        }
+    }
+
+    std::ifstream deckFile(eventsFile);
+    if (!deckFile) {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+    const rules::EventDeck deck = rules::EventDeck::parse(deckFile);
+    const rules::Board& board = rules::Board::standard();
+
+    auto start = std::chrono::steady_clock::now();
+    outcomes::PlayerOutcome paths[rules::pathCount];
+    for (int path = 0; path < rules::pathCount; ++path) {
+        paths[path] = outcomes::pathOutcome(board, deck, path);
+    }
+    outcomes::GameOutcome games[rules::pathCount][rules::pathCount];
+    for (int a = 0; a < rules::pathCount; ++a) {
+        for (int b = 0; b < rules::pathCount; ++b) {
+            games[a][b] = outcomes::gameOutcome(paths[a], paths[b]);
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::setprecision(4);
+    std::cout << deck.events.size() << " events, solved in " << ms << " ms" << std::endl;
+    if (deck.shuffled) {
+        std::cout << "The deck is shuffled; the exact figures treat each draw as independent" << std::endl;
+    }
+    for (int path = 0; path < rules::pathCount; ++path) {
+        const outcomes::PlayerOutcome& outcome = paths[path];
+        std::cout << std::endl << pathNames[path] << " path: " << outcome.meanSpins << " spins on average, "
+                  << outcome.finals.size() << " possible finishes" << std::endl;
+        std::cout << "  Event spaces landed on:";
+        for (size_t k = 0; k < outcome.eventsLanded.size(); ++k) {
+            std::cout << " " << k << ":" << outcome.eventsLanded[k] * 100 << "%";
+        }
+        std::cout << std::endl;
+        printDistribution("GPA", outcome.gpa, outcome.meanGpa);
+        printDistribution("Debt", outcome.debt, outcome.meanDebt);
+        printDistribution("Happiness", outcome.happiness, outcome.meanHappiness);
+    }
+
+    std::cout << std::endl << "Graduation (player 1 path vs player 2 path): P1 wins / P2 wins / tie" << std::endl;
+    for (int a = 0; a < rules::pathCount; ++a) {
+        for (int b = 0; b < rules::pathCount; ++b) {
+            const outcomes::GameOutcome& game = games[a][b];
+            std::cout << "  " << pathNames[a] << " vs " << pathNames[b] << ": " << game.win[0] * 100 << "% / "
+                      << game.win[1] * 100 << "% / " << game.tie * 100 << "%";
+
+            if (checkGames > 0) {
+                // Play the same matchup with the game rules to confirm the exact figures
+                int wins[3] = {0, 0, 0};
+                rules::Rng rng = {static_cast<std::uint32_t>(a * rules::pathCount + b + 1), 0};
+                for (int g = 0; g < checkGames; ++g) {
+                    rules::GameState state = rules::newGame();
+                    rules::choosePath(state, 0, a);
+                    rules::choosePath(state, 1, b);
+                    while (!rules::gameOver(state, board)) {
+                        rules::playTurn(state, board, deck, rng);
+                    }
+                    ++wins[rules::winner(state) + 1];
+                }
+                std::cout << " (simulated " << 100.0 * wins[1] / checkGames << "% / " << 100.0 * wins[2] / checkGames
+                          << "% / " << 100.0 * wins[0] / checkGames << "%)";
+            }
+            std::cout << std::endl;
+        }
+    }
+    return 0;
+}
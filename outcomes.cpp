@@ -0,0 +1,198 @@
+#include <algorithm>
+#include "Outcomes.h"
+
+/**
+ * @file outcomes.cpp
+ * @brief Implementation file for the exact outcome engine.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @brief Computes the distribution of one player's final resources.
+ * @param board Board being played.
+ * @param deck Event deck.
+ * @param from Player's current state.
+ * @return Exact distribution of the player's finish.
+ */
+outcomes::PlayerOutcome outcomes::playerOutcome(const rules::Board& board, const rules::EventDeck& deck,
+                                                const rules::PlayerState& from) {
+    PlayerOutcome outcome = PlayerOutcome();
+    const int last = board.lastIndex(from.path);
+    const double spinChance = 1.0 / rules::wheelSize;
+
+    // draws[i]: the table events on space i are drawn from, or null if landing there draws nothing
+    std::vector<const rules::EventTable*> draws(last + 1, nullptr);
+    for (int i = 0; i <= last; ++i) {
+        const rules::EventTable& table = deck.tables[board.regionAt[from.path][i]];
+        if (board.eventAt[from.path][i] && !table.events.empty()) {
+            draws[i] = &table;
+        }
+    }
+
+    // reach[i][k]: chance of stopping on space i after landing on k event spaces. Moves only go forward, so one
+    // pass in index order settles every space before it is spun from.
+    int maxEvents = 0;
+    for (int i = from.index + 1; i <= last; ++i) {
+        maxEvents += draws[i] ? 1 : 0;
+    }
+    std::vector<std::vector<double>> reach(last + 1, std::vector<double>(maxEvents + 1, 0.0));
+    std::vector<double> stops(last + 1, 0.0); // Expected number of times each space is stopped on
+    reach[from.index][0] = 1.0;
+    for (int i = from.index; i < last; ++i) {
+        for (int k = 0; k <= maxEvents; ++k) {
+            double p = reach[i][k];
+            if (p == 0) {
+                continue;
+            }
+            stops[i] += p;
+            for (int spin = 1; spin <= rules::wheelSize; ++spin) {
+                int j = std::min(i + spin, last);
+                int landed = k + (draws[j] ? 1 : 0);
+                reach[j][landed] += p * spinChance;
+            }
+        }
+    }
+    outcome.eventsLanded = reach[last];
+    for (int i = from.index; i < last; ++i) {
+        outcome.meanSpins += stops[i];
+    }
+
+    // Constant effects drawn from the same table on every space ahead only depend on how many events are drawn
+    bool constantDeck = true;
+    for (const rules::Event& event : deck.events) {
+        constantDeck = constantDeck && event.effect.empty();
+    }
+    const rules::EventTable* only = nullptr;
+    for (int i = from.index + 1; i <= last; ++i) {
+        if (draws[i] && only && draws[i]->events != only->events) {
+            constantDeck = false;
+        }
+        only = draws[i] ? draws[i] : only;
+    }
+
+    if (constantDeck) {
+        // Each event landed on adds one event's effects drawn by weight: mix the k-fold convolutions by
+        // eventsLanded
+        std::map<Resources, double> current;
+        current[{from.happiness, from.debt, from.gpa}] = 1.0;
+        for (int k = 0; k <= maxEvents; ++k) {
+            double pk = outcome.eventsLanded[k];
+            if (pk > 0) {
+                for (const auto& entry : current) {
+                    outcome.finals[entry.first] += pk * entry.second;
+                }
+            }
+            if (k == maxEvents) {
+                break;
+            }
+            std::map<Resources, double> next;
+            for (const auto& entry : current) {
+                for (std::uint16_t e : only->events) {
+                    const rules::Event& event = deck.events[e];
+                    Resources r = {entry.first.happiness + event.happinessScore, entry.first.debt + event.debtScore,
+                                   entry.first.gpa + event.gpaScore};
+                    next[r] += entry.second * event.weight / only->totalWeight;
+                }
+            }
+            current.swap(next);
+        }
+    } else {
+        // Compiled effects depend on the resources, path and space, and decks differ between regions, so carry
+        // the resource distribution along each space instead of only the count of events
+        std::vector<std::map<Resources, double>> at(last + 1);
+        at[from.index][{from.happiness, from.debt, from.gpa}] = 1.0;
+        rules::PlayerState player = from;
+        for (int i = from.index; i < last; ++i) {
+            for (const auto& entry : at[i]) {
+                for (int spin = 1; spin <= rules::wheelSize; ++spin) {
+                    int j = std::min(i + spin, last);
+                    double p = entry.second * spinChance;
+                    if (!draws[j]) {
+                        at[j][entry.first] += p;
+                        continue;
+                    }
+                    for (std::uint16_t e : draws[j]->events) {
+                        const rules::Event& event = deck.events[e];
+                        player.index = j;
+                        player.happiness = entry.first.happiness;
+                        player.debt = entry.first.debt;
+                        player.gpa = entry.first.gpa;
+                        rules::applyEvent(player, event);
+                        at[j][{player.happiness, player.debt, player.gpa}] += p * event.weight / draws[j]->totalWeight;
+                    }
+                }
+            }
+            at[i].clear();
+        }
+        outcome.finals.swap(at[last]);
+    }
+
+    for (const auto& entry : outcome.finals) {
+        const Resources& r = entry.first;
+        double p = entry.second;
+        outcome.happiness[r.happiness] += p;
+        outcome.debt[r.debt] += p;
+        outcome.gpa[r.gpa] += p;
+        outcome.meanHappiness += p * r.happiness;
+        outcome.meanDebt += p * r.debt;
+        outcome.meanGpa += p * r.gpa;
+    }
+    return outcome;
+}
+
+/**
+ * @brief Computes the distribution of one player's final resources from the start of a path.
+ * @param board Board being played.
+ * @param deck Event deck.
+ * @param path Path index.
+ * @return Exact distribution of the player's finish.
+ */
+outcomes::PlayerOutcome outcomes::pathOutcome(const rules::Board& board, const rules::EventDeck& deck, int path) {
+    rules::PlayerState start = rules::PlayerState();
+    start.path = path;
+    start.chosen = true;
+    return playerOutcome(board, deck, start);
+}
+
+/**
+ * @brief Computes the graduation result from both players' distributions.
+ * @param player1 Player 1's distribution.
+ * @param player2 Player 2's distribution.
+ * @return Exact graduation result.
+ */
+outcomes::GameOutcome outcomes::gameOutcome(const PlayerOutcome& player1, const PlayerOutcome& player2) {
+    GameOutcome outcome = GameOutcome();
+    rules::GameState state = rules::GameState();
+
+    // Player 2's finishes are copied into a flat list, which is faster to walk in the inner loop
+    const std::vector<std::pair<Resources, double>> others(player2.finals.begin(), player2.finals.end());
+    for (const auto& a : player1.finals) {
+        state.players[0].happiness = a.first.happiness;
+        state.players[0].debt = a.first.debt;
+        state.players[0].gpa = a.first.gpa;
+        for (const auto& b : others) {
+            state.players[1].happiness = b.first.happiness;
+            state.players[1].debt = b.first.debt;
+            state.players[1].gpa = b.first.gpa;
+
+            int score1;
+            int score2;
+            rules::scores(state, score1, score2);
+            outcome.scores[score1][score2] += a.second * b.second;
+        }
+    }
+
+    for (int s1 = 0; s1 < 4; ++s1) {
+        for (int s2 = 0; s2 < 4; ++s2) {
+            double p = outcome.scores[s1][s2];
+            if (s1 > s2) {
+                outcome.win[0] += p;
+            } else if (s1 < s2) {
+                outcome.win[1] += p;
+            } else {
+                outcome.tie += p;
+            }
+        }
+    }
+    return outcome;
+}
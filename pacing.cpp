@@ -0,0 +1,137 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "Pacing.h"
+
+/**
+ * @file pacing.cpp
+ * @brief Implementation file for the game clock.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Steady; ///< Real-time clock game time is measured from.
+
+    Steady::time_point base = Steady::now(); ///< Real time game time was last lined up with.
+    double gameSpeed = 1.0;                  ///< Multiple of real time, or pacing::fastest.
+    std::atomic<std::int64_t> skipped(0);    ///< Game time skipped by waits at the fastest speed, in clock ticks.
+
+    /**
+     * @brief Works out game time from the real time since base and the time skipped.
+     * @param skip Time skipped, in clock ticks.
+     * @return Game time.
+     */
+    pacing::TimePoint gameTime(std::int64_t skip) {
+        const Steady::duration real = Steady::now() - base;
+        Steady::duration scaled = real;
+        if (gameSpeed != 1.0 && gameSpeed != pacing::fastest) {
+            scaled = std::chrono::duration_cast<Steady::duration>(real * gameSpeed);
+        }
+        return base + scaled + Steady::duration(skip);
+    }
+}
+
+/**
+ * @brief Sets how fast game time runs, starting from the current real time.
+ * @param speed Multiple of real time, or fastest; negative speeds are taken as real time.
+ */
+void pacing::setSpeed(double speed) {
+    base = Steady::now();
+    skipped = 0;
+    gameSpeed = speed < 0 ? 1.0 : speed;
+}
+
+/**
+ * @brief Gets how fast game time runs.
+ * @return Multiple of real time, or fastest.
+ */
+double pacing::speed() {
+    return gameSpeed;
+}
+
+/**
+ * @brief Gets the current game time.
+ * @return Game time.
+ */
+pacing::TimePoint pacing::now() {
+    return gameTime(skipped.load(std::memory_order_acquire));
+}
+
+/**
+ * @brief Waits until a moment in game time. At the fastest speed, game time is moved on to the moment instead,
+ * only ever forwards, so two threads waiting at once never skip more than the later of their waits.
+ * @param until Moment to wait for.
+ */
+void pacing::sleepUntil(TimePoint until) {
+    if (gameSpeed != fastest) {
+        const Steady::duration gap = until - now();
+        Steady::duration wait = gap;
+        if (gameSpeed != 1.0) {
+            wait = std::chrono::duration_cast<Steady::duration>(gap / gameSpeed);
+        }
+        if (wait > Steady::duration::zero()) {
+            std::this_thread::sleep_for(wait);
+        }
+        return;
+    }
+
+    std::int64_t skip = skipped.load(std::memory_order_acquire);
+    while (true) {
+        const Steady::duration gap = until - gameTime(skip);
+        if (gap <= Steady::duration::zero() ||
+            skipped.compare_exchange_weak(skip, skip + gap.count(), std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+    std::this_thread::yield(); // Let the other thread run, as a real wait would
+}
+
+/**
+ * @brief Waits for a length of game time.
+ * @param length Game time to wait.
+ */
+void pacing::sleepFor(std::chrono::steady_clock::duration length) {
+    sleepUntil(now() + length);
+}
+
+/**
+ * @brief Constructs a clock started at the current game time.
+ */
+pacing::Clock::Clock() : start(now()) {
+}
+
+/**
+ * @brief Starts measuring again from now.
+ * @return Game time elapsed before the restart.
+ */
+std::chrono::steady_clock::duration pacing::Clock::restart() {
+    const TimePoint at = now();
+    const std::chrono::steady_clock::duration elapsed = at - start;
+    start = at;
+    return elapsed;
+}
+
+/**
+ * @brief Gets the game time elapsed since the clock started.
+ * @return Elapsed game time.
+ */
+std::chrono::steady_clock::duration pacing::Clock::elapsed() const {
+    return now() - start;
+}
+
+/**
+ * @brief Gets the game time elapsed since the clock started, in seconds.
+ * @return Elapsed game time in seconds.
+ */
+float pacing::Clock::seconds() const {
+    return std::chrono::duration<float>(elapsed()).count();
+}
+
+/**
+ * @brief Gets the game time elapsed since the clock started, in milliseconds.
+ * @return Elapsed game time in milliseconds.
+ */
+int pacing::Clock::milliseconds() const {
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed()).count());
+}
@@ -57,10 +57,11 @@ bool Player::justMoved() {
  * @brief Updates the player's position during movement.
  */
 void Player::update() {
-    if (isMoving && moveClock.getElapsedTime().asSeconds() >= moveDelay) {
+    if (isMoving && moveClock.seconds() >= moveDelay) {
         if (currentSpaceIndex != targetSpaceIndex) {
             currentSpaceIndex++;
             marker.setPosition(path[currentSpaceIndex]);
+            markDirty();
             moveClock.restart();
         } else {
             isMoving = false;
@@ -86,13 +87,50 @@ bool Player::onEvent(const std::vector<sf::Vector2f>& eventSpaces) {
 }
 
 /**
- * @brief Draws the player on the SFML RenderWindow.
- * @param window SFML RenderWindow to draw the player on.
+ * @brief Draws the player on the render target.
+ * @param window SFML RenderWindow or RenderTexture to draw the player on.
  */
-void Player::draw(sf::RenderWindow& window) {
+void Player::draw(sf::RenderTarget& window) {
     window.draw(marker);
 }
 
+/**
+ * @brief Gets the area covered by the player's marker.
+ * @return Bounding rectangle of the marker.
+ */
+sf::FloatRect Player::getBounds() const {
+    return marker.getGlobalBounds();
+}
+
+/**
+ * @brief Draws the marker as part of the scene.
+ * @param target Render target to draw on.
+ */
+void Player::render(sf::RenderTarget& target) {
+    draw(target);
+}
+
+/**
+ * @brief Places the player on a space immediately, as when joining a game already in progress.
+ * @param index Index of the space on the player's path.
+ */
+void Player::setSpaceIndex(int index) {
+    currentSpaceIndex = index;
+    targetSpaceIndex = index;
+    isMoving = false;
+    eventTriggered = true;
+    marker.setPosition(path[currentSpaceIndex]);
+    markDirty();
+}
+
+/**
+ * @brief Gets the index of the space the player is on or moving towards.
+ * @return Index of the space on the player's path.
+ */
+int Player::getSpaceIndex() const {
+    return targetSpaceIndex;
+}
+
 /**
  * @brief Gets the current position of the player.
  * @return Vector representing the player's current position.
@@ -117,6 +155,14 @@ int Player::getMajor() const {
     return GPA; // This should be "return major;" instead of "return GPA;"
 }
 
+/**
+ * @brief Gets the path the player follows.
+ * @return Positions of the spaces on the player's path.
+ */
+const std::vector<sf::Vector2f>& Player::getPath() const {
+    return path;
+}
+
 /**
  * @brief Sets the path for the player to follow.
  * @param spaces Vector of positions representing the player's path.
@@ -0,0 +1,186 @@
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+#include "Poller.h"
+#include "Net.h"
+
+/**
+ * @file poller.cpp
+ * @brief Implementation file for the socket readiness poller.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @brief Constructs a poller with an empty watch set.
+ */
+Poller::Poller() : wakeRead(-1), wakeWrite(-1) {
+    int ends[2];
+    if (pipe(ends) == 0) {
+        wakeRead = ends[0];
+        wakeWrite = ends[1];
+        net::setNonBlocking(wakeRead);
+        net::setNonBlocking(wakeWrite);
+    }
+#if defined(__linux__)
+    epoll = epoll_create1(0);
+    epoll_event event = epoll_event();
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr; // The wake pipe is the only watched descriptor without a token
+    epoll_ctl(epoll, EPOLL_CTL_ADD, wakeRead, &event);
+#else
+    fds.push_back({wakeRead, POLLIN, 0});
+    tokens.push_back(nullptr);
+#endif
+}
+
+/**
+ * @brief Closes the poller and its wake pipe.
+ */
+Poller::~Poller() {
+#if defined(__linux__)
+    close(epoll);
+#endif
+    close(wakeRead);
+    close(wakeWrite);
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Starts watching a socket.
+ * @param fd Socket descriptor.
+ * @param token Returned by wait() when the socket is ready.
+ * @param writable True to also wait for writability.
+ * @return False on error.
+ */
+bool Poller::add(int fd, void* token, bool writable) {
+    epoll_event event = epoll_event();
+    event.events = EPOLLIN | (writable ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+    event.data.ptr = token;
+    return epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+/**
+ * @brief Changes whether a watched socket is waited on for writability.
+ * @param fd Socket descriptor.
+ * @param token Token given to add().
+ * @param writable True to also wait for writability.
+ */
+void Poller::modify(int fd, void* token, bool writable) {
+    epoll_event event = epoll_event();
+    event.events = EPOLLIN | (writable ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+    event.data.ptr = token;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+}
+
+/**
+ * @brief Stops watching a socket.
+ * @param fd Socket descriptor.
+ */
+void Poller::remove(int fd) {
+    epoll_event event = epoll_event(); // Ignored, but kernels before 2.6.9 require it
+    epoll_ctl(epoll, EPOLL_CTL_DEL, fd, &event);
+}
+
+/**
+ * @brief Waits until a watched socket is ready, wake() is called or the timeout passes.
+ * @param ready Receives the tokens of the ready sockets.
+ * @param timeoutMs Longest time to wait in milliseconds, or -1 to wait indefinitely.
+ */
+void Poller::wait(std::vector<void*>& ready, int timeoutMs) {
+    epoll_event events[256];
+    ready.clear();
+    int count = epoll_wait(epoll, events, 256, timeoutMs);
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.ptr) {
+            ready.push_back(events[i].data.ptr);
+        } else {
+            char drain[64];
+            while (read(wakeRead, drain, sizeof(drain)) > 0) {
+            }
+        }
+    }
+}
+
+#else
+
+/**
+ * @brief Starts watching a socket.
+ * @param fd Socket descriptor.
+ * @param token Returned by wait() when the socket is ready.
+ * @param writable True to also wait for writability.
+ * @return False on error.
+ */
+bool Poller::add(int fd, void* token, bool writable) {
+    fds.push_back({fd, static_cast<short>(POLLIN | (writable ? POLLOUT : 0)), 0});
+    tokens.push_back(token);
+    return true;
+}
+
+/**
+ * @brief Changes whether a watched socket is waited on for writability.
+ * @param fd Socket descriptor.
+ * @param token Token given to add().
+ * @param writable True to also wait for writability.
+ */
+void Poller::modify(int fd, void* token, bool writable) {
+    for (size_t i = 1; i < fds.size(); ++i) {
+        if (fds[i].fd == fd) {
+            fds[i].events = static_cast<short>(POLLIN | (writable ? POLLOUT : 0));
+            tokens[i] = token;
+        }
+    }
+}
+
+/**
+ * @brief Stops watching a socket.
+ * @param fd Socket descriptor.
+ */
+void Poller::remove(int fd) {
+    for (size_t i = 1; i < fds.size(); ++i) {
+        if (fds[i].fd == fd) {
+            // Swap with the last entry so removal stays constant time after the search
+            fds[i] = fds.back();
+            tokens[i] = tokens.back();
+            fds.pop_back();
+            tokens.pop_back();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Waits until a watched socket is ready, wake() is called or the timeout passes.
+ * @param ready Receives the tokens of the ready sockets.
+ * @param timeoutMs Longest time to wait in milliseconds, or -1 to wait indefinitely.
+ */
+void Poller::wait(std::vector<void*>& ready, int timeoutMs) {
+    ready.clear();
+    if (poll(fds.data(), fds.size(), timeoutMs) <= 0) {
+        return;
+    }
+    if (fds[0].revents) {
+        char drain[64];
+        while (read(wakeRead, drain, sizeof(drain)) > 0) {
+        }
+    }
+    for (size_t i = 1; i < fds.size(); ++i) {
+        if (fds[i].revents) {
+            ready.push_back(tokens[i]);
+        }
+    }
+}
+
+#endif
+
+/**
+ * @brief Makes a wait() in progress on another thread return.
+ */
+void Poller::wake() {
+    char byte = 0;
+    ssize_t written = write(wakeWrite, &byte, 1); // A full pipe already guarantees a wake up
+    (void)written;
+}
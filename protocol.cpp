@@ -0,0 +1,235 @@
+#include "Protocol.h"
+
+/**
+ * @file protocol.cpp
+ * @brief Implementation file for the server and client messages.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+/**
+ * @brief Appends an unsigned varint, seven bits per byte with the high bit marking continuation.
+ * @param out Output bytes.
+ * @param value Value to append.
+ */
+void protocol::putVarint(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * @brief Appends a signed value as a zigzag varint so small negative numbers stay short.
+ * @param out Output bytes.
+ * @param value Value to append.
+ */
+void protocol::putSigned(std::vector<std::uint8_t>& out, std::int32_t value) {
+    putVarint(out, (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31));
+}
+
+/**
+ * @brief Reads an unsigned varint.
+ * @param p Read position.
+ * @param end End of the input.
+ * @param value Receives the value.
+ * @return False if the input is malformed.
+ */
+bool protocol::getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) {
+            return false;
+        }
+        std::uint8_t byte = *p++;
+        value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reads a zigzag varint.
+ * @param p Read position.
+ * @param end End of the input.
+ * @param value Receives the value.
+ * @return False if the input is malformed.
+ */
+bool protocol::getSigned(const std::uint8_t*& p, const std::uint8_t* end, std::int32_t& value) {
+    std::uint32_t raw;
+    if (!getVarint(p, end, raw)) {
+        return false;
+    }
+    value = static_cast<std::int32_t>((raw >> 1) ^ (~(raw & 1) + 1));
+    return true;
+}
+
+/**
+ * @brief Flattens a game state into a fixed list of integers.
+ * @param state Game state.
+ * @param fields Receives fieldCount integers.
+ */
+void protocol::flatten(const rules::GameState& state, std::int32_t fields[fieldCount]) {
+    fields[0] = state.turn;
+    for (int p = 0; p < rules::playerCount; ++p) {
+        const rules::PlayerState& player = state.players[p];
+        std::int32_t* out = fields + 1 + 6 * p;
+        out[0] = player.path;
+        out[1] = player.index;
+        out[2] = player.chosen;
+        out[3] = player.happiness;
+        out[4] = player.debt;
+        out[5] = player.gpa;
+    }
+}
+
+/**
+ * @brief Rebuilds a game state from flattened integers.
+ * @param fields fieldCount integers.
+ * @param state Receives the game state.
+ */
+void protocol::unflatten(const std::int32_t fields[fieldCount], rules::GameState& state) {
+    state.turn = fields[0];
+    for (int p = 0; p < rules::playerCount; ++p) {
+        rules::PlayerState& player = state.players[p];
+        const std::int32_t* in = fields + 1 + 6 * p;
+        player.path = in[0];
+        player.index = in[1];
+        player.chosen = in[2] != 0;
+        player.happiness = in[3];
+        player.debt = in[4];
+        player.gpa = in[5];
+    }
+}
+
+/**
+ * @brief Encodes the fields that changed between two states.
+ * @param from State the receiver already has.
+ * @param to New state.
+ * @param out Output bytes.
+ * @return True if anything changed.
+ */
+bool protocol::encodeDelta(const rules::GameState& from, const rules::GameState& to, std::vector<std::uint8_t>& out) {
+    std::int32_t before[fieldCount];
+    std::int32_t after[fieldCount];
+    flatten(from, before);
+    flatten(to, after);
+
+    std::uint32_t mask = 0;
+    for (int i = 0; i < fieldCount; ++i) {
+        if (before[i] != after[i]) {
+            mask |= 1u << i;
+        }
+    }
+
+    putVarint(out, mask);
+    for (int i = 0; i < fieldCount; ++i) {
+        if (mask & (1u << i)) {
+            // Resources can hold any int32 value, so the difference wraps in unsigned arithmetic
+            putSigned(out, static_cast<std::int32_t>(static_cast<std::uint32_t>(after[i]) -
+                                                     static_cast<std::uint32_t>(before[i])));
+        }
+    }
+    return mask != 0;
+}
+
+/**
+ * @brief Applies a delta produced by encodeDelta().
+ * @param p Read position.
+ * @param end End of the input.
+ * @param state State to update in place.
+ * @return False if the delta is malformed.
+ */
+bool protocol::decodeDelta(const std::uint8_t*& p, const std::uint8_t* end, rules::GameState& state) {
+    std::int32_t fields[fieldCount];
+    flatten(state, fields);
+
+    std::uint32_t mask;
+    if (!getVarint(p, end, mask) || mask >> fieldCount) {
+        return false;
+    }
+    for (int i = 0; i < fieldCount; ++i) {
+        if (mask & (1u << i)) {
+            std::int32_t difference;
+            if (!getSigned(p, end, difference)) {
+                return false;
+            }
+            fields[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(fields[i]) +
+                                                  static_cast<std::uint32_t>(difference));
+        }
+    }
+
+    unflatten(fields, state);
+    return true;
+}
+
+/**
+ * @brief Computes a checksum of a state.
+ * @param state Game state.
+ * @return FNV-1a hash of the flattened state.
+ */
+std::uint32_t protocol::checksum(const rules::GameState& state) {
+    std::int32_t fields[fieldCount];
+    flatten(state, fields);
+
+    std::uint32_t hash = 2166136261u;
+    for (int i = 0; i < fieldCount; ++i) {
+        std::uint32_t value = static_cast<std::uint32_t>(fields[i]);
+        for (int b = 0; b < 4; ++b) {
+            hash ^= (value >> (8 * b)) & 0xff;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Applies a State message and checks the result against the server's checksum.
+ * @param message State message.
+ * @param state Client's copy of the state, updated in place.
+ * @return False if the message is malformed or the states have diverged.
+ */
+bool protocol::applyState(const Message& message, rules::GameState& state) {
+    const std::uint8_t* p = message.payload.data();
+    const std::uint8_t* end = p + message.payload.size();
+    if (!decodeDelta(p, end, state) || end - p != 4) {
+        return false;
+    }
+    std::uint32_t sum = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    return sum == checksum(state);
+}
+
+/**
+ * @brief Appends a framed message.
+ * @param out Output bytes.
+ * @param type Message type.
+ * @param payload Message body.
+ */
+void protocol::frame(std::vector<std::uint8_t>& out, std::uint8_t type, const std::vector<std::uint8_t>& payload) {
+    out.push_back(static_cast<std::uint8_t>(payload.size() & 0xff));
+    out.push_back(static_cast<std::uint8_t>(payload.size() >> 8));
+    out.push_back(type);
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+/**
+ * @brief Removes one complete message from the front of a receive buffer.
+ * @param in Received bytes.
+ * @param message Receives the message.
+ * @return False if no complete message has arrived yet.
+ */
+bool protocol::unframe(std::vector<std::uint8_t>& in, Message& message) {
+    if (in.size() < 3) {
+        return false;
+    }
+    std::size_t length = in[0] | (in[1] << 8);
+    if (in.size() < 3 + length) {
+        return false;
+    }
+    message.type = in[2];
+    message.payload.assign(in.begin() + 3, in.begin() + 3 + length);
+    in.erase(in.begin(), in.begin() + 3 + length);
+    return true;
+}
@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "Raster.h"
+
+/**
+ * @file raster.cpp
+ * @brief Implementation file for the software rasteriser.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const int span = 4; ///< Pixels blended together.
+
+    /**
+     * @brief Sets up the edge function of a triangle side. The side's ends are always taken in the same order,
+     * whichever way round the triangle has them, so two triangles sharing a side compute exactly opposite values
+     * and a pixel centre on the side goes to one of them only.
+     * @param from Start of the side, going round the triangle.
+     * @param to End of the side.
+     * @param t Triangle to fill in.
+     * @param side Index of the side.
+     */
+    void setupSide(const sf::Vector2f& from, const sf::Vector2f& to, raster::Canvas::Triangle& t, int side) {
+        const bool ordered = from.x < to.x || (from.x == to.x && from.y < to.y);
+        const sf::Vector2f& p = ordered ? from : to;
+        const sf::Vector2f& q = ordered ? to : from;
+        t.a[side] = p.y - q.y;
+        t.b[side] = q.x - p.x;
+        t.c[side] = p.x * q.y - p.y * q.x;
+        t.sign[side] = ordered ? 1.0f : -1.0f;
+        t.owns[side] = to.y < from.y || (to.y == from.y && to.x > from.x);
+    }
+
+    /**
+     * @brief Evaluates a side's edge function.
+     * @param t The triangle.
+     * @param side Index of the side.
+     * @param x Pixel centre's x.
+     * @param rowTerm The side's y * b + c for the row.
+     * @return Positive inside the side, negative outside.
+     */
+    float sideValue(const raster::Canvas::Triangle& t, int side, float x, float rowTerm) {
+        return t.sign[side] * (x * t.a[side] + rowTerm);
+    }
+
+    /**
+     * @brief Reads a texel, clamping to the image's edge, as textures clamp.
+     * @param pixels Image pixels.
+     * @param size Image size.
+     * @param x Texel column.
+     * @param y Texel row.
+     * @return Pointer to the texel's RGBA bytes.
+     */
+    const std::uint8_t* texel(const std::uint8_t* pixels, const sf::Vector2u& size, int x, int y) {
+        x = std::min(std::max(x, 0), static_cast<int>(size.x) - 1);
+        y = std::min(std::max(y, 0), static_cast<int>(size.y) - 1);
+        return pixels + (static_cast<std::size_t>(y) * size.x + x) * 4;
+    }
+
+    /**
+     * @brief Samples an image at a point in texels, nearest or filtered as a texture would be.
+     * @param image The image.
+     * @param smooth True to filter between texels.
+     * @param u Column in texels.
+     * @param v Row in texels.
+     * @param out Receives the RGBA colour, from 0 to 255.
+     */
+    void sampleAt(const sf::Image& image, bool smooth, float u, float v, float out[4]) {
+        const std::uint8_t* pixels = image.getPixelsPtr();
+        const sf::Vector2u size = image.getSize();
+        if (!smooth) {
+            const std::uint8_t* t = texel(pixels, size, static_cast<int>(std::floor(u)),
+                                          static_cast<int>(std::floor(v)));
+            for (int c = 0; c < 4; ++c) {
+                out[c] = t[c];
+            }
+            return;
+        }
+        const float x = u - 0.5f;
+        const float y = v - 0.5f;
+        const int x0 = static_cast<int>(std::floor(x));
+        const int y0 = static_cast<int>(std::floor(y));
+        const float fx = x - x0;
+        const float fy = y - y0;
+        const std::uint8_t* t00 = texel(pixels, size, x0, y0);
+        const std::uint8_t* t10 = texel(pixels, size, x0 + 1, y0);
+        const std::uint8_t* t01 = texel(pixels, size, x0, y0 + 1);
+        const std::uint8_t* t11 = texel(pixels, size, x0 + 1, y0 + 1);
+        for (int c = 0; c < 4; ++c) {
+            const float top = t00[c] + (t10[c] - t00[c]) * fx;
+            const float bottom = t01[c] + (t11[c] - t01[c]) * fx;
+            out[c] = top + (bottom - top) * fy;
+        }
+    }
+
+    /**
+     * @brief Blends a span of source pixels over the framebuffer as SFML's alpha blending does: colour by the
+     * source's alpha, and alpha added on top. A fully transparent source pixel leaves its target as it was.
+     * @param target First framebuffer pixel.
+     * @param source RGBA source pixels, not premultiplied.
+     * @param count Pixels in the span, at most span.
+     */
+    void blend(std::uint8_t* target, const std::uint8_t* source, int count) {
+#if defined(__SSE2__)
+        if (count == span) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i rounding = _mm_set1_epi16(128);
+            const __m128i full = _mm_set1_epi16(255);
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+            const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(target));
+            __m128i halves[2];
+            for (int h = 0; h < 2; ++h) {
+                const __m128i s = h == 0 ? _mm_unpacklo_epi8(src, zero) : _mm_unpackhi_epi8(src, zero);
+                const __m128i d = h == 0 ? _mm_unpacklo_epi8(dst, zero) : _mm_unpackhi_epi8(dst, zero);
+                const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+                const __m128i sourceFactor = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha),
+                                                          _mm_and_si128(alphaLanes, full));
+                __m128i sum = _mm_add_epi16(_mm_mullo_epi16(s, sourceFactor),
+                                            _mm_mullo_epi16(d, _mm_sub_epi16(full, alpha)));
+                sum = _mm_add_epi16(sum, rounding);
+                halves[h] = _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8); // Divides by 255
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_packus_epi16(halves[0], halves[1]));
+            return;
+        }
+#endif
+        for (int i = 0; i < count * 4; i += 4) {
+            const unsigned alpha = source[i + 3];
+            for (int c = 0; c < 4; ++c) {
+                const unsigned factor = c == 3 ? 255 : alpha;
+                unsigned sum = source[i + c] * factor + target[i + c] * (255 - alpha) + 128;
+                target[i + c] = static_cast<std::uint8_t>((sum + (sum >> 8)) >> 8);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the instruction set pixels are blended with.
+ * @return "SSE2" or "scalar".
+ */
+const char* raster::blending() {
+#if defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * @brief Constructs a transparent canvas and starts its worker threads, no more than there are tiles to share.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @param threads Threads to draw with, counting the one that draws, or 0 for one per core.
+ */
+raster::Canvas::Canvas(unsigned width, unsigned height, unsigned threads)
+    : width(width), height(height),
+      pixels(static_cast<std::size_t>(width) * height * 4, 0),
+      tiles(static_cast<std::size_t>((width + tileSize - 1) / tileSize) * ((height + tileSize - 1) / tileSize)),
+      skippedTextures(false), pass(0), busy(0), stopping(false), nextTile(0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const std::size_t workerCount = std::min<std::size_t>(threads, std::max<std::size_t>(tiles.size(), 1)) - 1;
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers.push_back(std::thread(&Canvas::work, this));
+    }
+}
+
+/**
+ * @brief Tells the workers to stop and waits for them.
+ */
+raster::Canvas::~Canvas() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Fills the canvas with one colour.
+ * @param color Colour to fill with.
+ */
+void raster::Canvas::clear(const sf::Color& color) {
+    const std::uint8_t rgba[4] = {color.r, color.g, color.b, color.a};
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        std::memcpy(&pixels[i], rgba, 4);
+    }
+}
+
+/**
+ * @brief Transforms the triangles, turns each so its area is positive and adds it to every tile its bounds touch.
+ * @param vertices Corners, three per triangle.
+ * @param count Number of vertices.
+ * @param image Image to sample, or nullptr for plain colour.
+ * @param smooth True to filter between the image's texels.
+ * @param transform Maps the vertices' positions onto canvas pixels.
+ */
+void raster::Canvas::add(const sf::Vertex* vertices, std::size_t count, const sf::Image* image, bool smooth,
+                         const sf::Transform& transform) {
+    const int columns = static_cast<int>((width + tileSize - 1) / tileSize);
+    for (std::size_t i = 0; i + 2 < count; i += 3) {
+        sf::Vertex v[3];
+        for (int k = 0; k < 3; ++k) {
+            v[k] = vertices[i + k];
+            v[k].position = transform.transformPoint(vertices[i + k].position);
+        }
+        const sf::Vector2f& p0 = v[0].position;
+        float area = (v[1].position.x - p0.x) * (v[2].position.y - p0.y) -
+                     (v[1].position.y - p0.y) * (v[2].position.x - p0.x);
+        if (area == 0) {
+            continue;
+        }
+        if (area < 0) {
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+
+        // Each side lies opposite the corner whose share of a point it measures
+        Triangle t;
+        for (int k = 0; k < 3; ++k) {
+            setupSide(v[(k + 1) % 3].position, v[(k + 2) % 3].position, t, k);
+        }
+        for (int attribute = 0; attribute < 6; ++attribute) {
+            t.base[attribute] = t.dx[attribute] = t.dy[attribute] = 0;
+            for (int k = 0; k < 3; ++k) {
+                const sf::Color& color = v[k].color;
+                const float values[6] = {static_cast<float>(color.r), static_cast<float>(color.g),
+                                         static_cast<float>(color.b), static_cast<float>(color.a),
+                                         v[k].texCoords.x, v[k].texCoords.y};
+                const float share = values[attribute] * t.sign[k] / area;
+                t.base[attribute] += share * t.c[k];
+                t.dx[attribute] += share * t.a[k];
+                t.dy[attribute] += share * t.b[k];
+            }
+        }
+        t.image = image;
+        t.smooth = smooth;
+        t.flat = !image && v[0].color == v[1].color && v[1].color == v[2].color;
+        if (t.flat) {
+            const sf::Color& color = v[0].color;
+            const float values[4] = {static_cast<float>(color.r), static_cast<float>(color.g),
+                                     static_cast<float>(color.b), static_cast<float>(color.a)};
+            for (int attribute = 0; attribute < 4; ++attribute) {
+                t.base[attribute] = values[attribute]; // Exact, with no rounding from the planes
+            }
+        }
+
+        // Pixel centres sit at half coordinates, so these bounds hold every centre the triangle can cover
+        float minX = p0.x, maxX = minX;
+        float minY = p0.y, maxY = minY;
+        for (int k = 1; k < 3; ++k) {
+            minX = std::min(minX, v[k].position.x);
+            maxX = std::max(maxX, v[k].position.x);
+            minY = std::min(minY, v[k].position.y);
+            maxY = std::max(maxY, v[k].position.y);
+        }
+        t.left = std::max(0, static_cast<int>(std::floor(minX)));
+        t.top = std::max(0, static_cast<int>(std::floor(minY)));
+        t.right = std::min(static_cast<int>(width) - 1, static_cast<int>(std::ceil(maxX)));
+        t.bottom = std::min(static_cast<int>(height) - 1, static_cast<int>(std::ceil(maxY)));
+        if (t.left > t.right || t.top > t.bottom) {
+            continue;
+        }
+
+        const std::uint32_t index = static_cast<std::uint32_t>(triangles.size());
+        triangles.push_back(t);
+        for (int row = t.top / tileSize; row <= t.bottom / tileSize; ++row) {
+            for (int column = t.left / tileSize; column <= t.right / tileSize; ++column) {
+                tiles[static_cast<std::size_t>(row) * columns + column].push_back(index);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Starts a pass, draws tiles alongside the workers and waits for the last of them to finish.
+ */
+void raster::Canvas::flush() {
+    if (triangles.empty()) {
+        return;
+    }
+    nextTile = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++pass;
+        busy = static_cast<unsigned>(workers.size());
+    }
+    start.notify_all();
+    drawTiles();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return busy == 0; });
+    }
+
+    triangles.clear();
+    for (auto& tile : tiles) {
+        tile.clear();
+    }
+}
+
+/**
+ * @brief Takes the next tile nobody has started until every tile of the pass is taken.
+ */
+void raster::Canvas::drawTiles() {
+    for (std::size_t tile = nextTile++; tile < tiles.size(); tile = nextTile++) {
+        if (!tiles[tile].empty()) {
+            drawTile(tile);
+        }
+    }
+}
+
+/**
+ * @brief Waits for each new pass, draws tiles in it and reports back, until the canvas stops the workers.
+ */
+void raster::Canvas::work() {
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        start.wait(lock, [this, &seen] { return stopping || pass != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = pass;
+        lock.unlock();
+        drawTiles();
+        lock.lock();
+        if (--busy == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Draws triangles that sample one image.
+ * @param vertices Corners, three per triangle.
+ * @param count Number of vertices.
+ * @param image Image to sample, or nullptr for plain colour.
+ * @param smooth True to filter between the image's texels.
+ * @param transform Maps the vertices' positions onto canvas pixels.
+ */
+void raster::Canvas::draw(const sf::Vertex* vertices, std::size_t count, const sf::Image* image, bool smooth,
+                          const sf::Transform& transform) {
+    add(vertices, count, image, smooth, transform);
+    flush();
+}
+
+/**
+ * @brief Draws every batch of a draw list in one pass over the tiles. Texture batches cannot be read without
+ * OpenGL, so they are skipped, with a warning the first time.
+ * @param list Draw list to draw.
+ * @param transform Maps the list's coordinates onto canvas pixels.
+ */
+void raster::Canvas::draw(DrawList& list, const sf::Transform& transform) {
+    const std::vector<DrawList::Batch>& batches = list.build();
+    const std::vector<sf::Vertex>& vertices = list.vertices();
+    for (const DrawList::Batch& batch : batches) {
+        if (batch.texture) {
+            if (!skippedTextures) {
+                std::cerr << "Skipped a batch drawn from a texture; call assets::keepInMemory() before loading"
+                          << std::endl;
+                skippedTextures = true;
+            }
+            continue;
+        }
+        add(&vertices[batch.first], batch.count, batch.image, batch.smooth, transform);
+    }
+    flush();
+}
+
+/**
+ * @brief Rasterises the triangles touching one tile in drawing order. Each row is narrowed to the columns between
+ * the triangle's sides, then walked in spans of four pixels: covered pixels get the triangle's colour, times its
+ * image if it has one, and the rest stay transparent so blending leaves them alone.
+ * @param tile Index of the tile.
+ */
+void raster::Canvas::drawTile(std::size_t tile) {
+    const int columns = static_cast<int>((width + tileSize - 1) / tileSize);
+    const int tileLeft = static_cast<int>(tile % columns) * tileSize;
+    const int tileTop = static_cast<int>(tile / columns) * tileSize;
+    const int tileRight = std::min(tileLeft + tileSize, static_cast<int>(width)) - 1;
+    const int tileBottom = std::min(tileTop + tileSize, static_cast<int>(height)) - 1;
+
+    for (std::uint32_t index : tiles[tile]) {
+        const Triangle& t = triangles[index];
+        std::uint8_t flat[4];
+        for (int k = 0; k < 4; ++k) {
+            flat[k] = static_cast<std::uint8_t>(std::min(std::max(t.base[k], 0.0f), 255.0f) + 0.5f);
+        }
+        const int top = std::max(t.top, tileTop);
+        const int bottom = std::min(t.bottom, tileBottom);
+
+        for (int y = top; y <= bottom; ++y) {
+            const float py = y + 0.5f;
+            float rowTerm[3];
+            int left = std::max(t.left, tileLeft);
+            int right = std::min(t.right, tileRight);
+            for (int k = 0; k < 3; ++k) {
+                rowTerm[k] = py * t.b[k] + t.c[k];
+
+                // Where the side crosses the row, widened by a pixel; the exact test below settles the ends
+                const float slope = t.sign[k] * t.a[k];
+                const float offset = t.sign[k] * rowTerm[k];
+                if (slope != 0) {
+                    const float crossing = std::min(std::max(-offset / slope - 0.5f, -1.0f), static_cast<float>(width));
+                    if (slope > 0) {
+                        left = std::max(left, static_cast<int>(std::floor(crossing)) - 1);
+                    } else {
+                        right = std::min(right, static_cast<int>(std::ceil(crossing)) + 1);
+                    }
+                } else if (offset < 0) {
+                    right = left - 1; // The row is wholly outside this side
+                }
+            }
+
+            std::uint8_t* row = &pixels[(static_cast<std::size_t>(y) * width) * 4];
+            for (int x = left; x <= right; x += span) {
+                const int count = std::min(span, right - x + 1);
+                std::uint8_t source[span * 4] = {};
+                bool any = false;
+                for (int i = 0; i < count; ++i) {
+                    const float px = x + i + 0.5f;
+                    const float w0 = sideValue(t, 0, px, rowTerm[0]);
+                    const float w1 = sideValue(t, 1, px, rowTerm[1]);
+                    const float w2 = sideValue(t, 2, px, rowTerm[2]);
+                    if (w0 < 0 || w1 < 0 || w2 < 0 || (w0 == 0 && !t.owns[0]) || (w1 == 0 && !t.owns[1]) ||
+                        (w2 == 0 && !t.owns[2])) {
+                        continue;
+                    }
+                    any = true;
+                    if (t.flat) {
+                        std::memcpy(source + i * 4, flat, 4);
+                        continue;
+                    }
+                    float color[4];
+                    for (int k = 0; k < 4; ++k) {
+                        color[k] = t.base[k] + px * t.dx[k] + py * t.dy[k];
+                    }
+                    if (t.image) {
+                        float sampled[4];
+                        sampleAt(*t.image, t.smooth, t.base[4] + px * t.dx[4] + py * t.dy[4],
+                                 t.base[5] + px * t.dx[5] + py * t.dy[5], sampled);
+                        for (int k = 0; k < 4; ++k) {
+                            color[k] = color[k] * sampled[k] / 255;
+                        }
+                    }
+                    for (int k = 0; k < 4; ++k) {
+                        source[i * 4 + k] = static_cast<std::uint8_t>(std::min(std::max(color[k], 0.0f), 255.0f) +
+                                                                      0.5f);
+                    }
+                }
+                if (any) {
+                    blend(row + static_cast<std::size_t>(x) * 4, source, count);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the canvas size.
+ * @return Width and height in pixels.
+ */
+sf::Vector2u raster::Canvas::getSize() const {
+    return sf::Vector2u(width, height);
+}
+
+/**
+ * @brief Gets the framebuffer.
+ * @return RGBA bytes, row by row.
+ */
+const std::uint8_t* raster::Canvas::getPixels() const {
+    return pixels.data();
+}
+
+/**
+ * @brief Saves the canvas through sf::Image, which picks the format from the file's extension.
+ * @param file File name.
+ * @return False if the file could not be written.
+ */
+bool raster::Canvas::saveToFile(const std::string& file) const {
+    sf::Image image;
+    image.create(width, height, pixels.data());
+    if (!image.saveToFile(file)) {
+        std::cerr << "Failed to save " << file << std::endl;
+        return false;
+    }
+    return true;
+}
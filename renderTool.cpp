@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <SFML/Graphics.hpp>
+#include "Assets.h"
+#include "DrawList.h"
+#include "Events.h"
+#include "GameBoard.h"
+#include "Raster.h"
+#include "Rules.h"
+#include "Wheel.h"
+
+/**
+ * @file renderTool.cpp
+ * @brief Renders a frame of the game, the board with the wheel and optionally an event popup, on the CPU and
+ * saves it as an image, with no window, display or OpenGL. It can also time many frames to measure the rasteriser.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwRender frame.png [--scale S] [--angle degrees] [--event N] [--threads N] [--frames N]
+ * --scale shrinks or grows the frame, for thumbnails; --event draws the popup of the Nth event in events.txt.
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock; ///< Clock used to time the frames.
+
+    const unsigned windowSize = 40 * 11; ///< Width and height of the game window, TILE_SIZE * BOARD_SIZE in main.cpp.
+}
+
+/**
+ * @brief Renders the frame, saves it and reports the frame rate.
+ * @param argc Number of arguments.
+ * @param argv Output file, then --scale, --angle, --event, --threads and --frames options.
+ * @return Exit status of the program: 1 if the arguments were wrong or the image could not be saved.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: wwRender frame.png [--scale S] [--angle degrees] [--event N] [--threads N] "
+                  << "[--frames N]" << std::endl;
+        return 1;
+    }
+    const std::string output = argv[1];
+    float scale = 1.0f;
+    float angle = 0.0f;
+    int event = -1;
+    unsigned threads = 0;
+    int frames = 1;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--scale") {
+            scale = std::max(0.01f, static_cast<float>(std::atof(argv[i + 1])));
+        } else if (arg == "--angle") {
+            angle = static_cast<float>(std::atof(argv[i + 1]));
+        } else if (arg == "--event") {
+            event = std::atoi(argv[i + 1]);
+        } else if (arg == "--threads") {
+            threads = static_cast<unsigned>(std::max(0, std::atoi(argv[i + 1])));
+        } else if (arg == "--frames") {
+            frames = std::max(1, std::atoi(argv[i + 1]));
+        }
+    }
+
+    // Images and glyphs stay in memory, where the canvas reads them
+    assets::keepInMemory();
+
+    GameBoard board(rules::Board::standard());
+    Wheel wheel;
+    DrawList popup;
+    if (event >= 0) {
+        const rules::EventDeck& deck = events::deck();
+        if (event >= static_cast<int>(deck.events.size())) {
+            std::cerr << "There are only " << deck.events.size() << " events" << std::endl;
+            return 1;
+        }
+        const rules::Event& shown = deck.events[event];
+        events::recordPopup(popup, sf::Vector2u(windowSize, windowSize), shown,
+                            rules::eventEffect(shown, rules::newGame().players[0]));
+    }
+
+    // Everything is recorded in window pixels and scaled onto the canvas as it is drawn
+    const unsigned size = std::max(1u, static_cast<unsigned>(windowSize * scale + 0.5f));
+    raster::Canvas canvas(size, size, threads);
+    sf::Transform transform;
+    transform.scale(scale, scale);
+
+    // The first frame decodes the campus picture and renders the glyphs, so it is left out of the timing
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame <= frames; ++frame) {
+        if (frame == 1) {
+            start = Clock::now();
+        }
+        canvas.clear(sf::Color::White);
+        board.draw(canvas, transform);
+        wheel.DrawWheel(angle, canvas, transform);
+        canvas.draw(popup, transform);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (!canvas.saveToFile(output)) {
+        std::cerr << output << " could not be saved" << std::endl;
+        return 1;
+    }
+    std::cout << "Saved " << size << "x" << size << " frame to " << output << std::endl;
+    std::cout << frames << " frames in " << seconds * 1000.0 << " ms (" << frames / seconds << " frames/s, "
+              << raster::blending() << " blending)" << std::endl;
+    return 0;
+}
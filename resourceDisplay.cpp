@@ -2,6 +2,10 @@
 #include <SFML/Graphics.hpp>
 #include "ResourceDisplay.h"
 #include "Player.h"
+#include "Assets.h"
+#include "DrawList.h"
+#include "Latency.h"
+#include "Metrics.h"
 
 /**
  * @file ResourceDisplay.cpp
@@ -16,14 +20,8 @@
  * @param message Message to be displayed in the popup window.
  */
 void ResourceDisplay::resourceDisplay(sf::RenderWindow& window, const Player& player, const std::string& message) {
-    sf::Font font;
-    if (!font.loadFromFile("Montserrat Medium 500.ttf")) {
-        std::cerr << "Montserrat font failed to load" << std::endl;
-    }
-    sf::Font arialFont;  // Placeholder for Arial font
-    if (!font.loadFromFile("Arial.ttf")) {
-        std::cerr << "Arial font failed to load" << std::endl;
-    }
+    metrics::PopupTimer onScreen(metrics::ResourcePopup);
+    const sf::Font& font = assets::font("Montserrat Medium 500.ttf");
 
     // For graduation text
     sf::Text text;
@@ -59,12 +57,18 @@ void ResourceDisplay::resourceDisplay(sf::RenderWindow& window, const Player& pl
     background.setFillColor(sf::Color(91, 10, 125));
     background.setPosition((window.getSize().x - background.getSize().x) / 2, (window.getSize().y - background.getSize().y) / 2);
 
+    // Record the popup once and replay it every frame
+    DrawList popup;
+    popup.shape(background, 0);
+    popup.text(text, 1);
+    popup.text(text2, 1);
+
     bool closeEventWindow = false;  // Flag to control the event window closure
 
     // Popup should be opened for 15 seconds and then will close
     while (window.isOpen()) {
         sf::Event event;
-        while (window.pollEvent(event)) {
+        while (latency::pollEvent(window, event)) {
             if (event.type == sf::Event::Closed) {
                 window.close();
             }
@@ -72,6 +76,7 @@ void ResourceDisplay::resourceDisplay(sf::RenderWindow& window, const Player& pl
             // Check if close button (X key) is pressed
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::X) {
                 closeEventWindow = true;  // Set the flag to close the event window
+                latency::pressed(latency::PopupClose);
             }
         }
 
@@ -79,9 +84,7 @@ void ResourceDisplay::resourceDisplay(sf::RenderWindow& window, const Player& pl
             break;  // Exit the loop to close the event window
         }
 
-        window.draw(background);
-        window.draw(text);
-        window.draw(text2);
-        window.display();
+        popup.draw(window);
+        latency::display(window);
     }
 }
@@ -0,0 +1,669 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include "Effects.h"
+#include "Rules.h"
+
+/**
+ * @file rules.cpp
+ * @brief Implementation file for the headless game rules.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    /**
+     * @brief Checks if a line holds only whitespace.
+     * @param line Line to check.
+     * @return True if the line is blank.
+     */
+    bool isBlank(const std::string& line) {
+        return line.find_first_not_of(" \t\r") == std::string::npos;
+    }
+
+    /**
+     * @brief Checks if a keyword comes at a place in a line as a word of its own, so "when" does not match
+     * "whenever".
+     * @param line Line to check.
+     * @param start Where the keyword would start.
+     * @param keyword The keyword.
+     * @return True if the keyword is there and is not followed by a letter, digit or underscore.
+     */
+    bool startsWord(const std::string& line, size_t start, const char* keyword) {
+        const size_t length = std::char_traits<char>::length(keyword);
+        if (line.compare(start, length, keyword) != 0) {
+            return false;
+        }
+        const size_t end = start + length;
+        return end == line.size() || (!std::isalnum(static_cast<unsigned char>(line[end])) && line[end] != '_');
+    }
+
+    /**
+     * @brief Reads the regions named on an "on" line.
+     * @param names Region names: western, ivey and shared.
+     * @param regions Receives one bit per region named.
+     * @return False if a name is not a region or none is given.
+     */
+    bool parseRegions(const std::string& names, unsigned& regions) {
+        std::istringstream words(names);
+        std::string word;
+        unsigned found = 0;
+        while (words >> word) {
+            if (word == "western") {
+                found |= 1u << rules::western;
+            } else if (word == "ivey") {
+                found |= 1u << rules::ivey;
+            } else if (word == "shared") {
+                found |= 1u << rules::sharedRoad;
+            } else {
+                return false;
+            }
+        }
+        if (found != 0) {
+            regions = found;
+        }
+        return found != 0;
+    }
+
+    /**
+     * @brief Maps an index onto a pseudo-random permutation of 0 to size - 1 in constant time: a four-round
+     * Feistel network over the next even power of two, walking the cycle until it lands back in range.
+     * @param index Position, below size.
+     * @param size Number of positions.
+     * @param key Chooses the permutation.
+     * @return Permuted position.
+     */
+    std::uint32_t permute(std::uint32_t index, std::uint32_t size, std::uint32_t key) {
+        int half = 1;
+        while ((1u << (2 * half)) < size) {
+            ++half;
+        }
+        const std::uint32_t mask = (1u << half) - 1;
+        do {
+            std::uint32_t left = index >> half;
+            std::uint32_t right = index & mask;
+            for (std::uint32_t round = 0; round < 4; ++round) {
+                std::uint32_t next = left ^ (rules::mix(key, right * 4 + round) & mask);
+                left = right;
+                right = next;
+            }
+            index = (left << half) | right;
+        } while (index >= size);
+        return index;
+    }
+
+    /**
+     * @brief Packs a tile's position into one sortable key.
+     * @param tile Tile to pack.
+     * @return Key equal for tiles at the same place.
+     */
+    std::uint64_t tileKey(const rules::Tile& tile) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tile.x)) << 32) |
+               static_cast<std::uint32_t>(tile.y);
+    }
+
+    /**
+     * @brief Builds the standard board.
+     * @return The board drawn by GameBoard.
+     */
+    rules::Board makeStandardBoard() {
+        rules::Board board;
+        board.columns = 11;
+        board.rows = 11;
+        board.tileSize = 40;
+        std::vector<rules::Tile>& ivey = board.paths[rules::ivey];
+        std::vector<rules::Tile>& western = board.paths[rules::western];
+
+        // Ivey path
+        ivey.push_back({220, 420}); // start
+        ivey.push_back({220, 380}); // crossing 1
+        ivey.push_back({260, 380});
+        ivey.push_back({300, 380});
+        ivey.push_back({340, 380});
+        ivey.push_back({380, 380});
+        ivey.push_back({380, 340});
+        ivey.push_back({380, 300});
+        ivey.push_back({380, 260});
+        ivey.push_back({340, 260});
+        ivey.push_back({300, 260});
+        ivey.push_back({260, 260}); // crossing 2
+        ivey.push_back({260, 220});
+        ivey.push_back({260, 180});
+        ivey.push_back({300, 180});
+        ivey.push_back({340, 180});
+        ivey.push_back({380, 180});
+        ivey.push_back({380, 140});
+        ivey.push_back({380, 100});
+        ivey.push_back({340, 100});
+        ivey.push_back({300, 100});
+        ivey.push_back({260, 100});
+        ivey.push_back({220, 100});
+        ivey.push_back({180, 100}); // end
+
+        // Western path
+        western.push_back({220, 420}); // start
+        western.push_back({220, 380}); // crossing 1
+        western.push_back({180, 380});
+        western.push_back({140, 380});
+        western.push_back({100, 380});
+        western.push_back({60, 380});
+        western.push_back({60, 340});
+        western.push_back({60, 300});
+        western.push_back({60, 260});
+        western.push_back({60, 220});
+        western.push_back({100, 220});
+        western.push_back({140, 220});
+        western.push_back({180, 220});
+        western.push_back({180, 260});
+        western.push_back({220, 260});
+        western.push_back({260, 260}); // crossing 2
+        western.push_back({260, 220});
+        western.push_back({260, 180});
+        western.push_back({300, 180});
+        western.push_back({340, 180});
+        western.push_back({380, 180});
+        western.push_back({380, 140});
+        western.push_back({380, 100});
+        western.push_back({340, 100});
+        western.push_back({300, 100});
+        western.push_back({260, 100});
+        western.push_back({220, 100});
+        western.push_back({180, 100}); // end
+
+        // Event spaces
+        board.eventSpaces.push_back({140, 380}); // first Western square - missing others
+        board.eventSpaces.push_back({340, 380}); // first Ivey
+        board.eventSpaces.push_back({380, 300}); // second Ivey
+        board.eventSpaces.push_back({60, 300});
+        board.eventSpaces.push_back({140, 220});
+        board.eventSpaces.push_back({300, 180});
+        board.eventSpaces.push_back({380, 140});
+
+        board.markEvents();
+        return board;
+    }
+}
+
+/**
+ * @brief Fills eventAt and regionAt from the paths and eventSpaces. A space on both paths is on the shared road.
+ * Lookups go through sorted tile keys, so large layouts with long paths are marked quickly.
+ */
+void rules::Board::markEvents() {
+    std::vector<std::uint64_t> events;
+    for (const auto& space : eventSpaces) {
+        events.push_back(tileKey(space));
+    }
+    std::sort(events.begin(), events.end());
+    std::vector<std::uint64_t> onPath[pathCount];
+    for (int path = 0; path < pathCount; ++path) {
+        for (const auto& tile : paths[path]) {
+            onPath[path].push_back(tileKey(tile));
+        }
+        std::sort(onPath[path].begin(), onPath[path].end());
+    }
+
+    for (int path = 0; path < pathCount; ++path) {
+        eventAt[path].assign(paths[path].size(), 0);
+        regionAt[path].assign(paths[path].size(), static_cast<unsigned char>(path));
+        const std::vector<std::uint64_t>& other = onPath[1 - path];
+        for (size_t i = 0; i < paths[path].size(); ++i) {
+            const std::uint64_t key = tileKey(paths[path][i]);
+            if (std::binary_search(events.begin(), events.end(), key)) {
+                eventAt[path][i] = 1;
+            }
+            if (std::binary_search(other.begin(), other.end(), key)) {
+                regionAt[path][i] = sharedRoad;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Loads a board layout, reporting the first malformed line.
+ * @param in Stream holding the layout.
+ * @param board Receives the board.
+ * @return False if the layout is malformed.
+ */
+bool rules::Board::load(std::istream& in, Board& board) {
+    board = Board();
+    board.tileSize = 40;
+    std::string line;
+    int number = 0;
+    while (std::getline(in, line)) {
+        ++number;
+        std::istringstream words(line);
+        std::string keyword;
+        if (!(words >> keyword) || keyword[0] == '#') {
+            continue;
+        }
+
+        bool ok = true;
+        if (keyword == "size" && board.columns > 0) {
+            // Waypoints already read were only checked against the first size
+            std::cerr << "Layout line " << number << ": size may only be given once" << std::endl;
+            return false;
+        } else if (keyword == "size") {
+            ok = static_cast<bool>(words >> board.columns >> board.rows) && board.columns > 0 && board.rows > 0 &&
+                 board.columns <= maxBoardTiles && board.rows <= maxBoardTiles;
+        } else if (keyword == "tile") {
+            ok = static_cast<bool>(words >> board.tileSize) && board.tileSize >= 2 && board.tileSize <= maxTileSize;
+        } else if (board.columns <= 0) {
+            std::cerr << "Layout line " << number << ": size must come first" << std::endl;
+            return false;
+        } else if (keyword == "western" || keyword == "ivey" || keyword == "event") {
+            // Waypoints are kept in tiles until the tile size is final
+            std::vector<Tile>& tiles = keyword == "event" ? board.eventSpaces
+                                                          : board.paths[keyword == "ivey" ? ivey : western];
+            std::string point;
+            while (ok && words >> point) {
+                Tile to = Tile();
+                char comma = 0;
+                std::istringstream coordinates(point);
+                ok = static_cast<bool>(coordinates >> to.x >> comma >> to.y) && comma == ',' && to.x >= 0 &&
+                     to.y >= 0 && to.x < board.columns && to.y < board.rows;
+                if (!ok) {
+                    break;
+                }
+                if (keyword == "event" || tiles.empty()) {
+                    tiles.push_back(to);
+                    continue;
+                }
+                const Tile from = tiles.back();
+                ok = from.x == to.x || from.y == to.y;
+                const int steps = std::abs(to.x - from.x) + std::abs(to.y - from.y);
+                for (int step = 1; ok && step <= steps; ++step) {
+                    tiles.push_back({from.x + (to.x - from.x) * step / steps, from.y + (to.y - from.y) * step / steps});
+                }
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Layout line " << number << " is malformed: " << line << std::endl;
+            return false;
+        }
+    }
+    for (int path = 0; path < pathCount; ++path) {
+        if (board.paths[path].size() < 2) {
+            std::cerr << "Layout has no " << (path == ivey ? "ivey" : "western") << " path" << std::endl;
+            return false;
+        }
+    }
+
+    // Move every tile to the centre of its square in pixels
+    const int half = board.tileSize / 2;
+    for (int path = 0; path < pathCount; ++path) {
+        for (auto& tile : board.paths[path]) {
+            tile = {tile.x * board.tileSize + half, tile.y * board.tileSize + half};
+        }
+    }
+    for (auto& tile : board.eventSpaces) {
+        tile = {tile.x * board.tileSize + half, tile.y * board.tileSize + half};
+    }
+    board.markEvents();
+    return true;
+}
+
+/**
+ * @brief Gets the index of the last space on a path.
+ * @param path Path index.
+ * @return Index of the graduation space.
+ */
+int rules::Board::lastIndex(int path) const {
+    return static_cast<int>(paths[path].size()) - 1;
+}
+
+/**
+ * @brief Gets the standard board, built once.
+ * @return The board drawn by GameBoard.
+ */
+const rules::Board& rules::Board::standard() {
+    static const Board board = makeStandardBoard();
+    return board;
+}
+
+/**
+ * @brief Parses a deck in the events.txt format, compiling each event's effect.
+ * @param in Stream holding the deck.
+ * @return The parsed deck.
+ */
+rules::EventDeck rules::EventDeck::parse(std::istream& in) {
+    EventDeck deck = EventDeck();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (isBlank(line)) {
+            continue; // Skip empty lines between events
+        }
+        if (line.compare(0, 7, "shuffle") == 0 && isBlank(line.substr(7))) {
+            deck.shuffled = true;
+            continue;
+        }
+        if (deck.events.size() >= static_cast<size_t>(maxEvents)) {
+            std::cerr << "Deck has more than " << maxEvents << " events; ignoring " << line << " and the rest"
+                      << std::endl;
+            break;
+        }
+        Event event = Event();
+        event.description = line;
+        event.weight = 1;
+        event.regions = (1u << regionCount) - 1;
+
+        // Read the three scores, then an optional condition
+        std::string scores[effects::outputCount];
+        int read = 0;
+        while (read < effects::outputCount && std::getline(in, scores[read])) {
+            ++read;
+        }
+        if (read < effects::outputCount) {
+            break;
+        }
+        std::string condition;
+        while (std::getline(in, line) && !isBlank(line)) {
+            size_t start = line.find_first_not_of(" \t");
+            if (startsWord(line, start, "when")) {
+                condition = line.substr(start + 4);
+            } else if (startsWord(line, start, "weight")) {
+                std::istringstream value(line.substr(start + 6));
+                if (!(value >> event.weight) || event.weight < 0 || event.weight > maxWeight) {
+                    std::cerr << "Event " << event.description << " has a bad weight: " << line << std::endl;
+                    event.weight = 1;
+                }
+            } else if (startsWord(line, start, "on")) {
+                if (!parseRegions(line.substr(start + 2), event.regions)) {
+                    std::cerr << "Event " << event.description << " has a bad region: " << line << std::endl;
+                }
+            } else {
+                std::cerr << "Ignoring extra line after " << event.description << ": " << line << std::endl;
+            }
+        }
+
+        std::int32_t constants[effects::outputCount] = {0, 0, 0};
+        std::string error;
+        if (!effects::compile(scores, condition, event.effect, constants, error)) {
+            std::cerr << "Event " << event.description << " has no effect: " << error << std::endl;
+        }
+        event.happinessScore = constants[0];
+        event.debtScore = constants[1];
+        event.gpaScore = constants[2];
+        deck.events.push_back(event);
+    }
+    deck.build();
+    return deck;
+}
+
+/**
+ * @brief Rebuilds the region tables after events change.
+ */
+void rules::EventDeck::build() {
+    for (int region = 0; region < regionCount; ++region) {
+        tables[region].build(events, region);
+    }
+}
+
+/**
+ * @brief Builds the alias table with Vose's method, in exact integer arithmetic so every machine builds the same
+ * table. Each column holds totalWeight units: its own event's share and the rest from its alias. The shuffle bag
+ * keeps only the running total of the weights, so its size does not grow with them.
+ * @param deck Every event.
+ * @param region Region index.
+ */
+void rules::EventTable::build(const std::vector<Event>& deck, int region) {
+    events.clear();
+    ends.clear();
+    totalWeight = 0;
+    std::vector<std::uint64_t> share;
+    for (size_t i = 0; i < deck.size(); ++i) {
+        if ((deck[i].regions >> region & 1u) && deck[i].weight > 0) {
+            events.push_back(static_cast<std::uint16_t>(i));
+            share.push_back(static_cast<std::uint64_t>(deck[i].weight));
+            totalWeight += deck[i].weight;
+            ends.push_back(static_cast<std::uint32_t>(totalWeight));
+        }
+    }
+    const size_t n = events.size();
+    alias = events;
+    threshold.assign(n, 65536);
+
+    std::vector<size_t> small;
+    std::vector<size_t> large;
+    for (size_t i = 0; i < n; ++i) {
+        share[i] *= n; // Column i's share in units of one column's capacity, totalWeight
+        (share[i] < static_cast<std::uint64_t>(totalWeight) ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        size_t s = small.back();
+        size_t l = large.back();
+        small.pop_back();
+        threshold[s] = static_cast<std::uint32_t>((share[s] * 65536 + totalWeight / 2) / totalWeight);
+        alias[s] = events[l];
+        share[l] -= totalWeight - share[s];
+        if (share[l] < static_cast<std::uint64_t>(totalWeight)) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+}
+
+/**
+ * @brief Draws an event by weight from one multiply: the whole part of bits * n / 2^32 picks a column and the
+ * fraction chooses between its event and its alias. With equal weights every column keeps its own event.
+ * @param bits Random bits.
+ * @return Deck index of the event.
+ */
+int rules::EventTable::draw(std::uint32_t bits) const {
+    const std::uint64_t scaled = static_cast<std::uint64_t>(bits) * events.size();
+    const size_t column = static_cast<size_t>(scaled >> 32);
+    const std::uint32_t coin = static_cast<std::uint32_t>(scaled) >> 16;
+    return coin < threshold[column] ? events[column] : alias[column];
+}
+
+/**
+ * @brief Gets the event of one copy in the shuffle bag: the column whose running total of weights first passes
+ * the copy index.
+ * @param copy Copy index, below totalWeight.
+ * @return Deck index of the event.
+ */
+int rules::EventTable::copy(std::uint32_t copy) const {
+    return events[std::upper_bound(ends.begin(), ends.end(), copy) - ends.begin()];
+}
+
+/**
+ * @brief Creates the state at the start of a game.
+ * @return The starting state.
+ */
+rules::GameState rules::newGame() {
+    GameState state = GameState();
+    state.turn = 0;
+    state.players[0].path = ivey;
+    state.players[1].path = western;
+    return state;
+}
+
+/**
+ * @brief Checks if a player has reached graduation.
+ * @param state Game state.
+ * @param board Board being played.
+ * @param player Player index.
+ * @return True if the player is on the last space of their path.
+ */
+bool rules::finished(const GameState& state, const Board& board, int player) {
+    return state.players[player].index == board.lastIndex(state.players[player].path);
+}
+
+/**
+ * @brief Checks if both players have reached graduation.
+ * @param state Game state.
+ * @param board Board being played.
+ * @return True if the game is over.
+ */
+bool rules::gameOver(const GameState& state, const Board& board) {
+    return finished(state, board, 0) && finished(state, board, 1);
+}
+
+/**
+ * @brief Sets a player's path if they have not chosen yet.
+ * @param state Game state.
+ * @param player Player index.
+ * @param path Path index.
+ * @return True if the choice was accepted.
+ */
+bool rules::choosePath(GameState& state, int player, int path) {
+    if (player < 0 || player >= playerCount || path < 0 || path >= pathCount || state.players[player].chosen) {
+        return false;
+    }
+    state.players[player].path = path;
+    state.players[player].chosen = true;
+    return true;
+}
+
+/**
+ * @brief Checks if the player whose turn it is may spin.
+ * @param state Game state.
+ * @param board Board being played.
+ * @return True if a spin is allowed.
+ */
+bool rules::canSpin(const GameState& state, const Board& board) {
+    return state.players[state.turn].chosen && !gameOver(state, board);
+}
+
+/**
+ * @brief Draws a wheel result.
+ * @param rng Random number stream.
+ * @return Value from 1 to wheelSize.
+ */
+int rules::drawSpin(Rng& rng) {
+    return 1 + uniform(rng.next(), wheelSize);
+}
+
+/**
+ * @brief Draws an event for a space in a region. A shuffled deck deals every copy in the region once, in a random
+ * order picked at the start of each pass, before dealing them again; other decks draw by weight.
+ * @param rng Random number stream.
+ * @param deck Event deck.
+ * @param region Region of the space landed on.
+ * @param bag That region's shuffled deck.
+ * @return Index of the event, or -1 if the region has no events.
+ */
+int rules::drawEvent(Rng& rng, const EventDeck& deck, int region, Bag& bag) {
+    const EventTable& table = deck.tables[region];
+    if (table.events.empty()) {
+        return -1;
+    }
+    std::uint32_t bits = rng.next();
+    if (!deck.shuffled) {
+        return table.draw(bits);
+    }
+    const std::uint32_t size = static_cast<std::uint32_t>(table.totalWeight);
+    if (bag.drawn % size == 0) {
+        bag.key = bits; // Shuffle for a new pass
+    }
+    return table.copy(permute(bag.drawn++ % size, size, bag.key));
+}
+
+/**
+ * @brief Works out what an event does to a player. Constant effects skip the interpreter.
+ * @param event Event landed on.
+ * @param player Player state before the event.
+ * @return Changes to the player's resources.
+ */
+rules::Effect rules::eventEffect(const Event& event, const PlayerState& player) {
+    if (event.effect.empty()) {
+        return {event.happinessScore, event.debtScore, event.gpaScore};
+    }
+    const std::int32_t inputs[effects::inputCount] = {player.happiness, player.debt, player.gpa, player.path,
+                                                      player.index};
+    std::int32_t outputs[effects::outputCount];
+    effects::run(event.effect.data(), inputs, outputs);
+    return {outputs[0], outputs[1], outputs[2]};
+}
+
+/**
+ * @brief Adds an event's effects to a player's resources. Every score is worked out before any is changed.
+ * @param player Player state.
+ * @param event Event to apply.
+ */
+void rules::applyEvent(PlayerState& player, const Event& event) {
+    Effect effect = eventEffect(event, player);
+    player.happiness += effect.happiness;
+    player.debt += effect.debt;
+    player.gpa += effect.gpa;
+}
+
+/**
+ * @brief Moves the current player, applies any event and passes the turn.
+ * Movement stops at the end of the path, as in Player::move.
+ * @param state Game state.
+ * @param board Board being played.
+ * @param deck Event deck.
+ * @param spin Wheel result.
+ * @param rng Random number stream for the event draw.
+ * @return What happened.
+ */
+rules::Turn rules::applySpin(GameState& state, const Board& board, const EventDeck& deck, int spin, Rng& rng) {
+    Turn turn = {state.turn, spin, -1};
+    PlayerState& player = state.players[state.turn];
+
+    if (!finished(state, board, state.turn)) {
+        player.index = std::min(player.index + spin, board.lastIndex(player.path));
+        if (board.eventAt[player.path][player.index] && !deck.events.empty()) {
+            int region = board.regionAt[player.path][player.index];
+            turn.event = drawEvent(rng, deck, region, state.bags[region]);
+            if (turn.event >= 0) {
+                applyEvent(player, deck.events[turn.event]);
+            }
+        }
+    }
+
+    // Players who have graduated are skipped
+    int other = 1 - state.turn;
+    if (!finished(state, board, other)) {
+        state.turn = other;
+    }
+    return turn;
+}
+
+/**
+ * @brief Spins for the current player and plays out the turn.
+ * @param state Game state.
+ * @param board Board being played.
+ * @param deck Event deck.
+ * @param rng Random number stream.
+ * @return What happened.
+ */
+rules::Turn rules::playTurn(GameState& state, const Board& board, const EventDeck& deck, Rng& rng) {
+    int spin = drawSpin(rng);
+    return applySpin(state, board, deck, spin, rng);
+}
+
+/**
+ * @brief Counts the resource categories each player wins: higher GPA, lower debt and higher happiness.
+ * @param state Game state.
+ * @param score1 Receives player 1's score.
+ * @param score2 Receives player 2's score.
+ */
+void rules::scores(const GameState& state, int& score1, int& score2) {
+    const PlayerState& p1 = state.players[0];
+    const PlayerState& p2 = state.players[1];
+    score1 = (p1.gpa > p2.gpa) + (p1.debt < p2.debt) + (p1.happiness > p2.happiness);
+    score2 = (p1.gpa < p2.gpa) + (p1.debt > p2.debt) + (p1.happiness < p2.happiness);
+}
+
+/**
+ * @brief Determines the winner.
+ * @param state Game state.
+ * @return 0 or 1 for the winning player, or -1 for a tie.
+ */
+int rules::winner(const GameState& state) {
+    int score1;
+    int score2;
+    scores(state, score1, score2);
+    if (score1 > score2) {
+        return 0;
+    }
+    if (score1 < score2) {
+        return 1;
+    }
+    return -1;
+}
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <SFML/Graphics.hpp>
+#include "Latency.h"
+#include "SceneGraph.h"
+
+/**
+ * @file sceneGraph.cpp
+ * @brief Implementation file for the retained scene graph.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    /**
+     * @brief Computes the smallest rectangle containing two rectangles.
+     * @param a First rectangle.
+     * @param b Second rectangle.
+     * @return Union of the two.
+     */
+    sf::FloatRect unite(const sf::FloatRect& a, const sf::FloatRect& b) {
+        float left = std::min(a.left, b.left);
+        float top = std::min(a.top, b.top);
+        float right = std::max(a.left + a.width, b.left + b.width);
+        float bottom = std::max(a.top + a.height, b.top + b.height);
+        return sf::FloatRect(left, top, right - left, bottom - top);
+    }
+
+    /**
+     * @brief Checks whether two rectangles overlap or share an edge.
+     * @param a First rectangle.
+     * @param b Second rectangle.
+     * @return True if they touch.
+     */
+    bool touches(const sf::FloatRect& a, const sf::FloatRect& b) {
+        return a.left <= b.left + b.width && b.left <= a.left + a.width &&
+               a.top <= b.top + b.height && b.top <= a.top + a.height;
+    }
+}
+
+/**
+ * @brief Constructs a dirty scene node.
+ */
+SceneNode::SceneNode() : dirty(true) {
+}
+
+/**
+ * @brief Destroys the scene node.
+ */
+SceneNode::~SceneNode() {
+}
+
+/**
+ * @brief Flags the node for redrawing.
+ */
+void SceneNode::markDirty() {
+    dirty = true;
+}
+
+/**
+ * @brief Clears the dirty flag.
+ */
+void SceneNode::markClean() {
+    dirty = false;
+}
+
+/**
+ * @brief Checks if the node changed since the last composed frame.
+ * @return True if the node is dirty.
+ */
+bool SceneNode::isDirty() const {
+    return dirty;
+}
+
+/**
+ * @brief Constructs a scene with cached layers the size of the window.
+ * @param width Width of the window in pixels.
+ * @param height Height of the window in pixels.
+ */
+Scene::Scene(unsigned width, unsigned height)
+    : size(width, height), camera(sf::FloatRect(0, 0, width, height)), fullRedraw(true), cameraMoved(false) {
+    staticLayer.create(width, height);
+    frame.create(width, height);
+}
+
+/**
+ * @brief Adds a node to the cached static layer.
+ * @param node Node to add.
+ */
+void Scene::addStatic(SceneNode& node) {
+    // Keep static nodes ahead of dynamic ones so the drawing order matches the layering
+    auto firstDynamic = std::find_if(nodes.begin(), nodes.end(), [](const Entry& entry) { return !entry.isStatic; });
+    Entry entry = {&node, sf::FloatRect(), true, false};
+    entry.lastBounds = placeOf(entry);
+    nodes.insert(firstDynamic, entry);
+    node.markDirty();
+}
+
+/**
+ * @brief Adds a node that is redrawn whenever it changes.
+ * @param node Node to add.
+ */
+void Scene::addDynamic(SceneNode& node) {
+    Entry entry = {&node, sf::FloatRect(), false, false};
+    entry.lastBounds = placeOf(entry);
+    nodes.push_back(entry);
+    node.markDirty();
+}
+
+/**
+ * @brief Adds a dynamic node placed in window coordinates.
+ * @param node Node to add.
+ */
+void Scene::addOverlay(SceneNode& node) {
+    nodes.push_back({&node, node.getBounds(), false, true});
+    node.markDirty();
+}
+
+/**
+ * @brief Moves the camera, scheduling a full redraw if the view changed.
+ * @param view Part of the board to show.
+ */
+void Scene::setCamera(const sf::View& view) {
+    if (view.getCenter() != camera.getCenter() || view.getSize() != camera.getSize()) {
+        camera.setCenter(view.getCenter());
+        camera.setSize(view.getSize());
+        cameraMoved = true;
+    }
+}
+
+/**
+ * @brief Gets the camera.
+ * @return Part of the board shown.
+ */
+const sf::View& Scene::getCamera() const {
+    return camera;
+}
+
+/**
+ * @brief Maps a node's bounds through the camera, unless it is an overlay.
+ * @param entry The node.
+ * @return Its bounds in window coordinates.
+ */
+sf::FloatRect Scene::placeOf(const Entry& entry) const {
+    const sf::FloatRect bounds = entry.node->getBounds();
+    if (entry.isOverlay) {
+        return bounds;
+    }
+    const sf::Vector2f scale(size.x / camera.getSize().x, size.y / camera.getSize().y);
+    const sf::Vector2f corner = camera.getCenter() - camera.getSize() / 2.0f;
+    return sf::FloatRect((bounds.left - corner.x) * scale.x, (bounds.top - corner.y) * scale.y,
+                         bounds.width * scale.x, bounds.height * scale.y);
+}
+
+/**
+ * @brief Forces the next frame to be recomposed in full.
+ */
+void Scene::invalidate() {
+    fullRedraw = true;
+}
+
+/**
+ * @brief Adds a rectangle to a damage list, merging touching rectangles.
+ * @param damage Damage list.
+ * @param rect Damaged rectangle.
+ */
+void Scene::addDamage(std::vector<sf::FloatRect>& damage, const sf::FloatRect& rect) const {
+    // Snap outwards to whole pixels so no half-covered pixel is left stale
+    float left = std::max(0.0f, std::floor(rect.left));
+    float top = std::max(0.0f, std::floor(rect.top));
+    float right = std::min(static_cast<float>(size.x), std::ceil(rect.left + rect.width));
+    float bottom = std::min(static_cast<float>(size.y), std::ceil(rect.top + rect.height));
+    if (right <= left || bottom <= top) {
+        return;
+    }
+
+    sf::FloatRect merged(left, top, right - left, bottom - top);
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (size_t i = 0; i < damage.size(); ++i) {
+            if (touches(damage[i], merged)) {
+                merged = unite(damage[i], merged);
+                damage.erase(damage.begin() + i);
+                grew = true;
+                break;
+            }
+        }
+    }
+    damage.push_back(merged);
+}
+
+/**
+ * @brief Restricts drawing to one region by mapping a view onto just that part of the target. Through the camera,
+ * the view shows the part of the board that the camera puts in that region.
+ * @param target Render target to clip.
+ * @param region Region to draw into.
+ * @param throughCamera True to draw board coordinates through the camera.
+ */
+void Scene::clipTo(sf::RenderTarget& target, const sf::FloatRect& region, bool throughCamera) const {
+    sf::View view(region);
+    if (throughCamera) {
+        const sf::Vector2f scale(camera.getSize().x / size.x, camera.getSize().y / size.y);
+        const sf::Vector2f corner = camera.getCenter() - camera.getSize() / 2.0f;
+        view.reset(sf::FloatRect(corner.x + region.left * scale.x, corner.y + region.top * scale.y,
+                                 region.width * scale.x, region.height * scale.y));
+    }
+    view.setViewport(sf::FloatRect(region.left / size.x, region.top / size.y, region.width / size.x, region.height / size.y));
+    target.setView(view);
+}
+
+/**
+ * @brief Recomposes the damaged regions into the cached frame.
+ * @return True if the frame changed.
+ */
+bool Scene::compose() {
+    sf::FloatRect everything(0, 0, size.x, size.y);
+    std::vector<sf::FloatRect> damage;
+    std::vector<sf::FloatRect> staticDamage;
+
+    // A moved camera shifts everything on the board, so both layers are redrawn in full
+    if (cameraMoved) {
+        fullRedraw = true;
+        staticDamage.push_back(everything);
+        cameraMoved = false;
+    }
+
+    // Collect where dirty nodes were and where they are now
+    for (auto& entry : nodes) {
+        if (!entry.node->isDirty() && !fullRedraw) {
+            continue;
+        }
+        sf::FloatRect bounds = placeOf(entry);
+        if (entry.node->isDirty()) {
+            addDamage(damage, entry.lastBounds);
+            addDamage(damage, bounds);
+            if (entry.isStatic) {
+                addDamage(staticDamage, entry.lastBounds);
+                addDamage(staticDamage, bounds);
+            }
+        }
+        entry.lastBounds = bounds;
+        entry.node->markClean();
+    }
+    if (fullRedraw) {
+        damage.assign(1, everything);
+        fullRedraw = false;
+    }
+    if (damage.empty()) {
+        return false;
+    }
+
+    // Refresh the cached static layer where static nodes changed
+    for (const auto& region : staticDamage) {
+        clipTo(staticLayer, region, false);
+
+        // clear() ignores the view, so blank the region by drawing over it
+        sf::RectangleShape blank(sf::Vector2f(region.width, region.height));
+        blank.setPosition(region.left, region.top);
+        blank.setFillColor(sf::Color::Black);
+        staticLayer.draw(blank);
+
+        clipTo(staticLayer, region, true);
+        for (auto& entry : nodes) {
+            if (entry.isStatic && entry.lastBounds.intersects(region)) {
+                entry.node->render(staticLayer);
+            }
+        }
+    }
+    staticLayer.display();
+
+    // Rebuild each damaged region from the static layer plus the dynamic nodes over it
+    sf::Sprite staticSprite(staticLayer.getTexture());
+    for (const auto& region : damage) {
+        clipTo(frame, region, false);
+        frame.draw(staticSprite);
+        for (auto& entry : nodes) {
+            if (!entry.isStatic && entry.lastBounds.intersects(region)) {
+                clipTo(frame, region, !entry.isOverlay);
+                entry.node->render(frame);
+            }
+        }
+    }
+    frame.display();
+    return true;
+}
+
+/**
+ * @brief Gets the cached frame.
+ * @return Texture holding the last composed frame.
+ */
+const sf::Texture& Scene::getFrame() const {
+    return frame.getTexture();
+}
+
+/**
+ * @brief Recomposes the damaged regions and shows the frame.
+ * @param window SFML RenderWindow to present on.
+ * @return True if a frame was displayed.
+ */
+bool Scene::present(sf::RenderWindow& window) {
+    if (!compose()) {
+        return false;
+    }
+    window.setView(window.getDefaultView());
+    window.draw(sf::Sprite(frame.getTexture()));
+    latency::display(window);
+    return true;
+}
@@ -0,0 +1,235 @@
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include "Net.h"
+#include "Protocol.h"
+#include "Rules.h"
+#include "Telemetry.h"
+
+/**
+ * @file server.cpp
+ * @brief Authoritative game server: runs the rules for one table and streams state deltas to its clients.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage: wwServer [address] [--seed N] [--events events.txt] [--telemetry games.ndjson]
+ */
+
+/**
+ * @brief A connected client.
+ */
+struct Client {
+    std::unique_ptr<net::Connection> connection; ///< Socket to the client.
+    int seat;                                    ///< 1 or 2 for players, 0 for spectators.
+    bool welcomed;                               ///< True once the client has said hello.
+    bool closed;                                 ///< True once the connection has failed or been closed.
+    rules::GameState sent;                       ///< State the client has been sent so far.
+};
+
+/**
+ * @brief The game being played and what it is played with.
+ */
+struct Table {
+    const rules::Board& board;    ///< Board being played.
+    const rules::EventDeck& deck; ///< Event deck.
+    rules::GameState state;       ///< Authoritative state.
+    rules::Rng rng;               ///< Spin and event stream.
+    std::uint64_t game;           ///< Number of the game being played, for telemetry.
+    telemetry::Log& log;          ///< Per-game telemetry; ignores records unless opened.
+};
+
+/**
+ * @brief Reads one varint from a message payload.
+ * @param message Received message.
+ * @param value Receives the value.
+ * @return False if the payload is malformed.
+ */
+bool readValue(const protocol::Message& message, std::uint32_t& value) {
+    const std::uint8_t* p = message.payload.data();
+    return protocol::getVarint(p, p + message.payload.size(), value);
+}
+
+/**
+ * @brief Acts on one message from a client.
+ * @param client Client that sent the message.
+ * @param message Received message.
+ * @param table The table.
+ * @param clients Every connected client, to check seats and broadcast spins.
+ */
+void handle(Client& client, const protocol::Message& message, Table& table, std::vector<Client>& clients) {
+    std::uint32_t value = 0;
+    if (message.type != protocol::Spin && !readValue(message, value)) {
+        client.closed = true;
+        return;
+    }
+
+    if (message.type == protocol::Hello && !client.welcomed) {
+        // Grant the requested seat if nobody holds it, otherwise let the client watch
+        int seat = (value == 1 || value == 2) ? static_cast<int>(value) : 0;
+        for (const auto& other : clients) {
+            if (other.welcomed && !other.closed && other.seat == seat) {
+                seat = 0;
+            }
+        }
+        client.seat = seat;
+        client.welcomed = true;
+        client.sent = rules::GameState(); // The first delta is the full state
+
+        std::vector<std::uint8_t> payload;
+        protocol::putVarint(payload, seat);
+        protocol::putVarint(payload, static_cast<std::uint32_t>(table.deck.events.size()));
+        client.connection->send(protocol::Welcome, payload);
+        std::cout << (seat ? "Player " + std::to_string(seat) + " joined" : std::string("Spectator joined")) << std::endl;
+    } else if (message.type == protocol::ChoosePath && client.seat > 0) {
+        if (rules::choosePath(table.state, client.seat - 1, static_cast<int>(value))) {
+            table.log.record(0, telemetry::chose(table.game, client.seat - 1, static_cast<int>(value)));
+        }
+    } else if (message.type == protocol::Spin && client.seat > 0 && table.state.turn == client.seat - 1 &&
+               rules::canSpin(table.state, table.board)) {
+        const rules::PlayerState before = table.state.players[table.state.turn];
+        rules::Turn turn = rules::playTurn(table.state, table.board, table.deck, table.rng);
+        table.log.record(0, telemetry::played(table.game, turn, before, table.state.players[turn.player]));
+        if (rules::gameOver(table.state, table.board)) {
+            table.log.record(0, telemetry::ended(table.game, table.state));
+        }
+        std::cout << "Player " << turn.player + 1 << " spun " << turn.spin
+                  << (turn.event >= 0 ? ", event " + std::to_string(turn.event) : std::string()) << std::endl;
+
+        std::vector<std::uint8_t> payload;
+        protocol::putVarint(payload, turn.player);
+        protocol::putVarint(payload, turn.spin);
+        protocol::putVarint(payload, turn.event + 1);
+        for (auto& other : clients) {
+            if (other.welcomed) {
+                other.connection->send(protocol::Spun, payload);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the server until it is killed.
+ * @param argc Number of arguments.
+ * @param argv Address, --seed, --events and --telemetry options.
+ * @return Exit status of the program.
+ */
+int main(int argc, char* argv[]) {
+    std::signal(SIGPIPE, SIG_IGN); // A client vanishing mid-write is handled as a failed write
+
+    std::string address = net::defaultAddress;
+    std::string eventsFile = "events.txt";
+    std::string telemetryFile;
+    std::uint32_t seed = std::random_device()();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--events" && i + 1 < argc) {
+            eventsFile = argv[++i];
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetryFile = argv[++i];
+        } else {
+            address = arg;
+        }
+    }
+
+    std::ifstream deckFile(eventsFile);
+    if (!deckFile) {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+    rules::EventDeck deck = rules::EventDeck::parse(deckFile);
+
+    int listener = net::listenOn(address);
+    if (listener < 0) {
+        return 1;
+    }
+    std::cout << "Serving Western Wonderland on " << address << std::endl;
+
+    telemetry::Log log;
+    if (!telemetryFile.empty() && !log.open(telemetryFile)) {
+        return 1;
+    }
+    Table table = {rules::Board::standard(), deck, rules::newGame(), {seed, 0}, 0, log};
+    log.record(0, telemetry::started(table.game));
+    std::vector<Client> clients;
+
+    while (true) {
+        std::vector<pollfd> fds;
+        fds.push_back({listener, POLLIN, 0});
+        for (const auto& client : clients) {
+            short events = POLLIN;
+            if (client.connection->wantsWrite()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({client.connection->fd(), events, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            continue; // Interrupted by a signal
+        }
+
+        // Read and act on everything that arrived
+        size_t polled = clients.size();
+        for (size_t i = 0; i < polled; ++i) {
+            if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) {
+                if (!clients[i].connection->receive()) {
+                    clients[i].closed = true;
+                }
+                protocol::Message message;
+                while (!clients[i].closed && clients[i].connection->next(message)) {
+                    handle(clients[i], message, table, clients);
+                }
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = net::acceptFrom(listener)) >= 0) {
+                Client client = Client(); // Unseated, not yet welcomed
+                client.connection.reset(new net::Connection(fd));
+                clients.push_back(std::move(client));
+            }
+        }
+
+        // Send each client only what changed since its last update
+        for (auto& client : clients) {
+            if (!client.welcomed || client.closed) {
+                continue;
+            }
+            std::vector<std::uint8_t> payload;
+            if (protocol::encodeDelta(client.sent, table.state, payload)) {
+                std::uint32_t sum = protocol::checksum(table.state);
+                for (int b = 0; b < 4; ++b) {
+                    payload.push_back(static_cast<std::uint8_t>(sum >> (8 * b)));
+                }
+                client.connection->send(protocol::State, payload);
+                client.sent = table.state;
+            }
+        }
+
+        bool seated = false;
+        for (size_t i = 0; i < clients.size();) {
+            if (clients[i].closed || !clients[i].connection->flush()) {
+                if (clients[i].seat) {
+                    std::cout << "Player " << clients[i].seat << " left" << std::endl;
+                }
+                clients.erase(clients.begin() + i);
+            } else {
+                seated = seated || clients[i].seat > 0;
+                ++i;
+            }
+        }
+
+        // Once a finished game has no players left, set the table up for the next one
+        if (!seated && rules::gameOver(table.state, table.board)) {
+            table.state = rules::newGame();
+            log.record(0, telemetry::started(++table.game));
+            std::cout << "New game" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "Simulation.h"
+#include "Metrics.h"
+#include "Pacing.h"
+
+/**
+ * @file simulation.cpp
+ * @brief Implementation file for the simulation thread that runs a local game.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const std::chrono::milliseconds tickLength(1);   ///< Time between simulation ticks.
+    const std::chrono::milliseconds stepLength(300); ///< Time a marker waits on each space it passes.
+    const std::size_t inputCapacity = 64;            ///< Inputs the render thread can queue between ticks.
+    const std::uint64_t game = 0;                    ///< Telemetry id of the local game.
+}
+
+/**
+ * @brief Constructs a simulation of a new game. Nothing runs until start() is called.
+ * @param board Board to play on.
+ * @param deck Event deck.
+ * @param wheel Wheel shown by the render thread.
+ * @param bot Computer playing player 2, or nullptr.
+ * @param log Telemetry log.
+ * @param seed Seed of the spin and event stream.
+ */
+Simulation::Simulation(const rules::Board& board, const rules::EventDeck& deck, const Wheel& wheel, Bot* bot,
+                       telemetry::Log& log, std::uint32_t seed)
+    : board(board), deck(deck), wheel(wheel), bot(bot), log(log), journal(nullptr),
+      layout(journal::fingerprint(board, deck)), input(inputCapacity),
+      running(false), now(Snapshot()), rng({seed, 0}), pendingEvent(-1), seenEvents(0), changed(false),
+      botThinking(false), ended(false), saved(0) {
+    now.state = rules::newGame();
+    now.lastTurn = {-1, 0, -1};
+    now.eventPlayer = -1;
+    now.event = -1;
+    snapshots.writeSlot() = now;
+    snapshots.publish();
+}
+
+/**
+ * @brief Destructor for the Simulation class.
+ */
+Simulation::~Simulation() {
+    stop();
+}
+
+/**
+ * @brief Saves every change to the game to a journal from now on.
+ * @param writer Open journal.
+ */
+void Simulation::autosave(journal::Writer& writer) {
+    journal = &writer;
+}
+
+/**
+ * @brief Carries on a recovered game from the state and random stream position of its latest entry.
+ * @param entry Latest entry of the game.
+ */
+void Simulation::resume(const journal::Entry& entry) {
+    now.state = entry.state;
+    rng = {entry.seed, entry.counter};
+    for (int p = 0; p < rules::playerCount; ++p) {
+        now.shown[p] = now.state.players[p].index;
+    }
+    saved = entry.sequence;
+    snapshots.writeSlot() = now;
+    snapshots.publish();
+}
+
+/**
+ * @brief Starts the simulation thread. A new game starts a new journal; a resumed one goes on with its own.
+ */
+void Simulation::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    log.record(0, telemetry::started(game));
+    if (saved == 0) {
+        save(journal::Started, -1, 0, -1);
+    }
+    thread = std::thread(&Simulation::run, this);
+}
+
+/**
+ * @brief Stops the simulation thread, recording the game as given up if it had not finished.
+ */
+void Simulation::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    thread.join();
+    if (!ended) {
+        log.record(0, telemetry::abandoned(game));
+    }
+}
+
+/**
+ * @brief Sends input to the simulation without blocking.
+ * @param in The input.
+ * @return False if the input was dropped.
+ */
+bool Simulation::send(const Input& in) {
+    return input.push(in);
+}
+
+/**
+ * @brief Picks up the newest snapshot.
+ * @return True if latest() changed.
+ */
+bool Simulation::update() {
+    return snapshots.update();
+}
+
+/**
+ * @brief Gets the snapshot the render thread holds.
+ * @return The snapshot.
+ */
+const Simulation::Snapshot& Simulation::latest() const {
+    return snapshots.latest();
+}
+
+/**
+ * @brief Runs fixed ticks against the steady clock until stopped. Ticks are scheduled from the clock rather than
+ * from the previous tick, so the game keeps real time however long the render thread takes over a frame.
+ */
+void Simulation::run() {
+    std::chrono::steady_clock::time_point next = pacing::now();
+    while (running) {
+        const std::chrono::steady_clock::time_point at = pacing::now();
+        Input in;
+        while (input.pop(in)) {
+            handle(in, at);
+        }
+        advance(at);
+
+        ++now.tick;
+        if (changed) {
+            snapshots.writeSlot() = now;
+            snapshots.publish();
+            changed = false;
+        }
+
+        next += tickLength;
+        if (next < at) {
+            next = at; // Fell behind, e.g. the machine was suspended; carry on from now rather than catch up
+        }
+        pacing::sleepUntil(next);
+    }
+}
+
+/**
+ * @brief Acts on one piece of input. Input that does not fit the moment, such as a spin while a marker is still
+ * moving, is ignored.
+ * @param in The input.
+ * @param at Time of the tick.
+ */
+void Simulation::handle(const Input& in, std::chrono::steady_clock::time_point at) {
+    if (in.kind == ChoosePath && in.player >= 0 && in.player < rules::playerCount && !(bot && in.player == 1)) {
+        if (rules::choosePath(now.state, in.player, in.value)) {
+            log.record(0, telemetry::chose(game, in.player, in.value));
+            save(journal::Chose, in.player, in.value, -1);
+            changed = true;
+        }
+    } else if (in.kind == Spin && spinnable(at)) {
+        spin(at);
+    } else if (in.kind == EventSeen && seenEvents < now.events) {
+        ++seenEvents;
+    } else if (in.kind == Rewind && timeline.started() && settled(at)) {
+        rewind(in.value, at);
+    }
+}
+
+/**
+ * @brief Plays a turn for the player whose turn it is. The event, if any, is applied at once but only shown once
+ * the marker reaches its space.
+ * @param at Time of the tick.
+ */
+void Simulation::spin(std::chrono::steady_clock::time_point at) {
+    if (!timeline.started()) {
+        timeline.start(now.state, rng);
+    }
+    const int mover = now.state.turn;
+    const rules::PlayerState before = now.state.players[mover];
+    const rules::Turn turn = rules::playTurn(now.state, board, deck, rng);
+    const rules::PlayerState& after = now.state.players[mover];
+    log.record(0, telemetry::played(game, turn, before, after));
+    timeline.record(now.state, rng, mover);
+    save(journal::Spun, mover, turn.spin, turn.event);
+    now.turn = static_cast<int>(timeline.position());
+    now.turns = static_cast<int>(timeline.turns());
+
+    ++now.spins;
+    metrics::spun();
+    now.lastTurn = turn;
+    pendingEvent = turn.event;
+    now.unseen[mover] = {after.happiness - before.happiness, after.debt - before.debt, after.gpa - before.gpa};
+    nextStep[mover] = at + std::chrono::milliseconds(wheel.SpinMillis(turn.spin)) + stepLength;
+    changed = true;
+}
+
+/**
+ * @brief Takes the game back or forward by a number of turns. The random stream comes back with the state, so
+ * turns played again after going back spin and draw exactly as they did before, and a rewind can never re-roll a
+ * spin.
+ * @param by Turns to move.
+ * @param at Time of the tick.
+ */
+void Simulation::rewind(int by, std::chrono::steady_clock::time_point at) {
+    const long turns = static_cast<long>(timeline.turns());
+    long target = std::min(std::max(static_cast<long>(timeline.position()) + by, 0L), turns);
+    if (!timeline.restore(static_cast<std::size_t>(target), now.state, rng)) {
+        return;
+    }
+
+    // The bot would replay its own turn at once, dropping every turn after it, so going back or forward skips
+    // over its turns to the next one a person plays
+    while (bot && by < 0 && now.state.turn == 1 && target > 0) {
+        timeline.restore(static_cast<std::size_t>(--target), now.state, rng);
+    }
+    while (bot && by > 0 && now.state.turn == 1 && target < turns) {
+        timeline.restore(static_cast<std::size_t>(++target), now.state, rng);
+    }
+
+    for (int p = 0; p < rules::playerCount; ++p) {
+        now.shown[p] = now.state.players[p].index;
+        now.unseen[p] = rules::Effect();
+        nextStep[p] = at;
+    }
+    now.turn = static_cast<int>(timeline.position());
+    now.turns = static_cast<int>(timeline.turns());
+    log.record(0, telemetry::rewound(game, now.turn));
+    save(journal::Rewound, -1, by, -1);
+
+    // Going back from graduation reopens the game, so reaching it again records the result again
+    ended = ended && rules::gameOver(now.state, board);
+    pendingEvent = -1;
+    changed = true;
+}
+
+/**
+ * @brief Queues the current state for the journal. The entry is zeroed first so no uninitialised padding reaches the
+ * file.
+ * @param kind A journal::Kind.
+ * @param player Player who chose or spun, or -1.
+ * @param value Path chosen, wheel result or turns rewound.
+ * @param event Event applied, or -1.
+ */
+void Simulation::save(std::uint8_t kind, int player, int value, int event) {
+    if (!journal) {
+        return;
+    }
+    journal::Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.sequence = kind == journal::Started ? 0 : ++saved;
+    entry.kind = kind;
+    entry.player = static_cast<std::int8_t>(player);
+    entry.value = static_cast<std::int8_t>(value);
+    entry.event = event;
+    entry.seed = rng.seed;
+    entry.counter = rng.counter;
+    entry.layout = layout;
+    entry.state = now.state;
+    journal->append(entry);
+}
+
+/**
+ * @brief Moves each marker one space per step towards its player's space, shows the event once the marker has
+ * stopped on it, lets the bot choose and spin, and records the result once both markers reach graduation.
+ * @param at Time of the tick.
+ */
+void Simulation::advance(std::chrono::steady_clock::time_point at) {
+    for (int p = 0; p < rules::playerCount; ++p) {
+        if (now.shown[p] < now.state.players[p].index && at >= nextStep[p]) {
+            ++now.shown[p];
+            nextStep[p] = at + stepLength;
+            changed = true;
+        }
+    }
+
+    const int mover = now.lastTurn.player;
+    if (pendingEvent >= 0 && now.shown[mover] == now.state.players[mover].index && at >= nextStep[mover]) {
+        ++now.events;
+        now.eventPlayer = mover;
+        now.event = pendingEvent;
+        metrics::eventShown(pendingEvent);
+        now.effect = now.unseen[mover];
+        now.unseen[mover] = rules::Effect();
+        pendingEvent = -1;
+        changed = true;
+    }
+
+    // The bot chooses once player 1 has, thinking on its own threads, and spins whenever it is its turn
+    if (bot && now.state.players[0].chosen && !now.state.players[1].chosen) {
+        int path;
+        if (!botThinking) {
+            bot->startPathChoice(now.state, 1);
+            botThinking = true;
+        } else if (bot->poll(path)) {
+            rules::choosePath(now.state, 1, path);
+            log.record(0, telemetry::chose(game, 1, path));
+            save(journal::Chose, 1, path, -1);
+            botThinking = false;
+            changed = true;
+        }
+    } else if (bot && now.state.turn == 1 && rules::canSpin(now.state, board) && settled(at)) {
+        spin(at);
+    }
+
+    if (!ended && rules::gameOver(now.state, board) && settled(at)) {
+        log.record(0, telemetry::ended(game, now.state));
+        metrics::gameCompleted();
+        save(journal::Ended, -1, 0, -1);
+        ended = true;
+    }
+
+    // Tell the render thread when a spin would be taken, so it only sends and times presses that start one
+    const bool ready = spinnable(at);
+    if (ready != now.spinReady) {
+        now.spinReady = ready;
+        changed = true;
+    }
+}
+
+/**
+ * @brief Checks if every marker has stopped and every event has been seen.
+ * @param at Time of the tick.
+ * @return True if the game is waiting for a spin.
+ */
+bool Simulation::settled(std::chrono::steady_clock::time_point at) const {
+    for (int p = 0; p < rules::playerCount; ++p) {
+        if (now.shown[p] != now.state.players[p].index || at < nextStep[p]) {
+            return false;
+        }
+    }
+    return pendingEvent < 0 && seenEvents == now.events;
+}
+
+/**
+ * @brief Checks if a Spin from the player would be played.
+ * @param at Time of the tick.
+ * @return True if it is a person's turn and the game is waiting for a spin.
+ */
+bool Simulation::spinnable(std::chrono::steady_clock::time_point at) const {
+    return !(bot && now.state.turn == 1) && rules::canSpin(now.state, board) && settled(at);
+}
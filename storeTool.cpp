@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GameStore.h"
+#include "Rules.h"
+
+/**
+ * @file storeTool.cpp
+ * @brief Simulates games in bulk into a columnar game store and answers group-by queries over it.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ *
+ * Usage:
+ *   wwStore simulate FILE [--games N] [--seed N] [--threads N] [--events events.txt]
+ *   wwStore query FILE [--by pair|path|event|winner] [--threads N] [--events events.txt]
+ *   wwStore info FILE
+ * Simulated games are appended, so a store can be grown over several runs; use a new seed for each run.
+ */
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock; ///< Clock used to time runs.
+
+    const char* const pathNames[rules::pathCount] = {"Western", "Ivey"}; ///< Path names by path index.
+
+    /**
+     * @brief Plays one game with random path choices and records its result.
+     * @param board Board being played.
+     * @param deck Event deck.
+     * @param seed Seed of the run.
+     * @param game Game id; the game's random stream is seeded from it and the run's seed.
+     * @param row Receives the result.
+     */
+    void playGame(const rules::Board& board, const rules::EventDeck& deck, std::uint32_t seed, std::uint64_t game,
+                  store::Row& row) {
+        rules::Rng rng = {rules::mix(seed, static_cast<std::uint32_t>(game)), 0};
+        rules::GameState state = rules::newGame();
+        for (int p = 0; p < rules::playerCount; ++p) {
+            rules::choosePath(state, p, rules::uniform(rng.next(), rules::pathCount));
+        }
+        row.game = game;
+        row.spins = 0;
+        row.events[0].clear();
+        row.events[1].clear();
+        while (!rules::gameOver(state, board)) {
+            const rules::Turn turn = rules::playTurn(state, board, deck, rng);
+            ++row.spins;
+            if (turn.event >= 0) {
+                row.events[turn.player].push_back(static_cast<std::uint16_t>(turn.event));
+            }
+        }
+        for (int p = 0; p < rules::playerCount; ++p) {
+            row.paths[p] = state.players[p].path;
+            row.happiness[p] = state.players[p].happiness;
+            row.debt[p] = state.players[p].debt;
+            row.gpa[p] = state.players[p].gpa;
+        }
+        row.winner = rules::winner(state);
+    }
+
+    /**
+     * @brief Simulates games into a store, each thread filling whole blocks and appending them as they fill.
+     * @param file Store file.
+     * @param games Number of games.
+     * @param seed Seed of the run.
+     * @param threads Number of threads.
+     * @param deck Event deck.
+     * @return Exit status of the program.
+     */
+    int simulate(const std::string& file, std::uint64_t games, std::uint32_t seed, int threads,
+                 const rules::EventDeck& deck) {
+        store::Writer writer;
+        if (!writer.open(file)) {
+            return 1;
+        }
+        const rules::Board& board = rules::Board::standard();
+        const std::uint64_t blocks = (games + store::blockRows - 1) / store::blockRows;
+        std::atomic<std::uint64_t> nextBlock(0);
+        std::atomic<bool> failed(false);
+
+        const Clock::time_point start = Clock::now();
+        auto fill = [&]() {
+            store::BlockBuilder builder;
+            store::Row row;
+            std::string encoded;
+            for (std::uint64_t b = nextBlock++; b < blocks && !failed; b = nextBlock++) {
+                const std::uint64_t end = std::min(games, (b + 1) * store::blockRows);
+                for (std::uint64_t game = b * store::blockRows; game < end; ++game) {
+                    playGame(board, deck, seed, game, row);
+                    builder.add(row);
+                }
+                encoded.clear();
+                builder.finish(encoded);
+                if (!writer.append(encoded)) {
+                    failed = true;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; ++t) {
+            workers.emplace_back(fill);
+        }
+        fill();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        if (!writer.close() || failed) {
+            std::cerr << "Failed to write " << file << std::endl;
+            return 1;
+        }
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "Simulated " << games << " games with seed " << seed << " on " << threads << " threads in "
+                  << seconds << " s (" << static_cast<std::uint64_t>(games / std::max(seconds, 1e-9))
+                  << " games/s)" << std::endl;
+        return 0;
+    }
+
+    /**
+     * @brief Prints the size of a store, column by column.
+     * @param reader Open store.
+     * @return Exit status of the program.
+     */
+    int info(const store::Reader& reader) {
+        std::uint64_t total = 0;
+        const double rows = std::max<double>(1, static_cast<double>(reader.rowCount()));
+        std::cout << reader.rowCount() << " games in " << reader.blockCount() << " blocks" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (int c = 0; c < store::columnCount; ++c) {
+            const store::Column column = static_cast<store::Column>(c);
+            total += reader.columnBytes(column);
+            std::cout << "  " << std::left << std::setw(12) << store::columnName(column) << std::right
+                      << std::setw(14) << reader.columnBytes(column) << " bytes, "
+                      << reader.columnBytes(column) / rows << " per game" << std::endl;
+        }
+        std::cout << "  " << std::left << std::setw(12) << "total" << std::right << std::setw(14) << total
+                  << " bytes, " << total / rows << " per game" << std::endl;
+        return 0;
+    }
+
+    /**
+     * @brief Runs a group-by query and prints one line per group.
+     * @param reader Open store.
+     * @param by Key name.
+     * @param threads Number of threads to scan with.
+     * @param deck Event deck, for event descriptions; may be empty.
+     * @return Exit status of the program.
+     */
+    int query(const store::Reader& reader, const std::string& by, int threads, const rules::EventDeck& deck) {
+        store::Key key;
+        if (by == "pair") {
+            key = store::ByPair;
+        } else if (by == "path") {
+            key = store::ByPath;
+        } else if (by == "event") {
+            key = store::ByEvent;
+        } else if (by == "winner") {
+            key = store::ByWinner;
+        } else {
+            std::cerr << "Unknown key " << by << "; use pair, path, event or winner" << std::endl;
+            return 1;
+        }
+
+        const Clock::time_point start = Clock::now();
+        std::vector<store::Aggregate> groups;
+        if (!store::aggregate(reader, key, threads, groups)) {
+            return 1;
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Scanned " << reader.rowCount() << " games on " << threads << " threads in " << ms << " ms"
+                  << std::endl;
+        std::cout << (key == store::ByPath || key == store::ByEvent ? "Players" : "Player 1")
+                  << " by " << by << ": count, won / lost / tied, mean happiness, debt, GPA and spins per game"
+                  << std::endl;
+        for (std::size_t g = 0; g < groups.size(); ++g) {
+            const store::Aggregate& group = groups[g];
+            if (group.rows == 0) {
+                continue;
+            }
+            std::string name;
+            if (key == store::ByPair) {
+                name = std::string(pathNames[g / 2]) + " vs " + pathNames[g % 2];
+            } else if (key == store::ByPath) {
+                name = pathNames[g];
+            } else if (key == store::ByWinner) {
+                name = g == 0 ? "tie" : "player " + std::to_string(g);
+            } else {
+                name = "event " + std::to_string(g);
+                if (g < deck.events.size()) {
+                    name += " (" + deck.events[g].description.substr(0, 40) + ")";
+                }
+            }
+            const double rows = static_cast<double>(group.rows);
+            std::cout << "  " << name << ": " << group.rows << ", " << 100 * group.won / rows << "% / "
+                      << 100 * group.lost / rows << "% / " << 100 * group.tied / rows << "%, "
+                      << group.happiness / rows << ", " << group.debt / rows << ", " << group.gpa / rows << ", "
+                      << group.spins / rows << std::endl;
+        }
+        return 0;
+    }
+}
+
+/**
+ * @brief Runs the store tool.
+ * @param argc Number of arguments.
+ * @param argv Command, store file and options.
+ * @return Exit status of the program.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: wwStore simulate|query|info FILE [options]" << std::endl;
+        return 1;
+    }
+    const std::string command = argv[1];
+    const std::string file = argv[2];
+    std::uint64_t games = 1000000;
+    std::uint32_t seed = std::random_device()();
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string by = "pair";
+    std::string eventsFile = "events.txt";
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--games") {
+            games = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (arg == "--seed") {
+            seed = static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (arg == "--threads") {
+            threads = std::max(1, std::atoi(argv[i + 1]));
+        } else if (arg == "--by") {
+            by = argv[i + 1];
+        } else if (arg == "--events") {
+            eventsFile = argv[i + 1];
+        }
+    }
+
+    rules::EventDeck deck = rules::EventDeck();
+    std::ifstream deckFile(eventsFile);
+    if (deckFile) {
+        deck = rules::EventDeck::parse(deckFile);
+    } else if (command == "simulate") {
+        std::cerr << eventsFile << " failed to load" << std::endl;
+        return 1;
+    }
+
+    if (command == "simulate") {
+        return simulate(file, games, seed, threads, deck);
+    }
+    store::Reader reader;
+    if (command != "query" && command != "info") {
+        std::cerr << "Unknown command " << command << "; use simulate, query or info" << std::endl;
+        return 1;
+    }
+    if (!reader.open(file)) {
+        return 1;
+    }
+    return command == "info" ? info(reader) : query(reader, by, threads, deck);
+}
@@ -0,0 +1,513 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Tables.h"
+#include "Assets.h"
+#include "Bot.h"
+#include "DrawList.h"
+#include "Events.h"
+#include "GameBoard.h"
+#include "Graduation.h"
+#include "Latency.h"
+#include "Pacing.h"
+#include "Player.h"
+#include "SceneGraph.h"
+#include "Simulation.h"
+#include "Telemetry.h"
+#include "Wheel.h"
+
+/**
+ * @file tables.cpp
+ * @brief Implementation file for the multi-table view.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const float focusWidth = 4.0f;                    ///< Width of the frame around the table the keyboard plays.
+    const sf::Color focusColour(255, 215, 0);         ///< Colour of that frame.
+    const sf::Color popupColour(91, 10, 125);         ///< Background of a table's popups, as in the single game.
+
+    /**
+     * @brief Works out how many tables go across the grid: the smallest number that makes it at least as tall
+     * as it is wide.
+     * @param count Number of tables.
+     * @return Columns of the grid.
+     */
+    int columnsFor(int count) {
+        return static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+    }
+
+    /**
+     * @brief Clamps a number of tables to what the view shows.
+     * @param count Number of tables asked for.
+     * @return Number of tables shown.
+     */
+    int clampCount(int count) {
+        return std::min(std::max(count, tables::minTables), tables::maxTables);
+    }
+
+    /**
+     * @class Notice
+     * @brief A popup drawn over one table's scene instead of taking over the window.
+     */
+    class Notice : public SceneNode {
+    private:
+        DrawList content;   ///< What the popup shows, in table coordinates.
+        sf::FloatRect area; ///< Area the popup covers.
+        bool shown;         ///< True while the popup is up.
+
+    public:
+        /**
+         * @brief Constructor for the Notice class. The popup starts hidden.
+         */
+        Notice() : shown(false) {
+        }
+
+        /**
+         * @brief Replaces what the popup shows and puts it up.
+         * @param covers Area the new content covers.
+         * @return Draw list to record the new content into.
+         */
+        DrawList& show(const sf::FloatRect& covers) {
+            content.clear();
+            area = covers;
+            shown = true;
+            markDirty();
+            return content;
+        }
+
+        /**
+         * @brief Takes the popup down.
+         */
+        void hide() {
+            if (shown) {
+                shown = false;
+                markDirty();
+            }
+        }
+
+        /**
+         * @brief Checks if the popup is up.
+         * @return True while it is shown.
+         */
+        bool isShown() const {
+            return shown;
+        }
+
+        /**
+         * @brief Gets the area the popup covers, which the scene repaints when it goes up or down.
+         * @return Bounding rectangle in table coordinates.
+         */
+        sf::FloatRect getBounds() const override {
+            return area;
+        }
+
+        /**
+         * @brief Draws the popup as part of the table's scene, if it is up.
+         * @param target Render target to draw on.
+         */
+        void render(sf::RenderTarget& target) override {
+            if (shown) {
+                content.draw(target);
+            }
+        }
+    };
+
+    /**
+     * @brief Gets the area a message popup covers: centred, like the single game's popups.
+     * @param size Size of the table in pixels.
+     * @return Bounding rectangle in table coordinates.
+     */
+    sf::FloatRect messageArea(const sf::Vector2u& size) {
+        float popupWidth = size.x * 0.75f;
+        float popupHeight = size.y * 0.9f;
+        return sf::FloatRect((size.x - popupWidth) / 2, (size.y - popupHeight) / 2, popupWidth, popupHeight);
+    }
+
+    /**
+     * @brief Records a popup with a heading and a body, laid out like the single game's resource popup.
+     * @param popup Draw list to record into.
+     * @param size Size of the table in pixels.
+     * @param heading Heading, in the larger size.
+     * @param body Body text.
+     */
+    void recordMessage(DrawList& popup, const sf::Vector2u& size, const std::string& heading,
+                       const std::string& body) {
+        const sf::Font& font = assets::font("Montserrat Medium 500.ttf");
+        const sf::FloatRect area = messageArea(size);
+
+        sf::Text text(heading, font, 24);
+        text.setFillColor(sf::Color::White);
+        text.setPosition(area.left + 20, area.top + 10);
+
+        sf::Text text2(body, font, 20);
+        text2.setFillColor(sf::Color::White);
+        text2.setPosition(area.left + 20, area.top + 60);
+
+        popup.rect(area, popupColour, 0);
+        popup.text(text, 1);
+        popup.text(text2, 1);
+    }
+
+    /**
+     * @class Table
+     * @brief One game in the grid: its board, markers, wheel and popup, the scene they are composed into, and the
+     * simulation thread playing it.
+     */
+    class Table {
+    private:
+        /**
+         * @brief What the table's popup is showing.
+         */
+        enum Showing {
+            Nothing,    ///< No popup.
+            EventShown, ///< The latest event, until it is closed.
+            PathChoice, ///< A player being asked for their path.
+            Results     ///< The graduation results, once both players have finished.
+        };
+
+        const rules::Board& layout;           ///< Board being played.
+        const sf::Vector2u size;              ///< Size of the table's scene in pixels.
+        GameBoard board;                      ///< Board, drawn from the shared atlas.
+        Wheel wheel;                          ///< The table's wheel.
+        Player player1;                       ///< Player 1's marker.
+        Player player2;                       ///< Player 2's marker.
+        Player* players[rules::playerCount];  ///< Both markers by player index.
+        Notice popup;                         ///< Popup drawn over the table.
+        Scene scene;                          ///< Retained scene the table is composed into.
+        std::unique_ptr<Bot> bot;             ///< Computer playing player 2, or nullptr.
+        Simulation simulation;                ///< Thread playing the table's game.
+
+        bool pathShown[rules::playerCount];   ///< True once a marker was moved onto its chosen path.
+        int spinsShown;                       ///< Spins animated so far.
+        int eventsShown;                      ///< Events shown so far.
+        int spinResult;                       ///< Result of the spin being animated.
+        bool spinning;                        ///< True while the wheel animates a spin.
+        pacing::Clock spinClock;              ///< Game time since the spin being animated started.
+        Showing showing;                      ///< What the popup shows.
+        int asking;                           ///< Player asked for their path while showing PathChoice.
+        sf::FloatRect closeButton;            ///< Close button of the event popup.
+
+        /**
+         * @brief Brings a marker and its resources in line with the latest snapshot.
+         * @param p Player index.
+         */
+        void showPlayer(int p) {
+            const Simulation::Snapshot& snapshot = simulation.latest();
+            const rules::PlayerState& state = snapshot.state.players[p];
+            Player& player = *players[p];
+            if (state.chosen && !pathShown[p]) {
+                player.setPath(state.path == rules::western ? board.getWesternPath() : board.getIveyPath());
+                pathShown[p] = true;
+            }
+            if (player.getPosition() != player.getPath()[snapshot.shown[p]]) {
+                player.setSpaceIndex(snapshot.shown[p]);
+            }
+
+            // Leave out an event still on its way, and remember the setters add the amount they are given
+            const rules::Effect& unseen = snapshot.unseen[p];
+            player.setHappiness(state.happiness - unseen.happiness - player.getHappiness());
+            player.setDebt(state.debt - unseen.debt - player.getDebt());
+            player.setGPA(state.gpa - unseen.gpa - player.getGPA());
+        }
+
+        /**
+         * @brief Puts up whatever popup the game is waiting on, if none is up: the latest event, then a path
+         * choice, then the results.
+         */
+        void showPopup() {
+            const Simulation::Snapshot& snapshot = simulation.latest();
+            if (snapshot.events != eventsShown) {
+                eventsShown = snapshot.events;
+                DrawList& content = popup.show(sf::FloatRect(0, 0, size.x, size.y));
+                closeButton = events::recordPopup(content, size, events::deck().events[snapshot.event],
+                                                  snapshot.effect);
+                showing = EventShown;
+                return;
+            }
+
+            // Player 1 chooses first, and the bot chooses for itself
+            for (int p = 0; p < rules::playerCount; ++p) {
+                if (!snapshot.state.players[p].chosen && !(bot && p == 1) &&
+                    (p == 0 || snapshot.state.players[0].chosen)) {
+                    recordMessage(popup.show(messageArea(size)), size, "Player " + std::to_string(p + 1) +
+                                  " Choose Your Path", "Western - Press W\nIvey - Press I");
+                    showing = PathChoice;
+                    asking = p;
+                    return;
+                }
+            }
+
+            if (player1.finished() && player2.finished() && !spinning) {
+                int score1 = 0;
+                int score2 = 0;
+                rules::scores(snapshot.state, score1, score2);
+                std::string body;
+                for (int p = 0; p < rules::playerCount; ++p) {
+                    const rules::PlayerState& state = snapshot.state.players[p];
+                    body += "Player " + std::to_string(p + 1) + ": GPA " + std::to_string(state.gpa) + ", Debt " +
+                            std::to_string(state.debt) + ",\nHappiness " + std::to_string(state.happiness) +
+                            ", Categories " + std::to_string(p == 0 ? score1 : score2) + "/3\n";
+                }
+                body += "\nWinner is " + Graduation::Winner(score1, score2);
+                recordMessage(popup.show(messageArea(size)), size, "Graduation", body);
+                showing = Results;
+            }
+        }
+
+        /**
+         * @brief Closes the event popup and lets the game go on.
+         */
+        void closeEvent() {
+            popup.hide();
+            showing = Nothing;
+            simulation.send({Simulation::EventSeen, 0, 0});
+        }
+
+    public:
+        /**
+         * @brief Constructor for the Table class. Sets up the table's scene and starts its game.
+         * @param layout Board to play on.
+         * @param size Width and height of the table's scene in pixels.
+         * @param log Telemetry log, left closed so the tables do not share its producer slot.
+         * @param botBudgetMs If above 0, the bot's thinking time per decision in milliseconds.
+         * @param seed Seed of the table's spin and event stream.
+         */
+        Table(const rules::Board& layout, unsigned size, telemetry::Log& log, double botBudgetMs, std::uint32_t seed)
+            : layout(layout),
+              size(size, size),
+              board(layout),
+              player1(board.getIveyPath(), sf::Color::Red),
+              player2(board.getWesternPath(), sf::Color::Blue),
+              scene(size, size),
+              bot(botBudgetMs > 0 ? new Bot(layout, events::deck(),
+                                            std::chrono::microseconds(static_cast<long>(botBudgetMs * 1000)), 1)
+                                  : nullptr),
+              simulation(layout, events::deck(), wheel, bot.get(), log, seed),
+              spinsShown(0),
+              eventsShown(0),
+              spinResult(0),
+              spinning(false),
+              showing(Nothing),
+              asking(0) {
+            players[0] = &player1;
+            players[1] = &player2;
+            pathShown[0] = false;
+            pathShown[1] = false;
+            scene.addStatic(board);
+            scene.addDynamic(player1);
+            scene.addDynamic(player2);
+            scene.addOverlay(wheel);
+            scene.addOverlay(popup);
+            simulation.start();
+        }
+
+        /**
+         * @brief Catches up with the simulation, moves the wheel on and recomposes whatever changed.
+         * @return True if the table's frame changed.
+         */
+        bool update() {
+            simulation.update();
+            const Simulation::Snapshot& snapshot = simulation.latest();
+            showPlayer(0);
+            showPlayer(1);
+
+            // The wheel animates without blocking, so the other tables keep going while it spins
+            if (snapshot.spins != spinsShown) {
+                spinsShown = snapshot.spins;
+                spinResult = snapshot.lastTurn.spin;
+                spinning = true;
+                spinClock.restart();
+            }
+            if (spinning) {
+                const int elapsed = spinClock.milliseconds();
+                wheel.SetArrowAngle(wheel.SpinAngle(spinResult, elapsed));
+                spinning = elapsed < wheel.SpinMillis(spinResult);
+            }
+
+            // A path choice stays up until the simulation has taken it, so it is not asked for twice
+            if (showing == PathChoice && snapshot.state.players[asking].chosen) {
+                popup.hide();
+                showing = Nothing;
+            }
+            if (!popup.isShown()) {
+                showPopup();
+            }
+
+            // Loaded boards are bigger than a table, so each table's camera follows its current player
+            if (&layout != &rules::Board::standard()) {
+                sf::View camera(sf::FloatRect(0, 0, size.x, size.y));
+                camera.setCenter(players[snapshot.state.turn]->getPosition());
+                scene.setCamera(camera);
+            }
+            return scene.compose();
+        }
+
+        /**
+         * @brief Acts on a key pressed while the table has the keyboard.
+         * @param code Key pressed.
+         */
+        void key(sf::Keyboard::Key code) {
+            if (code == sf::Keyboard::Space && showing == Nothing) {
+                simulation.send({Simulation::Spin, 0, 0});
+            } else if (showing == PathChoice && (code == sf::Keyboard::W || code == sf::Keyboard::I)) {
+                const int path = code == sf::Keyboard::W ? rules::western : rules::ivey;
+                simulation.send({Simulation::ChoosePath, static_cast<std::int8_t>(asking),
+                                 static_cast<std::int8_t>(path)});
+            } else if (showing == EventShown && (code == sf::Keyboard::Enter || code == sf::Keyboard::X)) {
+                closeEvent();
+            } else if (showing == Nothing && (code == sf::Keyboard::U || code == sf::Keyboard::Y)) {
+                simulation.send({Simulation::Rewind, 0, static_cast<std::int8_t>(code == sf::Keyboard::U ? -1 : 1)});
+            }
+        }
+
+        /**
+         * @brief Acts on a click on the table.
+         * @param at Point clicked, in table coordinates.
+         */
+        void click(const sf::Vector2f& at) {
+            if (showing == EventShown && closeButton.contains(at.x, at.y)) {
+                closeEvent();
+            }
+        }
+
+        /**
+         * @brief Gets the table's last composed frame.
+         * @return Texture holding the frame.
+         */
+        const sf::Texture& frame() const {
+            return scene.getFrame();
+        }
+    };
+
+    /**
+     * @brief Draws a frame around a table, inside its edges.
+     * @param outline Draw list to record into.
+     * @param size Width and height of the table.
+     */
+    void recordFocus(DrawList& outline, float size) {
+        outline.rect(sf::FloatRect(0, 0, size, focusWidth), focusColour);
+        outline.rect(sf::FloatRect(0, size - focusWidth, size, focusWidth), focusColour);
+        outline.rect(sf::FloatRect(0, focusWidth, focusWidth, size - 2 * focusWidth), focusColour);
+        outline.rect(sf::FloatRect(size - focusWidth, focusWidth, focusWidth, size - 2 * focusWidth), focusColour);
+    }
+}
+
+/**
+ * @brief Works out how big a window the grid needs.
+ * @param count Number of tables.
+ * @param tableSize Width and height of one table in pixels at full size.
+ * @return Size of the window in pixels.
+ */
+sf::Vector2u tables::windowSize(int count, unsigned tableSize) {
+    count = clampCount(count);
+    const int columns = columnsFor(count);
+    const int rows = (count + columns - 1) / columns;
+    const sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
+    const float scale = std::min(1.0f, std::min(0.9f * desktop.width / (columns * tableSize),
+                                                0.9f * desktop.height / (rows * tableSize)));
+    const unsigned cell = static_cast<unsigned>(tableSize * scale);
+    return sf::Vector2u(columns * cell, rows * cell);
+}
+
+/**
+ * @brief Plays a grid of tables until the window is closed. Each table is recomposed only when its game changed;
+ * the window is redrawn only when a table changed or the keyboard moved, by stretching every table's cached frame
+ * into its viewport.
+ * @param window SFML RenderWindow for the grid.
+ * @param layout Board every table plays on.
+ * @param count Number of tables.
+ * @param tableSize Width and height of one table's scene in pixels.
+ * @param botBudgetMs If above 0, the bot's thinking time per decision in milliseconds.
+ * @return Exit status of the program.
+ */
+int tables::play(sf::RenderWindow& window, const rules::Board& layout, int count, unsigned tableSize,
+                 double botBudgetMs) {
+    count = clampCount(count);
+    const int columns = columnsFor(count);
+    const int rows = (count + columns - 1) / columns;
+
+    // Every table plays its own stream; the telemetry log stays closed, since each simulation records as producer 0
+    telemetry::Log log;
+    const std::uint32_t seed = std::random_device()();
+    std::vector<std::unique_ptr<Table>> grid;
+    std::vector<sf::View> views;
+    for (int t = 0; t < count; ++t) {
+        grid.emplace_back(new Table(layout, tableSize, log, botBudgetMs, rules::mix(seed, t)));
+        sf::View view(sf::FloatRect(0, 0, tableSize, tableSize));
+        view.setViewport(sf::FloatRect(static_cast<float>(t % columns) / columns,
+                                       static_cast<float>(t / columns) / rows, 1.0f / columns, 1.0f / rows));
+        views.push_back(view);
+    }
+
+    DrawList outline;
+    recordFocus(outline, static_cast<float>(tableSize));
+    sf::Sprite tableSprite;
+    int focus = 0;
+    bool redraw = true;
+
+    while (window.isOpen()) {
+        for (auto& table : grid) {
+            if (table->update()) {
+                redraw = true;
+            }
+        }
+
+        sf::Event event;
+        while (latency::pollEvent(window, event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+            }
+            if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus) {
+                redraw = true;
+            }
+
+            // A click gives its table the keyboard and may close that table's event
+            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+                const sf::Vector2i pixel(event.mouseButton.x, event.mouseButton.y);
+                for (int t = 0; t < count; ++t) {
+                    if (window.getViewport(views[t]).contains(pixel.x, pixel.y)) {
+                        focus = t;
+                        grid[t]->click(window.mapPixelToCoords(pixel, views[t]));
+                        redraw = true;
+                    }
+                }
+            }
+
+            if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::Tab) {
+                    focus = (focus + 1) % count;
+                    redraw = true;
+                } else {
+                    grid[focus]->key(event.key.code);
+                }
+            }
+        }
+
+        if (!redraw) {
+            sf::sleep(sf::milliseconds(1)); // Nothing changed, so the previous frame is still on screen
+            continue;
+        }
+
+        // The back buffer is not kept between frames, so every table's cached frame is drawn again
+        window.clear();
+        for (int t = 0; t < count; ++t) {
+            window.setView(views[t]);
+            tableSprite.setTexture(grid[t]->frame(), true);
+            window.draw(tableSprite);
+            if (t == focus) {
+                outline.draw(window);
+            }
+        }
+        window.setView(window.getDefaultView());
+        latency::display(window);
+        redraw = false;
+    }
+    return 0;
+}
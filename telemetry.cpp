@@ -0,0 +1,334 @@
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Telemetry.h"
+
+/**
+ * @file telemetry.cpp
+ * @brief Implementation file for the per-game telemetry log.
+ * @author Ansel Zeng, Kelly Guo, Stanley Cao, Charmaine Lee, Nicole Moskovitch
+ */
+
+namespace {
+
+    const char* const pathNames[rules::pathCount] = {"western", "ivey"}; ///< Path names by path index.
+    const std::int64_t syncMicros = 1000000; ///< Longest time written lines stay unsynced.
+    const int idleMillis = 20;               ///< Writer's sleep when the rings are empty.
+
+    /**
+     * @brief A game whose line is still being put together by the writer.
+     */
+    struct Game {
+        std::int64_t start;            ///< Time of the first record.
+        std::int64_t last;             ///< Time of the latest record.
+        int paths[rules::playerCount]; ///< Path each player chose, or -1.
+        std::string turns;             ///< JSON objects for the turns so far, comma separated.
+    };
+
+    /**
+     * @brief Writes a whole buffer, retrying short writes.
+     * @param fd File to write to.
+     * @param data Bytes to write.
+     * @return False if the write failed.
+     */
+    bool writeAll(int fd, const std::string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Appends a game's line.
+     * @param id Game id.
+     * @param game The game so far.
+     * @param startedUnixMs Wall clock time of the game's first record.
+     * @param end The Ended record, or nullptr if the game did not finish.
+     * @param out Buffer to append to.
+     */
+    void writeGame(std::uint64_t id, const Game& game, std::int64_t startedUnixMs, const telemetry::Record* end,
+                   std::string& out) {
+        out += "{\"game\":" + std::to_string(id) + ",\"started\":" + std::to_string(startedUnixMs) +
+               ",\"ms\":" + std::to_string((game.last - game.start) / 1000) + ",\"paths\":[";
+        for (int p = 0; p < rules::playerCount; ++p) {
+            out += p ? "," : "";
+            out += game.paths[p] >= 0 ? std::string("\"") + pathNames[game.paths[p]] + "\"" : "null";
+        }
+        out += "],\"turns\":[" + game.turns + "],\"finished\":" + (end ? "true" : "false");
+        if (end) {
+            out += ",\"scores\":[" + std::to_string(end->change[0]) + "," + std::to_string(end->change[1]) +
+                   "],\"winner\":" + (end->player < 0 ? std::string("null") : std::to_string(end->player + 1));
+        }
+        out += "}\n";
+    }
+}
+
+/**
+ * @brief Reads the steady clock in microseconds.
+ * @return Current time.
+ */
+std::int64_t telemetry::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Makes a record that a game began.
+ * @param game Game id.
+ * @return The record.
+ */
+telemetry::Record telemetry::started(std::uint64_t game) {
+    Record record = Record();
+    record.game = game;
+    record.micros = now();
+    record.kind = Started;
+    record.event = -1;
+    return record;
+}
+
+/**
+ * @brief Makes a record of a path choice.
+ * @param game Game id.
+ * @param player Player index.
+ * @param path Path index.
+ * @return The record.
+ */
+telemetry::Record telemetry::chose(std::uint64_t game, int player, int path) {
+    Record record = started(game);
+    record.kind = Chose;
+    record.player = static_cast<std::int8_t>(player);
+    record.value = static_cast<std::int8_t>(path);
+    return record;
+}
+
+/**
+ * @brief Makes a record of a turn.
+ * @param game Game id.
+ * @param turn What happened.
+ * @param before The player before the turn.
+ * @param after The player after the turn.
+ * @return The record.
+ */
+telemetry::Record telemetry::played(std::uint64_t game, const rules::Turn& turn, const rules::PlayerState& before,
+                                    const rules::PlayerState& after) {
+    Record record = started(game);
+    record.kind = Played;
+    record.player = static_cast<std::int8_t>(turn.player);
+    record.value = static_cast<std::int8_t>(turn.spin);
+    record.event = turn.event;
+    record.change[0] = after.happiness - before.happiness;
+    record.change[1] = after.debt - before.debt;
+    record.change[2] = after.gpa - before.gpa;
+    return record;
+}
+
+/**
+ * @brief Makes a record of an undo or redo.
+ * @param game Game id.
+ * @param turn Turns played to reach the state gone to.
+ * @return The record.
+ */
+telemetry::Record telemetry::rewound(std::uint64_t game, int turn) {
+    Record record = started(game);
+    record.kind = Rewound;
+    record.change[0] = turn;
+    return record;
+}
+
+/**
+ * @brief Makes a record of the graduation result.
+ * @param game Game id.
+ * @param state Finished game.
+ * @return The record.
+ */
+telemetry::Record telemetry::ended(std::uint64_t game, const rules::GameState& state) {
+    Record record = started(game);
+    record.kind = Ended;
+    record.player = static_cast<std::int8_t>(rules::winner(state));
+    int score1;
+    int score2;
+    rules::scores(state, score1, score2);
+    record.change[0] = score1;
+    record.change[1] = score2;
+    return record;
+}
+
+/**
+ * @brief Makes a record that a game was given up.
+ * @param game Game id.
+ * @return The record.
+ */
+telemetry::Record telemetry::abandoned(std::uint64_t game) {
+    Record record = started(game);
+    record.kind = Abandoned;
+    return record;
+}
+
+/**
+ * @brief Constructor for the Log class.
+ */
+telemetry::Log::Log() : fd(-1), stopping(false), dropped(0), openedMicros(0), openedUnixMs(0) {
+}
+
+/**
+ * @brief Destructor for the Log class.
+ */
+telemetry::Log::~Log() {
+    close();
+}
+
+/**
+ * @brief Opens a file for appending and starts the writer.
+ * @param path File name.
+ * @param producers Number of threads that will record.
+ * @param capacity Records each producer's ring holds.
+ * @return False if the file could not be opened.
+ */
+bool telemetry::Log::open(const std::string& path, int producers, std::size_t capacity) {
+    close();
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        std::cerr << "Cannot open telemetry file " << path << std::endl;
+        return false;
+    }
+    rings.clear();
+    for (int i = 0; i < producers; ++i) {
+        rings.emplace_back(new SpscQueue<Record>(capacity));
+    }
+    openedMicros = now();
+    openedUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    stopping = false;
+    writer = std::thread(&Log::run, this);
+    return true;
+}
+
+/**
+ * @brief Queues a record without blocking, counting it as dropped if the ring is full.
+ * @param producer Index of the calling thread.
+ * @param record Record to queue.
+ */
+void telemetry::Log::record(int producer, const Record& record) {
+    if (fd < 0) {
+        return;
+    }
+    if (!rings[producer]->push(record)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes out everything queued, syncs the file and stops the writer.
+ */
+void telemetry::Log::close() {
+    if (fd < 0) {
+        return;
+    }
+    stopping = true;
+    writer.join();
+    ::close(fd);
+    fd = -1;
+    if (dropped > 0) {
+        std::cerr << dropped << " telemetry records were dropped" << std::endl;
+    }
+}
+
+/**
+ * @brief Checks if the log is open.
+ * @return True if records are being written.
+ */
+bool telemetry::Log::isOpen() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Gets the number of records lost because the writer fell behind.
+ * @return Records dropped so far.
+ */
+std::uint64_t telemetry::Log::droppedCount() const {
+    return dropped;
+}
+
+/**
+ * @brief Drains the rings, assembles each game's line and writes finished lines in batches. The file is synced
+ * at most once a second, and once more when the log closes; games still open then are written as unfinished.
+ */
+void telemetry::Log::run() {
+    std::map<std::uint64_t, Game> games;
+    std::string out;
+    bool unsynced = false;
+    std::int64_t lastSync = now();
+
+    while (true) {
+        // Read the flag first, so every record pushed before close() is drained below
+        const bool stop = stopping.load();
+        Record r;
+        for (auto& ring : rings) {
+            while (ring->pop(r)) {
+                auto found = games.find(r.game);
+                if (found == games.end()) {
+                    Game fresh = {r.micros, r.micros, {-1, -1}, std::string()};
+                    found = games.emplace(r.game, fresh).first;
+                }
+                Game& game = found->second;
+                const std::int64_t since = r.micros - game.last;
+                game.last = r.micros;
+                const std::int64_t startedUnixMs = openedUnixMs + (game.start - openedMicros) / 1000;
+
+                if (r.kind == Chose && r.player >= 0 && r.player < rules::playerCount && r.value >= 0 &&
+                    r.value < rules::pathCount) {
+                    game.paths[r.player] = r.value;
+                } else if (r.kind == Played) {
+                    game.turns += game.turns.empty() ? "" : ",";
+                    game.turns += "{\"player\":" + std::to_string(r.player + 1) + ",\"spin\":" +
+                                  std::to_string(r.value) + ",\"event\":" +
+                                  (r.event < 0 ? std::string("null") : std::to_string(r.event)) +
+                                  ",\"happiness\":" + std::to_string(r.change[0]) + ",\"debt\":" +
+                                  std::to_string(r.change[1]) + ",\"gpa\":" + std::to_string(r.change[2]) +
+                                  ",\"ms\":" + std::to_string(since / 1000) + "}";
+                } else if (r.kind == Rewound) {
+                    game.turns += game.turns.empty() ? "" : ",";
+                    game.turns += "{\"rewound\":" + std::to_string(r.change[0]) + ",\"ms\":" +
+                                  std::to_string(since / 1000) + "}";
+                } else if (r.kind == Ended || r.kind == Abandoned) {
+                    writeGame(r.game, game, startedUnixMs, r.kind == Ended ? &r : nullptr, out);
+                    games.erase(found);
+                }
+            }
+        }
+        if (stop) {
+            for (const auto& entry : games) {
+                writeGame(entry.first, entry.second,
+                          openedUnixMs + (entry.second.start - openedMicros) / 1000, nullptr, out);
+            }
+        }
+
+        if (!out.empty()) {
+            if (!writeAll(fd, out)) {
+                std::cerr << "Telemetry write failed" << std::endl;
+            }
+            out.clear();
+            unsynced = true;
+        }
+        if (unsynced && (stop || now() - lastSync >= syncMicros)) {
+            ::fsync(fd);
+            unsynced = false;
+            lastSync = now();
+        }
+        if (stop) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(idleMillis));
+    }
+}